@@ -4,6 +4,12 @@
 /* Define if we don't have proper support for the system's crypt().  */
 #undef HAVE_UNSAFE_CRYPT
 
+/* Define if the system has POSIX threads (-lpthread).  */
+#undef EMPIRE_THREADS
+
+/* Define if the system has zlib (-lz), for MCCP compression.  */
+#undef EMPIRE_ZLIB
+
 /* Define is the system has struct in_addr.  */
 #undef HAVE_STRUCT_IN_ADDR
 
@@ -2590,7 +2590,7 @@ ACMD(do_fillin) {
 		// anything to reverse it to?
 		msg_to_char(ch, "You can't fill anything in here.\r\n");
 	}
-	else if (SECT(IN_ROOM(ch)) == world_map[FLAT_X_COORD(IN_ROOM(ch))][FLAT_Y_COORD(IN_ROOM(ch))].natural_sector) {
+	else if (SECT(IN_ROOM(ch)) == MAP_NATURAL_SECT(GET_ROOM_VNUM(IN_ROOM(ch)))) {
 		msg_to_char(ch, "You can only fill in a tile that was made by excavation, not a natural one.\r\n");
 	}
 	else if (!can_use_room(ch, IN_ROOM(ch), MEMBERS_ONLY)) {
@@ -1219,6 +1219,8 @@ void downgrade_city(char_data *ch, char *argument) {
 
 	if (city->type > 0) {
 		city->type--;
+		invalidate_map_icon(GET_ROOM_VNUM(city->location));
+		reset_city_coverage(emp);
 		log_to_empire(emp, ELOG_TERRITORY, "%s has downgraded %s to a %s", PERS(ch, ch, 1), city->name, city_type[city->type].name);
 	}
 	else {
@@ -1371,8 +1373,9 @@ void found_city(char_data *ch, char *argument) {
 * @return bool TRUE if in-city, FALSE if not.
 */
 bool is_in_city_for_empire(room_data *loc, empire_data *emp, bool check_wait, bool *too_soon) {
+	struct city_coverage_data *cov;
 	struct empire_city_data *city;
-	int dist;
+	int dist, x, y;
 	
 	int wait = config_get_int("minutes_to_full_city") * SECS_PER_REAL_MIN;
 	
@@ -1387,10 +1390,16 @@ bool is_in_city_for_empire(room_data *loc, empire_data *emp, bool check_wait, bo
 		return TRUE;
 	}
 	
-	for (city = EMPIRE_CITY_LIST(emp); city; city = city->next) {
-		dist = compute_distance(loc, city->location);
+	if ((x = X_COORD(loc)) == -1 || (y = Y_COORD(loc)) == -1) {
+		return FALSE;	// not on the map
+	}
+	
+	// only cities near this map cell are in its coverage list
+	for (cov = get_city_coverage(emp, x, y); cov; cov = cov->next) {
+		city = cov->city;
+		dist = compute_map_distance(x, y, cov->x, cov->y);
 		
-		if (dist <= city_type[city->type].radius || (LARGE_CITY_RADIUS(loc) && dist <= (3 * city_type[city->type].radius))) {
+		if (dist <= cov->radius || (LARGE_CITY_RADIUS(loc) && dist <= (3 * cov->radius))) {
 			if (!check_wait || (get_room_extra_data(city->location, ROOM_EXTRA_FOUND_TIME) + wait) < time(0)) {
 				return TRUE;
 			}
@@ -1476,6 +1485,7 @@ void perform_abandon_city(empire_data *emp, struct empire_city_data *city, bool
 		disassociate_building(cityloc);
 	}
 	REMOVE_FROM_LIST(city, EMPIRE_CITY_LIST(emp), next);
+	reset_city_coverage(emp);
 	if (city->name) {
 		free(city->name);
 	}
@@ -1576,6 +1586,8 @@ void upgrade_city(char_data *ch, char *argument) {
 	}
 	
 	city->type++;
+	invalidate_map_icon(GET_ROOM_VNUM(city->location));
+	reset_city_coverage(emp);
 	
 	log_to_empire(emp, ELOG_TERRITORY, "%s has upgraded %s to a %s", PERS(ch, ch, 1), city->name, city_type[city->type].name);
 	read_empire_territory(emp, FALSE);
@@ -2547,7 +2559,7 @@ void do_abandon_vehicle(char_data *ch, vehicle_data *veh) {
 	else {
 		act("You abandon $V.", FALSE, ch, NULL, veh, TO_CHAR);
 		act("$n abandons $V.", FALSE, ch, NULL, veh, TO_ROOM);
-		VEH_OWNER(veh) = NULL;
+		set_vehicle_owner(veh, NULL);
 		
 		if (VEH_INTERIOR_HOME_ROOM(veh)) {
 			abandon_room(VEH_INTERIOR_HOME_ROOM(veh));
@@ -2898,7 +2910,7 @@ void do_claim_vehicle(char_data *ch, vehicle_data *veh) {
 	else {
 		send_config_msg(ch, "ok_string");
 		act("$n claims $V.", FALSE, ch, NULL, veh, TO_ROOM);
-		VEH_OWNER(veh) = emp;
+		set_vehicle_owner(veh, emp);
 		VEH_SHIPPING_ID(veh) = -1;
 		
 		if (VEH_INTERIOR_HOME_ROOM(veh)) {
@@ -3871,7 +3883,7 @@ ACMD(do_enroll) {
 			// vehicles
 			LL_FOREACH_SAFE2(vehicle_list, veh, next_veh, next) {
 				if (VEH_OWNER(veh) == old) {
-					VEH_OWNER(veh) = e;
+					set_vehicle_owner(veh, e);
 				}
 				LL_FOREACH(VEH_ANIMALS(veh), vam) {
 					if (vam->empire == EMPIRE_VNUM(old)) {
@@ -3883,11 +3895,7 @@ ACMD(do_enroll) {
 			// storage
 			for (store = EMPIRE_STORAGE(old); store; store = store->next) {
 				if (!(store2 = find_stored_resource(e, store->island, store->vnum))) {
-					CREATE(store2, struct empire_storage_data, 1);
-					store2->next = EMPIRE_STORAGE(e);
-					EMPIRE_STORAGE(e) = store2;
-					store2->vnum = store->vnum;
-					store2->island = store->island;
+					store2 = create_storage_entry(e, store->island, store->vnum);
 				}
 
 				old_store = store2->amount;
@@ -3897,6 +3905,7 @@ ACMD(do_enroll) {
 					store2->amount = MAX_STORAGE;
 				}
 			}
+			EMPIRE_STORAGE_CHANGED(e);
 			
 			// unique storage: append to end of current empire's list
 			if (EMPIRE_UNIQUE_STORAGE(old)) {
@@ -3921,6 +3930,8 @@ ACMD(do_enroll) {
 					// remove from old empire
 					REMOVE_FROM_LIST(city, EMPIRE_CITY_LIST(old), next);
 					city->next = NULL;
+					reset_city_coverage(old);
+					reset_city_coverage(e);
 					
 					// add to new empire
 					if (EMPIRE_CITY_LIST(e)) {
@@ -3950,11 +3961,15 @@ ACMD(do_enroll) {
 				}
 				
 				// move territory over
+				HASH_DEL(EMPIRE_TERRITORY_BY_VNUM(old), ter);
 				ter->next = EMPIRE_TERRITORY_LIST(e);
 				EMPIRE_TERRITORY_LIST(e) = ter;
+				HASH_ADD_INT(EMPIRE_TERRITORY_BY_VNUM(e), vnum, ter);
 			}
 			
 			EMPIRE_TERRITORY_LIST(old) = NULL;
+			free_territory_indexes(old);
+			reset_territory_indexes(e);
 			
 			// move territory over
 			HASH_ITER(hh, world_table, room, next_room) {
@@ -4453,7 +4468,7 @@ ACMD(do_home) {
 				}
 			}
 			
-			COMPLEX_DATA(real)->private_owner = GET_IDNUM(ch);
+			set_private_owner(real, GET_IDNUM(ch));
 
 			// interior only
 			for (iter = interior_room_list; iter; iter = next_iter) {
@@ -4981,12 +4996,12 @@ ACMD(do_publicize) {
 	}
 	else if (ROOM_AFF_FLAGGED(IN_ROOM(ch), ROOM_AFF_PUBLIC)) {
 		REMOVE_BIT(ROOM_AFF_FLAGS(IN_ROOM(ch)), ROOM_AFF_PUBLIC);
-		REMOVE_BIT(ROOM_BASE_FLAGS(IN_ROOM(ch)), ROOM_AFF_PUBLIC);
+		remove_room_base_flags(IN_ROOM(ch), ROOM_AFF_PUBLIC);
 		msg_to_char(ch, "This area is no longer public.\r\n");
 	}
 	else {
 		SET_BIT(ROOM_AFF_FLAGS(IN_ROOM(ch)), ROOM_AFF_PUBLIC);
-		SET_BIT(ROOM_BASE_FLAGS(IN_ROOM(ch)), ROOM_AFF_PUBLIC);
+		set_room_base_flags(IN_ROOM(ch), ROOM_AFF_PUBLIC);
 		msg_to_char(ch, "This area is now public.\r\n");
 	}
 }
@@ -5431,7 +5446,7 @@ ACMD(do_unpublicize) {
 		HASH_ITER(hh, world_table, iter, next_iter) {
 			if (ROOM_AFF_FLAGGED(iter, ROOM_AFF_PUBLIC) && ROOM_OWNER(iter) == e) {
 				REMOVE_BIT(ROOM_AFF_FLAGS(iter), ROOM_AFF_PUBLIC);
-				REMOVE_BIT(ROOM_BASE_FLAGS(iter), ROOM_AFF_PUBLIC);
+				remove_room_base_flags(iter, ROOM_AFF_PUBLIC);
 			}
 		}
 		msg_to_char(ch, "All public status for this empire's buildings has been renounced.\r\n");
@@ -5483,12 +5498,12 @@ ACMD(do_workforce) {
 		}
 		else if (ROOM_AFF_FLAGGED(IN_ROOM(ch), ROOM_AFF_NO_WORK)) {
 			REMOVE_BIT(ROOM_AFF_FLAGS(IN_ROOM(ch)), ROOM_AFF_NO_WORK);
-			REMOVE_BIT(ROOM_BASE_FLAGS(IN_ROOM(ch)), ROOM_AFF_NO_WORK);
+			remove_room_base_flags(IN_ROOM(ch), ROOM_AFF_NO_WORK);
 			msg_to_char(ch, "Workforce will now be able to work this tile.\r\n");
 		}
 		else {
 			SET_BIT(ROOM_AFF_FLAGS(IN_ROOM(ch)), ROOM_AFF_NO_WORK);
-			SET_BIT(ROOM_BASE_FLAGS(IN_ROOM(ch)), ROOM_AFF_NO_WORK);
+			set_room_base_flags(IN_ROOM(ch), ROOM_AFF_NO_WORK);
 			msg_to_char(ch, "Workforce will no longer work this tile.\r\n");
 			deactivate_workforce_room(emp, IN_ROOM(ch));
 		}
@@ -1530,7 +1530,7 @@ RITUAL_FINISH_FUNC(perform_chant_of_illusions) {
 	}
 	
 	SET_BIT(ROOM_AFF_FLAGS(IN_ROOM(ch)), ROOM_AFF_CHAMELEON);
-	SET_BIT(ROOM_BASE_FLAGS(IN_ROOM(ch)), ROOM_AFF_CHAMELEON);
+	set_room_base_flags(IN_ROOM(ch), ROOM_AFF_CHAMELEON);
 	msg_to_char(ch, "As you finish the chant, the road is cloaked in illusion!\r\n");
 }
 
@@ -1810,7 +1810,7 @@ RITUAL_FINISH_FUNC(perform_ritual_of_defense) {
 		gain_ability_exp(ch, ABIL_RITUAL_OF_DEFENSE, 25);
 	}
 	SET_BIT(ROOM_AFF_FLAGS(IN_ROOM(ch)), ROOM_AFF_NO_FLY);
-	SET_BIT(ROOM_BASE_FLAGS(IN_ROOM(ch)), ROOM_AFF_NO_FLY);
+	set_room_base_flags(IN_ROOM(ch), ROOM_AFF_NO_FLY);
 }
 
 
@@ -23,6 +23,7 @@
 #include "skills.h"
 #include "olc.h"
 #include "dg_scripts.h"
+#include "dg_event.h"
 
 /**
 * Contents:
@@ -333,14 +334,23 @@ bool users_output(char_data *to, char_data *tch, descriptor_data *d, char *name_
 
 ADMIN_UTIL(util_b318_buildings);
 ADMIN_UTIL(util_clear_roles);
+ADMIN_UTIL(util_cmdtrie);
+ADMIN_UTIL(util_cmdtrigs);
 ADMIN_UTIL(util_diminish);
+ADMIN_UTIL(util_eventbench);
+ADMIN_UTIL(util_evobench);
 ADMIN_UTIL(util_islandsize);
+ADMIN_UTIL(util_lookbench);
+ADMIN_UTIL(util_mapbench);
+ADMIN_UTIL(util_nearbench);
 ADMIN_UTIL(util_playerdump);
 ADMIN_UTIL(util_randtest);
 ADMIN_UTIL(util_redo_islands);
 ADMIN_UTIL(util_rescan);
 ADMIN_UTIL(util_resetbuildingtriggers);
+ADMIN_UTIL(util_scriptbench);
 ADMIN_UTIL(util_strlen);
+ADMIN_UTIL(util_territorybench);
 ADMIN_UTIL(util_tool);
 ADMIN_UTIL(util_yearly);
 
@@ -352,14 +362,23 @@ struct {
 } admin_utils[] = {
 	{ "b318buildings", LVL_CIMPL, util_b318_buildings },
 	{ "clearroles", LVL_CIMPL, util_clear_roles },
+	{ "cmdtrie", LVL_CIMPL, util_cmdtrie },
+	{ "cmdtrigs", LVL_CIMPL, util_cmdtrigs },
 	{ "diminish", LVL_START_IMM, util_diminish },
+	{ "eventbench", LVL_CIMPL, util_eventbench },
+	{ "evobench", LVL_CIMPL, util_evobench },
 	{ "islandsize", LVL_START_IMM, util_islandsize },
+	{ "lookbench", LVL_CIMPL, util_lookbench },
+	{ "mapbench", LVL_CIMPL, util_mapbench },
+	{ "nearbench", LVL_CIMPL, util_nearbench },
 	{ "playerdump", LVL_IMPL, util_playerdump },
 	{ "randtest", LVL_CIMPL, util_randtest },
 	{ "redoislands", LVL_CIMPL, util_redo_islands },
 	{ "rescan", LVL_START_IMM, util_rescan },
 	{ "resetbuildingtriggers", LVL_CIMPL, util_resetbuildingtriggers },
+	{ "scriptbench", LVL_CIMPL, util_scriptbench },
 	{ "strlen", LVL_START_IMM, util_strlen },
+	{ "territorybench", LVL_CIMPL, util_territorybench },
 	{ "tool", LVL_IMPL, util_tool },
 	{ "yearly", LVL_CIMPL, util_yearly },
 
@@ -368,6 +387,62 @@ struct {
 };
 
 
+// one timed step of a *bench util: 'iter' counts up from 0 (see time_bench_step)
+#define BENCH_STEP(name)  static int name(void *data, int iter)
+
+
+/**
+* Reads the optional count argument of a *bench util. If there isn't one, the
+* default is used; if it's not valid, the player is sent the usage.
+*
+* @param char_data *ch The person running the util.
+* @param char *argument The util's argument.
+* @param const char *usage The usage, e.g. "evobench [number of tiles]".
+* @param const char *what What it counts, for the range error, e.g. "Number of tiles".
+* @param int default_num The count to use if there's no argument.
+* @param int min_num The lowest allowed count.
+* @param int max_num The highest allowed count.
+* @param int *num Will be set to the count.
+* @return bool TRUE if *num was set, FALSE if the player was sent an error.
+*/
+static bool get_bench_count(char_data *ch, char *argument, const char *usage, const char *what, int default_num, int min_num, int max_num, int *num) {
+	if (*argument && !isdigit(*argument)) {
+		msg_to_char(ch, "Usage: %s\r\n", usage);
+		return FALSE;
+	}
+	
+	*num = *argument ? atoi(argument) : default_num;
+	if (*num < min_num || *num > max_num) {
+		msg_to_char(ch, "%s must be %d-%d.\r\n", what, min_num, max_num);
+		return FALSE;
+	}
+	
+	return TRUE;
+}
+
+
+/**
+* Times one BENCH_STEP of a *bench util, running it 'num' times.
+*
+* @param int (*step)(void *data, int iter) The BENCH_STEP to run.
+* @param void *data Whatever that step needs.
+* @param int num How many times to run it, with iter 0 to num-1.
+* @param unsigned long long *time The run time, in microseconds, is added to this.
+* @return int The total of what the step returned (e.g. how many it found).
+*/
+static int time_bench_step(int (*step)(void *data, int iter), void *data, int num, unsigned long long *time) {
+	unsigned long long start = microtime();
+	int iter, total = 0;
+	
+	for (iter = 0; iter < num; ++iter) {
+		total += step(data, iter);
+	}
+	
+	*time += microtime() - start;
+	return total;
+}
+
+
 // secret implementor-only util for quick changes -- util tool
 ADMIN_UTIL(util_tool) {
 	// msg_to_char(ch, "Ok.\r\n");
@@ -436,6 +511,125 @@ ADMIN_UTIL(util_clear_roles) {
 }
 
 
+// checks the command/social tries against the old linear scans, for every prefix of every command and social
+ADMIN_UTIL(util_cmdtrie) {
+	extern bool check_social_trie(char_data *ch, char *name, bool exact);
+	extern const struct command_info cmd_info[];
+	const int max_shown = 10;
+	
+	unsigned long long start, trie_time = 0, linear_time = 0;
+	int cmd, len, pos, trie_cmd, linear_cmd, checked = 0, errors = 0;
+	char prefix[MAX_INPUT_LENGTH];
+	const char *name;
+	social_data *soc;
+	char_data *vict;
+	
+	one_argument(argument, arg);
+	if (!*arg) {
+		vict = ch;
+	}
+	else if (!(vict = get_char_vis(ch, arg, FIND_CHAR_WORLD))) {
+		msg_to_char(ch, "Usage: cmdtrie [character to check as]\r\n");
+		return;
+	}
+	
+	// every command name, then every social name
+	cmd = 0;
+	soc = sorted_socials;
+	for (;;) {
+		if (*cmd_info[cmd].command != '\n') {
+			name = cmd_info[cmd++].command;
+		}
+		else if (soc) {
+			name = SOC_COMMAND(soc);
+			soc = soc->sorted_hh.next;
+		}
+		else {
+			break;
+		}
+		
+		for (len = 1; len <= strlen(name) && len < sizeof(prefix); ++len) {
+			// lowercase, as command_interpreter() does
+			for (pos = 0; pos < len; ++pos) {
+				prefix[pos] = LOWER(name[pos]);
+			}
+			prefix[len] = '\0';
+			++checked;
+			
+			start = microtime();
+			trie_cmd = find_command_for_char(vict, prefix);
+			trie_time += microtime() - start;
+			
+			start = microtime();
+			linear_cmd = find_command_for_char_linear(vict, prefix);
+			linear_time += microtime() - start;
+			
+			if (trie_cmd != linear_cmd) {
+				if (++errors <= max_shown) {
+					msg_to_char(ch, "Mismatch: '%s' found command '%s' but should be '%s'\r\n", prefix, cmd_info[trie_cmd].command, cmd_info[linear_cmd].command);
+				}
+			}
+			if (!check_social_trie(vict, prefix, FALSE) || !check_social_trie(vict, prefix, TRUE)) {
+				if (++errors <= max_shown) {
+					msg_to_char(ch, "Mismatch: '%s' found different socials\r\n", prefix);
+				}
+			}
+		}
+	}
+	
+	msg_to_char(ch, "Checked %d prefixes as %s: %d mismatch%s.\r\n", checked, PERS(vict, ch, TRUE), errors, (errors != 1 ? "es" : ""));
+	msg_to_char(ch, "Command lookups: trie %.2f ms, linear scan %.2f ms (%.1fx faster)\r\n", trie_time / 1000.0, linear_time / 1000.0, trie_time > 0 ? ((double) linear_time / trie_time) : 0.0);
+}
+
+
+// recounts command-trigger holders everywhere and repairs any bad counts
+ADMIN_UTIL(util_cmdtrigs) {
+	room_data *room, *next_room;
+	int count, pos, errors = 0;
+	char_data *vict;
+	obj_data *obj;
+	
+	HASH_ITER(hh, world_table, room, next_room) {
+		count = 0;
+		LL_FOREACH2(ROOM_CONTENTS(room), obj, next_content) {
+			count += SCRIPT_CHECK(obj, OTRIG_COMMAND) ? 1 : 0;
+		}
+		if (count != ROOM_COMMAND_TRIG_OBJS(room)) {
+			msg_to_char(ch, "Room %d: %d item%s with command triggers, counted %d\r\n", GET_ROOM_VNUM(room), count, PLURAL(count), ROOM_COMMAND_TRIG_OBJS(room));
+			ROOM_COMMAND_TRIG_OBJS(room) = count;
+			++errors;
+		}
+		
+		count = 0;
+		LL_FOREACH2(ROOM_PEOPLE(room), vict, next_in_room) {
+			count += SCRIPT_CHECK(vict, MTRIG_COMMAND) ? 1 : 0;
+		}
+		if (count != ROOM_COMMAND_TRIG_MOBS(room)) {
+			msg_to_char(ch, "Room %d: %d %s with command triggers, counted %d\r\n", GET_ROOM_VNUM(room), count, (count != 1 ? "people" : "person"), ROOM_COMMAND_TRIG_MOBS(room));
+			ROOM_COMMAND_TRIG_MOBS(room) = count;
+			++errors;
+		}
+	}
+	
+	for (vict = character_list; vict; vict = vict->next) {
+		count = 0;
+		for (pos = 0; pos < NUM_WEARS; ++pos) {
+			count += (GET_EQ(vict, pos) && SCRIPT_CHECK(GET_EQ(vict, pos), OTRIG_COMMAND)) ? 1 : 0;
+		}
+		LL_FOREACH2(vict->carrying, obj, next_content) {
+			count += SCRIPT_CHECK(obj, OTRIG_COMMAND) ? 1 : 0;
+		}
+		if (count != GET_COMMAND_TRIG_OBJS(vict)) {
+			msg_to_char(ch, "%s: %d item%s with command triggers, counted %d\r\n", GET_NAME(vict), count, PLURAL(count), GET_COMMAND_TRIG_OBJS(vict));
+			GET_COMMAND_TRIG_OBJS(vict) = count;
+			++errors;
+		}
+	}
+	
+	msg_to_char(ch, "Checked %d rooms and all characters: %d bad count%s repaired.\r\n", HASH_COUNT(world_table), errors, PLURAL(errors));
+}
+
+
 ADMIN_UTIL(util_diminish) {
 	double number, scale, result;
 	
@@ -470,6 +664,158 @@ int sort_isf_list(struct isf_type *a, struct isf_type *b) {
 	return a->island - b->island;
 }
 
+// private event queue and events for eventbench
+struct eventbench_data {
+	struct queue *q;
+	struct q_element **elements;
+	long *delays;
+};
+
+// schedules one event for eventbench
+BENCH_STEP(eventbench_schedule) {
+	extern unsigned long pulse;
+	struct eventbench_data *bench = data;
+	
+	bench->elements[iter] = queue_enq(bench->q, NULL, pulse + bench->delays[iter]);
+	return 0;
+}
+
+// cancels one event for eventbench
+BENCH_STEP(eventbench_cancel) {
+	struct eventbench_data *bench = data;
+	
+	queue_deq(bench->q, bench->elements[iter]);
+	return 0;
+}
+
+// times scheduling and canceling a batch of events on a private event queue
+ADMIN_UTIL(util_eventbench) {
+	extern struct queue *event_q;
+	
+	unsigned long long scheduled = 0, canceled = 0;
+	struct eventbench_data bench;
+	int iter, num;
+	
+	if (!get_bench_count(ch, argument, "eventbench [number of events]", "Number of events", 1000000, 1, 10000000, &num)) {
+		return;
+	}
+	
+	CREATE(bench.elements, struct q_element*, num);
+	CREATE(bench.delays, long, num);
+	
+	// spread them across an hour of pulses, like script waits and cooldowns
+	for (iter = 0; iter < num; ++iter) {
+		bench.delays[iter] = number(1, SECS_PER_REAL_HOUR RL_SEC);
+	}
+	
+	bench.q = queue_init();
+	time_bench_step(eventbench_schedule, &bench, num, &scheduled);
+	time_bench_step(eventbench_cancel, &bench, num, &canceled);
+	
+	msg_to_char(ch, "Scheduled %d events in %.2f ms (%.1f ns each).\r\n", num, scheduled / 1000.0, scheduled * 1000.0 / num);
+	msg_to_char(ch, "Canceled %d events in %.2f ms (%.1f ns each).\r\n", num, canceled / 1000.0, canceled * 1000.0 / num);
+	msg_to_char(ch, "Live event queue: %d pending.\r\n", queue_count(event_q));
+	
+	queue_free(bench.q);
+	free(bench.elements);
+	free(bench.delays);
+}
+
+
+// one evaluation pass for evobench
+struct evobench_data {
+	struct map_evolution_data *list;
+	int count;
+	unsigned long seed;
+	bool threads;
+};
+
+// evaluates every tile in the evobench list once
+BENCH_STEP(evobench_evaluate) {
+	struct evobench_data *bench = data;
+	
+	evaluate_map_evolutions(bench->list, bench->count, bench->seed, bench->threads);
+	return 0;
+}
+
+// times the evaluation phase of a map evolution pass, on one thread and split across threads
+ADMIN_UTIL(util_evobench) {
+	struct map_evolution_data *serial, *threaded;
+	unsigned long long serial_time = 0, threaded_time = 0;
+	struct evobench_data serial_bench, threaded_bench;
+	struct sector_index_type *idx, *next_idx;
+	int iter, num, found, changes, mismatches;
+	sector_data *sect;
+	unsigned long seed;
+	
+	if (!get_bench_count(ch, argument, "evobench [number of tiles]", "Number of tiles", 100000, 1, 1000000, &num)) {
+		return;
+	}
+	
+	CREATE(serial, struct map_evolution_data, num);
+	CREATE(threaded, struct map_evolution_data, num);
+	
+	// take tiles from every sector that evolves, repeating them if there aren't enough
+	found = 0;
+	while (found < num) {
+		int last_found = found;
+		
+		HASH_ITER(hh, sector_index, idx, next_idx) {
+			if (idx->vnum == BASIC_OCEAN || !(sect = sector_proto(idx->vnum)) || !GET_SECT_EVOS(sect)) {
+				continue;
+			}
+			for (iter = 0; iter < idx->num_sect_rooms && found < num; ++iter) {
+				serial[found++].tile = idx->sect_rooms[iter];
+			}
+		}
+		
+		if (found == last_found) {
+			break;	// nothing evolves
+		}
+	}
+	
+	if (found == 0) {
+		msg_to_char(ch, "There are no map tiles that can evolve.\r\n");
+		free(serial);
+		free(threaded);
+		return;
+	}
+	
+	for (iter = 0; iter < found; ++iter) {
+		threaded[iter].tile = serial[iter].tile;
+	}
+	seed = number(1, INT_MAX - 1);
+	
+	serial_bench.list = serial;
+	serial_bench.count = found;
+	serial_bench.seed = seed;
+	serial_bench.threads = FALSE;
+	threaded_bench = serial_bench;
+	threaded_bench.list = threaded;
+	threaded_bench.threads = TRUE;
+	
+	time_bench_step(evobench_evaluate, &serial_bench, 1, &serial_time);
+	time_bench_step(evobench_evaluate, &threaded_bench, 1, &threaded_time);
+	
+	changes = mismatches = 0;
+	for (iter = 0; iter < found; ++iter) {
+		if (serial[iter].becomes != NOTHING) {
+			++changes;
+		}
+		if (serial[iter].becomes != threaded[iter].becomes || serial[iter].original != threaded[iter].original) {
+			++mismatches;
+		}
+	}
+	
+	msg_to_char(ch, "Evaluated %d tiles on one thread in %.2f ms (%.1f ns each).\r\n", found, serial_time / 1000.0, serial_time * 1000.0 / found);
+	msg_to_char(ch, "Evaluated %d tiles with threads in %.2f ms (%.1f ns each).\r\n", found, threaded_time / 1000.0, threaded_time * 1000.0 / found);
+	msg_to_char(ch, "Proposed changes: %d, mismatches between the two: %d.\r\n", changes, mismatches);
+	
+	free(serial);
+	free(threaded);
+}
+
+
 ADMIN_UTIL(util_islandsize) {
 	struct isf_type *isf, *next_isf, *list = NULL;
 	char buf[MAX_STRING_LENGTH];
@@ -511,6 +857,287 @@ ADMIN_UTIL(util_islandsize) {
 }
 
 
+// draws the map view for lookbench (data is the character)
+BENCH_STEP(lookbench_draw) {
+	extern int draw_map_view_for_benchmark(char_data *ch);
+	
+	return draw_map_view_for_benchmark((char_data*) data);
+}
+
+// times drawing your map view with and without the map icon cache
+ADMIN_UTIL(util_lookbench) {
+	extern int draw_map_view_for_benchmark(char_data *ch);
+	extern int get_map_radius(char_data *ch);
+	extern bool map_icon_cache_enabled;
+	
+	unsigned long long uncached = 0, cached = 0;
+	int num, tiles;
+	
+	if (!get_bench_count(ch, argument, "lookbench [number of looks]", "Number of looks", 100, 1, 10000, &num)) {
+		return;
+	}
+	if (!draw_map_view_for_benchmark(ch)) {
+		msg_to_char(ch, "You need to be somewhere with a map view.\r\n");
+		return;
+	}
+	
+	map_icon_cache_enabled = FALSE;
+	tiles = time_bench_step(lookbench_draw, ch, num, &uncached);
+	
+	// the first pass fills the cache for this view, as a real first look would
+	map_icon_cache_enabled = TRUE;
+	draw_map_view_for_benchmark(ch);
+	time_bench_step(lookbench_draw, ch, num, &cached);
+	
+	msg_to_char(ch, "Drew %d map views of %d tiles each (radius %d).\r\n", num, tiles / num, get_map_radius(ch));
+	msg_to_char(ch, "Without icon cache: %.2f ms (%.1f us per view)\r\n", uncached / 1000.0, (double) uncached / num);
+	msg_to_char(ch, "With icon cache: %.2f ms (%.1f us per view, %.1fx faster)\r\n", cached / 1000.0, (double) cached / num, cached > 0 ? ((double) uncached / cached) : 0.0);
+}
+
+
+// the world_map layout prior to the packed arrays, for mapbench to compare against
+struct legacy_map_data {
+	room_vnum vnum;
+	int island;
+	sector_data *sector_type, *base_sector, *natural_sector;
+	crop_data *crop_type;
+	struct legacy_map_data *next_in_sect, *next_in_base_sect, *next;
+};
+#define LEGACY_POS(x, y)  ((x) * MAP_HEIGHT + (y))	// was world_map[x][y]
+
+// the old map copy and the search to run on both, for mapbench
+struct mapbench_data {
+	struct legacy_map_data *legacy;
+	int *centers;	// random tiles to scan around
+	int dist;	// radius to scan
+	sector_data *find;	// sector to scan for
+};
+
+// counts tiles that can't be part of an island, like island numbering does (packed map)
+BENCH_STEP(mapbench_scan_packed) {
+	room_vnum tile;
+	int count = 0;
+	
+	for (tile = 0; tile < MAP_SIZE; ++tile) {
+		if (SECT_FLAGGED(MAP_SECT(tile), SECTF_NON_ISLAND) && MAP_ISLAND(tile) == NO_ISLAND) {
+			++count;
+		}
+	}
+	return count;
+}
+
+// counts tiles that can't be part of an island, like island numbering does (old layout)
+BENCH_STEP(mapbench_scan_legacy) {
+	struct mapbench_data *bench = data;
+	int x, y, count = 0;
+	
+	for (x = 0; x < MAP_WIDTH; ++x) {
+		for (y = 0; y < MAP_HEIGHT; ++y) {
+			if (SECT_FLAGGED(bench->legacy[LEGACY_POS(x, y)].sector_type, SECTF_NON_ISLAND) && bench->legacy[LEGACY_POS(x, y)].island == NO_ISLAND) {
+				++count;
+			}
+		}
+	}
+	return count;
+}
+
+// radius scan like find_sect_within_distance_from_room() around one center (packed map)
+BENCH_STEP(mapbench_radius_packed) {
+	struct mapbench_data *bench = data;
+	int dx, dy, count = 0;
+	int cx = MAP_X_COORD(bench->centers[iter]), cy = MAP_Y_COORD(bench->centers[iter]);
+	
+	for (dx = -bench->dist; dx <= bench->dist; ++dx) {
+		for (dy = -bench->dist; dy <= bench->dist; ++dy) {
+			if (MAP_SECT(MAP_TILE(WRAP_X_COORD(cx + dx), WRAP_Y_COORD(cy + dy))) == bench->find) {
+				++count;
+			}
+		}
+	}
+	return count;
+}
+
+// radius scan like find_sect_within_distance_from_room() around one center (old layout)
+BENCH_STEP(mapbench_radius_legacy) {
+	struct mapbench_data *bench = data;
+	int dx, dy, count = 0;
+	int cx = MAP_X_COORD(bench->centers[iter]), cy = MAP_Y_COORD(bench->centers[iter]);
+	
+	for (dx = -bench->dist; dx <= bench->dist; ++dx) {
+		for (dy = -bench->dist; dy <= bench->dist; ++dy) {
+			if (bench->legacy[LEGACY_POS(WRAP_X_COORD(cx + dx), WRAP_Y_COORD(cy + dy))].sector_type == bench->find) {
+				++count;
+			}
+		}
+	}
+	return count;
+}
+
+// near-sector evolution check for one center, using the distance field
+BENCH_STEP(mapbench_near_field) {
+	struct mapbench_data *bench = data;
+	
+	return map_tile_near_sector(bench->centers[iter], GET_SECT_VNUM(bench->find)) ? 1 : 0;
+}
+
+// near-sector evolution check for one center, using a radius scan
+BENCH_STEP(mapbench_near_scan) {
+	struct mapbench_data *bench = data;
+	
+	return find_sect_within_distance_from_tile(bench->centers[iter], GET_SECT_VNUM(bench->find), bench->dist) ? 1 : 0;
+}
+
+// compares the packed world_map against the old array-of-structs layout
+ADMIN_UTIL(util_mapbench) {
+	extern int map_sect_table_size, map_crop_table_size;
+	
+	unsigned long long packed_scan = 0, legacy_scan = 0, packed_radius = 0, legacy_radius = 0, field_build = 0, field_time = 0, scan_time = 0;
+	int iter, num, x, y, packed_count, legacy_count;
+	struct sector_index_type *idx, *next_idx;
+	struct mapbench_data bench;
+	size_t packed_size, index_size;
+	room_vnum tile;
+	
+	if (!get_bench_count(ch, argument, "mapbench [number of radius scans]", "Number of radius scans", 10000, 1, 1000000, &num)) {
+		return;
+	}
+	
+	// build a copy of the map in the old layout (this is big, so don't abort on failure)
+	if (!(bench.legacy = calloc(MAP_SIZE, sizeof(struct legacy_map_data)))) {
+		msg_to_char(ch, "Unable to allocate %.1f MB for the old layout.\r\n", MAP_SIZE * sizeof(struct legacy_map_data) / (1024.0 * 1024.0));
+		return;
+	}
+	for (x = 0; x < MAP_WIDTH; ++x) {
+		for (y = 0; y < MAP_HEIGHT; ++y) {
+			tile = MAP_TILE(x, y);
+			bench.legacy[LEGACY_POS(x, y)].vnum = tile;
+			bench.legacy[LEGACY_POS(x, y)].island = MAP_ISLAND(tile);
+			bench.legacy[LEGACY_POS(x, y)].sector_type = MAP_SECT(tile);
+			bench.legacy[LEGACY_POS(x, y)].base_sector = MAP_BASE_SECT(tile);
+			bench.legacy[LEGACY_POS(x, y)].natural_sector = MAP_NATURAL_SECT(tile);
+			bench.legacy[LEGACY_POS(x, y)].crop_type = MAP_CROP(tile);
+		}
+	}
+	
+	// memory
+	packed_size = sizeof(world_map) + map_sect_table_size * sizeof(sector_data*) + map_crop_table_size * sizeof(crop_data*);
+	index_size = 0;
+	HASH_ITER(hh, sector_index, idx, next_idx) {
+		index_size += idx->max_sect_rooms * sizeof(room_vnum);
+	}
+	
+	// full scans
+	packed_count = time_bench_step(mapbench_scan_packed, &bench, 1, &packed_scan);
+	legacy_count = time_bench_step(mapbench_scan_legacy, &bench, 1, &legacy_scan);
+	
+	msg_to_char(ch, "Old layout: %.1f MB (%d bytes/tile)\r\n", MAP_SIZE * sizeof(struct legacy_map_data) / (1024.0 * 1024.0), (int) sizeof(struct legacy_map_data));
+	msg_to_char(ch, "Packed layout: %.1f MB (%.1f bytes/tile) + %.1f MB of sector lists\r\n", packed_size / (1024.0 * 1024.0), (double) packed_size / MAP_SIZE, index_size / (1024.0 * 1024.0));
+	msg_to_char(ch, "Full-map scan: packed %.2f ms, old %.2f ms (%d/%d non-island tiles)\r\n", packed_scan / 1000.0, legacy_scan / 1000.0, packed_count, legacy_count);
+	
+	// radius scans around random centers
+	bench.dist = config_get_int("nearby_sector_distance");
+	bench.find = MAP_SECT(land_map != NOWHERE ? land_map : 0);
+	CREATE(bench.centers, int, num);
+	for (iter = 0; iter < num; ++iter) {
+		bench.centers[iter] = number(0, MAP_SIZE - 1);
+	}
+	
+	packed_count = time_bench_step(mapbench_radius_packed, &bench, num, &packed_radius);
+	legacy_count = time_bench_step(mapbench_radius_legacy, &bench, num, &legacy_radius);
+	
+	msg_to_char(ch, "%d radius-%d scans: packed %.2f ms, old %.2f ms (%d/%d matches)\r\n", num, bench.dist, packed_radius / 1000.0, legacy_radius / 1000.0, packed_count, legacy_count);
+	
+	// near-sector evolution checks: distance field vs. radius scan (the first call builds the field)
+	time_bench_step(mapbench_near_field, &bench, 1, &field_build);
+	packed_count = time_bench_step(mapbench_near_field, &bench, num, &field_time);
+	legacy_count = time_bench_step(mapbench_near_scan, &bench, num, &scan_time);
+	
+	msg_to_char(ch, "%d near-sector checks: field %.2f ms (built in %.2f ms), scan %.2f ms (%d/%d near)\r\n", num, field_time / 1000.0, field_build / 1000.0, scan_time / 1000.0, packed_count, legacy_count);
+	
+	free(bench.centers);
+	free(bench.legacy);
+}
+#undef LEGACY_POS
+
+
+// one "who's near here" search for nearbench
+struct nearbench_data {
+	char_data *center;
+	int dist;
+};
+
+// counts characters near the nearbench center by scanning the whole character list
+BENCH_STEP(nearbench_scan) {
+	struct nearbench_data *bench = data;
+	char_data *vict;
+	int count = 0;
+	
+	for (vict = character_list; vict; vict = vict->next) {
+		if (IN_ROOM(vict) && compute_distance(IN_ROOM(bench->center), IN_ROOM(vict)) <= bench->dist) {
+			++count;
+		}
+	}
+	return count;
+}
+
+// counts characters near the nearbench center using the location grid
+BENCH_STEP(nearbench_grid) {
+	struct nearbench_data *bench = data;
+	struct near_char_iterator near;
+	char_data *vict;
+	int count = 0;
+	
+	for (vict = first_char_near(&near, IN_ROOM(bench->center), bench->dist, FALSE); vict; vict = next_char_near(&near)) {
+		if (compute_distance(IN_ROOM(bench->center), IN_ROOM(vict)) <= bench->dist) {
+			++count;
+		}
+	}
+	return count;
+}
+
+// times "who's near here" searches using the character location grid vs. a full character list scan, and checks they agree
+ADMIN_UTIL(util_nearbench) {
+	const int max_centers = 2000;
+	
+	unsigned long long scan_time = 0, grid_time = 0;
+	int centers = 0, scan_found = 0, grid_found = 0, mismatches = 0, scan_count, grid_count;
+	struct nearbench_data bench;
+	char_data *center;
+	
+	if (!get_bench_count(ch, argument, "nearbench [distance]", "Distance", 25, 0, MAP_WIDTH, &bench.dist)) {
+		return;
+	}
+	
+	// search around each character (up to max_centers of them)
+	for (center = character_list; center && centers < max_centers; center = center->next) {
+		if (!IN_ROOM(center)) {
+			continue;
+		}
+		++centers;
+		
+		bench.center = center;
+		scan_count = time_bench_step(nearbench_scan, &bench, 1, &scan_time);
+		grid_count = time_bench_step(nearbench_grid, &bench, 1, &grid_time);
+		
+		scan_found += scan_count;
+		grid_found += grid_count;
+		if (scan_count != grid_count) {
+			++mismatches;
+		}
+	}
+	
+	if (centers == 0) {
+		msg_to_char(ch, "There are no characters to search around.\r\n");
+		return;
+	}
+	
+	msg_to_char(ch, "Searched within %d tiles of %d characters.\r\n", bench.dist, centers);
+	msg_to_char(ch, "Full list scans: %.2f ms (%.1f us each), %d found.\r\n", scan_time / 1000.0, (double) scan_time / centers, scan_found);
+	msg_to_char(ch, "Location grid: %.2f ms (%.1f us each), %d found.\r\n", grid_time / 1000.0, (double) grid_time / centers, grid_found);
+	msg_to_char(ch, "Searches that disagreed: %d.\r\n", mismatches);
+}
+
+
 ADMIN_UTIL(util_playerdump) {
 	player_index_data *index, *next_index;
 	char_data *plr;
@@ -696,6 +1323,62 @@ ADMIN_UTIL(util_resetbuildingtriggers) {
 }
 
 
+// runs the control flow of every trigger once, for scriptbench (data is a bool: compiled or not)
+BENCH_STEP(scriptbench_pass) {
+	extern unsigned int run_script_control_flow(trig_data *trig, bool compiled);
+	bool compiled = *(bool*) data;
+	trig_data *trig, *next_trig;
+	
+	HASH_ITER(hh, trigger_table, trig, next_trig) {
+		run_script_control_flow(trig, compiled);
+	}
+	return 0;
+}
+
+// times the text vs compiled script engine over every trigger in the game, without running commands
+ADMIN_UTIL(util_scriptbench) {
+	extern unsigned int run_script_control_flow(trig_data *trig, bool compiled);
+	extern bool script_dry_run;
+	
+	unsigned long long text_time = 0, compiled_time = 0;
+	int iter, num, triggers = 0, lines = 0, errors = 0;
+	struct cmdlist_element *cl;
+	trig_data *trig, *next_trig;
+	bool compiled;
+	
+	if (!get_bench_count(ch, argument, "scriptbench [number of passes]", "Number of passes", 100, 1, 10000, &num)) {
+		return;
+	}
+	
+	// no variables are looked up, so conditions see their raw text
+	script_dry_run = TRUE;
+	
+	// both engines must agree on every trigger
+	HASH_ITER(hh, trigger_table, trig, next_trig) {
+		++triggers;
+		LL_COUNT(trig->cmdlist, cl, iter);
+		lines += iter;
+		
+		if (run_script_control_flow(trig, FALSE) != run_script_control_flow(trig, TRUE)) {
+			if (++errors <= 10) {
+				msg_to_char(ch, "Mismatch: [%d] %s\r\n", GET_TRIG_VNUM(trig), GET_TRIG_NAME(trig));
+			}
+		}
+	}
+	
+	compiled = FALSE;
+	time_bench_step(scriptbench_pass, &compiled, num, &text_time);
+	compiled = TRUE;
+	time_bench_step(scriptbench_pass, &compiled, num, &compiled_time);
+	
+	script_dry_run = FALSE;
+	
+	msg_to_char(ch, "Ran the control flow of %d triggers (%d lines) %d time%s: %d mismatch%s.\r\n", triggers, lines, num, PLURAL(num), errors, (errors != 1 ? "es" : ""));
+	msg_to_char(ch, "Text scripts: %.2f ms (%.1f us per pass)\r\n", text_time / 1000.0, (double) text_time / num);
+	msg_to_char(ch, "Compiled scripts: %.2f ms (%.1f us per pass, %.1fx faster)\r\n", compiled_time / 1000.0, (double) compiled_time / num, compiled_time > 0 ? ((double) text_time / compiled_time) : 0.0);
+}
+
+
 ADMIN_UTIL(util_strlen) {
 	msg_to_char(ch, "String: %s\r\n", argument);
 	msg_to_char(ch, "Raw: %s\r\n", show_color_codes(argument));
@@ -705,6 +1388,109 @@ ADMIN_UTIL(util_strlen) {
 }
 
 
+// one territory entry for territorybench, and what the list scans found for it
+struct territorybench_data {
+	empire_data *emp;
+	struct empire_territory_data *ter;
+	struct empire_territory_data *found;	// territory lookup
+	struct empire_city_data *city;	// nearest city in range
+	bool in_city;	// is_in_city_for_empire()
+	int count;	// completed buildings of the same type
+};
+
+// looks up the territorybench entry the old way, with list scans
+BENCH_STEP(territorybench_scan) {
+	extern struct city_metadata_type city_type[];
+	struct territorybench_data *bench = data;
+	room_data *room = bench->ter->room;
+	struct empire_territory_data *ter;
+	struct empire_city_data *city;
+	int dist, min = -1;
+	
+	LL_FOREACH(EMPIRE_TERRITORY_LIST(bench->emp), ter) {
+		if (ter->room == room) {
+			break;
+		}
+	}
+	bench->found = ter;
+	
+	bench->city = NULL;
+	bench->in_city = ROOM_BLD_FLAGGED(room, BLD_SECONDARY_TERRITORY);
+	LL_FOREACH(EMPIRE_CITY_LIST(bench->emp), city) {
+		dist = compute_distance(room, city->location);
+		if (dist <= city_type[city->type].radius && (min == -1 || dist < min)) {
+			bench->city = city;
+			min = dist;
+		}
+		if (dist <= city_type[city->type].radius || (LARGE_CITY_RADIUS(room) && dist <= (3 * city_type[city->type].radius))) {
+			bench->in_city = TRUE;
+		}
+	}
+	
+	bench->count = 0;
+	if (GET_BUILDING(room)) {
+		LL_FOREACH(EMPIRE_TERRITORY_LIST(bench->emp), ter) {
+			if (IS_COMPLETE(ter->room) && GET_BUILDING(ter->room) && GET_BLD_VNUM(GET_BUILDING(ter->room)) == GET_BLD_VNUM(GET_BUILDING(room))) {
+				++bench->count;
+			}
+		}
+	}
+	return 0;
+}
+
+// looks up the territorybench entry with the indexes; returns how many lookups disagree with the scans
+BENCH_STEP(territorybench_index) {
+	extern int count_owned_buildings(empire_data *emp, bld_vnum vnum);
+	struct territorybench_data *bench = data;
+	room_data *room = bench->ter->room;
+	int mismatches = 0;
+	bool junk;
+	
+	if (find_territory_entry(bench->emp, room) != bench->found) {
+		++mismatches;
+	}
+	if (find_city(bench->emp, room) != bench->city) {
+		++mismatches;
+	}
+	if (is_in_city_for_empire(room, bench->emp, FALSE, &junk) != bench->in_city) {
+		++mismatches;
+	}
+	if (GET_BUILDING(room) && count_owned_buildings(bench->emp, GET_BLD_VNUM(GET_BUILDING(room))) != bench->count) {
+		++mismatches;
+	}
+	return mismatches;
+}
+
+// compares the empire territory/city indexes with plain list scans
+ADMIN_UTIL(util_territorybench) {
+	unsigned long long scan_time = 0, index_time = 0;
+	struct territorybench_data bench;
+	struct empire_territory_data *ter;
+	int checks = 0, mismatches = 0;
+	empire_data *emp, *next_emp;
+	
+	HASH_ITER(hh, empire_table, emp, next_emp) {
+		LL_FOREACH(EMPIRE_TERRITORY_LIST(emp), ter) {
+			++checks;
+			bench.emp = emp;
+			bench.ter = ter;
+			time_bench_step(territorybench_scan, &bench, 1, &scan_time);
+			mismatches += time_bench_step(territorybench_index, &bench, 1, &index_time);
+		}
+	}
+	
+	if (checks == 0) {
+		msg_to_char(ch, "No empires have any territory to check.\r\n");
+		return;
+	}
+	
+	msg_to_char(ch, "Checked %d territory entries.\r\n", checks);
+	msg_to_char(ch, "List scans: %.2f ms (%.1f us each).\r\n", scan_time / 1000.0, (double) scan_time / checks);
+	msg_to_char(ch, "Indexes: %.2f ms (%.1f us each).\r\n", index_time / 1000.0, (double) index_time / checks);
+	msg_to_char(ch, "Lookups that disagreed: %d.\r\n", mismatches);
+}
+
+
 ADMIN_UTIL(util_yearly) {
 	void annual_world_update();
 	
@@ -1784,6 +2570,7 @@ int perform_set(char_data *ch, char_data *vict, int mode, char *val_arg) {
 		}
 		
 		// rename the save file
+		flush_player_file_writes();
 		get_filename(oldname, buf1, PLR_FILE);
 		get_filename(GET_NAME(vict), buf2, PLR_FILE);
 		rename(buf1, buf2);
@@ -1974,6 +2761,49 @@ SHOW(show_factions) {
 }
 
 
+SHOW(show_heartbeat) {
+	extern unsigned long long heartbeat_timing_p99(struct heartbeat_timing_data *timing);
+	extern struct heartbeat_job_data *heartbeat_jobs;
+	extern int num_heartbeat_jobs;
+	extern struct budget_job_data point_update_budget, chore_update_budget, save_world_budget;
+	
+	struct budget_job_data *budget_list[] = { &point_update_budget, &chore_update_budget, &save_world_budget, NULL };
+	char buf[MAX_STRING_LENGTH * 2], line[256];
+	struct heartbeat_timing_data *timing;
+	struct budget_job_data *job;
+	size_t size;
+	int iter;
+	
+	size = snprintf(buf, sizeof(buf), "Heartbeat jobs since startup (times in usec; overrun = %d+ usec):\r\n", OPT_USEC);
+	size += snprintf(buf + size, sizeof(buf) - size, "%-28s %9s %8s %9s %9s %7s %12s\r\n", "Job", "Calls", "Avg", "Max", "p99", "Overrun", "Total");
+	
+	for (iter = 0; iter < num_heartbeat_jobs; ++iter) {
+		timing = &heartbeat_jobs[iter].since_boot;
+		snprintf(line, sizeof(line), "%-28.28s %9lu %8llu %9llu %9llu %7lu %12llu\r\n", heartbeat_jobs[iter].name, timing->calls, timing->calls ? (timing->total_usec / timing->calls) : 0, timing->max_usec, heartbeat_timing_p99(timing), timing->overruns, timing->total_usec);
+		
+		if (size + strlen(line) < sizeof(buf)) {
+			strcat(buf, line);
+			size += strlen(line);
+		}
+		else {
+			break;
+		}
+	}
+	
+	if (num_heartbeat_jobs == 0) {
+		size += snprintf(buf + size, sizeof(buf) - size, " no jobs have run yet\r\n");
+	}
+	
+	size += snprintf(buf + size, sizeof(buf) - size, "Budgeted jobs:\r\n");
+	for (iter = 0; budget_list[iter]; ++iter) {
+		job = budget_list[iter];
+		size += snprintf(buf + size, sizeof(buf) - size, " %s: %lu run%s, last took %lu pulse%s (%llu usec)%s\r\n", job->name, job->runs, PLURAL(job->runs), job->last_pulses, PLURAL(job->last_pulses), job->last_usec, job->queued ? " - running now" : "");
+	}
+	
+	page_string(ch->desc, buf, TRUE);
+}
+
+
 // for show_islands	
 struct show_island_data {
 	int island;
@@ -2208,11 +3038,20 @@ SHOW(show_rent) {
 
 SHOW(show_stats) {
 	void update_account_stats();
-	extern int buf_switches, buf_largecount, buf_overflows;
+	extern int outbuf_chunks, outbuf_pool_size, buf_overflows;
 	extern int total_accounts, active_accounts, active_accounts_week;
+	extern int map_views_drawn, map_view_rooms_loaded;
+	extern int map_icon_cache_hits, map_icon_cache_misses;
+	extern int count_map_icon_cache(void);
+	extern int last_world_save_blocks;
+	extern unsigned long long last_world_save_usec;
+	extern int snapshot_saves_done, snapshot_saves_failed;
+	extern unsigned long long snapshot_fork_usec;
+	extern int player_writes_queued, player_writes_queued_max, player_writes_done, player_writes_failed;
+	extern unsigned long long player_write_usec_total, player_write_usec_max;
 	
 	int num_active_empires = 0, num_objs = 0, num_mobs = 0, num_vehs = 0, num_players = 0, num_descs = 0, menu_count = 0;
-	int num_trigs = 0;
+	int num_trigs = 0, uid_count, uid_size, uid_probe, iter, world_files = 0, world_dirty = 0;
 	empire_data *emp, *next_emp;
 	descriptor_data *desc;
 	vehicle_data *veh;
@@ -2252,6 +3091,16 @@ SHOW(show_stats) {
 		}
 	}
 	
+	// world block files
+	for (iter = 0; iter < num_world_blocks; ++iter) {
+		if (world_blocks[iter].rooms > 0) {
+			++world_files;
+			if (world_blocks[iter].dirty) {
+				++world_dirty;
+			}
+		}
+	}
+	
 	update_account_stats();
 
 	msg_to_char(ch, "Current stats:\r\n");
@@ -2273,8 +3122,28 @@ SHOW(show_stats) {
 	msg_to_char(ch, "  %6d abilities        %6d factions\r\n", HASH_COUNT(ability_table), HASH_COUNT(faction_table));
 	msg_to_char(ch, "  %6d globals          %6d morphs\r\n", HASH_COUNT(globals_table), HASH_COUNT(morph_table));
 	msg_to_char(ch, "  %6d socials\r\n", HASH_COUNT(social_table));
-	msg_to_char(ch, "  %6d large bufs       %6d buf switches\r\n", buf_largecount, buf_switches);
+	msg_to_char(ch, "  %6d output chunks    %6d in the pool (%d KB each)\r\n", outbuf_chunks, outbuf_pool_size, OUTBUF_CHUNK_SIZE / 1024);
 	msg_to_char(ch, "  %6d overflows\r\n", buf_overflows);
+	msg_to_char(ch, "  %6d map views        %6d map rooms loaded by them (%.2f per view)\r\n", map_views_drawn, map_view_rooms_loaded, map_views_drawn > 0 ? ((double) map_view_rooms_loaded / map_views_drawn) : 0.0);
+	msg_to_char(ch, "  %6d map rooms loaded in all\r\n", map_rooms_loaded);
+	msg_to_char(ch, "  %6d world files      %6d changed since saved\r\n", world_files, world_dirty);
+	msg_to_char(ch, "  %6d written by the last world save, in %.2f ms\r\n", last_world_save_blocks, last_world_save_usec / 1000.0);
+	msg_to_char(ch, "  %6d player files queued  %6d most queued (%d written, %d failed)\r\n", player_writes_queued, player_writes_queued_max, player_writes_done, player_writes_failed);
+	msg_to_char(ch, "  %6.2f ms to write them on average (longest %.2f ms)\r\n", player_writes_done > 0 ? (player_write_usec_total / 1000.0 / player_writes_done) : 0.0, player_write_usec_max / 1000.0);
+	msg_to_char(ch, "  %6d snapshot saves   %6d failed (last fork took %.2f ms)\r\n", snapshot_saves_done, snapshot_saves_failed, snapshot_fork_usec / 1000.0);
+	msg_to_char(ch, "  %6d map icons cached  %6d hits, %d misses\r\n", count_map_icon_cache(), map_icon_cache_hits, map_icon_cache_misses);
+	uid_count = get_lookup_table_stats(&uid_size, &uid_probe);
+	msg_to_char(ch, "  %6d script uids      %6d slots (%d%% load, longest probe %d)\r\n", uid_count, uid_size, uid_size > 0 ? (uid_count * 100 / uid_size) : 0, uid_probe);
+	
+	// output queue depth for each connection
+	msg_to_char(ch, "Output queues:\r\n");
+	for (desc = descriptor_list; desc; desc = desc->next) {
+		if (desc->character && !CAN_SEE(ch, desc->character)) {
+			continue;
+		}
+		
+		msg_to_char(ch, "  %-20.20s %6.1f KB queued, %.1f KB peak%s\r\n", desc->character ? GET_NAME(desc->character) : desc->host, desc->output_size / 1024.0, desc->output_peak / 1024.0, desc->output_overflow ? " (overflowed)" : "");
+	}
 }
 
 
@@ -4059,7 +4928,7 @@ void do_stat_room(char_data *ch) {
 	
 	// check for natural sect
 	if (GET_ROOM_VNUM(IN_ROOM(ch)) < MAP_SIZE) {
-		sprintf(buf3, "/&c%s&0", GET_SECT_NAME(world_map[X_COORD(IN_ROOM(ch))][Y_COORD(IN_ROOM(ch))].natural_sector));
+		sprintf(buf3, "/&c%s&0", GET_SECT_NAME(MAP_NATURAL_SECT(MAP_TILE(X_COORD(IN_ROOM(ch)), Y_COORD(IN_ROOM(ch))))));
 	}
 	else {
 		*buf3 = '\0';
@@ -5931,7 +6800,7 @@ ACMD(do_load) {
 
 
 ACMD(do_mapout) {
-	void output_map_to_file(void);
+	bool output_map_to_file(void);
 
 	msg_to_char(ch, "Writing map output file...\r\n");
 	output_map_to_file();
@@ -5942,7 +6811,7 @@ ACMD(do_mapout) {
 ACMD(do_moveeinv) {
 	char arg1[MAX_INPUT_LENGTH], arg2[MAX_INPUT_LENGTH], arg3[MAX_INPUT_LENGTH];
 	struct empire_unique_storage *unique;
-	struct empire_storage_data *store, *next_store, *temp;
+	struct empire_storage_data *store, *next_store;
 	int island_from, island_to, count;
 	empire_data *emp;
 	
@@ -5968,11 +6837,9 @@ ACMD(do_moveeinv) {
 			
 			if (store->island == island_from) {
 				add_to_empire_storage(emp, island_to, store->vnum, store->amount);
-				store->island = island_to;
 				count += store->amount;
 				
-				REMOVE_FROM_LIST(store, EMPIRE_STORAGE(emp), next);
-				free(store);
+				delete_storage_entry(emp, store);
 			}
 		}
 		for (unique = EMPIRE_UNIQUE_STORAGE(emp); unique; unique = unique->next) {
@@ -6781,6 +7648,7 @@ ACMD(do_show) {
 		{ "factions", LVL_START_IMM, show_factions },
 		{ "dailycycle", LVL_START_IMM, show_dailycycle },
 		{ "data", LVL_CIMPL, show_data },
+		{ "heartbeat", LVL_GOD, show_heartbeat },
 
 		// last
 		{ "\n", 0, NULL }
@@ -2075,24 +2075,28 @@ void deliver_shipment(empire_data *emp, struct shipping_data *shipd) {
 * @return room_data* The found docks room, or NULL for none.
 */
 room_data *find_docks(empire_data *emp, int island_id) {
-	struct empire_territory_data *ter;
+	struct empire_territory_ref *ref;
 	
 	if (!emp || island_id == NO_ISLAND) {
 		return NULL;
 	}
 	
-	for (ter = EMPIRE_TERRITORY_LIST(emp); ter; ter = ter->next) {
-		if (GET_ISLAND_ID(ter->room) != island_id) {
+	// only rooms on this island with functions are in the index
+	for (ref = get_territory_functions_on_island(emp, island_id); ref; ref = ref->next) {
+		if (!IS_SET(ref->functions, FNC_DOCKS)) {
 			continue;
 		}
-		if (!room_has_function_and_city_ok(ter->room, FNC_DOCKS)) {
+		if (GET_ISLAND_ID(ref->ter->room) != island_id) {
 			continue;
 		}
-		if (ROOM_AFF_FLAGGED(ter->room, ROOM_AFF_NO_WORK)) {
+		if (!room_has_function_and_city_ok(ref->ter->room, FNC_DOCKS)) {
+			continue;
+		}
+		if (ROOM_AFF_FLAGGED(ref->ter->room, ROOM_AFF_NO_WORK)) {
 			continue;
 		}
 				
-		return ter->room;
+		return ref->ter->room;
 	}
 	
 	return NULL;
@@ -5134,6 +5138,7 @@ ACMD(do_roadsign) {
 			old_sign = TRUE;
 		}
 		ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch)) = str_dup(argument);
+		request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 
 		act("You engrave your message and plant $p in the ground by the road.", FALSE, ch, sign, NULL, TO_CHAR);
 		act("$n engraves a message on $p and plants it in the ground by the road.", FALSE, ch, sign, NULL, TO_ROOM);
@@ -36,6 +36,11 @@ extern bool validate_social_requirements(char_data *ch, social_data *soc);
 social_data *find_social(char_data *ch, char *name, bool exact);
 void perform_social(char_data *ch, social_data *soc, char *argument);
 
+// prefix trie over sorted_socials, built on demand by find_social()
+static struct cmd_trie_node *social_trie = NULL;
+static social_data **social_trie_list = NULL;	// socials by trie id, in sorted_socials order
+static int social_trie_size = 0;
+
 
  //////////////////////////////////////////////////////////////////////////////
 //// SOCIAL CORE /////////////////////////////////////////////////////////////
@@ -71,32 +76,117 @@ bool check_social(char_data *ch, char *string, bool exact) {
 }
 
 
+/**
+* Frees the social lookup trie. Call this any time sorted_socials or a
+* social's command changes; find_social() rebuilds it when next needed.
+*/
+void clear_social_trie(void) {
+	free_cmd_trie(social_trie);
+	social_trie = NULL;
+	
+	if (social_trie_list) {
+		free(social_trie_list);
+		social_trie_list = NULL;
+	}
+	social_trie_size = 0;
+}
+
+
+/**
+* Builds the social lookup trie from sorted_socials. Names are added in
+* lowercase, and each node keeps sorted_socials order.
+*/
+static void build_social_trie(void) {
+	char lower[MAX_INPUT_LENGTH];
+	social_data *soc, *next_soc;
+	int iter;
+	
+	clear_social_trie();
+	
+	CREATE(social_trie_list, social_data*, MAX(1, HASH_CNT(sorted_hh, sorted_socials)));
+	CREATE(social_trie, struct cmd_trie_node, 1);	// never NULL once built
+	
+	HASH_ITER(sorted_hh, sorted_socials, soc, next_soc) {
+		if (!SOC_COMMAND(soc) || !*SOC_COMMAND(soc)) {
+			continue;	// can't be typed
+		}
+		
+		for (iter = 0; SOC_COMMAND(soc)[iter] && iter < sizeof(lower) - 1; ++iter) {
+			lower[iter] = LOWER(SOC_COMMAND(soc)[iter]);
+		}
+		lower[iter] = '\0';
+		
+		social_trie_list[social_trie_size] = soc;
+		add_to_cmd_trie(&social_trie, lower, social_trie_size++, TRUE);
+	}
+}
+
+
+/**
+* Finds the trie node for a typed-in social name, building the trie if
+* needed.
+*
+* @param char *name The typed-in social.
+* @return struct cmd_trie_node* The node, or NULL if no social can match.
+*/
+static struct cmd_trie_node *find_social_node(char *name) {
+	char lower[MAX_INPUT_LENGTH];
+	int iter;
+	
+	if (!*name || strlen(name) >= sizeof(lower)) {
+		return NULL;	// nothing can match
+	}
+	if (!social_trie) {
+		build_social_trie();
+	}
+	
+	for (iter = 0; name[iter]; ++iter) {
+		lower[iter] = LOWER(name[iter]);
+	}
+	lower[iter] = '\0';
+	
+	return find_in_cmd_trie(social_trie, lower);
+}
+
+
+/**
+* Checks everything about whether ch can use a social, except its name.
+*
+* @param char_data *ch The person trying the social.
+* @param social_data *soc The social.
+* @return bool TRUE if ch can use it.
+*/
+static bool can_use_social(char_data *ch, social_data *soc) {
+	if (SOCIAL_FLAGGED(soc, SOC_IN_DEVELOPMENT) && !IS_IMMORTAL(ch)) {
+		return FALSE;
+	}
+	if (!validate_social_requirements(ch, soc)) {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+
 /**
 * @param char *name The typed-in social?
 * @param bool exact Must be an exact match if TRUE; may be an abbrev if FALSE.
 * @return social_data* The social, or NULL if no match.
 */
 social_data *find_social(char_data *ch, char *name, bool exact) {
-	social_data *soc, *next_soc, *found = NULL;
-	int num_found = 0;
+	social_data *soc, *found = NULL;
+	struct cmd_trie_node *node;
+	int iter, num, *list, num_found = 0;
 	
-	HASH_ITER(sorted_hh, sorted_socials, soc, next_soc) {
-		if (LOWER(*SOC_COMMAND(soc)) < LOWER(*name)) {	// shortcut: check first letter
-			continue;
-		}
-		if (LOWER(*SOC_COMMAND(soc)) > LOWER(*name)) {	// short exit: past the right letter
-			break;
-		}
-		if (SOCIAL_FLAGGED(soc, SOC_IN_DEVELOPMENT) && !IS_IMMORTAL(ch)) {
-			continue;
-		}
-		if (exact && str_cmp(name, SOC_COMMAND(soc))) {
-			continue;
-		}
-		if (!exact && !is_abbrev(name, SOC_COMMAND(soc))) {
-			continue;
-		}
-		if (!validate_social_requirements(ch, soc)) {
+	if (!(node = find_social_node(name))) {
+		return NULL;
+	}
+	
+	list = exact ? node->exact : node->abbrev;
+	num = exact ? node->num_exact : node->num_abbrev;
+	
+	for (iter = 0; iter < num; ++iter) {
+		soc = social_trie_list[list[iter]];
+		if (!can_use_social(ch, soc)) {
 			continue;
 		}
 		
@@ -124,6 +214,59 @@ social_data *find_social(char_data *ch, char *name, bool exact) {
 }
 
 
+/**
+* Compares the socials find_social() would choose between against the
+* original scan of sorted_socials, for the "util cmdtrie" check.
+*
+* @param char_data *ch The person trying the social.
+* @param char *name The typed-in social.
+* @param bool exact Must be an exact match if TRUE; may be an abbrev if FALSE.
+* @return bool TRUE if both found the same socials in the same order.
+*/
+bool check_social_trie(char_data *ch, char *name, bool exact) {
+	social_data *soc, *next_soc;
+	struct cmd_trie_node *node;
+	int iter = 0, num = 0, *list = NULL;
+	
+	if ((node = find_social_node(name))) {
+		list = exact ? node->exact : node->abbrev;
+		num = exact ? node->num_exact : node->num_abbrev;
+	}
+	
+	HASH_ITER(sorted_hh, sorted_socials, soc, next_soc) {
+		if (LOWER(*SOC_COMMAND(soc)) < LOWER(*name)) {	// shortcut: check first letter
+			continue;
+		}
+		if (LOWER(*SOC_COMMAND(soc)) > LOWER(*name)) {	// short exit: past the right letter
+			break;
+		}
+		if (exact && str_cmp(name, SOC_COMMAND(soc))) {
+			continue;
+		}
+		if (!exact && !is_abbrev(name, SOC_COMMAND(soc))) {
+			continue;
+		}
+		if (!can_use_social(ch, soc)) {
+			continue;
+		}
+		
+		// the trie must have this one next
+		while (iter < num && !can_use_social(ch, social_trie_list[list[iter]])) {
+			++iter;
+		}
+		if (iter >= num || social_trie_list[list[iter++]] != soc) {
+			return FALSE;
+		}
+	}
+	
+	// and nothing left over
+	while (iter < num && !can_use_social(ch, social_trie_list[list[iter]])) {
+		++iter;
+	}
+	return (iter >= num);
+}
+
+
 /**
 * Executes the a pre-validated social command.
 *
@@ -90,7 +90,7 @@ void special_building_setup(char_data *ch, room_data *room) {
 */
 bool can_build_on(room_data *room, bitvector_t flags) {
 	#define CLEAR_OPEN_BUILDING(r)	(IS_MAP_BUILDING(r) && ROOM_BLD_FLAGGED((r), BLD_OPEN) && !ROOM_BLD_FLAGGED((r), BLD_BARRIER) && (IS_COMPLETE(r) || !SECT_FLAGGED(BASE_SECT(r), SECTF_FRESH_WATER | SECTF_OCEAN)))
-	#define IS_PLAYER_MADE(r)  (GET_ROOM_VNUM(r) < MAP_SIZE && SECT(r) != world_map[FLAT_X_COORD(r)][FLAT_Y_COORD(r)].natural_sector)
+	#define IS_PLAYER_MADE(r)  (GET_ROOM_VNUM(r) < MAP_SIZE && SECT(r) != MAP_NATURAL_SECT(GET_ROOM_VNUM(r)))
 
 	return (!IS_SET(flags, BLD_ON_NOT_PLAYER_MADE) || !IS_PLAYER_MADE(room)) && (
 		IS_SET(GET_SECT_BUILD_FLAGS(SECT(room)), flags) || 
@@ -139,6 +139,8 @@ void complete_building(room_data *room) {
 		return;
 	}
 	
+	request_world_save(GET_ROOM_VNUM(room));
+	
 	// stop builders
 	stop_room_action(room, ACT_BUILDING, CHORE_BUILDING);
 	stop_room_action(room, ACT_MAINTENANCE, CHORE_MAINTENANCE);
@@ -152,7 +154,7 @@ void complete_building(room_data *room) {
 	
 	// remove incomplete
 	REMOVE_BIT(ROOM_AFF_FLAGS(room), ROOM_AFF_INCOMPLETE);
-	REMOVE_BIT(ROOM_BASE_FLAGS(room), ROOM_AFF_INCOMPLETE);
+	remove_room_base_flags(room, ROOM_AFF_INCOMPLETE);
 	
 	complete_wtrigger(room);
 	
@@ -208,7 +210,7 @@ void construct_building(room_data *room, bld_vnum type) {
 	// set actual data
 	attach_building_to_room(building_proto(type), room, TRUE);
 	
-	SET_BIT(ROOM_BASE_FLAGS(room), BLD_BASE_AFFECTS(room));
+	set_room_base_flags(room, BLD_BASE_AFFECTS(room));
 	SET_BIT(ROOM_AFF_FLAGS(room), BLD_BASE_AFFECTS(room));
 	
 	// check for territory updates
@@ -267,14 +269,14 @@ void construct_tunnel(char_data *ch, int dir, room_data *entrance, room_data *ex
 	// entrance
 	setup_tunnel_entrance(ch, entrance, dir);
 	GET_BUILDING_RESOURCES(entrance) = copy_resource_list(resources);
-	SET_BIT(ROOM_BASE_FLAGS(entrance), ROOM_AFF_INCOMPLETE);
+	set_room_base_flags(entrance, ROOM_AFF_INCOMPLETE);
 	SET_BIT(ROOM_AFF_FLAGS(entrance), ROOM_AFF_INCOMPLETE);
 	create_exit(entrance, IN_ROOM(ch), rev_dir[dir], FALSE);
 
 	// exit
 	setup_tunnel_entrance(ch, exit, rev_dir[dir]);
 	GET_BUILDING_RESOURCES(exit) = copy_resource_list(resources);
-	SET_BIT(ROOM_BASE_FLAGS(exit), ROOM_AFF_INCOMPLETE);
+	set_room_base_flags(exit, ROOM_AFF_INCOMPLETE);
 	SET_BIT(ROOM_AFF_FLAGS(exit), ROOM_AFF_INCOMPLETE);
 	to_room = real_shift(exit, shift_dir[dir][0], shift_dir[dir][1]);
 	create_exit(exit, to_room, dir, FALSE);
@@ -285,7 +287,7 @@ void construct_tunnel(char_data *ch, int dir, room_data *entrance, room_data *ex
 		attach_building_to_room(building_proto(RTYPE_TUNNEL), new_room, TRUE);
 		COMPLEX_DATA(new_room)->home_room = (iter <= length/2) ? entrance : exit;
 		GET_BUILDING_RESOURCES(new_room) = copy_resource_list(resources);
-		SET_BIT(ROOM_BASE_FLAGS(new_room), ROOM_AFF_INCOMPLETE);
+		set_room_base_flags(new_room, ROOM_AFF_INCOMPLETE);
 		SET_BIT(ROOM_AFF_FLAGS(new_room), ROOM_AFF_INCOMPLETE);
 
 		create_exit(last_room, new_room, dir, TRUE);
@@ -324,6 +326,8 @@ void disassociate_building(room_data *room) {
 	struct instance_data *inst;
 	bool deleted = FALSE;
 	
+	request_world_save(GET_ROOM_VNUM(room));
+	
 	// for updating territory counts
 	was_large = ROOM_BLD_FLAGGED(room, BLD_LARGE_CITY_RADIUS);
 	was_in_city = ROOM_OWNER(room) ? is_in_city_for_empire(room, ROOM_OWNER(room), FALSE, &junk) : FALSE;
@@ -348,7 +352,7 @@ void disassociate_building(room_data *room) {
 	delete_room_npcs(room, NULL);
 	
 	// remove bits including dismantle
-	REMOVE_BIT(ROOM_BASE_FLAGS(room), ROOM_AFF_DISMANTLING | ROOM_AFF_TEMPORARY | ROOM_AFF_HAS_INSTANCE | ROOM_AFF_CHAMELEON | ROOM_AFF_NO_FLY | ROOM_AFF_NO_DISMANTLE | ROOM_AFF_NO_DISREPAIR | ROOM_AFF_INCOMPLETE);
+	remove_room_base_flags(room, ROOM_AFF_DISMANTLING | ROOM_AFF_TEMPORARY | ROOM_AFF_HAS_INSTANCE | ROOM_AFF_CHAMELEON | ROOM_AFF_NO_FLY | ROOM_AFF_NO_DISMANTLE | ROOM_AFF_NO_DISREPAIR | ROOM_AFF_INCOMPLETE);
 	REMOVE_BIT(ROOM_AFF_FLAGS(room), ROOM_AFF_DISMANTLING | ROOM_AFF_TEMPORARY | ROOM_AFF_HAS_INSTANCE | ROOM_AFF_CHAMELEON | ROOM_AFF_NO_FLY | ROOM_AFF_NO_DISMANTLE | ROOM_AFF_NO_DISREPAIR | ROOM_AFF_INCOMPLETE);
 	
 	// TODO should do an affect-total here in case any of those were also added by an affect?
@@ -368,7 +372,7 @@ void disassociate_building(room_data *room) {
 	free_proto_scripts(&room->proto_script);
 
 	// restore sect: this does not use change_terrain()
-	perform_change_sect(room, NULL, BASE_SECT(room));
+	perform_change_sect(room, NOWHERE, BASE_SECT(room));
 	
 	if (COMPLEX_DATA(room)) {
 		COMPLEX_DATA(room)->home_room = NULL;
@@ -605,6 +609,8 @@ void finish_dismantle(char_data *ch, room_data *room) {
 * @param room_data *room the location
 */
 void finish_maintenance(char_data *ch, room_data *room) {
+	request_world_save(GET_ROOM_VNUM(room));
+	
 	// repair all damage
 	if (COMPLEX_DATA(room)) {
 		COMPLEX_DATA(room)->damage = 0;
@@ -756,6 +762,8 @@ void process_build(char_data *ch, room_data *room, int act_type) {
 		return;
 	}
 	
+	request_world_save(GET_ROOM_VNUM(room));
+	
 	// just emergency check that it's not actually dismantling
 	if (!IS_DISMANTLING(room) && BUILDING_RESOURCES(room)) {
 		if ((res = get_next_resource(ch, BUILDING_RESOURCES(room), can_use_room(ch, room, GUESTS_ALLOWED), TRUE, &found_obj))) {
@@ -800,6 +808,8 @@ void process_dismantling(char_data *ch, room_data *room) {
 	
 	struct resource_data *res, *find_res, *next_res, *copy;
 	char buf[MAX_STRING_LENGTH];
+	
+	request_world_save(GET_ROOM_VNUM(room));
 
 	// sometimes zeroes end up in here ... just clear them
 	res = NULL;
@@ -923,7 +933,7 @@ void setup_tunnel_entrance(char_data *ch, room_data *room, int dir) {
 	
 	construct_building(room, BUILDING_TUNNEL);
 		
-	SET_BIT(ROOM_BASE_FLAGS(room), tunnel_flags);
+	set_room_base_flags(room, tunnel_flags);
 	SET_BIT(ROOM_AFF_FLAGS(room), tunnel_flags);
 	COMPLEX_DATA(room)->entrance = dir;
 	if (emp && can_claim(ch) && !ROOM_AFF_FLAGGED(room, ROOM_AFF_UNCLAIMABLE)) {
@@ -955,6 +965,8 @@ void start_dismantle_building(room_data *loc) {
 		return;
 	}
 	
+	request_world_save(GET_ROOM_VNUM(loc));
+	
 	// find the entry
 	if (!(type = find_building_list_entry(loc, FIND_BUILD_NORMAL)) && !(type = find_building_list_entry(loc, FIND_BUILD_UPGRADE))) {
 		log("SYSERR: Attempting to dismantle non-dismantlable building at #%d", GET_ROOM_VNUM(loc));
@@ -998,9 +1010,7 @@ void start_dismantle_building(room_data *loc) {
 	}
 	
 	// unset private owner
-	if (ROOM_PRIVATE_OWNER(loc) != NOBODY) {
-		COMPLEX_DATA(loc)->private_owner = NOBODY;
-	}
+	set_private_owner(loc, NOBODY);
 	
 	// remove any existing resources remaining
 	if (GET_BUILDING_RESOURCES(loc)) {
@@ -1049,7 +1059,7 @@ void start_dismantle_building(room_data *loc) {
 	halve_resource_list(&GET_BUILDING_RESOURCES(loc), TRUE);
 
 	SET_BIT(ROOM_AFF_FLAGS(loc), ROOM_AFF_DISMANTLING);
-	SET_BIT(ROOM_BASE_FLAGS(loc), ROOM_AFF_DISMANTLING);
+	set_room_base_flags(loc, ROOM_AFF_DISMANTLING);
 	delete_room_npcs(loc, NULL);
 	
 	if (loc && ROOM_OWNER(loc) && GET_BUILDING(loc) && complete) {
@@ -1340,7 +1350,7 @@ ACMD(do_build) {
 	construct_building(IN_ROOM(ch), GET_CRAFT_BUILD_TYPE(type));
 	set_room_extra_data(IN_ROOM(ch), ROOM_EXTRA_BUILD_RECIPE, GET_CRAFT_VNUM(type));
 	
-	SET_BIT(ROOM_BASE_FLAGS(IN_ROOM(ch)), ROOM_AFF_INCOMPLETE);
+	set_room_base_flags(IN_ROOM(ch), ROOM_AFF_INCOMPLETE);
 	SET_BIT(ROOM_AFF_FLAGS(IN_ROOM(ch)), ROOM_AFF_INCOMPLETE);
 	GET_BUILDING_RESOURCES(IN_ROOM(ch)) = copy_resource_list(GET_CRAFT_RESOURCES(type));
 	special_building_setup(ch, IN_ROOM(ch));
@@ -1523,6 +1533,7 @@ void do_customize_room(char_data *ch, char *argument) {
 			if (ROOM_CUSTOM_NAME(IN_ROOM(ch))) {
 				free(ROOM_CUSTOM_NAME(IN_ROOM(ch)));
 				ROOM_CUSTOM_NAME(IN_ROOM(ch)) = NULL;
+				request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 			}
 			
 			msg_to_char(ch, "This room no longer has a custom name.\r\n");
@@ -1542,6 +1553,7 @@ void do_customize_room(char_data *ch, char *argument) {
 				gain_ability_exp(ch, ABIL_CUSTOMIZE_BUILDING, 33.4);
 			}
 			ROOM_CUSTOM_NAME(IN_ROOM(ch)) = str_dup(arg2);
+			request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 			
 			msg_to_char(ch, "This room is now called \"%s\".\r\n", arg2);
 			command_lag(ch, WAIT_ABILITY);
@@ -1559,6 +1571,7 @@ void do_customize_room(char_data *ch, char *argument) {
 			if (ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch))) {
 				free(ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch)));
 				ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch)) = NULL;
+				request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 			}
 			msg_to_char(ch, "This room no longer has a custom description.\r\n");
 		}
@@ -1567,6 +1580,7 @@ void do_customize_room(char_data *ch, char *argument) {
 				gain_ability_exp(ch, ABIL_CUSTOMIZE_BUILDING, 33.4);
 			}
 			start_string_editor(ch->desc, "room description", &(ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch))), MAX_ROOM_DESCRIPTION, TRUE);
+			ch->desc->save_room = GET_ROOM_VNUM(IN_ROOM(ch));
 			act("$n begins editing the room description.", TRUE, ch, 0, 0, TO_ROOM);
 		}
 		else {
@@ -2026,12 +2040,12 @@ ACMD(do_nodismantle) {
 	}
 	else if (ROOM_AFF_FLAGGED(HOME_ROOM(IN_ROOM(ch)), ROOM_AFF_NO_DISMANTLE)) {
 		REMOVE_BIT(ROOM_AFF_FLAGS(HOME_ROOM(IN_ROOM(ch))), ROOM_AFF_NO_DISMANTLE);
-		REMOVE_BIT(ROOM_BASE_FLAGS(HOME_ROOM(IN_ROOM(ch))), ROOM_AFF_NO_DISMANTLE);
+		remove_room_base_flags(HOME_ROOM(IN_ROOM(ch)), ROOM_AFF_NO_DISMANTLE);
 		msg_to_char(ch, "This building can now be dismantled.\r\n");
 	}
 	else {
 		SET_BIT(ROOM_AFF_FLAGS(HOME_ROOM(IN_ROOM(ch))), ROOM_AFF_NO_DISMANTLE);
-		SET_BIT(ROOM_BASE_FLAGS(HOME_ROOM(IN_ROOM(ch))), ROOM_AFF_NO_DISMANTLE);
+		set_room_base_flags(HOME_ROOM(IN_ROOM(ch)), ROOM_AFF_NO_DISMANTLE);
 		msg_to_char(ch, "This building can no longer be dismantled.\r\n");
 	}
 }
@@ -2190,7 +2204,7 @@ ACMD(do_upgrade) {
 			detach_building_from_room(IN_ROOM(ch));
 			attach_building_to_room(building_proto(GET_CRAFT_BUILD_TYPE(type)), IN_ROOM(ch), TRUE);
 			set_room_extra_data(IN_ROOM(ch), ROOM_EXTRA_BUILD_RECIPE, GET_CRAFT_VNUM(type));
-			SET_BIT(ROOM_BASE_FLAGS(IN_ROOM(ch)), ROOM_AFF_INCOMPLETE);
+			set_room_base_flags(IN_ROOM(ch), ROOM_AFF_INCOMPLETE);
 			SET_BIT(ROOM_AFF_FLAGS(IN_ROOM(ch)), ROOM_AFF_INCOMPLETE);
 			GET_BUILDING_RESOURCES(IN_ROOM(ch)) = copy_resource_list(GET_CRAFT_RESOURCES(type));
 
@@ -32,6 +32,9 @@
 *   Reboot System
 *   Main Game Loop
 *   Messaging
+*   Hostname Resolver
+*   I/O Backend
+*   Sockets
 *   Prompt
 *   Signal Processing
 *   Startup
@@ -63,7 +66,12 @@ extern int max_playing;
 extern char *help;
 
 // external functions
+BUDGET_JOB(chore_update_job);
+BUDGET_JOB(point_update_job);
+void check_player_file_writes(void);
 void save_all_players();
+void save_players_in_rotation(void);
+BUDGET_JOB(save_whole_world_job);
 extern char *flush_reduced_color_codes(descriptor_data *desc);
 void mobile_activity(void);
 void show_string(descriptor_data *d, char *input);
@@ -91,6 +99,7 @@ int set_sendbuf(socket_t s);
 socket_t init_socket(ush_int port);
 ssize_t perform_socket_read(socket_t desc, char *read_point,size_t space_left);
 ssize_t perform_socket_write(socket_t desc, const char *txt,size_t length);
+ssize_t perform_socket_writev(socket_t desc, const struct iovec *vec, int count);
 static int process_output(descriptor_data *t);
 struct in_addr *get_bind_addr(void);
 void empire_sleep(struct timeval *timeout);
@@ -99,6 +108,10 @@ void game_loop(socket_t mother_desc);
 void heartbeat(int heart_pulse);
 void init_descriptor(descriptor_data *newd, int desc);
 void init_game(ush_int port);
+void check_hostname_lookups(void);
+bool is_slow_ip(char *ip);
+void start_hostname_lookup(descriptor_data *desc, struct in_addr *addr);
+void io_backend_init(socket_t mother);
 void nonblock(socket_t s);
 void perform_act(const char *orig, char_data *ch, const void *obj, const void *vict_obj, const char_data *to, bitvector_t act_flags);
 void reboot_recover(void);
@@ -116,10 +129,14 @@ sigfunc *my_signal(int signo, sigfunc * func);
 
 /* local globals (I majored in oxymoronism) */
 descriptor_data *descriptor_list = NULL;/* master desc list					*/
-struct txt_block *bufpool = 0;			/* pool of large output buffers		*/
-int buf_largecount = 0;					/* # of large buffers which exist	*/
+struct outbuf_chunk *outbuf_pool = NULL;	/* spare output chunks			*/
+int outbuf_pool_size = 0;				/* # of chunks in outbuf_pool		*/
+int outbuf_chunks = 0;					/* # of output chunks which exist	*/
 int buf_overflows = 0;					/* # of overflows of output			*/
-int buf_switches = 0;					/* # of switches from small to large buf*/
+struct io_timing_data io_timing = { 0, 0, 0, 0, 0 };	/* time spent in socket I/O */
+struct heartbeat_job_data *heartbeat_jobs = NULL;	/* heartbeat profiler table */
+int num_heartbeat_jobs = 0;				/* size of heartbeat_jobs			*/
+struct budget_job_data *budget_job_queue = NULL;	/* budgeted jobs waiting to run (LL) */
 int empire_shutdown = 0;				/* clean shutdown					*/
 int max_players = 0;					/* max descriptors available		*/
 int tics_passed = 0;					/* for extern checkpointing			*/
@@ -133,6 +150,11 @@ static bool reboot_recovery = FALSE;
 int mother_desc;
 ush_int port;
 
+// heavy hourly jobs, run by the budgeted job scheduler
+struct budget_job_data point_update_budget = { "point_update", point_update_job };
+struct budget_job_data chore_update_budget = { "chore_update", chore_update_job };
+struct budget_job_data save_world_budget = { "save_whole_world", save_whole_world_job };
+
 // vars to prevent running multiple cycles during a missed-pulse catch-up cycle
 bool catch_up_combat = FALSE;	// frequent_combat()
 bool catch_up_actions = FALSE;	// update_actions()
@@ -719,6 +741,7 @@ void perform_reboot(void) {
 	}
 
 	// prepare for the end!
+	wait_for_snapshot_save();
 	save_all_empires();
 	save_whole_world();
 
@@ -735,7 +758,7 @@ void perform_reboot(void) {
 		
 		// people not in-game get trimmed
 		if (!och || STATE(desc) != CON_PLAYING) {
-			write_to_descriptor(desc->descriptor, buf);
+			ProtocolWrite(desc, buf);
 			close_socket(desc);
 			continue;
 		}
@@ -748,10 +771,10 @@ void perform_reboot(void) {
 			}
 		}
 		
-		// send output
-		write_to_descriptor(desc->descriptor, buf);
+		// send output (CopyoverGet has already ended any compression for a reboot)
+		ProtocolWrite(desc, buf);
 		if (reboot_control.type == SCMD_REBOOT) {
-			write_to_descriptor(desc->descriptor, reboot_strings[number(0, num_of_reboot_strings - 1)]);
+			ProtocolWrite(desc, reboot_strings[number(0, num_of_reboot_strings - 1)]);
 		}
 		
 		SAVE_CHAR(och);
@@ -761,6 +784,8 @@ void perform_reboot(void) {
 		// extract_char(och);
 	}
 
+	flush_player_file_writes();	// everyone's on disk before we exec/exit
+
 	if (reboot_control.type == SCMD_REBOOT && fl) {
 		fprintf(fl, "-1 ~ ~\n");
 		fprintf(fl, "%s", group_data);
@@ -875,19 +900,236 @@ void update_reboot(void) {
  //////////////////////////////////////////////////////////////////////////////
 //// MAIN GAME LOOP //////////////////////////////////////////////////////////
 
+/**
+* Finds the histogram bucket for a job duration. Buckets are on a log scale
+* with 4 sub-buckets per power of 2 (about 19% resolution).
+*
+* @param unsigned long long usec The duration.
+* @return int The bucket, 0 to HEARTBEAT_HISTOGRAM_SIZE-1.
+*/
+static int heartbeat_histogram_bucket(unsigned long long usec) {
+	int msb;
+	
+	if (usec < 8) {
+		return (int) usec;
+	}
+	
+	for (msb = 3; (usec >> (msb + 1)) > 0; ++msb);
+	return MIN(HEARTBEAT_HISTOGRAM_SIZE - 1, msb * 4 + (int) ((usec >> (msb - 2)) & 3));
+}
+
+
+/**
+* @param int bucket A histogram bucket.
+* @return unsigned long long The largest duration that falls in that bucket.
+*/
+static unsigned long long heartbeat_histogram_max(int bucket) {
+	int msb = bucket / 4, sub = bucket % 4;
+	
+	if (bucket < 8) {
+		return (unsigned long long) bucket;
+	}
+	return ((unsigned long long) (5 + sub) << (msb - 2)) - 1;
+}
+
+
+/**
+* Estimates the 99th-percentile duration from a job's histogram.
+*
+* @param struct heartbeat_timing_data *timing The stats to check.
+* @return unsigned long long The p99 time, in microseconds.
+*/
+unsigned long long heartbeat_timing_p99(struct heartbeat_timing_data *timing) {
+	unsigned long long target, seen = 0;
+	int iter;
+	
+	if (timing->calls == 0) {
+		return 0;
+	}
+	
+	target = timing->calls - (timing->calls / 100);	// calls at or under p99
+	for (iter = 0; iter < HEARTBEAT_HISTOGRAM_SIZE; ++iter) {
+		if ((seen += timing->histogram[iter]) >= target) {
+			return MIN(heartbeat_histogram_max(iter), timing->max_usec);
+		}
+	}
+	return timing->max_usec;
+}
+
+
+/**
+* Adds a heartbeat job to the profiler table. This is called automatically the
+* first time a HEARTBEAT_JOB() runs.
+*
+* @param const char *name The job's name, as shown in 'show heartbeat'.
+* @return int The job's position in heartbeat_jobs.
+*/
+int register_heartbeat_job(const char *name) {
+	int iter;
+	
+	for (iter = 0; iter < num_heartbeat_jobs; ++iter) {
+		if (!strcmp(heartbeat_jobs[iter].name, name)) {
+			return iter;
+		}
+	}
+	
+	RECREATE(heartbeat_jobs, struct heartbeat_job_data, num_heartbeat_jobs + 1);
+	memset(&heartbeat_jobs[num_heartbeat_jobs], 0, sizeof(struct heartbeat_job_data));
+	heartbeat_jobs[num_heartbeat_jobs].name = str_dup(name);
+	return num_heartbeat_jobs++;
+}
+
+
+/**
+* Records one run of a heartbeat job.
+*
+* @param int job The job's position in heartbeat_jobs.
+* @param unsigned long long usec How long it took.
+*/
+void record_heartbeat_job(int job, unsigned long long usec) {
+	struct heartbeat_timing_data *list[2];
+	int iter, bucket = heartbeat_histogram_bucket(usec);
+	
+	list[0] = &heartbeat_jobs[job].since_boot;
+	list[1] = &heartbeat_jobs[job].since_dump;
+	
+	for (iter = 0; iter < 2; ++iter) {
+		++list[iter]->calls;
+		list[iter]->total_usec += usec;
+		list[iter]->max_usec = MAX(list[iter]->max_usec, usec);
+		++list[iter]->histogram[bucket];
+		if (usec >= OPT_USEC) {
+			++list[iter]->overruns;
+		}
+	}
+}
+
+
+/**
+* Appends the heartbeat profile since the last dump to the profile file, one
+* tab-separated line per job, then resets the interval stats. This is meant
+* for graphing tick costs over time.
+*/
+void write_heartbeat_profile(void) {
+	struct heartbeat_timing_data *timing;
+	time_t now = time(0);
+	bool new_file;
+	FILE *fl;
+	int iter;
+	
+	new_file = (access(HEARTBEAT_PROFILE_FILE, F_OK) != 0);
+	if (!(fl = fopen(HEARTBEAT_PROFILE_FILE, "a"))) {
+		log("SYSERR: Unable to write %s: %s", HEARTBEAT_PROFILE_FILE, strerror(errno));
+		return;
+	}
+	
+	if (new_file) {
+		fprintf(fl, "# timestamp\tjob\tcalls\ttotal_usec\tavg_usec\tmax_usec\tp99_usec\toverruns\n");
+	}
+	
+	for (iter = 0; iter < num_heartbeat_jobs; ++iter) {
+		timing = &heartbeat_jobs[iter].since_dump;
+		if (timing->calls > 0) {
+			fprintf(fl, "%ld\t%s\t%lu\t%llu\t%llu\t%llu\t%llu\t%lu\n", (long) now, heartbeat_jobs[iter].name, timing->calls, timing->total_usec, timing->total_usec / timing->calls, timing->max_usec, heartbeat_timing_p99(timing), timing->overruns);
+		}
+		memset(timing, 0, sizeof(struct heartbeat_timing_data));
+	}
+	
+	fclose(fl);
+}
+
+
+/**
+* Runs a heartbeat job and records how long it took. The job is added to the
+* profiler table the first time it runs.
+*
+* @param name The job's name, for 'show heartbeat'.
+* @param call The code to run.
+*/
+#define HEARTBEAT_JOB(name, call)  do {	\
+		static int _hb_job = NOTHING;	\
+		unsigned long long _hb_start;	\
+		if (_hb_job == NOTHING) {	\
+			_hb_job = register_heartbeat_job(name);	\
+		}	\
+		_hb_start = microtime();	\
+		call;	\
+		record_heartbeat_job(_hb_job, microtime() - _hb_start);	\
+	} while (0)
+
+
+/**
+* Adds a budgeted job to the end of the scheduler queue. The job will start on
+* this pulse if there's time left, and it may take several pulses to finish.
+* If the job is still running from a previous queue, it is not added again.
+*
+* @param struct budget_job_data *job The job to queue.
+*/
+void queue_budget_job(struct budget_job_data *job) {
+	if (job->queued) {
+		log("SYSERR: Budgeted job %s is still running from pulse %lu; not queueing it again", job->name, job->queued_pulse);
+		return;
+	}
+	
+	job->queued = TRUE;
+	job->started = FALSE;
+	job->queued_pulse = pulse;
+	job->run_usec = 0;
+	job->profile_job = register_heartbeat_job(job->name);
+	job->next = NULL;
+	LL_APPEND(budget_job_queue, job);
+}
+
+
+/**
+* Runs queued budgeted jobs, in order, until the deadline passes. Each job
+* gets one call per pass (a job may stop early to pace itself), and the first
+* job always gets its call so that the queue keeps moving even on a slow
+* pulse. This runs once per pass of the game loop (not once per missed pulse),
+* so heavy jobs don't make the game fall further behind.
+*
+* @param unsigned long long deadline The microtime() to stop at.
+*/
+void run_budget_jobs(unsigned long long deadline) {
+	struct budget_job_data *job, *next_job;
+	unsigned long long start, usec;
+	bool done;
+	
+	LL_FOREACH_SAFE(budget_job_queue, job, next_job) {
+		start = microtime();
+		done = (job->func)(!job->started, deadline);
+		usec = microtime() - start;
+		
+		job->started = TRUE;
+		job->run_usec += usec;
+		record_heartbeat_job(job->profile_job, usec);
+		
+		if (done) {
+			LL_DELETE(budget_job_queue, job);
+			job->queued = FALSE;
+			++job->runs;
+			job->last_pulses = pulse - job->queued_pulse + 1;
+			job->last_usec = job->run_usec;
+		}
+		
+		if (microtime() >= deadline) {
+			break;
+		}
+	}
+}
+
+
 void heartbeat(int heart_pulse) {
 	void check_death_respawn();
 	void check_expired_cooldowns();
 	void check_idle_passwords();
 	void check_newbie_islands();
 	void check_wars();
-	void chore_update();
 	void detect_evos_per_hour();
 	void extract_pending_chars();
 	void frequent_combat(int pulse);
 	void generate_adventure_instances();
-	void output_map_to_file();
-	void point_update();
+	bool output_map_to_file();
 	void process_imports();
 	void prune_instances();
 	void real_update();
@@ -908,8 +1150,8 @@ void heartbeat(int heart_pulse) {
 	void update_world();
 	void weather_and_time(int mode);
 
-	static int mins_since_crashsave = 0;
-	bool debug_log = FALSE;
+	static int whole_pulse_job = NOTHING;
+	unsigned long long pulse_start = microtime();
 	
 	#define HEARTBEAT(x)  !(heart_pulse % ((x) * PASSES_PER_SEC))
 	
@@ -920,170 +1162,148 @@ void heartbeat(int heart_pulse) {
 		gain_cond_messsage = TRUE;
 	}
 	
-	event_process();
+	HEARTBEAT_JOB("event_process", event_process());
 
 	// this is meant to be slightly longer than the mobile_activity pulse, and is mentioned in help files
 	if (HEARTBEAT(13)) {
-		script_trigger_check();
-		if (debug_log && HEARTBEAT(15)) { log("debug  2:\t%lld", microtime()); }
+		HEARTBEAT_JOB("script_trigger_check", script_trigger_check());
 	}
 
 	if (HEARTBEAT(1)) {
-		update_actions();		
-		if (debug_log && HEARTBEAT(15)) { log("debug  3:\t%lld", microtime()); }
-		check_expired_cooldowns();	// descriptor list
-		if (debug_log && HEARTBEAT(15)) { log("debug  4:\t%lld", microtime()); }
+		HEARTBEAT_JOB("update_actions", update_actions());
+		HEARTBEAT_JOB("check_expired_cooldowns", check_expired_cooldowns());	// descriptor list
+		HEARTBEAT_JOB("check_snapshot_save", check_snapshot_save());
+		HEARTBEAT_JOB("save_players_in_rotation", save_players_in_rotation());	// staggered so players aren't all saved at once
+		HEARTBEAT_JOB("check_player_file_writes", check_player_file_writes());
 	}
 
 	if (HEARTBEAT(3)) {
-		update_guard_towers();
-		if (debug_log && HEARTBEAT(15)) { log("debug  5:\t%lld", microtime()); }
+		HEARTBEAT_JOB("update_guard_towers", update_guard_towers());
 	}
 	
 	if (HEARTBEAT(30)) {
-		sanity_check();
-		if (debug_log && HEARTBEAT(15)) { log("debug  6:\t%lld", microtime()); }
+		HEARTBEAT_JOB("sanity_check", sanity_check());
 	}
 
 	if (HEARTBEAT(15)) {
-		check_idle_passwords();
-		if (debug_log && HEARTBEAT(15)) { log("debug  7:\t%lld", microtime()); }
-		check_death_respawn();
-		if (debug_log && HEARTBEAT(15)) { log("debug  7.5:\t%lld", microtime()); }
-		run_mob_echoes();
-		if (debug_log && HEARTBEAT(15)) { log("debug  7.6:\t%lld", microtime()); }
+		HEARTBEAT_JOB("check_idle_passwords", check_idle_passwords());
+		HEARTBEAT_JOB("check_death_respawn", check_death_respawn());
+		HEARTBEAT_JOB("run_mob_echoes", run_mob_echoes());
 	}
 
 	if (HEARTBEAT(30)) {
-		update_world();
-		if (debug_log && HEARTBEAT(15)) { log("debug  9:\t%lld", microtime()); }
-		
-		update_players_online_stats();
-		if (debug_log && HEARTBEAT(15)) { log("debug  9.5:\t%lld", microtime()); }
+		HEARTBEAT_JOB("update_world", update_world());
+		HEARTBEAT_JOB("update_players_online_stats", update_players_online_stats());
 	}
 
 	if (HEARTBEAT(10)) {
-		mobile_activity();
-		if (debug_log && HEARTBEAT(15)) { log("debug 10:\t%lld", microtime()); }
+		HEARTBEAT_JOB("mobile_activity", mobile_activity());
 	}
 
 	// TODO won't the macro work here?
 	if (!(heart_pulse % (int)(0.1 * PASSES_PER_SEC))) {
-		frequent_combat(heart_pulse);
-		if (debug_log && HEARTBEAT(15)) { log("debug 11:\t%lld", microtime()); }
+		HEARTBEAT_JOB("frequent_combat", frequent_combat(heart_pulse));
 	}
 	
 	if (HEARTBEAT(SECS_PER_MUD_HOUR)) {
-		point_update();
-		if (debug_log && HEARTBEAT(15)) { log("debug 12:\t%lld", microtime()); }
+		// point_update also does the real_update for everything it touches; it runs as a budgeted job
+		queue_budget_job(&point_update_budget);
 	}
-	else if (HEARTBEAT(SECS_PER_REAL_UPDATE)) {
+	else if (HEARTBEAT(SECS_PER_REAL_UPDATE) && !point_update_budget.queued) {
 		// only call real_update if we didn't also point_update
-		real_update();
-		if (debug_log && HEARTBEAT(15)) { log("debug 13:\t%lld", microtime()); }
+		HEARTBEAT_JOB("real_update", real_update());
 	}
 
 	if (HEARTBEAT(SECS_PER_MUD_HOUR)) {
-		weather_and_time(1);
-		if (debug_log && HEARTBEAT(15)) { log("debug 14a:\t%lld", microtime()); }
-		chore_update();
-		if (debug_log && HEARTBEAT(15)) { log("debug 14b:\t%lld", microtime()); }
+		// time must advance on the hour, so this is not budgeted (it's cheap except at new year)
+		HEARTBEAT_JOB("weather_and_time", weather_and_time(1));
+		queue_budget_job(&chore_update_budget);
 		
-		// save the world at dawn
-		if (time_info.hours == 7) {
-			save_whole_world();
-			if (debug_log && HEARTBEAT(15)) { log("debug 14c:\t%lld", microtime()); }
+		// save the world at dawn (in a snapshot, that includes the empires)
+		if (time_info.hours == 7 && !start_snapshot_save(SNAPSHOT_WORLD | SNAPSHOT_EMPIRES)) {
+			queue_budget_job(&save_world_budget);
 		}
 	}
 	
 	// slightly off the hour to prevent yet another thing on the tick
 	if (HEARTBEAT(SECS_PER_MUD_HOUR+1)) {
-		update_empire_npc_data();
-		if (debug_log && HEARTBEAT(15)) { log("debug 15:\t%lld", microtime()); }
+		HEARTBEAT_JOB("update_empire_npc_data", update_empire_npc_data());
 	}
 	
 	if (HEARTBEAT(SECS_PER_REAL_MIN)) {
-		check_wars();
-		if (debug_log && HEARTBEAT(15)) { log("debug 16:\t%lld", microtime()); }
-		reset_instances();
-		if (debug_log && HEARTBEAT(15)) { log("debug 17:\t%lld", microtime()); }
+		HEARTBEAT_JOB("check_wars", check_wars());
+		HEARTBEAT_JOB("reset_instances", reset_instances());
 	}
 	
 	if (HEARTBEAT(15 * SECS_PER_REAL_MIN)) {
-		output_map_to_file();
-		if (debug_log && HEARTBEAT(15)) { log("debug 18:\t%lld", microtime()); }
+		if (!start_snapshot_save(SNAPSHOT_MAP_OUTPUT)) {
+			HEARTBEAT_JOB("output_map_to_file", output_map_to_file());
+		}
+		write_heartbeat_profile();
 	}
 
 	if (HEARTBEAT(SECS_PER_REAL_MIN)) {
 		update_reboot();
-		if (++mins_since_crashsave >= 5) {
-			mins_since_crashsave = 0;
-			save_all_players();
-			if (debug_log && HEARTBEAT(15)) { log("debug 19:\t%lld", microtime()); }
-		}
 	}
 	
 	if (HEARTBEAT(12 * SECS_PER_REAL_HOUR)) {
-		reduce_city_overages();
-		if (debug_log && HEARTBEAT(15)) { log("debug 20:\t%lld", microtime()); }
-		check_newbie_islands();
-		if (debug_log && HEARTBEAT(15)) { log("debug 20.5:\t%lld", microtime()); }
+		HEARTBEAT_JOB("reduce_city_overages", reduce_city_overages());
+		HEARTBEAT_JOB("check_newbie_islands", check_newbie_islands());
 	}
 	
 	if (HEARTBEAT(SECS_PER_REAL_HOUR)) {
-		reduce_stale_empires();
-		if (debug_log && HEARTBEAT(15)) { log("debug 21:\t%lld", microtime()); }
-		detect_evos_per_hour();
-		if (debug_log && HEARTBEAT(15)) { log("debug 21.5:\t%lld", microtime()); }
+		HEARTBEAT_JOB("reduce_stale_empires", reduce_stale_empires());
+		HEARTBEAT_JOB("detect_evos_per_hour", detect_evos_per_hour());
 	}
 	
 	if (HEARTBEAT(30 * SECS_PER_REAL_MIN)) {
-		reduce_outside_territory();
-		if (debug_log && HEARTBEAT(15)) { log("debug 22:\t%lld", microtime()); }
+		HEARTBEAT_JOB("reduce_outside_territory", reduce_outside_territory());
 	}
 	
 	if (HEARTBEAT(3 * SECS_PER_REAL_MIN)) {
-		generate_adventure_instances();
-		if (debug_log && HEARTBEAT(15)) { log("debug 23:\t%lld", microtime()); }
+		HEARTBEAT_JOB("generate_adventure_instances", generate_adventure_instances());
 	}
 	
 	if (HEARTBEAT(5 * SECS_PER_REAL_MIN)) {
-		prune_instances();
-		if (debug_log && HEARTBEAT(15)) { log("debug 24:\t%lld", microtime()); }
-		update_trading_post();
-		if (debug_log && HEARTBEAT(15)) { log("debug 24.5:\t%lld", microtime()); }
+		HEARTBEAT_JOB("prune_instances", prune_instances());
+		HEARTBEAT_JOB("update_trading_post", update_trading_post());
 	}
 	
 	if (HEARTBEAT(SECS_PER_MUD_HOUR)) {
 		if (time_info.hours == 12) {
-			process_imports();
-			if (debug_log && HEARTBEAT(15)) { log("debug 25:\t%lld", microtime()); }
+			HEARTBEAT_JOB("process_imports", process_imports());
 		}
 		// evos happen every hour
-		run_map_evolutions();
-		if (debug_log && HEARTBEAT(15)) { log("debug 26:\t%lld", microtime()); }
+		HEARTBEAT_JOB("run_map_evolutions", run_map_evolutions());
 	}
 	
 	if (HEARTBEAT(1)) {
 		if (data_table_needs_save) {
-			save_data_table(FALSE);
-			if (debug_log && HEARTBEAT(15)) { log("debug 26:\t%lld", microtime()); }
+			HEARTBEAT_JOB("save_data_table", save_data_table(FALSE));
+		}
+		// empires wait while a snapshot child is writing them
+		if (!snapshot_save_running(SNAPSHOT_EMPIRES)) {
+			HEARTBEAT_JOB("save_marked_empires", save_marked_empires());
 		}
-		save_marked_empires();
-		if (debug_log && HEARTBEAT(15)) { log("debug 27:\t%lld", microtime()); }
 	}
 	
 	// this goes roughly last -- update MSDP users
 	if (HEARTBEAT(1)) {
-		msdp_update();
+		HEARTBEAT_JOB("msdp_update", msdp_update());
 	}
 
 	/* Every pulse! Don't want them to stink the place up... */
-	extract_pending_chars();
+	HEARTBEAT_JOB("extract_pending_chars", extract_pending_chars());
 
 	/* Turn this off */
 	gain_cond_messsage = FALSE;
 	
+	// whole-pulse cost (overruns here are pulses that blew the budget)
+	if (whole_pulse_job == NOTHING) {
+		whole_pulse_job = register_heartbeat_job("(whole pulse)");
+	}
+	record_heartbeat_job(whole_pulse_job, microtime() - pulse_start);
+	
 	// check for immediate reboot
 	if (reboot_control.immediate == TRUE) {
 		perform_reboot();
@@ -1587,111 +1807,756 @@ void send_to_room(const char *messg, room_data *room) {
 
 
  //////////////////////////////////////////////////////////////////////////////
-//// SOCKETS /////////////////////////////////////////////////////////////////
+//// HOSTNAME RESOLVER ///////////////////////////////////////////////////////
 
+/**
+* Reverse-DNS lookups for new connections run on background threads so that a
+* slow nameserver can't stall the game. New descriptors keep their numeric IP
+* as their host (with resolving_host set) and their input is held until the
+* name arrives or the lookup times out; then isbanned() runs again on the new
+* name. Recent results are cached by IP.
+*
+* Without thread support, this falls back to a blocking gethostbyaddr().
+*/
 
-void close_socket(descriptor_data *d) {
-	descriptor_data *temp;
+#define HOSTNAME_LOOKUP_TIMEOUT  5	// seconds to hold a new connection's input waiting on its hostname
+#define HOSTNAME_CACHE_TTL  (30 * SECS_PER_REAL_MIN)	// how long to trust a cached lookup
+#define HOSTNAME_CACHE_MAX  2048	// prune the cache when it gets this big
+#define NUM_RESOLVER_THREADS  2	// lookups that can be in flight at once
 
-	REMOVE_FROM_LIST(d, descriptor_list, next);
-	CLOSE_SOCKET(d->descriptor);
-	flush_queues(d);
+// cached IP -> hostname results
+struct hostname_cache_data {
+	char ip[INET_ADDRSTRLEN];	// key: numeric IP
+	char *host;	// resolved name, or NULL if it failed to resolve
+	time_t timestamp;	// when it was looked up
+	
+	UT_hash_handle hh;	// hostname_cache hash handle
+};
+
+// a pending or finished lookup, passed between the game and resolver threads
+struct hostname_lookup_data {
+	char ip[INET_ADDRSTRLEN];	// numeric IP to look up
+	struct in_addr addr;	// same IP, for the lookup
+	char host[NI_MAXHOST];	// result, if found
+	bool found;	// TRUE if host was resolved
+	
+	struct hostname_lookup_data *next;	// linked list
+};
+
+struct hostname_cache_data *hostname_cache = NULL;	// hash by ip
+int hostname_lookups_pending = 0;	// descriptors with resolving_host set
+
+#ifdef EMPIRE_THREADS
+bool resolver_started = FALSE;	// threads are only created on the first lookup
+pthread_mutex_t resolver_lock = PTHREAD_MUTEX_INITIALIZER;	// guards both queues
+pthread_cond_t resolver_wake = PTHREAD_COND_INITIALIZER;	// signals new requests
+struct hostname_lookup_data *resolver_requests = NULL;	// game -> resolver (LL)
+struct hostname_lookup_data *resolver_results = NULL;	// resolver -> game (LL)
+#endif
 
-	/* Forget snooping */
-	if (d->snooping)
-		d->snooping->snoop_by = NULL;
 
-	if (d->snoop_by) {
-		SEND_TO_Q("Your victim is no longer among us.\r\n", d->snoop_by);
-		d->snoop_by->snooping = NULL;
+/**
+* Looks up a cached hostname for an IP.
+*
+* @param const char *ip The numeric IP.
+* @return struct hostname_cache_data* The cache entry, or NULL if none/expired.
+*/
+static struct hostname_cache_data *find_cached_hostname(const char *ip) {
+	struct hostname_cache_data *entry;
+	
+	HASH_FIND_STR(hostname_cache, ip, entry);
+	if (entry && entry->timestamp + HOSTNAME_CACHE_TTL < time(0)) {
+		return NULL;	// too old to trust; it will be replaced on the next lookup
 	}
+	return entry;
+}
 
-	if (d->character) {
-		/*
-		 * Plug memory leak, from Eric Green.
-		 * Note: only free if it's a type that isn't editing a live string -pc
-		 */
-		if (!IS_NPC(d->character) && PLR_FLAGGED(d->character, PLR_MAILING) && d->str) {
-			if (*(d->str)) {
-				free(*(d->str));
-			}
-			free(d->str);
-			d->str = NULL;
-		}
-		if (STATE(d) == CON_PLAYING || STATE(d) == CON_DISCONNECT) {
-			act("$n has lost $s link.", TRUE, d->character, 0, 0, TO_ROOM);
-			if (!IS_NPC(d->character)) {
-				SAVE_CHAR(d->character);
-				syslog(SYS_LOGIN, GET_INVIS_LEV(d->character), TRUE, "Closing link to: %s.", GET_NAME(d->character));
+
+/**
+* Stores a lookup result in the hostname cache.
+*
+* @param const char *ip The numeric IP.
+* @param const char *host The resolved hostname, or NULL if it didn't resolve.
+*/
+static void add_cached_hostname(const char *ip, const char *host) {
+	struct hostname_cache_data *entry, *next_entry;
+	time_t now = time(0);
+	
+	// prune before adding, if we're full
+	if (HASH_COUNT(hostname_cache) >= HOSTNAME_CACHE_MAX) {
+		HASH_ITER(hh, hostname_cache, entry, next_entry) {
+			if (entry->timestamp + HOSTNAME_CACHE_TTL < now || HASH_COUNT(hostname_cache) >= HOSTNAME_CACHE_MAX) {
+				HASH_DEL(hostname_cache, entry);
+				if (entry->host) {
+					free(entry->host);
+				}
+				free(entry);
 			}
-			d->character->desc = NULL;
-		}
-		else {
-			syslog(SYS_LOGIN, 0, TRUE, "Losing player: %s.", GET_NAME(d->character) ? GET_NAME(d->character) : "<null>");
-			free_char(d->character);
 		}
 	}
-	else {
-		if (config_get_bool("log_losing_descriptor_without_char")) {
-			syslog(SYS_LOGIN, 0, TRUE, "Losing descriptor without char.");
-		}
+	
+	HASH_FIND_STR(hostname_cache, ip, entry);
+	if (!entry) {
+		CREATE(entry, struct hostname_cache_data, 1);
+		strncpy(entry->ip, ip, sizeof(entry->ip) - 1);
+		HASH_ADD_STR(hostname_cache, ip, entry);
+	}
+	else if (entry->host) {
+		free(entry->host);
 	}
+	
+	entry->host = host ? str_dup(host) : NULL;
+	entry->timestamp = now;
+}
 
-	/* JE 2/22/95 -- part of my unending quest to make switch stable */
-	if (d->original && d->original->desc)
-		d->original->desc = NULL;
 
-	/* Clear the command history. */
-	if (d->history) {
-		int cnt;
-		for (cnt = 0; cnt < HISTORY_SIZE; cnt++)
-			if (d->history[cnt])
-				free(d->history[cnt]);
-		free(d->history);
+/**
+* Sets a descriptor's final hostname and re-checks bans against it.
+*
+* @param descriptor_data *desc The descriptor that was waiting on its name.
+* @param const char *host The resolved name, or NULL to keep the numeric IP.
+*/
+static void finish_hostname_lookup(descriptor_data *desc, const char *host) {
+	desc->resolving_host = FALSE;
+	--hostname_lookups_pending;
+	
+	if (host && *host) {
+		if (desc->host) {
+			free(desc->host);
+		}
+		desc->host = str_dup(host);
+		
+		if (isbanned(desc->host) == BAN_ALL) {
+			syslog(SYS_LOGIN, 0, FALSE, "Connection attempt denied from [%s]", desc->host);
+			STATE(desc) = CON_CLOSE;
+		}
 	}
+}
 
-	if (d->showstr_head)
-		free(d->showstr_head);
-	if (d->showstr_count)
-		free(d->showstr_vector);
-	if (d->backstr) {
-		free(d->backstr);
+
+#ifdef EMPIRE_THREADS
+
+/**
+* Resolver thread: pulls requests off the queue and does the (possibly slow)
+* lookups. This must not touch any game data.
+*
+* @param void *arg Unused.
+* @return void* Never returns.
+*/
+static void *resolver_thread(void *arg) {
+	struct hostname_lookup_data *req;
+	struct sockaddr_in sa;
+	
+	for (;;) {
+		pthread_mutex_lock(&resolver_lock);
+		while (!resolver_requests) {
+			pthread_cond_wait(&resolver_wake, &resolver_lock);
+		}
+		req = resolver_requests;
+		resolver_requests = req->next;
+		pthread_mutex_unlock(&resolver_lock);
+		
+		memset(&sa, 0, sizeof(sa));
+		sa.sin_family = AF_INET;
+		sa.sin_addr = req->addr;
+		req->found = (getnameinfo((struct sockaddr *) &sa, sizeof(sa), req->host, sizeof(req->host), NULL, 0, NI_NAMEREQD) == 0);
+		
+		pthread_mutex_lock(&resolver_lock);
+		req->next = resolver_results;
+		resolver_results = req;
+		pthread_mutex_unlock(&resolver_lock);
 	}
-	// do NOT free d->str_on_abort (is a pointer to something else)
 	
-	// other strings
-	if (d->host) {
-		free(d->host);
+	return NULL;
+}
+
+
+/**
+* Starts the resolver threads, if they aren't running yet.
+*
+* @return bool TRUE if the resolver is available.
+*/
+static bool start_resolver(void) {
+	pthread_attr_t attr;
+	pthread_t thread;
+	int iter, count = 0;
+	
+	if (resolver_started) {
+		return TRUE;
 	}
-	if (d->last_act_message) {
-		free(d->last_act_message);
+	
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	for (iter = 0; iter < NUM_RESOLVER_THREADS; ++iter) {
+		if (pthread_create(&thread, &attr, resolver_thread, NULL) == 0) {
+			++count;
+		}
 	}
-	if (d->file_storage) {
-		free(d->file_storage);
+	pthread_attr_destroy(&attr);
+	
+	if (count == 0) {
+		log("SYSERR: Unable to start hostname resolver threads; using blocking lookups");
+		return FALSE;
 	}
 	
-	ProtocolDestroy(d->pProtocol);
+	resolver_started = TRUE;
+	return TRUE;
+}
 
-	// OLC_x: olc data
-	if (d->olc_storage) {
-		free(d->olc_storage);
+#endif	/* EMPIRE_THREADS */
+
+
+/**
+* Finds the hostname for a new descriptor. If it's cached (or lookups are
+* disabled), the host is set immediately. Otherwise, desc->host is set to the
+* numeric IP and a background lookup is queued.
+*
+* @param descriptor_data *desc The new descriptor.
+* @param struct in_addr *addr Its peer address.
+*/
+void start_hostname_lookup(descriptor_data *desc, struct in_addr *addr) {
+	struct hostname_cache_data *cached;
+	struct hostent *from;
+	char ip[INET_ADDRSTRLEN];
+#ifdef EMPIRE_THREADS
+	struct hostname_lookup_data *req;
+#endif
+	
+	strncpy(ip, inet_ntoa(*addr), sizeof(ip) - 1);
+	ip[sizeof(ip) - 1] = '\0';
+	desc->host = str_dup(ip);
+	
+	if (config_get_bool("nameserver_is_slow") || is_slow_ip(ip)) {
+		return;	// numeric only
 	}
-	if (d->olc_ability) {
-		free_ability(d->olc_ability);
+	if ((cached = find_cached_hostname(ip))) {
+		if (cached->host) {
+			free(desc->host);
+			desc->host = str_dup(cached->host);
+		}
+		return;
 	}
-	if (d->olc_adventure) {
-		free_adventure(d->olc_adventure);
+	
+#ifdef EMPIRE_THREADS
+	if (start_resolver()) {
+		CREATE(req, struct hostname_lookup_data, 1);
+		strcpy(req->ip, ip);
+		req->addr = *addr;
+		
+		pthread_mutex_lock(&resolver_lock);
+		req->next = resolver_requests;
+		resolver_requests = req;
+		pthread_cond_signal(&resolver_wake);
+		pthread_mutex_unlock(&resolver_lock);
+		
+		desc->resolving_host = TRUE;
+		++hostname_lookups_pending;
+		return;
 	}
-	if (d->olc_archetype) {
-		free_archetype(d->olc_archetype);
+#endif
+	
+	// blocking fallback
+	if ((from = gethostbyaddr((char *) addr, sizeof(*addr), AF_INET))) {
+		add_cached_hostname(ip, from->h_name);
+		free(desc->host);
+		desc->host = str_dup(from->h_name);
 	}
-	if (d->olc_augment) {
-		free_augment(d->olc_augment);
+	else {
+		char buf[MAX_STRING_LENGTH];
+		snprintf(buf, sizeof(buf), "SYSERR: gethostbyaddr [%s]", ip);
+		perror(buf);
+		add_cached_hostname(ip, NULL);
 	}
-	if (d->olc_book) {
-		free_book(d->olc_book);
+}
+
+
+/**
+* Called every pulse: applies finished hostname lookups to any descriptors
+* waiting on them, and gives up on lookups that have taken too long.
+*/
+void check_hostname_lookups(void) {
+	struct hostname_lookup_data *done = NULL, *req;
+	descriptor_data *desc;
+	time_t now;
+	
+#ifdef EMPIRE_THREADS
+	// results may still arrive after a timeout; they go to the cache
+	pthread_mutex_lock(&resolver_lock);
+	done = resolver_results;
+	resolver_results = NULL;
+	pthread_mutex_unlock(&resolver_lock);
+#endif
+	
+	if (!done && hostname_lookups_pending <= 0) {
+		return;	// nothing to do
 	}
-	if (d->olc_craft) {
+	
+	while ((req = done)) {
+		done = req->next;
+		
+		add_cached_hostname(req->ip, req->found ? req->host : NULL);
+		
+		if (!req->found) {
+			log("Unable to resolve hostname for [%s]", req->ip);
+		}
+		
+		// a single lookup may serve several connections from the same IP
+		for (desc = descriptor_list; desc && hostname_lookups_pending > 0; desc = desc->next) {
+			if (desc->resolving_host && !strcmp(desc->host, req->ip)) {
+				finish_hostname_lookup(desc, req->found ? req->host : NULL);
+			}
+		}
+		
+		free(req);
+	}
+	
+	// timeouts: these keep their numeric IP (the cache still fills in later)
+	if (hostname_lookups_pending > 0) {
+		now = time(0);
+		for (desc = descriptor_list; desc; desc = desc->next) {
+			if (desc->resolving_host && desc->login_time + HOSTNAME_LOOKUP_TIMEOUT <= now) {
+				log("Hostname lookup for [%s] timed out", desc->host);
+				finish_hostname_lookup(desc, NULL);
+			}
+		}
+	}
+}
+
+
+ //////////////////////////////////////////////////////////////////////////////
+//// I/O BACKEND /////////////////////////////////////////////////////////////
+
+/**
+* The I/O backend tells game_loop() which sockets are ready, so that it only
+* has to touch descriptors that actually have input or errors pending. The
+* epoll backend is used where available; select() is the fallback. Either way,
+* game_loop() consumes the io_ready list that the backend fills on each poll.
+*/
+
+// one entry per descriptor with pending events, filled by io_backend->poll()
+struct io_ready_data {
+	descriptor_data *desc;	// may be NULL if the desc closed mid-pulse
+	bitvector_t events;	// IO_x
+};
+
+// IO_x: events reported by an I/O backend
+#define IO_READ  BIT(0)	// input (or EOF) is waiting
+#define IO_EXCEPT  BIT(1)	// exceptional condition: close it
+
+// function table for a socket polling backend
+struct io_backend_type {
+	const char *name;
+	bool (*init)(socket_t mother);	// returns FALSE if unavailable
+	void (*add)(descriptor_data *desc);	// start watching a new desc
+	void (*remove)(descriptor_data *desc);	// stop watching a desc
+	int (*poll)(socket_t mother);	// fill io_ready; returns -1 on error
+	bool (*can_write)(descriptor_data *desc);	// safe to flush output now?
+};
+
+struct io_backend_type *io_backend = NULL;	// active backend
+struct io_ready_data *io_ready = NULL;	// ready list from the last poll
+int io_ready_count = 0;	// entries in io_ready
+int io_ready_size = 0;	// allocated size of io_ready
+bool io_mother_ready = FALSE;	// new connection waiting on the mother desc
+
+
+/**
+* Adds a descriptor to the ready list for this poll.
+*
+* @param descriptor_data *desc The ready descriptor.
+* @param bitvector_t events IO_x flags.
+*/
+static void add_io_ready(descriptor_data *desc, bitvector_t events) {
+	if (io_ready_count >= io_ready_size) {
+		io_ready_size = MAX(32, io_ready_size * 2);
+		RECREATE(io_ready, struct io_ready_data, io_ready_size);
+	}
+	
+	io_ready[io_ready_count].desc = desc;
+	io_ready[io_ready_count].events = events;
+	++io_ready_count;
+}
+
+
+/**
+* Removes a closing descriptor from the current ready list, so game_loop()
+* doesn't touch it again after it's freed.
+*
+* @param descriptor_data *desc The descriptor being closed.
+*/
+static void clear_io_ready(descriptor_data *desc) {
+	int iter;
+	
+	for (iter = 0; iter < io_ready_count; ++iter) {
+		if (io_ready[iter].desc == desc) {
+			io_ready[iter].desc = NULL;
+		}
+	}
+}
+
+
+// select() backend: always available
+
+fd_set io_select_input, io_select_output, io_select_exc;
+
+static bool io_select_init(socket_t mother) {
+	FD_ZERO(&io_select_input);
+	FD_ZERO(&io_select_output);
+	FD_ZERO(&io_select_exc);
+	return TRUE;
+}
+
+
+static void io_select_add(descriptor_data *desc) {
+	if (desc->descriptor >= FD_SETSIZE) {
+		log("SYSERR: io_select_add: descriptor %d exceeds FD_SETSIZE (%d); closing", desc->descriptor, FD_SETSIZE);
+		STATE(desc) = CON_CLOSE;
+	}
+}
+
+
+static void io_select_remove(descriptor_data *desc) {
+	if (desc->descriptor < FD_SETSIZE) {
+		FD_CLR(desc->descriptor, &io_select_output);
+	}
+}
+
+
+static int io_select_poll(socket_t mother) {
+	descriptor_data *desc;
+	bitvector_t events;
+	int maxdesc;
+	
+	FD_ZERO(&io_select_input);
+	FD_ZERO(&io_select_output);
+	FD_ZERO(&io_select_exc);
+	FD_SET(mother, &io_select_input);
+
+	maxdesc = mother;
+	for (desc = descriptor_list; desc; desc = desc->next) {
+		if (desc->descriptor >= FD_SETSIZE) {
+			continue;	// logged in io_select_add
+		}
+		if (desc->descriptor > maxdesc) {
+			maxdesc = desc->descriptor;
+		}
+		FD_SET(desc->descriptor, &io_select_input);
+		FD_SET(desc->descriptor, &io_select_output);
+		FD_SET(desc->descriptor, &io_select_exc);
+	}
+	
+	if (select(maxdesc + 1, &io_select_input, &io_select_output, &io_select_exc, &null_time) < 0) {
+		perror("SYSERR: Select poll");
+		return -1;
+	}
+	
+	io_mother_ready = FD_ISSET(mother, &io_select_input) ? TRUE : FALSE;
+	for (desc = descriptor_list; desc; desc = desc->next) {
+		if (desc->descriptor >= FD_SETSIZE) {
+			continue;
+		}
+		
+		events = NOBITS;
+		if (FD_ISSET(desc->descriptor, &io_select_input)) {
+			events |= IO_READ;
+		}
+		if (FD_ISSET(desc->descriptor, &io_select_exc)) {
+			events |= IO_EXCEPT;
+		}
+		if (events) {
+			add_io_ready(desc, events);
+		}
+	}
+	
+	return io_ready_count;
+}
+
+
+static bool io_select_can_write(descriptor_data *desc) {
+	return (desc->descriptor < FD_SETSIZE && FD_ISSET(desc->descriptor, &io_select_output));
+}
+
+
+struct io_backend_type io_select_backend = { "select", io_select_init, io_select_add, io_select_remove, io_select_poll, io_select_can_write };
+
+
+#ifdef HAVE_SYS_EPOLL_H
+
+// epoll backend: only ready descriptors are reported, and there is no FD_SETSIZE limit
+
+#define IO_EPOLL_MAX_EVENTS  256	// events fetched per epoll_wait() call
+
+int io_epoll_fd = -1;
+struct epoll_event io_epoll_events[IO_EPOLL_MAX_EVENTS];
+
+
+static bool io_epoll_init(socket_t mother) {
+	struct epoll_event ev;
+	
+#ifdef EPOLL_CLOEXEC
+	io_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+#else
+	if ((io_epoll_fd = epoll_create(IO_EPOLL_MAX_EVENTS)) >= 0) {
+		fcntl(io_epoll_fd, F_SETFD, FD_CLOEXEC);	// don't leak it across a reboot
+	}
+#endif
+	if (io_epoll_fd < 0) {
+		perror("SYSERR: epoll_create");
+		return FALSE;
+	}
+	
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL;	// NULL indicates the mother desc
+	if (epoll_ctl(io_epoll_fd, EPOLL_CTL_ADD, mother, &ev) < 0) {
+		perror("SYSERR: epoll_ctl mother");
+		close(io_epoll_fd);
+		io_epoll_fd = -1;
+		return FALSE;
+	}
+	
+	return TRUE;
+}
+
+
+static void io_epoll_add(descriptor_data *desc) {
+	struct epoll_event ev;
+	
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN | EPOLLPRI;
+	ev.data.ptr = desc;
+	if (epoll_ctl(io_epoll_fd, EPOLL_CTL_ADD, desc->descriptor, &ev) < 0) {
+		perror("SYSERR: epoll_ctl add");
+		STATE(desc) = CON_CLOSE;
+	}
+}
+
+
+static void io_epoll_remove(descriptor_data *desc) {
+	struct epoll_event ev;	// ignored, but old kernels require non-NULL
+	
+	// closing the socket would also drop it, but not if the fd was dup'd
+	epoll_ctl(io_epoll_fd, EPOLL_CTL_DEL, desc->descriptor, &ev);
+}
+
+
+static int io_epoll_poll(socket_t mother) {
+	descriptor_data *desc;
+	bitvector_t events;
+	int iter, count;
+	
+	do {
+		if ((count = epoll_wait(io_epoll_fd, io_epoll_events, IO_EPOLL_MAX_EVENTS, 0)) < 0) {
+			if (errno == EINTR) {
+				break;	// try again next pulse
+			}
+			perror("SYSERR: epoll_wait");
+			return -1;
+		}
+		
+		for (iter = 0; iter < count; ++iter) {
+			if (!(desc = io_epoll_events[iter].data.ptr)) {
+				io_mother_ready = TRUE;
+				continue;
+			}
+			
+			events = NOBITS;
+			if (io_epoll_events[iter].events & (EPOLLIN | EPOLLHUP)) {
+				events |= IO_READ;	// hangups are detected by the read
+			}
+			if (io_epoll_events[iter].events & (EPOLLPRI | EPOLLERR)) {
+				events |= IO_EXCEPT;
+			}
+			if (events) {
+				add_io_ready(desc, events);
+			}
+		}
+	} while (count == IO_EPOLL_MAX_EVENTS);	// more may be waiting
+	
+	return io_ready_count;
+}
+
+
+// non-blocking writes report a full buffer themselves
+static bool io_epoll_can_write(descriptor_data *desc) {
+	return TRUE;
+}
+
+
+struct io_backend_type io_epoll_backend = { "epoll", io_epoll_init, io_epoll_add, io_epoll_remove, io_epoll_poll, io_epoll_can_write };
+
+#endif	/* HAVE_SYS_EPOLL_H */
+
+
+/**
+* Picks the best available I/O backend and registers the mother descriptor.
+* This must run before any descriptors are created (including reboot
+* recovery).
+*
+* @param socket_t mother The mother descriptor.
+*/
+void io_backend_init(socket_t mother) {
+#ifdef HAVE_SYS_EPOLL_H
+	if (io_epoll_backend.init(mother)) {
+		io_backend = &io_epoll_backend;
+	}
+#endif
+	if (!io_backend) {
+		io_select_backend.init(mother);
+		io_backend = &io_select_backend;
+	}
+	
+	log("Using %s for socket I/O.", io_backend->name);
+}
+
+
+/**
+* Polls the I/O backend (without blocking) and rebuilds the ready list.
+*
+* @param socket_t mother The mother descriptor.
+* @return int The number of ready descriptors, or -1 on a fatal error.
+*/
+int io_backend_poll(socket_t mother) {
+	io_ready_count = 0;
+	io_mother_ready = FALSE;
+	return io_backend->poll(mother);
+}
+
+
+/**
+* Updates the socket I/O timing stats at the end of a pulse.
+*
+* @param unsigned long long usec Microseconds spent in socket I/O this pulse.
+* @param int ready How many descriptors were ready this pulse.
+*/
+void update_io_timing(unsigned long long usec, int ready) {
+	io_timing.last_usec = usec;
+	io_timing.max_usec = MAX(io_timing.max_usec, usec);
+	io_timing.total_usec += usec;
+	io_timing.total_ready += ready;
+	++io_timing.pulses;
+}
+
+
+/**
+* @return const char* The name of the active I/O backend.
+*/
+const char *get_io_backend_name(void) {
+	return io_backend ? io_backend->name : "none";
+}
+
+
+ //////////////////////////////////////////////////////////////////////////////
+//// SOCKETS /////////////////////////////////////////////////////////////////
+
+
+void close_socket(descriptor_data *d) {
+	descriptor_data *temp;
+
+	REMOVE_FROM_LIST(d, descriptor_list, next);
+	io_backend->remove(d);
+	clear_io_ready(d);
+	if (d->resolving_host) {
+		--hostname_lookups_pending;
+	}
+	CLOSE_SOCKET(d->descriptor);
+	flush_queues(d);
+
+	/* Forget snooping */
+	if (d->snooping)
+		d->snooping->snoop_by = NULL;
+
+	if (d->snoop_by) {
+		SEND_TO_Q("Your victim is no longer among us.\r\n", d->snoop_by);
+		d->snoop_by->snooping = NULL;
+	}
+
+	if (d->character) {
+		/*
+		 * Plug memory leak, from Eric Green.
+		 * Note: only free if it's a type that isn't editing a live string -pc
+		 */
+		if (!IS_NPC(d->character) && PLR_FLAGGED(d->character, PLR_MAILING) && d->str) {
+			if (*(d->str)) {
+				free(*(d->str));
+			}
+			free(d->str);
+			d->str = NULL;
+		}
+		if (STATE(d) == CON_PLAYING || STATE(d) == CON_DISCONNECT) {
+			act("$n has lost $s link.", TRUE, d->character, 0, 0, TO_ROOM);
+			if (!IS_NPC(d->character)) {
+				SAVE_CHAR(d->character);
+				syslog(SYS_LOGIN, GET_INVIS_LEV(d->character), TRUE, "Closing link to: %s.", GET_NAME(d->character));
+			}
+			d->character->desc = NULL;
+		}
+		else {
+			syslog(SYS_LOGIN, 0, TRUE, "Losing player: %s.", GET_NAME(d->character) ? GET_NAME(d->character) : "<null>");
+			free_char(d->character);
+		}
+	}
+	else {
+		if (config_get_bool("log_losing_descriptor_without_char")) {
+			syslog(SYS_LOGIN, 0, TRUE, "Losing descriptor without char.");
+		}
+	}
+
+	/* JE 2/22/95 -- part of my unending quest to make switch stable */
+	if (d->original && d->original->desc)
+		d->original->desc = NULL;
+
+	/* Clear the command history. */
+	if (d->history) {
+		int cnt;
+		for (cnt = 0; cnt < HISTORY_SIZE; cnt++)
+			if (d->history[cnt])
+				free(d->history[cnt]);
+		free(d->history);
+	}
+
+	if (d->showstr_head)
+		free(d->showstr_head);
+	if (d->showstr_count)
+		free(d->showstr_vector);
+	if (d->backstr) {
+		free(d->backstr);
+	}
+	// do NOT free d->str_on_abort (is a pointer to something else)
+	
+	// other strings
+	if (d->host) {
+		free(d->host);
+	}
+	if (d->last_act_message) {
+		free(d->last_act_message);
+	}
+	if (d->file_storage) {
+		free(d->file_storage);
+	}
+	
+	ProtocolDestroy(d->pProtocol);
+
+	// OLC_x: olc data
+	if (d->olc_storage) {
+		free(d->olc_storage);
+	}
+	if (d->olc_ability) {
+		free_ability(d->olc_ability);
+	}
+	if (d->olc_adventure) {
+		free_adventure(d->olc_adventure);
+	}
+	if (d->olc_archetype) {
+		free_archetype(d->olc_archetype);
+	}
+	if (d->olc_augment) {
+		free_augment(d->olc_augment);
+	}
+	if (d->olc_book) {
+		free_book(d->olc_book);
+	}
+	if (d->olc_craft) {
 		free_craft(d->olc_craft);
 	}
 	if (d->olc_object) {
@@ -1740,12 +2605,10 @@ void close_socket(descriptor_data *d) {
 
 /* Empty the queues before closing connection */
 void flush_queues(descriptor_data *d) {
+	void free_output_chunks(descriptor_data *d, int bytes);
 	int dummy;
 
-	if (d->large_outbuf) {
-		d->large_outbuf->next = bufpool;
-		bufpool = d->large_outbuf;
-	}
+	free_output_chunks(d, d->output_size);
 	while (get_from_q(&d->input, buf2, &dummy));
 }
 
@@ -1880,15 +2743,14 @@ void init_descriptor(descriptor_data *newd, int desc) {
 	newd->descriptor = desc;
 	newd->connected = CON_GET_NAME;
 	newd->idle_tics = 0;
-	newd->output = newd->small_outbuf;
-	newd->bufspace = SMALL_BUFSIZE - 1;
+	newd->output = newd->output_tail = NULL;
+	newd->output_size = 0;
 	newd->next = descriptor_list;
 	newd->login_time = time(0);
-	*newd->output = '\0';
-	newd->bufptr = 0;
 	newd->has_prompt = 0;
 	
 	newd->save_empire = NOTHING;
+	newd->save_room = NOWHERE;
 
 	CREATE(newd->history, char *, HISTORY_SIZE);
 	newd->pProtocol = ProtocolCreate();
@@ -1915,6 +2777,9 @@ void init_descriptor(descriptor_data *newd, int desc) {
 	} while (desc_num_in_use(last_desc) && last_desc != start);	// prevent infinite loop
 	
 	newd->desc_num = last_desc;
+	
+	// start watching it for input
+	io_backend->add(newd);
 }
 
 
@@ -2089,8 +2954,6 @@ int new_descriptor(int s) {
 	socklen_t i;
 	descriptor_data *newd;
 	struct sockaddr_in peer;
-	struct hostent *from;
-	bool slow_ip;
 
 	/* accept the new connection */
 	i = sizeof(peer);
@@ -2120,27 +2983,17 @@ int new_descriptor(int s) {
 	CREATE(newd, descriptor_data, 1);
 	memset((char *) newd, 0, sizeof(descriptor_data));
 
-	/* find the sitename */
-	slow_ip = config_get_bool("nameserver_is_slow") || is_slow_ip(inet_ntoa(peer.sin_addr));
-	if (slow_ip || !(from = gethostbyaddr((char *) &peer.sin_addr, sizeof(peer.sin_addr), AF_INET))) {
-		/* resolution failed */
-		if (!slow_ip) {
-			char buf[MAX_STRING_LENGTH];
-			snprintf(buf, sizeof(buf), "SYSERR: gethostbyaddr [%s]", inet_ntoa(peer.sin_addr));
-			perror(buf);
-		}
-
-		/* find the numeric site address */
-		newd->host = str_dup((char *)inet_ntoa(peer.sin_addr));
-	}
-	else {
-		newd->host = str_dup(from->h_name);
-	}
+	/* find the sitename (may finish later, in check_hostname_lookups) */
+	start_hostname_lookup(newd, &peer.sin_addr);
 
 	/* determine if the site is banned */
 	if (isbanned(newd->host) == BAN_ALL) {
 		CLOSE_SOCKET(desc);
 		syslog(SYS_LOGIN, 0, FALSE, "Connection attempt denied from [%s]", newd->host);
+		if (newd->resolving_host) {
+			--hostname_lookups_pending;	// the result will just go to the cache
+		}
+		free(newd->host);
 		free(newd);
 		return (0);
 	}
@@ -2259,29 +3112,69 @@ ssize_t perform_socket_read(socket_t desc, char *read_point, size_t space_left)
  * Right now there are two versions of this function: one for Windows,
  * and one for all other platforms.
  */
-/* perform_socket_write for all Non-Windows platforms */
-ssize_t perform_socket_write(socket_t desc, const char *txt, size_t length) {
+/* perform_socket_write for all Non-Windows platforms */
+ssize_t perform_socket_write(socket_t desc, const char *txt, size_t length) {
+	ssize_t result;
+
+	result = write(desc, txt, length);
+
+	if (result > 0) {
+		/* Write was successful. */
+		return (result);
+	}
+
+	if (result == 0) {
+		/* This should never happen! */
+		log("SYSERR: Huh??  write() returned 0???  Please report this!");
+		return (-1);
+	}
+
+	/*
+	 * result < 0, so an error was encountered - is it transient?
+	 * Unfortunately, different systems use different constants to
+	 * indicate this.
+	 */
+
+#ifdef EAGAIN		/* POSIX */
+	if (errno == EAGAIN)
+		return (0);
+#endif
+
+#ifdef EWOULDBLOCK	/* BSD */
+	if (errno == EWOULDBLOCK)
+		return (0);
+#endif
+
+#ifdef EDEADLK		/* Macintosh */
+	if (errno == EDEADLK)
+		return (0);
+#endif
+
+	/* Looks like the error was fatal.  Too bad. */
+	return (-1);
+}
+
+
+/*
+ * perform_socket_writev: like perform_socket_write, but sends several
+ * pieces of text with one writev() call. The return values are the same:
+ * -1 for a fatal error, 0 for a full socket buffer, or the number of bytes
+ * written, which may end partway through any of the pieces.
+ */
+ssize_t perform_socket_writev(socket_t desc, const struct iovec *vec, int count) {
 	ssize_t result;
 
-	result = write(desc, txt, length);
+	result = writev(desc, vec, count);
 
 	if (result > 0) {
-		/* Write was successful. */
 		return (result);
 	}
 
 	if (result == 0) {
-		/* This should never happen! */
-		log("SYSERR: Huh??  write() returned 0???  Please report this!");
+		log("SYSERR: Huh??  writev() returned 0???  Please report this!");
 		return (-1);
 	}
 
-	/*
-	 * result < 0, so an error was encountered - is it transient?
-	 * Unfortunately, different systems use different constants to
-	 * indicate this.
-	 */
-
 #ifdef EAGAIN		/* POSIX */
 	if (errno == EAGAIN)
 		return (0);
@@ -2297,7 +3190,6 @@ ssize_t perform_socket_write(socket_t desc, const char *txt, size_t length) {
 		return (0);
 #endif
 
-	/* Looks like the error was fatal.  Too bad. */
 	return (-1);
 }
 
@@ -2341,7 +3233,7 @@ int process_input(descriptor_data *t) {
 			}
 			
 			snprintf(buffer, sizeof(buffer), "Line too long. Truncated to:\r\n%s\r\n", t->inbuf);
-			if (write_to_descriptor(t->descriptor, buffer) < 0) {
+			if (ProtocolWrite(t, buffer) < 0) {
 				return (-1);
 			}
 			
@@ -2450,7 +3342,7 @@ int process_input(descriptor_data *t) {
 			char buffer[MAX_INPUT_LENGTH + 64];
 
 			sprintf(buffer, "Line too long. Truncated to:\r\n%s\r\n", tmp);
-			if (write_to_descriptor(t->descriptor, buffer) < 0)
+			if (ProtocolWrite(t, buffer) < 0)
 				return (-1);
 		}
 		if (t->snoop_by && *input) {
@@ -2534,58 +3426,174 @@ int process_input(descriptor_data *t) {
 }
 
 
-/* Send all of the output that we've accumulated for a player out to the
- * player's descriptor. 32 byte GARBAGE_SPACE in MAX_SOCK_BUF used for:
- *	 2 bytes: prepended \r\n
- *	14 bytes: overflow message
- *	 2 bytes: extra \r\n for non-comapct
- *      14 bytes: unused */
-static int process_output(descriptor_data *t) {
-	char i[MAX_SOCK_BUF], *osb = i + 2;
-	int result;
-
-	/* we may need this \r\n for later -- see below */
-	strcpy(i, "\r\n");	/* strcpy: OK (for 'MAX_SOCK_BUF >= 3') */
+/**
+* Takes an empty chunk for an output queue from the pool, or makes a new one.
+*
+* @return struct outbuf_chunk* The chunk.
+*/
+static struct outbuf_chunk *get_output_chunk(void) {
+	struct outbuf_chunk *chunk;
+	
+	if ((chunk = outbuf_pool)) {
+		outbuf_pool = chunk->next;
+		--outbuf_pool_size;
+	}
+	else {
+		CREATE(chunk, struct outbuf_chunk, 1);
+		++outbuf_chunks;
+	}
+	
+	chunk->start = chunk->length = 0;
+	chunk->next = NULL;
+	return chunk;
+}
 
-	/* now, append the 'real' output */
-	strcpy(osb, t->output);	/* strcpy: OK (t->output:LARGE_BUFSIZE < osb:MAX_SOCK_BUF-2) */
 
-	/* if we're in the overflow state, notify the user */
-	if (t->bufspace == 0)
-		strcat(osb, "**OVERFLOW**\r\n");	/* strcpy: OK (osb:MAX_SOCK_BUF-2 reserves space) */
+/**
+* Removes text from the front of a descriptor's output queue (because it was
+* sent, or is being thrown away), returning emptied chunks to the pool.
+*
+* @param descriptor_data *d The descriptor.
+* @param int bytes How many bytes to remove.
+*/
+void free_output_chunks(descriptor_data *d, int bytes) {
+	struct outbuf_chunk *chunk;
+	int amt;
+	
+	while ((chunk = d->output)) {
+		amt = MIN(bytes, chunk->length - chunk->start);
+		chunk->start += amt;
+		d->output_size -= amt;
+		bytes -= amt;
+		
+		if (chunk->start < chunk->length) {
+			break;	// partly sent
+		}
+		
+		d->output = chunk->next;
+		if (!d->output) {
+			d->output_tail = NULL;
+		}
+		
+		if (outbuf_pool_size < MAX_OUTBUF_POOL) {
+			chunk->next = outbuf_pool;
+			outbuf_pool = chunk;
+			++outbuf_pool_size;
+		}
+		else {
+			free(chunk);
+			--outbuf_chunks;
+		}
+	}
+	
+	// fully drained: new output is accepted again
+	if (!d->output) {
+		d->output_size = 0;
+		d->output_overflow = FALSE;
+	}
+}
 
-	/* add the extra CRLF if the person isn't in compact mode */
-	if (STATE(t) == CON_PLAYING && t->character && !REAL_NPC(t->character) && !PRF_FLAGGED(t->character, PRF_COMPACT) && !t->pProtocol->WriteOOB)
-		strcat(osb, "\r\n");	/* strcpy: OK (osb:MAX_SOCK_BUF-2 reserves space) */
 
-	// add prompt
-	if (!t->pProtocol->WriteOOB) {
-		char prompt[MAX_STRING_LENGTH];
-		int wantsize;
+/**
+* Adds text to the end of a descriptor's output queue exactly as it is,
+* starting new chunks as needed.
+*
+* @param descriptor_data *d The descriptor.
+* @param const char *txt The text to add.
+* @param int length How many bytes of txt to add.
+*/
+static void queue_output(descriptor_data *d, const char *txt, int length) {
+	struct outbuf_chunk *chunk;
+	int amt;
+	
+	while (length > 0) {
+		if (!(chunk = d->output_tail) || chunk->length >= OUTBUF_CHUNK_SIZE) {
+			chunk = get_output_chunk();
+			if (d->output_tail) {
+				d->output_tail->next = chunk;
+			}
+			else {
+				d->output = chunk;
+			}
+			d->output_tail = chunk;
+		}
 		
-		strcpy(prompt, make_prompt(t));
-		wantsize = strlen(prompt);
-		strncpy(prompt, ProtocolOutput(t, prompt, &wantsize), MAX_STRING_LENGTH);
-		prompt[MAX_STRING_LENGTH-1] = '\0';
-				
-		// force a color code flush
-		snprintf(prompt + strlen(prompt), sizeof(prompt) - strlen(prompt), "%s", flush_reduced_color_codes(t));
-
-		strncat(i, prompt, MAX_PROMPT_LENGTH);
+		amt = MIN(length, OUTBUF_CHUNK_SIZE - chunk->length);
+		memcpy(chunk->text + chunk->length, txt, amt);
+		chunk->length += amt;
+		d->output_size += amt;
+		txt += amt;
+		length -= amt;
 	}
+	
+	d->output_peak = MAX(d->output_peak, d->output_size);
+}
+
+
+/* Send all of the output that we've accumulated for a player out to the
+ * player's descriptor, in a single writev() of the queued chunks. The
+ * overflow notice, the extra CRLF for non-compact mode, and the prompt are
+ * added after the queue, but only once the whole queue fits in the write.
+ * Whatever the socket doesn't take stays queued for the next pass. */
+static int process_output(descriptor_data *t) {
+	char tail[GARBAGE_SPACE + MAX_PROMPT_LENGTH + 1], snoop[MAX_STRING_LENGTH];
+	struct iovec vec[MAX_OUTPUT_IOV + 2];
+	struct outbuf_chunk *chunk;
+	int count = 0, lead = 0, queued = 0, tail_len = 0, sent, amt, snoop_len = 0;
+	int result;
 
-	/* now, send the output.  If this is an 'interruption', use the prepended
-	* CRLF, otherwise send the straight output sans CRLF. */
+	/* If this is an 'interruption', prepend a CRLF, otherwise send the
+	* straight output sans CRLF. */
 	if (t->has_prompt && !t->data_left_to_write && !t->pProtocol->WriteOOB) {
-		t->has_prompt = FALSE;
-		result = write_to_descriptor(t->descriptor, i);
-		if (result >= 2)
-			result -= 2;
+		vec[count].iov_base = (char*) "\r\n";
+		vec[count++].iov_len = lead = 2;
 	}
-	else {
-		t->has_prompt = FALSE;
-		result = write_to_descriptor(t->descriptor, osb);
+	t->has_prompt = FALSE;
+	
+	// the queued output
+	for (chunk = t->output; chunk && count < MAX_OUTPUT_IOV; chunk = chunk->next) {
+		vec[count].iov_base = chunk->text + chunk->start;
+		vec[count++].iov_len = chunk->length - chunk->start;
+		queued += chunk->length - chunk->start;
+	}
+	
+	// anything that goes after the output, if all of it is going now
+	if (!chunk) {
+		*tail = '\0';
+		
+		/* if we're in the overflow state, notify the user */
+		if (t->output_overflow) {
+			strcat(tail, "**OVERFLOW**\r\n");
+		}
+
+		/* add the extra CRLF if the person isn't in compact mode */
+		if (STATE(t) == CON_PLAYING && t->character && !REAL_NPC(t->character) && !PRF_FLAGGED(t->character, PRF_COMPACT) && !t->pProtocol->WriteOOB) {
+			strcat(tail, "\r\n");
+		}
+
+		// add prompt
+		if (!t->pProtocol->WriteOOB) {
+			char prompt[MAX_STRING_LENGTH];
+			int wantsize;
+		
+			strcpy(prompt, make_prompt(t));
+			wantsize = strlen(prompt);
+			strncpy(prompt, ProtocolOutput(t, prompt, &wantsize), MAX_STRING_LENGTH);
+			prompt[MAX_STRING_LENGTH-1] = '\0';
+				
+			// force a color code flush
+			snprintf(prompt + strlen(prompt), sizeof(prompt) - strlen(prompt), "%s", flush_reduced_color_codes(t));
+
+			strncat(tail, prompt, MAX_PROMPT_LENGTH);
+		}
+		
+		if ((tail_len = strlen(tail)) > 0) {
+			vec[count].iov_base = tail;
+			vec[count++].iov_len = tail_len;
+		}
 	}
+	
+	result = ProtocolWritev(t, vec, count);
 
 	if (result < 0) {	/* Oops, fatal error. Bye! */
 		close_socket(t);
@@ -2593,12 +3601,27 @@ static int process_output(descriptor_data *t) {
 	}
 	else if (result == 0)	/* Socket buffer full. Try later. */
 		return (0);
-
-	/* Handle snooping: prepend "% " and send to snooper. */
-	if (t->snoop_by && *t->output) {
+	
+	result = MAX(0, result - lead);
+	sent = MIN(result, queued);
+
+	/* Handle snooping: the snooper sees whatever left the queue this time. */
+	if (t->snoop_by && sent > 0) {
+		for (chunk = t->output; chunk && snoop_len < sent && snoop_len < sizeof(snoop) - 1; chunk = chunk->next) {
+			amt = MIN(chunk->length - chunk->start, sent - snoop_len);
+			amt = MIN(amt, sizeof(snoop) - 1 - snoop_len);
+			memcpy(snoop + snoop_len, chunk->text + chunk->start, amt);
+			snoop_len += amt;
+		}
+		snoop[snoop_len] = '\0';
+	}
+	
+	free_output_chunks(t, sent);
+	
+	if (snoop_len > 0) {
 		char stripped[MAX_STRING_LENGTH];
 		
-		strncpy(stripped, strip_telnet_codes(t->output), MAX_STRING_LENGTH);
+		strncpy(stripped, strip_telnet_codes(snoop), MAX_STRING_LENGTH);
 		stripped[MAX_STRING_LENGTH-1] = '\0';
 		
 		if (*stripped) {
@@ -2609,39 +3632,17 @@ static int process_output(descriptor_data *t) {
 	}
 	
 	/* The common case: all saved output was handed off to the kernel buffer. */
-	if (result >= t->bufptr) {
-		/* If we were using a large buffer, put the large buffer on the buffer pool
-		* and switch back to the small one. */
-		if (t->large_outbuf) {
-			t->large_outbuf->next = bufpool;
-			bufpool = t->large_outbuf;
-			t->large_outbuf = NULL;
-			t->output = t->small_outbuf;
-		}
-		/* reset total bufspace back to that of a small buffer */
-		t->bufspace = SMALL_BUFSIZE - 1;
-		t->bufptr = 0;
-		*(t->output) = '\0';
-
+	if (!t->output) {
+		t->data_left_to_write = FALSE;
+		
 		/* If the overflow message or prompt were partially written, try to save
-		* them. There will be enough space for them if this is true.  'result'
-		* is effectively unsigned here anyway. */
-		if ((unsigned int)result < strlen(osb)) {
-			size_t savetextlen = strlen(osb + result);
-
-			strcat(t->output, osb + result);
-			t->bufptr -= savetextlen;
-			t->bufspace += savetextlen;
+		* them. */
+		if (tail_len > 0 && result - sent < tail_len) {
+			queue_output(t, tail + (result - sent), tail_len - (result - sent));
 		}
-
-		t->data_left_to_write = FALSE;
 	}
 	else {
-		/* Not all data in buffer sent.  result < output buffersize. */
-		strcpy(t->output, t->output + result);	/* strcpy: OK (overlap) */
-		t->bufptr -= result;
-		t->bufspace += result;
-		
+		/* Not all data in buffer sent. */
 		t->data_left_to_write = TRUE;
 	}
 
@@ -2704,67 +3705,56 @@ int write_to_descriptor(socket_t desc, const char *txt) {
 }
 
 
-/* Add a new string to a player's output queue */
+/* Add a new string to a player's output queue. Text is run through the
+ * protocol handler a line or so at a time (it can only expand so much at
+ * once) and added straight to the pooled chunks, so nothing is truncated
+ * until the queue reaches the max_output_buffer limit. */
 void write_to_output(const char *txt, descriptor_data *t) {
-	const char *overflow_txt = "**OVERFLOW**\r\n";
-	int size, wantsize;
-	char protocol_txt[MAX_STRING_LENGTH];
+	const char *protocol_txt;
+	int size, piece, pos, wantsize, limit;
 
 	/* if we're in the overflow state already, ignore this new output */
-	if (t->bufspace == 0)
+	if (t->output_overflow)
 		return;
-
-	size = wantsize = strlen(txt);
-	strncpy(protocol_txt, ProtocolOutput(t, txt, &wantsize), MAX_STRING_LENGTH);
-	protocol_txt[MAX_STRING_LENGTH-1] = '\0';
-	size = wantsize;
-	if (t->pProtocol->WriteOOB > 0) {
-		--t->pProtocol->WriteOOB;
-	}
-
-	/* If exceeding the size of the buffer, truncate it for the overflow message */
-	if (size < 0 || wantsize >= sizeof(protocol_txt)) {
-		size = sizeof(protocol_txt) - 1;
-		strcpy(protocol_txt + size - strlen(overflow_txt), overflow_txt);	/* strcpy: OK */
-	}
 	
-	// check that text size is going to fit into a large bufffer
-	if (size + t->bufptr + 1 > LARGE_BUFSIZE) {
-		size = LARGE_BUFSIZE - t->bufptr - 1;
-		protocol_txt[size] = '\0';
-		++buf_overflows;
-	}
-
-	/* if we have enough space, just write to buffer and that's it! */
-	if (t->bufspace > size) {
-		strcpy(t->output + t->bufptr, protocol_txt);
-		t->bufspace -= size;
-		t->bufptr += size;
-		return;
+	if ((limit = config_get_int("max_output_buffer")) <= 0) {
+		limit = DEFAULT_OUTPUT_LIMIT;
 	}
+	limit *= 1024;
 	
-	++buf_switches;
-
-	/* if the pool has a buffer in it, grab it */
-	if (bufpool != NULL) {
-		t->large_outbuf = bufpool;
-		bufpool = bufpool->next;
-	}
-	else {			/* else create a new one */
-   		CREATE(t->large_outbuf, struct txt_block, 1);
-		CREATE(t->large_outbuf->text, char, LARGE_BUFSIZE);
-		buf_largecount++;
+	if (t->pProtocol->WriteOOB > 0) {
+		--t->pProtocol->WriteOOB;
 	}
-
-	strcpy(t->large_outbuf->text, t->output);	/* copy to big buffer */
-	t->output = t->large_outbuf->text;	/* make big buffer primary */
-	strcat(t->output, protocol_txt);
-
-	/* set the pointer for the next write */
-	t->bufptr = strlen(t->output);
-
-	/* calculate how much space is left in the buffer */
-	t->bufspace = LARGE_BUFSIZE - 1 - t->bufptr;
+	
+	size = strlen(txt);
+	do {
+		// break long text at a newline, or at least not in a color code
+		piece = MIN(size, MAX_OUTPUT_PIECE);
+		if (piece < size) {
+			for (pos = piece; pos > 0 && txt[pos-1] != '\n'; --pos);
+			if (pos > 0) {
+				piece = pos;
+			}
+			else {
+				while (piece > 1 && (txt[piece-1] == COLOUR_CHAR || txt[piece-1] == '\t' || txt[piece-1] == '\033')) {
+					--piece;
+				}
+			}
+		}
+		
+		wantsize = piece;
+		protocol_txt = ProtocolOutput(t, txt, &wantsize);
+		
+		if (t->output_size + wantsize > limit) {
+			t->output_overflow = TRUE;
+			++buf_overflows;
+			return;
+		}
+		
+		queue_output(t, protocol_txt, wantsize);
+		txt += piece;
+		size -= piece;
+	} while (size > 0);
 }
 
 
@@ -3270,6 +4260,314 @@ char *replace_prompt_codes(char_data *ch, char *str) {
 }
 
 
+ //////////////////////////////////////////////////////////////////////////////
+//// SNAPSHOT SAVES //////////////////////////////////////////////////////////
+
+// With the "snapshot_saves" config on, the big saves fork() and let the child
+// write out its copy-on-write snapshot of memory while the game keeps going.
+// Only one snapshot child runs at a time; anything else that wants to write
+// the same files waits for it (see wait_for_snapshot_save).
+
+#define MAX_SNAPSHOT_SECONDS  (5 * SECS_PER_REAL_MIN)	// a child still running after this is killed
+
+static pid_t snapshot_pid = 0;	// child that's saving now, if any
+static bitvector_t snapshot_types = NOBITS;	// SNAPSHOT_x it's saving
+static bitvector_t snapshot_pending = NOBITS;	// SNAPSHOT_x to start when it's done
+static unsigned long long snapshot_started = 0;	// microtime() when it was forked
+static volatile sig_atomic_t snapshot_exited = FALSE;	// set by reap() when it exits
+static volatile int snapshot_status = 0;	// its wait status, once it exits
+static bool snapshot_killed = FALSE;	// TRUE if it ran too long and was killed
+int snapshot_saves_done = 0;	// snapshot children that succeeded (for 'show stats')
+int snapshot_saves_failed = 0;	// ... and ones that didn't
+unsigned long long snapshot_fork_usec = 0;	// how long the last fork() held up the game
+
+// SNAPSHOT_x
+static const char *snapshot_type_names[] = {
+	"world",
+	"empires",
+	"map output",
+	"\n"
+};
+
+
+/**
+* Runs the actual writers for a set of snapshot types. This is what the child
+* does, and it's also the in-process version.
+*
+* @param bitvector_t types SNAPSHOT_x flags.
+* @return bool TRUE if everything was written; FALSE if any file failed.
+*/
+static bool perform_snapshot_saves(bitvector_t types) {
+	bool output_map_to_file();
+	bool save_world_changes();
+	
+	bool ok = TRUE;
+	
+	if (IS_SET(types, SNAPSHOT_WORLD) && !save_world_changes()) {
+		ok = FALSE;
+	}
+	if (IS_SET(types, SNAPSHOT_EMPIRES) && !save_all_empires()) {
+		ok = FALSE;
+	}
+	if (IS_SET(types, SNAPSHOT_MAP_OUTPUT) && !output_map_to_file()) {
+		ok = FALSE;
+	}
+	
+	return ok;
+}
+
+
+/**
+* Saves a set of snapshot types without forking, e.g. after a snapshot child
+* failed. The world save goes through the budgeted job so it won't stall the
+* game; empires are just marked for the normal delayed save.
+*
+* @param bitvector_t types SNAPSHOT_x flags.
+*/
+static void save_snapshot_types_in_process(bitvector_t types) {
+	extern bool need_world_index;
+	extern bool world_map_needs_save;
+	bool output_map_to_file();
+	
+	empire_data *emp, *next_emp;
+	int iter;
+	
+	if (IS_SET(types, SNAPSHOT_WORLD)) {
+		// the parent gave up its dirty flags when it forked, so redo everything
+		for (iter = 0; iter < num_world_blocks; ++iter) {
+			world_blocks[iter].dirty = TRUE;
+		}
+		world_map_needs_save = TRUE;
+		need_world_index = TRUE;
+		
+		if (!save_world_budget.queued) {
+			queue_budget_job(&save_world_budget);
+		}
+	}
+	if (IS_SET(types, SNAPSHOT_EMPIRES)) {
+		HASH_ITER(hh, empire_table, emp, next_emp) {
+			EMPIRE_NEEDS_SAVE(emp) = TRUE;
+		}
+	}
+	if (IS_SET(types, SNAPSHOT_MAP_OUTPUT)) {
+		output_map_to_file();
+	}
+}
+
+
+/**
+* Reports on a snapshot child that has exited, and falls back to in-process
+* saves if it failed. This does not start any pending snapshot.
+*/
+static void finish_snapshot_save(void) {
+	char names[256];
+	int status = snapshot_status;
+	bitvector_t types = snapshot_types;
+	
+	prettier_sprintbit(types, snapshot_type_names, names);
+	
+	snapshot_pid = 0;
+	snapshot_types = NOBITS;
+	snapshot_exited = FALSE;
+	
+	if (!snapshot_killed && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+		++snapshot_saves_done;
+		log("Snapshot save finished: %s in %.2f seconds (fork took %.2f ms)", names, (microtime() - snapshot_started) / 1000000.0, snapshot_fork_usec / 1000.0);
+	}
+	else {
+		++snapshot_saves_failed;
+		if (snapshot_killed) {
+			syslog(SYS_ERROR, LVL_START_IMM, TRUE, "SYSERR: Snapshot save (%s) ran over %d seconds and was killed; saving in-process", names, MAX_SNAPSHOT_SECONDS);
+		}
+		else if (WIFSIGNALED(status)) {
+			syslog(SYS_ERROR, LVL_START_IMM, TRUE, "SYSERR: Snapshot save (%s) died on signal %d; saving in-process", names, WTERMSIG(status));
+		}
+		else {
+			syslog(SYS_ERROR, LVL_START_IMM, TRUE, "SYSERR: Snapshot save (%s) exited with status %d; saving in-process", names, WEXITSTATUS(status));
+		}
+		save_snapshot_types_in_process(types);
+	}
+	
+	snapshot_killed = FALSE;
+}
+
+
+/**
+* Starts a snapshot save in a forked child, if the "snapshot_saves" config is
+* on. If a snapshot is already running, these types are queued to run when it
+* finishes.
+*
+* @param bitvector_t types SNAPSHOT_x flags for what to save.
+* @return bool TRUE if the save was taken care of; FALSE if the caller should save the normal way (snapshots are off, or fork failed).
+*/
+bool start_snapshot_save(bitvector_t types) {
+	extern bool need_world_index;
+	extern bool world_map_needs_save;
+	
+	sigset_t chld, old_mask;
+	unsigned long long start;
+	pid_t pid;
+	
+	if (!types || !config_get_bool("snapshot_saves")) {
+		return FALSE;
+	}
+	if (IS_SET(types, SNAPSHOT_WORLD) && save_world_budget.queued) {
+		return FALSE;	// an in-process world save is already under way
+	}
+	if (snapshot_pid > 0) {
+		SET_BIT(snapshot_pending, types);
+		return TRUE;
+	}
+	
+	// hold SIGCHLD until snapshot_pid is set, so reap() can't miss the child
+	sigemptyset(&chld);
+	sigaddset(&chld, SIGCHLD);
+	sigprocmask(SIG_BLOCK, &chld, &old_mask);
+	
+	start = microtime();
+	pid = fork();
+	
+	if (pid == 0) {
+		// child: write out the frozen copy, then leave without any cleanup
+		descriptor_data *desc;
+		
+		sigprocmask(SIG_SETMASK, &old_mask, NULL);
+		CLOSE_SOCKET(mother_desc);
+		for (desc = descriptor_list; desc; desc = desc->next) {
+			CLOSE_SOCKET(desc->descriptor);	// so players who quit aren't held open by the child
+		}
+		// a nonzero exit makes the parent redo these saves in-process
+		_exit(perform_snapshot_saves(types) ? 0 : 1);
+	}
+	
+	if (pid < 0) {
+		sigprocmask(SIG_SETMASK, &old_mask, NULL);
+		log("SYSERR: Unable to fork for a snapshot save: %s; saving in-process", strerror(errno));
+		return FALSE;
+	}
+	
+	snapshot_fork_usec = microtime() - start;
+	snapshot_pid = pid;
+	snapshot_types = types;
+	snapshot_started = start;
+	snapshot_exited = FALSE;
+	snapshot_killed = FALSE;
+	sigprocmask(SIG_SETMASK, &old_mask, NULL);
+	
+	// the child has these now
+	if (IS_SET(types, SNAPSHOT_WORLD)) {
+		int iter;
+		for (iter = 0; iter < num_world_blocks; ++iter) {
+			world_blocks[iter].dirty = FALSE;
+		}
+		world_map_needs_save = FALSE;
+		need_world_index = FALSE;
+	}
+	if (IS_SET(types, SNAPSHOT_EMPIRES)) {
+		empire_data *emp, *next_emp;
+		HASH_ITER(hh, empire_table, emp, next_emp) {
+			EMPIRE_NEEDS_SAVE(emp) = FALSE;
+		}
+	}
+	
+	return TRUE;
+}
+
+
+/**
+* @param bitvector_t types Any SNAPSHOT_x flags.
+* @return bool TRUE if a snapshot child is writing any of those, or will be once the current one finishes.
+*/
+bool snapshot_save_running(bitvector_t types) {
+	return (snapshot_pid > 0 && IS_SET(snapshot_types | snapshot_pending, types));
+}
+
+
+/**
+* Called every second: reports on a finished snapshot child, kills one that
+* has hung, and starts any snapshot that was waiting for it.
+*/
+void check_snapshot_save(void) {
+	bitvector_t pending;
+	int status;
+	
+	if (snapshot_pid > 0 && !snapshot_exited) {
+		// in case reap() hasn't caught it yet
+		if (waitpid(snapshot_pid, &status, WNOHANG) == snapshot_pid) {
+			snapshot_status = status;
+			snapshot_exited = TRUE;
+		}
+		else if (!snapshot_killed && microtime() - snapshot_started > MAX_SNAPSHOT_SECONDS * 1000000ULL) {
+			kill(snapshot_pid, SIGKILL);
+			snapshot_killed = TRUE;	// reaped on a later call
+		}
+	}
+	
+	if (snapshot_pid > 0 && snapshot_exited) {
+		finish_snapshot_save();
+	}
+	
+	if (snapshot_pid <= 0 && snapshot_pending) {
+		pending = snapshot_pending;
+		snapshot_pending = NOBITS;
+		if (!start_snapshot_save(pending)) {
+			save_snapshot_types_in_process(pending);
+		}
+	}
+}
+
+
+/**
+* Blocks until any running snapshot child finishes. Anything that writes the
+* same files in-process (shutdown, full saves) must call this first. Snapshots
+* that were waiting are marked for in-process saving instead of forking again.
+*
+* A child that is still running at MAX_SNAPSHOT_SECONDS is killed, and its
+* types are saved in-process like any other failed snapshot.
+*/
+void wait_for_snapshot_save(void) {
+	struct timeval poll_wait;
+	bitvector_t pending;
+	int status;
+	pid_t got;
+	
+	while (snapshot_pid > 0 && !snapshot_exited) {
+		got = waitpid(snapshot_pid, &status, snapshot_killed ? 0 : WNOHANG);
+		if (got == snapshot_pid) {
+			snapshot_status = status;
+			snapshot_exited = TRUE;
+		}
+		else if (got < 0 && errno != EINTR) {
+			// reap() got it first (or it's gone): that sets snapshot_exited
+			if (!snapshot_exited) {
+				snapshot_status = 0;
+				snapshot_exited = TRUE;
+			}
+		}
+		else if (got == 0 && microtime() - snapshot_started > MAX_SNAPSHOT_SECONDS * 1000000ULL) {
+			// hung: kill it and block on the next pass until it's reaped
+			kill(snapshot_pid, SIGKILL);
+			snapshot_killed = TRUE;
+		}
+		else if (got == 0) {
+			poll_wait.tv_sec = 0;
+			poll_wait.tv_usec = 10000;
+			empire_sleep(&poll_wait);
+		}
+	}
+	
+	if (snapshot_pid > 0) {
+		finish_snapshot_save();
+	}
+	
+	if (snapshot_pending) {
+		pending = snapshot_pending;
+		snapshot_pending = NOBITS;
+		save_snapshot_types_in_process(pending);
+	}
+}
+
+
  //////////////////////////////////////////////////////////////////////////////
 //// SIGNAL PROCESSING ///////////////////////////////////////////////////////
 
@@ -3282,7 +4580,15 @@ RETSIGTYPE unrestrict_game(int sig) {
 
 /* clean up our zombie kids to avoid defunct processes */
 RETSIGTYPE reap(int sig) {
-	while (waitpid(-1, NULL, WNOHANG) > 0);
+	int status;
+	pid_t pid;
+	
+	while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+		if (pid == snapshot_pid) {
+			snapshot_status = status;
+			snapshot_exited = TRUE;
+		}
+	}
 
 	my_signal(SIGCHLD, reap);
 }
@@ -3383,19 +4689,18 @@ void signal_setup(void) {
 void game_loop(socket_t mother_desc) {
 	void reset_time(void);
 
-	fd_set input_set, output_set, exc_set, null_set;
 	struct timeval last_time, opt_time, process_time, temp_time;
 	struct timeval before_sleep, now, timeout;
 	char comm[MAX_INPUT_LENGTH];
 	descriptor_data *d, *next_d;
-	int missed_pulses, maxdesc, aliased;
+	int missed_pulses, aliased, iter, ready;
+	unsigned long long io_start, io_usec, pulse_usec;
 
 	/* initialize various time values */
 	null_time.tv_sec = 0;
 	null_time.tv_usec = 0;
 	opt_time.tv_usec = OPT_USEC;
 	opt_time.tv_sec = 0;
-	FD_ZERO(&null_set);
 
 	gettimeofday(&last_time, (struct timezone *) 0);
 
@@ -3422,21 +4727,6 @@ void game_loop(socket_t mother_desc) {
 		}
 		*/
 		
-		/* Set up the input, output, and exception sets for select(). */
-		FD_ZERO(&input_set);
-		FD_ZERO(&output_set);
-		FD_ZERO(&exc_set);
-		FD_SET(mother_desc, &input_set);
-
-		maxdesc = mother_desc;
-		for (d = descriptor_list; d; d = d->next) {
-			if (d->descriptor > maxdesc)
-				maxdesc = d->descriptor;
-			FD_SET(d->descriptor, &input_set);
-			FD_SET(d->descriptor, &output_set);
-			FD_SET(d->descriptor, &exc_set);
-		}
-
 		/*
 		 * At this point, we have completed all input, output and heartbeat
 		 * activity from the previous iteration, so we have to put ourselves
@@ -3476,32 +4766,34 @@ void game_loop(socket_t mother_desc) {
 			timediff(&timeout, &last_time, &now);
 		} while (timeout.tv_usec || timeout.tv_sec);
 
-		/* Poll (without blocking) for new input, output, and exceptions */
-		if (select(maxdesc + 1, &input_set, &output_set, &exc_set, &null_time) < 0) {
-			perror("SYSERR: Select poll");
+		/* Poll (without blocking) for new input and exceptions */
+		io_start = microtime();
+		if ((ready = io_backend_poll(mother_desc)) < 0) {
 			return;
 		}
+		
 		/* If there are new connections waiting, accept them. */
-		if (FD_ISSET(mother_desc, &input_set))
+		if (io_mother_ready)
 			new_descriptor(mother_desc);
+		
+		/* Apply any hostnames that finished resolving */
+		check_hostname_lookups();
 
-		/* Kick out the freaky folks in the exception set and marked for close */
-		for (d = descriptor_list; d; d = next_d) {
-			next_d = d->next;
-			if (FD_ISSET(d->descriptor, &exc_set)) {
-				FD_CLR(d->descriptor, &input_set);
-				FD_CLR(d->descriptor, &output_set);
+		/* Kick out the freaky folks in the exception set */
+		for (iter = 0; iter < io_ready_count; ++iter) {
+			if ((d = io_ready[iter].desc) && IS_SET(io_ready[iter].events, IO_EXCEPT)) {
 				close_socket(d);
 			}
 		}
 
 		/* Process descriptors with input pending */
-		for (d = descriptor_list; d; d = next_d) {
-			next_d = d->next;
-			if (FD_ISSET(d->descriptor, &input_set))
+		for (iter = 0; iter < io_ready_count; ++iter) {
+			if ((d = io_ready[iter].desc) && IS_SET(io_ready[iter].events, IO_READ)) {
 				if (process_input(d) < 0)
 					close_socket(d);
+			}
 		}
+		io_usec = microtime() - io_start;
 
 		/* Process commands we just read from process_input */
 		for (d = descriptor_list; d; d = next_d) {
@@ -3519,6 +4811,10 @@ void game_loop(socket_t mother_desc) {
 				if (GET_WAIT_STATE(d->character))
 					continue;
 			}
+			
+			/* Hold login input until we know the hostname (for bans) */
+			if (d->resolving_host)
+				continue;
 
 			if (!get_from_q(&d->input, comm, &aliased))
 				continue;
@@ -3546,9 +4842,17 @@ void game_loop(socket_t mother_desc) {
 		}
 
 		/* Send queued output out to the operating system (ultimately to user). */
+		io_start = microtime();
 		for (d = descriptor_list; d; d = next_d) {
 			next_d = d->next;
-			if (*(d->output) && FD_ISSET(d->descriptor, &output_set)) {
+			
+			// finish sending compressed output the socket couldn't take last time
+			if (d->pProtocol->ZipPendingLength > 0 && io_backend->can_write(d) && ProtocolWrite(d, "") < 0) {
+				close_socket(d);
+				continue;
+			}
+			
+			if (d->output && io_backend->can_write(d)) {
 				/* Output for this player is ready */
 				if (process_output(d) < 0) {
 					// process_output actually kills it itself
@@ -3576,11 +4880,13 @@ void game_loop(socket_t mother_desc) {
 				// force a color code flush
 				snprintf(prompt + strlen(prompt), sizeof(prompt) - strlen(prompt), "%s", flush_reduced_color_codes(d));
 				
-				if (write_to_descriptor(d->descriptor, prompt) >= 0) {
+				if (ProtocolWrite(d, prompt) >= 0) {
 					d->has_prompt = 1;
 				}
 			}
 		}
+		io_usec += microtime() - io_start;
+		update_io_timing(io_usec, ready);
 
 		/* Kick out folks in the CON_CLOSE or CON_DISCONNECT state */
 		for (d = descriptor_list; d; d = next_d) {
@@ -3614,6 +4920,12 @@ void game_loop(socket_t mother_desc) {
 		while (missed_pulses--) {
 			heartbeat(++pulse);
 		}
+		
+		// heavy jobs get whatever is left of the first half of this pulse (or a minimum slice)
+		if (budget_job_queue) {
+			pulse_usec = (unsigned long long) last_time.tv_sec * 1000000 + last_time.tv_usec;
+			run_budget_jobs(MAX(pulse_usec + BUDGET_JOB_USEC, microtime() + BUDGET_JOB_MIN_USEC));
+		}
 
 		/* Update tics_passed for deadlock protection */
 		++tics_passed;
@@ -3635,6 +4947,8 @@ void init_game(ush_int port) {
 		mother_desc = init_socket(port);
 	}
 
+	io_backend_init(mother_desc);
+
 	event_init();
 
 	/* set up hash table for find_char() */
@@ -3650,8 +4964,10 @@ void init_game(ush_int port) {
 
 	log("Entering game loop.");
 	game_loop(mother_desc);
-
+	
+	wait_for_snapshot_save();
 	save_all_players();
+	flush_player_file_writes();
 
 	log("Closing all sockets.");
 	while (descriptor_list)
@@ -3903,11 +5219,11 @@ void reboot_recover(void) {
 		CopyoverSet(d, protocol_info);
 
 		if (!fOld) {
-			write_to_descriptor(desc, "\r\nSomehow, your character couldn't be loaded.\r\n");
+			ProtocolWrite(d, "\r\nSomehow, your character couldn't be loaded.\r\n");
 			close_socket(d);
 		}
 		else {
-			write_to_descriptor(desc, "\033[0mRecovery complete.\r\n\r\n");
+			ProtocolWrite(d, "\033[0mRecovery complete.\r\n\r\n");
 			enter_player_game(d, FALSE, FALSE);
 			d->connected = CON_PLAYING;
 		}
@@ -55,7 +55,10 @@ void act(const char *str, int hide_invisible, char_data *ch, const void *obj, co
 #define TO_COMBAT_MISS  BIT(16)	// is a miss (fightmessages) -- REQUIRES vict_obj is a char
 
 /* I/O functions */
+struct iovec;
 int write_to_descriptor(socket_t desc, const char *txt);
+ssize_t perform_socket_write(socket_t desc, const char *txt, size_t length);
+ssize_t perform_socket_writev(socket_t desc, const struct iovec *vec, int count);
 void write_to_q(const char *txt, struct txt_q *queue, int aliased, bool add_to_head);
 void write_to_output(const char *txt, descriptor_data *d);
 void page_string(descriptor_data *d, char *str, int keep_internal);
@@ -64,8 +67,16 @@ void start_string_editor(descriptor_data *d, char *prompt, char **writeto, size_
 
 #define SEND_TO_Q(messg, desc)  write_to_output((messg), desc)
 
-#define USING_SMALL(d)	((d)->output == (d)->small_outbuf)
-#define USING_LARGE(d)  ((d)->output == (d)->large_outbuf)
+// snapshot saves (forked copies of the game write these)
+#define SNAPSHOT_WORLD  BIT(0)	// changed world blocks, index, instances, map file
+#define SNAPSHOT_EMPIRES  BIT(1)	// all empires and their storage
+#define SNAPSHOT_MAP_OUTPUT  BIT(2)	// output_map_to_file
+
+bool snapshot_save_running(bitvector_t types);
+bool start_snapshot_save(bitvector_t types);
+void check_snapshot_save(void);
+void wait_for_snapshot_save(void);
+
 
 typedef RETSIGTYPE sigfunc(int);
 
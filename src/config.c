@@ -1755,6 +1755,8 @@ void init_config_system(void) {
 	init_config(CONFIG_SYSTEM, "use_autowiz", CONFTYPE_BOOL, "if on, automatically generates the wizlist");
 	init_config(CONFIG_SYSTEM, "siteok_everyone", CONFTYPE_BOOL, "flags players siteok on creation, essentially inverting ban logic");
 	init_config(CONFIG_SYSTEM, "log_losing_descriptor_without_char", CONFTYPE_BOOL, "somewhat spammy disconnect logs");
+	init_config(CONFIG_SYSTEM, "max_output_buffer", CONFTYPE_INT, "KB of output that can queue up for one connection before it overflows (0 = 512)");
+	init_config(CONFIG_SYSTEM, "snapshot_saves", CONFTYPE_BOOL, "if on, the daily world/empire save and map output are written by a forked copy of the game");
 
 	// trade
 	init_config(CONFIG_TRADE, "imports_per_day", CONFTYPE_INT, "how many max items an empire will import per day");
@@ -164,7 +164,7 @@ room_template *room_template_table = NULL;	// hash table of room templates
 // sectors
 sector_data *sector_table = NULL;	// sector hash table
 struct sector_index_type *sector_index = NULL;	// index lists
-struct map_data *last_evo_tile = NULL;	// for resuming map evolutions
+int last_evo_pos = -1;	// position in last_evo_sect's sect_rooms, for resuming map evolutions
 sector_data *last_evo_sect = NULL;	// for resuming map evolutions
 int evos_per_hour = 1;	// how many map tiles evolve per hour (for load-balancing)
 
@@ -217,9 +217,18 @@ room_data *interior_room_list = NULL;	// linked list of interior rooms: room->ne
 bool world_is_sorted = FALSE;	// to prevent unnecessary re-sorts
 bool need_world_index = TRUE;	// used to trigger world index saving (always save at least once)
 struct island_info *island_table = NULL; // hash table for all the islands
-struct map_data world_map[MAP_WIDTH][MAP_HEIGHT];	// master world map
-struct map_data *land_map = NULL;	// linked list of non-ocean
+struct world_map_data world_map;	// master world map
+room_vnum land_map = NOWHERE;	// linked list of non-ocean (world_map.next)
+sector_data **map_sect_table = NULL;	// world_map sector indexes (0 is NULL)
+int map_sect_table_size = 0;	// allocated size of map_sect_table
+crop_data **map_crop_table = NULL;	// world_map crop indexes (0 is NULL)
+int map_crop_table_size = 0;	// allocated size of map_crop_table
 bool world_map_needs_save = TRUE;	// always do at least 1 save
+int map_rooms_loaded = 0;	// number of times load_map_room() built a room (for 'show stats')
+struct world_block_data *world_blocks = NULL;	// save tracking for each world block file
+int num_world_blocks = 0;	// size of world_blocks
+int last_world_save_blocks = 0;	// block files written by the last world save (for 'show stats')
+unsigned long long last_world_save_usec = 0;	// time the last world save spent writing them
 
 
 // DB_BOOT_x
@@ -330,6 +339,7 @@ void boot_db(void) {
 
 	log("Sorting command list.");
 	sort_commands();
+	build_command_trie();
 	
 	// sends own log
 	load_tips_of_the_day();
@@ -404,6 +414,7 @@ void boot_world(void) {
 	void check_newbie_islands();
 	void check_triggers();
 	void clean_empire_logs();
+	void clear_social_trie();
 	void index_boot_world();
 	void init_reputation();
 	void load_daily_quest_file();
@@ -544,6 +555,7 @@ void boot_world(void) {
 	HASH_SRT(sorted_hh, sorted_crafts, sort_crafts_by_data);
 	HASH_SRT(sorted_hh, sorted_skills, sort_skills_by_data);
 	HASH_SRT(sorted_hh, sorted_socials, sort_socials_by_data);
+	clear_social_trie();
 	
 	log("Checking newbie islands.");
 	check_newbie_islands();
@@ -824,7 +836,7 @@ void verify_sectors(void) {
 	HASH_ITER(hh, world_table, room, next_room) {
 		if (!SECT(room)) {
 			// can't use change_terrain() here
-			perform_change_sect(room, NULL, use_sect);
+			perform_change_sect(room, NOWHERE, use_sect);
 		}
 		if (!BASE_SECT(room)) {
 			change_base_sector(room, use_sect);
@@ -1275,7 +1287,7 @@ void index_boot_help(void) {
 
 // this helps find places to number
 struct island_num_data_t {
-	struct map_data *loc;
+	room_vnum loc;	// map tile
 	struct island_num_data_t *next;	// LL
 };
 
@@ -1296,7 +1308,7 @@ struct island_num_data_t *pop_island(void) {
 
 
 // push a location onto the stack
-void push_island(struct map_data *loc) {
+void push_island(room_vnum loc) {
 	struct island_num_data_t *island;
 	CREATE(island, struct island_num_data_t, 1);
 	island->loc = loc;
@@ -1379,18 +1391,18 @@ void check_newbie_islands(void) {
 * Numbers an island and pushes its neighbors onto the stack if they need island
 * ids.
 *
-* @param struct map_data *map A map location.
+* @param room_vnum map A map location.
 * @param int island The island id.
 */
-void number_island(struct map_data *map, int island) {
+void number_island(room_vnum map, int island) {
 	int x, y, new_x, new_y;
-	struct map_data *tile;
+	room_vnum tile;
 	room_data *room;
 	
-	map->island = island;
+	MAP_ISLAND(map) = island;
 	
 	// if there's a real room
-	if ((room = real_real_room(map->vnum))) {
+	if ((room = real_real_room(map))) {
 		SET_ISLAND_ID(room, island);
 	}
 	
@@ -1402,10 +1414,10 @@ void number_island(struct map_data *map, int island) {
 				continue;
 			}
 			
-			if (get_coord_shift(MAP_X_COORD(map->vnum), MAP_Y_COORD(map->vnum), x, y, &new_x, &new_y)) {
-				tile = &(world_map[new_x][new_y]);
+			if (get_coord_shift(MAP_X_COORD(map), MAP_Y_COORD(map), x, y, &new_x, &new_y)) {
+				tile = MAP_TILE(new_x, new_y);
 				
-				if (!SECT_FLAGGED(tile->sector_type, SECTF_NON_ISLAND) && tile->island <= 0) {
+				if (!SECT_FLAGGED(MAP_SECT(tile), SECTF_NON_ISLAND) && MAP_ISLAND(tile) <= 0) {
 					// add to stack
 					push_island(tile);
 				}
@@ -1438,18 +1450,18 @@ void number_and_count_islands(bool reset) {
 	bool re_empire = (top_island_num != -1);
 	struct island_num_data_t *item;
 	struct island_info *isle;
-	struct map_data *map;
+	room_vnum map;
 	room_data *room;
 	int iter, use_id;
 	
 	// find top island id (and reset if requested)
 	top_island_num = -1;
-	for (map = land_map; map; map = map->next) {
-		if (reset || SECT_FLAGGED(map->sector_type, SECTF_NON_ISLAND)) {
-			map->island = NO_ISLAND;
+	for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
+		if (reset || SECT_FLAGGED(MAP_SECT(map), SECTF_NON_ISLAND)) {
+			MAP_ISLAND(map) = NO_ISLAND;
 		}
 		else {
-			top_island_num = MAX(top_island_num, map->island);
+			top_island_num = MAX(top_island_num, MAP_ISLAND(map));
 		}
 	}
 	
@@ -1457,12 +1469,12 @@ void number_and_count_islands(bool reset) {
 	
 	// 1. expand EXISTING islands
 	if (!reset) {
-		for (map = land_map; map; map = map->next) {
-			if (map->island == NO_ISLAND) {
+		for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
+			if (MAP_ISLAND(map) == NO_ISLAND) {
 				continue;
 			}
 			
-			use_id = map->island;
+			use_id = MAP_ISLAND(map);
 			push_island(map);
 			
 			while ((item = pop_island())) {
@@ -1473,8 +1485,8 @@ void number_and_count_islands(bool reset) {
 	}
 	
 	// 2. look for places that have no island id but need one -- and also measure islands while we're here
-	for (map = land_map; map; map = map->next) {
-		if (map->island == NO_ISLAND && !SECT_FLAGGED(map->sector_type, SECTF_NON_ISLAND)) {
+	for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
+		if (MAP_ISLAND(map) == NO_ISLAND && !SECT_FLAGGED(MAP_SECT(map), SECTF_NON_ISLAND)) {
 			use_id = ++top_island_num;
 			push_island(map);
 			
@@ -1484,7 +1496,7 @@ void number_and_count_islands(bool reset) {
 			}
 		}
 		else {
-			use_id = map->island;
+			use_id = MAP_ISLAND(map);
 		}
 		
 		HASH_FIND_INT(list, &use_id, data);
@@ -1500,25 +1512,25 @@ void number_and_count_islands(bool reset) {
 
 		// update helper data
 		data->size += 1;
-		data->sum_x += MAP_X_COORD(map->vnum);
-		data->sum_y += MAP_Y_COORD(map->vnum);
+		data->sum_x += MAP_X_COORD(map);
+		data->sum_y += MAP_Y_COORD(map);
 	
 		// detect edges
-		if (data->edge[NORTH] == NOWHERE || MAP_Y_COORD(map->vnum) > data->edge_val[NORTH]) {
-			data->edge[NORTH] = map->vnum;
-			data->edge_val[NORTH] = MAP_Y_COORD(map->vnum);
+		if (data->edge[NORTH] == NOWHERE || MAP_Y_COORD(map) > data->edge_val[NORTH]) {
+			data->edge[NORTH] = map;
+			data->edge_val[NORTH] = MAP_Y_COORD(map);
 		}
-		if (data->edge[SOUTH] == NOWHERE || MAP_Y_COORD(map->vnum) < data->edge_val[SOUTH]) {
-			data->edge[SOUTH] = map->vnum;
-			data->edge_val[SOUTH] = MAP_Y_COORD(map->vnum);
+		if (data->edge[SOUTH] == NOWHERE || MAP_Y_COORD(map) < data->edge_val[SOUTH]) {
+			data->edge[SOUTH] = map;
+			data->edge_val[SOUTH] = MAP_Y_COORD(map);
 		}
-		if (data->edge[EAST] == NOWHERE || MAP_X_COORD(map->vnum) > data->edge_val[EAST]) {
-			data->edge[EAST] = map->vnum;
-			data->edge_val[EAST] = MAP_X_COORD(map->vnum);
+		if (data->edge[EAST] == NOWHERE || MAP_X_COORD(map) > data->edge_val[EAST]) {
+			data->edge[EAST] = map;
+			data->edge_val[EAST] = MAP_X_COORD(map);
 		}
-		if (data->edge[WEST] == NOWHERE || MAP_X_COORD(map->vnum) < data->edge_val[WEST]) {
-			data->edge[WEST] = map->vnum;
-			data->edge_val[WEST] = MAP_X_COORD(map->vnum);
+		if (data->edge[WEST] == NOWHERE || MAP_X_COORD(map) < data->edge_val[WEST]) {
+			data->edge[WEST] = map;
+			data->edge_val[WEST] = MAP_X_COORD(map);
 		}
 	}
 	
@@ -1958,11 +1970,11 @@ void b3_2_map_and_gear(void) {
 		if (IS_SET(ROOM_AFF_FLAGS(room) | ROOM_BASE_FLAGS(room), ROOM_AFF_PLAYER_MADE)) {
 			// remove the bits
 			REMOVE_BIT(ROOM_AFF_FLAGS(room), ROOM_AFF_PLAYER_MADE);
-			REMOVE_BIT(ROOM_BASE_FLAGS(room), ROOM_AFF_PLAYER_MADE);
+			remove_room_base_flags(room, ROOM_AFF_PLAYER_MADE);
 		
 			// update the natural sector
 			if (GET_ROOM_VNUM(room) < MAP_SIZE) {
-				world_map[FLAT_X_COORD(room)][FLAT_Y_COORD(room)].natural_sector = sector_proto((GET_SECT_VNUM(SECT(room)) == OASIS || GET_SECT_VNUM(SECT(room)) == SANDY_TRENCH) ? climate_default_sector[CLIMATE_ARID] : climate_default_sector[CLIMATE_TEMPERATE]);
+				SET_MAP_NATURAL_SECT(GET_ROOM_VNUM(room), sector_proto((GET_SECT_VNUM(SECT(room)) == OASIS || GET_SECT_VNUM(SECT(room)) == SANDY_TRENCH) ? climate_default_sector[CLIMATE_ARID] : climate_default_sector[CLIMATE_TEMPERATE]));
 				world_map_needs_save = TRUE;
 			}
 		}
@@ -2042,8 +2054,7 @@ void b3_6_einv_fix(void) {
 				total += amt;
 				add_to_empire_storage(emp, store->island, cloth, 4 * amt);
 				add_to_empire_storage(emp, store->island, silver, 2 * amt);
-				LL_DELETE(EMPIRE_STORAGE(emp), store);
-				free(store);
+				delete_storage_entry(emp, store);
 			}
 		}
 		
@@ -2087,31 +2098,31 @@ PLAYER_UPDATE_FUNC(b3_12_update_players) {
 void b3_15_crop_update(void) {
 	extern crop_data *get_potential_crop_for_location(room_data *location);
 	
-	struct map_data *map;
+	room_vnum map;
 	room_data *room;
 	
 	const int SECT_JUNGLE = 28;	// convert jungles at random
 	const int JUNGLE_PERCENT = 5;	// change to change jungle to crop
 	const int SECT_JUNGLE_FIELD = 16;	// sect to use for crop
 	
-	LL_FOREACH(land_map, map) {
+	for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
 		room = NULL;
 		
-		if ((room = real_real_room(map->vnum))) {
+		if ((room = real_real_room(map))) {
 			if (ROOM_OWNER(room)) {
 				continue;	// skip owned tiles
 			}
 		}
 		
-		if (map->crop_type) {
+		if (MAP_CROP(map)) {
 			// update crop
-			if (room || (room = real_room(map->vnum))) {
+			if (room || (room = real_room(map))) {
 				set_crop_type(room, get_potential_crop_for_location(room));
 			}
 		}
-		else if (map->sector_type->vnum == SECT_JUNGLE && number(1, 100) <= JUNGLE_PERCENT) {
+		else if (MAP_SECT(map)->vnum == SECT_JUNGLE && number(1, 100) <= JUNGLE_PERCENT) {
 			// transform jungle
-			if (room || (room = real_room(map->vnum))) {
+			if (room || (room = real_room(map))) {
 				change_terrain(room, SECT_JUNGLE_FIELD);	// picks own crop
 			}
 		}
@@ -2125,16 +2136,16 @@ void b3_15_crop_update(void) {
 void b3_17_road_update(void) {
 	extern struct complex_room_data *init_complex_data();
 	
-	struct map_data *map;
+	room_vnum map;
 	room_data *room;
 	
 	obj_vnum rock_obj = 100;
 	
-	LL_FOREACH(land_map, map) {
-		if (!SECT_FLAGGED(map->sector_type, SECTF_IS_ROAD)) {
+	for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
+		if (!SECT_FLAGGED(MAP_SECT(map), SECTF_IS_ROAD)) {
 			continue;
 		}
-		if (!(room = real_room(map->vnum))) {
+		if (!(room = real_room(map))) {
 			continue;
 		}
 		
@@ -2216,7 +2227,7 @@ void b4_15_building_update(void) {
 	HASH_ITER(hh, world_table, room, next_room) {
 		// add INCOMPLETE aff
 		if (BUILDING_RESOURCES(room) && !IS_DISMANTLING(room)) {
-			SET_BIT(ROOM_BASE_FLAGS(room), ROOM_AFF_INCOMPLETE);
+			set_room_base_flags(room, ROOM_AFF_INCOMPLETE);
 			SET_BIT(ROOM_AFF_FLAGS(room), ROOM_AFF_INCOMPLETE);
 		}
 		
@@ -2591,7 +2602,7 @@ void assign_old_workforce_chore(empire_data *emp, int chore) {
 	void set_workforce_limit(empire_data *emp, int island_id, int chore, int limit);
 	
 	struct trd_type *trd, *next_trd;
-	struct map_data *map;
+	room_vnum map;
 	int last_isle = -1;
 	
 	if (chore < 0 || chore >= NUM_CHORES) {
@@ -2607,10 +2618,10 @@ void assign_old_workforce_chore(empire_data *emp, int chore) {
 		}
 		
 		// only bother if different from the last island found
-		map = &(world_map[MAP_X_COORD(trd->vnum)][MAP_Y_COORD(trd->vnum)]);
-		if (map->island != NO_ISLAND && last_isle != map->island) {
-			set_workforce_limit(emp, map->island, chore, WORKFORCE_UNLIMITED);
-			last_isle = map->island;
+		map = trd->vnum;
+		if (MAP_ISLAND(map) != NO_ISLAND && last_isle != MAP_ISLAND(map)) {
+			set_workforce_limit(emp, MAP_ISLAND(map), chore, WORKFORCE_UNLIMITED);
+			last_isle = MAP_ISLAND(map);
 		}
 	}
 }
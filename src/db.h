@@ -158,6 +158,7 @@
 #define GEOGRAPHIC_MAP_FILE  DATA_DIR"map.txt"	// for map output
 #define POLITICAL_MAP_FILE  DATA_DIR"map-political.txt"	// for political map
 #define CITY_DATA_FILE  DATA_DIR"map-cities.txt"	// for cities on the website
+#define HEARTBEAT_PROFILE_FILE  DATA_DIR"heartbeat-profile.txt"	// periodic heartbeat job timings
 
 // world blocks: the world is split into chunks for saving and updating
 #define WORLD_BLOCK_SIZE  (MAP_WIDTH * 5)	// number of rooms per .wld file
@@ -165,7 +166,9 @@
 #define GET_WORLD_BLOCK(roomvnum)  (roomvnum == NOWHERE ? NOWHERE : (int)(roomvnum / WORLD_BLOCK_SIZE))
 
 // additional files
-#define WORLD_MAP_FILE  LIB_WORLD"base_map"	// storage for the game's base map
+#define WORLD_MAP_FILE  LIB_WORLD"base_map"	// text storage for the game's base map (read if there's no binary one)
+#define WORLD_MAP_BINARY_FILE  LIB_WORLD"base_map.bin"	// binary storage for the game's base map
+#define PLAYER_INDEX_FILE  LIB_PLAYERS"player_index"	// summary of the player table, so boot doesn't load every player
 
 // used for many file reads:
 #define READ_SIZE 256
@@ -320,8 +323,8 @@ void read_empire_members(empire_data *only_empire, bool read_techs);
 void read_empire_territory(empire_data *emp, bool check_tech);
 extern empire_data *real_empire(empire_vnum vnum);
 void reread_empire_tech(empire_data *emp);
-void save_empire(empire_data *e);
-void save_all_empires();
+bool save_empire(empire_data *e);
+bool save_all_empires();
 
 // extra descs
 void free_extra_descs(struct extra_descr_data **list);
@@ -367,6 +370,7 @@ void reset_char(char_data *ch);
 void free_char(char_data *ch);
 void set_title(char_data *ch, char *title);
 
+void flush_player_file_writes(void);
 void save_char(char_data *ch, room_data *load_room);
 #define SAVE_CHAR(ch)  save_char((ch), (IN_ROOM(ch) ? IN_ROOM(ch) : (GET_LOADROOM(ch) != NOWHERE ? real_room(GET_LOADROOM(ch)) : NULL)))
 
@@ -410,9 +414,11 @@ extern room_template *room_template_proto(rmt_vnum vnum);
 extern sector_data *sector_table;
 extern struct sector_index_type *sector_index;
 extern struct sector_index_type *find_sector_index(sector_vnum vnum);
+extern bool map_tile_near_sector(room_vnum tile, sector_vnum sect);
+void evaluate_map_evolutions(struct map_evolution_data *list, int count, unsigned long seed, bool allow_threads);
 void free_sector(struct sector_data *st);
-void perform_change_base_sect(room_data *loc, struct map_data *map, sector_data *sect);
-void perform_change_sect(room_data *loc, struct map_data *map, sector_data *sect);
+void perform_change_base_sect(room_data *loc, room_vnum map, sector_data *sect);
+void perform_change_sect(room_data *loc, room_vnum map, sector_data *sect);
 extern sector_data *sector_proto(sector_vnum vnum);
 
 // skills
@@ -449,10 +455,18 @@ extern struct room_direction_data *create_exit(room_data *from, room_data *to, i
 void delete_room(room_data *room, bool check_exits);
 extern room_data *world_table;
 extern room_data *interior_room_list;
-extern struct map_data world_map[MAP_WIDTH][MAP_HEIGHT];
-extern struct map_data *land_map;
+extern struct world_map_data world_map;
+extern room_vnum land_map;
+extern sector_data **map_sect_table;
+extern crop_data **map_crop_table;
+extern int map_rooms_loaded;
+extern struct world_block_data *world_blocks;
+extern int num_world_blocks;
+extern ush_int map_sect_index(sector_data *st);
+extern ush_int map_crop_index(crop_data *cp);
 room_data *real_real_room(room_vnum vnum);
 room_data *real_room(room_vnum vnum);
+void request_world_save(room_vnum vnum);
 
 // misc
 extern struct obj_apply *copy_obj_apply_list(struct obj_apply *list);
@@ -949,10 +949,17 @@ void remove_crop_from_table(crop_data *crop) {
 * @param crop_data *cp The crop to free.
 */
 void free_crop(crop_data *cp) {
+	extern int map_crop_table_size;
+	
 	crop_data *proto = crop_proto(cp->vnum);
 	struct spawn_info *spawn;
 	struct interaction_item *interact;
 	
+	// release its world_map index (but not if this is an olc copy)
+	if (cp->map_idx > 0 && cp->map_idx < map_crop_table_size && map_crop_table[cp->map_idx] == cp) {
+		map_crop_table[cp->map_idx] = NULL;
+	}
+	
 	if (GET_CROP_NAME(cp) && (!proto || GET_CROP_NAME(cp) != GET_CROP_NAME(proto))) {
 		free(GET_CROP_NAME(cp));
 	}
@@ -1381,7 +1388,7 @@ void delete_empire(empire_data *emp) {
 	// update all vehicles
 	LL_FOREACH_SAFE2(vehicle_list, veh, next_veh, next) {
 		if (VEH_OWNER(veh) == emp) {
-			VEH_OWNER(veh) = NULL;
+			set_vehicle_owner(veh, NULL);
 			VEH_SHIPPING_ID(veh) = -1;
 		}
 		LL_FOREACH(VEH_ANIMALS(veh), vam) {
@@ -1504,12 +1511,18 @@ void free_empire(empire_data *emp) {
 	EMPIRE_ISLANDS(emp) = NULL;
 			
 	// free storage
+	HASH_CLEAR(hh, EMPIRE_STORAGE_HASH(emp));
 	while ((store = emp->store)) {
 		emp->store = store->next;
 		store->next = NULL;
 		free(store);
 	}
 	emp->store = NULL;
+	if (emp->store_by_amount) {
+		free(emp->store_by_amount);
+		emp->store_by_amount = NULL;
+	}
+	emp->store_by_amount_size = 0;
 	
 	// free unique storage
 	while ((eus = EMPIRE_UNIQUE_STORAGE(emp))) {
@@ -1528,6 +1541,7 @@ void free_empire(empire_data *emp) {
 	EMPIRE_SHIPPING_LIST(emp) = NULL;
 	
 	// free cities (while they last)
+	reset_city_coverage(emp);
 	while ((city = emp->city_list)) {
 		if (city->name) {
 			free(city->name);
@@ -1557,6 +1571,7 @@ void free_empire(empire_data *emp) {
 	}
 	
 	// free territory
+	free_territory_indexes(emp);
 	while ((ter = emp->territory_list)) {
 		if (ter == global_next_territory_entry) {
 			global_next_territory_entry = ter->next;
@@ -1636,13 +1651,19 @@ void load_empire_storage_one(FILE *fl, empire_data *emp) {
 				
 				// validate vnum
 				proto = obj_proto(t[0]);
-				if (proto && proto->storage) {
+				if (proto && proto->storage && (store = find_stored_resource(emp, t[2], t[0]))) {
+					// duplicate entry: merge it
+					SAFE_ADD(store->amount, t[1], 0, MAX_STORAGE, FALSE);
+				}
+				else if (proto && proto->storage) {
 					CREATE(store, struct empire_storage_data, 1);
 					store->vnum = t[0];
 					store->amount = t[1];
 					store->island = t[2];
+					store->hash_key = STORAGE_HASH_KEY(store->island, store->vnum);
+					HASH_ADD(hh, EMPIRE_STORAGE_HASH(emp), hash_key, sizeof(store->hash_key), store);
 
-					// at end
+					// at end (to keep the file's order)
 					if (last_store) {
 						last_store->next = store;
 					}
@@ -1650,6 +1671,7 @@ void load_empire_storage_one(FILE *fl, empire_data *emp) {
 						emp->store = store;
 					}
 					last_store = store;
+					EMPIRE_STORAGE_CHANGED(emp);
 				}
 				else if (proto && !proto->storage) {
 					log("- removing %dx #%d from empire storage for %s: not storable", t[1], t[0], EMPIRE_NAME(emp));
@@ -2176,17 +2198,45 @@ void write_empire_storage_to_file(FILE *fl, empire_data *emp) {
 }
 
 
+/**
+* Finishes an empire file that was written to a temp file: closes it and moves
+* it over the real one, unless anything failed.
+*
+* @param FILE *fl The open temp file.
+* @param char *tempname The temp file's name.
+* @param char *fname The real file's name.
+* @return bool TRUE if the file was saved.
+*/
+static bool close_empire_file(FILE *fl, char *tempname, char *fname) {
+	bool failed;
+	
+	fprintf(fl, "$~\n");
+	failed = (ferror(fl) != 0);
+	if (fclose(fl) != 0 || failed || rename(tempname, fname) != 0) {
+		log("SYSERR: Unable to write %s: %s", fname, strerror(errno));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+
 /**
 * Saves an empire to files: main empire file, empire storage file.
 *
 * @param empire_data *emp The empire to save.
+* @return bool TRUE if it saved (or was deferred); FALSE if a file couldn't be written (it stays marked for saving).
 */
-void save_empire(empire_data *emp) {
+bool save_empire(empire_data *emp) {
 	FILE *fl;
 	char fname[30], tempname[64];
 
 	if (!emp) {
-		return;
+		return TRUE;
+	}
+	if (snapshot_save_running(SNAPSHOT_EMPIRES)) {
+		// a snapshot child is writing these files: save it after
+		EMPIRE_NEEDS_SAVE(emp) = TRUE;
+		return TRUE;
 	}
 
 	// main empire file
@@ -2195,12 +2245,14 @@ void save_empire(empire_data *emp) {
 	strcat(tempname, TEMP_SUFFIX);
 	if (!(fl = fopen(tempname, "w"))) {
 		log("SYSERR: Unable to write %s", tempname);
-		return;
+		EMPIRE_NEEDS_SAVE(emp) = TRUE;
+		return FALSE;
 	}
 	write_empire_to_file(fl, emp);
-	fprintf(fl, "$~\n");
-	fclose(fl);
-	rename(tempname, fname);
+	if (!close_empire_file(fl, tempname, fname)) {
+		EMPIRE_NEEDS_SAVE(emp) = TRUE;
+		return FALSE;
+	}
 
 	// empire storage: only if it's already been loaded (saves may trigger sooner)
 	if (emp->storage_loaded) {
@@ -2209,27 +2261,39 @@ void save_empire(empire_data *emp) {
 		strcat(tempname, TEMP_SUFFIX);
 		if (!(fl = fopen(tempname, "w"))) {
 			log("SYSERR: Unable to write %s", tempname);
-			return;
+			EMPIRE_NEEDS_SAVE(emp) = TRUE;
+			return FALSE;
 		}
 		write_empire_storage_to_file(fl, emp);
-		fprintf(fl, "$~\n");
-		fclose(fl);
-		rename(tempname, fname);
+		if (!close_empire_file(fl, tempname, fname)) {
+			EMPIRE_NEEDS_SAVE(emp) = TRUE;
+			return FALSE;
+		}
 	}
 	
 	EMPIRE_NEEDS_SAVE(emp) = FALSE;	// done
+	return TRUE;
 }
 
 
 /**
 * Saves all empires.
+*
+* @return bool TRUE if every empire saved; FALSE if any failed.
 */
-void save_all_empires(void) {
+bool save_all_empires(void) {
 	empire_data *iter, *next_iter;
+	bool ok = TRUE;
+	
+	wait_for_snapshot_save();
 
 	HASH_ITER(hh, empire_table, iter, next_iter) {
-		save_empire(iter);
+		if (!save_empire(iter)) {
+			ok = FALSE;
+		}
 	}
+	
+	return ok;
 }
 
 
@@ -4066,6 +4130,45 @@ void write_resources_to_file(FILE *fl, char letter, struct resource_data *list)
 //// ROOM LIB ////////////////////////////////////////////////////////////////
 
 
+/**
+* Finds the save-tracking entry for a world block, growing world_blocks if
+* needed.
+*
+* @param int block The world block (GET_WORLD_BLOCK).
+* @return struct world_block_data* The entry.
+*/
+static struct world_block_data *get_world_block_data(int block) {
+	int old_size = num_world_blocks;
+	
+	if (block >= num_world_blocks) {
+		num_world_blocks = MAX(block + 1, num_world_blocks * 2);
+		if (world_blocks) {
+			RECREATE(world_blocks, struct world_block_data, num_world_blocks);
+		}
+		else {
+			CREATE(world_blocks, struct world_block_data, num_world_blocks);
+		}
+		memset(world_blocks + old_size, 0, (num_world_blocks - old_size) * sizeof(struct world_block_data));
+	}
+	
+	return world_blocks + block;
+}
+
+
+/**
+* Marks the world block file that holds a room as needing to be written. Any
+* code that changes something write_room_to_file() saves should call this;
+* world saves skip blocks that haven't changed.
+*
+* @param room_vnum vnum The room that changed.
+*/
+void request_world_save(room_vnum vnum) {
+	if (vnum != NOWHERE && vnum >= 0) {
+		get_world_block_data(GET_WORLD_BLOCK(vnum))->dirty = TRUE;
+	}
+}
+
+
 /**
 * Adds a room to any applicable world hash tables.
 *
@@ -4074,6 +4177,9 @@ void write_resources_to_file(FILE *fl, char letter, struct resource_data *list)
 void add_room_to_world_tables(room_data *room) {	
 	HASH_ADD_INT(world_table, vnum, room);
 	
+	// only counted here: rooms being loaded from file don't need a save
+	++get_world_block_data(GET_WORLD_BLOCK(GET_ROOM_VNUM(room)))->rooms;
+	
 	// interior linked list
 	if (GET_ROOM_VNUM(room) >= MAP_SIZE) {
 		room->next_interior = interior_room_list;
@@ -4090,10 +4196,19 @@ void add_room_to_world_tables(room_data *room) {
 * @param room_data *room The room to remove.
 */
 void remove_room_from_world_tables(room_data *room) {
+	struct world_block_data *wbd;
 	room_data *temp;
 	
 	HASH_DEL(world_table, room);
 	
+	wbd = get_world_block_data(GET_WORLD_BLOCK(GET_ROOM_VNUM(room)));
+	--wbd->rooms;
+	
+	// unloaded map rooms were never in the file, so there's nothing to rewrite
+	if (!CAN_UNLOAD_MAP_ROOM(room)) {
+		wbd->dirty = TRUE;
+	}
+	
 	if (room->vnum >= MAP_SIZE) {
 		REMOVE_FROM_LIST(room, interior_room_list, next_interior);
 	}
@@ -4569,7 +4684,7 @@ void write_room_to_file(FILE *fl, room_data *room) {
 * Opens the world file for a specific world block, for writing.
 *
 * @param int block Which world block to open.
-* @return FILE* An open write file. (Game exits on failure.)
+* @return FILE* An open write file, or NULL if it couldn't be opened.
 */
 FILE *open_world_file(int block) {
 	char filename[64];
@@ -4578,8 +4693,7 @@ FILE *open_world_file(int block) {
 	sprintf(filename, "%s%d%s%s", WLD_PREFIX, block, WLD_SUFFIX, TEMP_SUFFIX);
 	
 	if (!(fl = fopen(filename, "w"))) {
-		log("Unable to open: %s", filename);
-		exit(1);
+		log("SYSERR: Unable to open %s: %s", filename, strerror(errno));
 	}
 	
 	return fl;
@@ -4592,13 +4706,15 @@ FILE *open_world_file(int block) {
 *
 * @param FILE *fl A file that was opened with open_world_file().
 * @param int block The world block id passed to that function.
+* @return bool TRUE if the file was written and renamed; FALSE if anything failed (the old file is left alone).
 */
-void save_and_close_world_file(FILE *fl, int block) {
+bool save_and_close_world_file(FILE *fl, int block) {
 	char filename[64], tempname[64];
+	bool failed;
 	
 	if (!fl) {
 		log("SYSERR: No file passed to save_and_close_world_file()");
-		return;
+		return FALSE;
 	}
 	
 	sprintf(filename, "%s%d%s", WLD_PREFIX, block, WLD_SUFFIX);
@@ -4606,8 +4722,12 @@ void save_and_close_world_file(FILE *fl, int block) {
 	strcat(tempname, TEMP_SUFFIX);
 	
 	fprintf(fl, "$~\n");
-	fclose(fl);
-	rename(tempname, filename);
+	failed = (ferror(fl) != 0);
+	if (fclose(fl) != 0 || failed || rename(tempname, filename) != 0) {
+		log("SYSERR: Unable to write %s: %s", filename, strerror(errno));
+		return FALSE;
+	}
+	return TRUE;
 }
 
 
@@ -4944,6 +5064,8 @@ void remove_sector_from_table(sector_data *sect) {
 * @param sector_data *st The sector to free.
 */
 void free_sector(sector_data *st) {
+	extern int map_sect_table_size;
+	
 	struct interaction_item *interact;
 	struct evolution_data *evo;
 	struct spawn_info *spawn;
@@ -4951,6 +5073,11 @@ void free_sector(sector_data *st) {
 	
 	proto = sector_proto(GET_SECT_VNUM(st));
 	
+	// release its world_map index (but not if this is an olc copy)
+	if (st->map_idx > 0 && st->map_idx < map_sect_table_size && map_sect_table[st->map_idx] == st) {
+		map_sect_table[st->map_idx] = NULL;
+	}
+	
 	if (GET_SECT_NAME(st) && (!proto || GET_SECT_NAME(st) != GET_SECT_NAME(proto))) {
 		free(GET_SECT_NAME(st));
 	}
@@ -10,6 +10,8 @@
 *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
 ************************************************************************ */
 
+#define __DB_PLAYER_C__
+
 #include "conf.h"
 #include "sysdep.h"
 
@@ -28,6 +30,8 @@
 *   Getters
 *   Account DB
 *   Core Player DB
+*   Player Index File
+*   Player File Writer
 *   Autowiz Wizlist Generator
 *   Helpers
 *   Empire Player Management
@@ -52,13 +56,21 @@ ACMD(do_slash_channel);
 void update_class(char_data *ch);
 
 // local protos
+void append_player_index_file(player_index_data *index);
+void check_delayed_load(char_data *ch);
+void check_player_file_writes(void);
 void clear_player(char_data *ch);
 void delete_player_character(char_data *ch);
+void free_player_index_data(player_index_data *index);
+static bool get_player_file_stats(char *name, time_t *file_time, long *file_size);
+player_index_data *load_player_index_file(void);
 static bool member_is_timed_out(time_t created, time_t last_login, double played_hours);
+static bool queue_player_file(char_data *ch, int type);
 char_data *read_player_from_file(FILE *fl, char *name, bool normal, char_data *ch);
 int sort_players_by_idnum(player_index_data *a, player_index_data *b);
 int sort_players_by_name(player_index_data *a, player_index_data *b);
 void write_player_delayed_data_to_file(FILE *fl, char_data *ch);
+void write_player_index_file(void);
 void write_player_primary_data_to_file(FILE *fl, char_data *ch);
 
 
@@ -610,8 +622,12 @@ void add_player_to_table(player_index_data *plr) {
 
 
 /**
-* Creates the player index by loading all players from the accounts. This must
-* be run after accounts are loaded, but before the mud boots up.
+* Creates the player index from the accounts. This must be run after accounts
+* (and empires) are loaded, but before the mud boots up.
+*
+* Most players come from the player index file; anybody who is missing from it
+* or whose player file has changed since it was written is loaded from file
+* instead. The player index file is then re-written to match.
 *
 * This also determines:
 *   top_idnum
@@ -619,11 +635,17 @@ void add_player_to_table(player_index_data *plr) {
 */
 void build_player_index(void) {
 	struct account_player *plr, *next_plr, *temp;
+	player_index_data *index, *next_index, *summary_table;
+	int from_summary = 0, from_file = 0;
+	char name[MAX_INPUT_LENGTH];
 	account_data *acct, *next_acct;
-	player_index_data *index;
 	bool has_players;
+	time_t file_time;
+	long file_size;
 	char_data *ch;
 	
+	summary_table = load_player_index_file();
+	
 	HASH_ITER(hh, account_table, acct, next_acct) {
 		acct->last_logon = 0;	// reset
 		
@@ -635,37 +657,63 @@ void build_player_index(void) {
 			next_plr = plr->next;
 			
 			if (!plr->player) {
-				// load the character
-				ch = NULL;
+				// use the summary if it's complete and matches the player file
+				index = NULL;
 				if (plr->name && *plr->name) {
-					ch = load_player(plr->name, FALSE);
+					snprintf(name, sizeof(name), "%s", plr->name);
+					strtolower(name);
+					HASH_FIND(name_hh, summary_table, name, strlen(name), index);
+				}
+				if (index) {
+					HASH_DELETE(name_hh, summary_table, index);
+					if (!index->summary_complete || index->account_id != acct->id || !get_player_file_stats(plr->name, &file_time, &file_size) || file_time != index->file_time || file_size != index->file_size) {
+						free_player_index_data(index);
+						index = NULL;
+					}
+					else {
+						++from_summary;
+					}
 				}
 				
-				// could not load character for this entry
-				if (!ch) {
-					log("SYSERR: Unable to index account player '%s'", plr->name ? plr->name : "???");
-					REMOVE_FROM_LIST(plr, acct->players, next);
-					if (plr->name) {
-						free(plr->name);
+				// stale or missing: load the character
+				if (!index) {
+					ch = NULL;
+					if (plr->name && *plr->name) {
+						ch = load_player(plr->name, FALSE);
+					}
+					
+					// could not load character for this entry
+					if (!ch) {
+						log("SYSERR: Unable to index account player '%s'", plr->name ? plr->name : "???");
+						REMOVE_FROM_LIST(plr, acct->players, next);
+						if (plr->name) {
+							free(plr->name);
+						}
+						free(plr);
+						continue;
 					}
-					free(plr);
-					continue;
+					
+					GET_ACCOUNT(ch) = acct;	// not set by load_player
+					
+					// greatness and techs need the whole character
+					check_delayed_load(ch);
+					affect_total(ch);
+					
+					CREATE(index, player_index_data, 1);
+					update_player_index(index, ch);
+					get_player_file_stats(plr->name, &index->file_time, &index->file_size);
+					++from_file;
+					
+					// unload character
+					free_char(ch);
 				}
 				
 				has_players = TRUE;
-				
-				GET_ACCOUNT(ch) = acct;	// not set by load_player
-				
-				CREATE(index, player_index_data, 1);
-				update_player_index(index, ch);
 				add_player_to_table(index);
 				plr->player = index;
 				
 				// detect top idnum
-				top_idnum = MAX(top_idnum, GET_IDNUM(ch));
-				
-				// unload character
-				free_char(ch);
+				top_idnum = MAX(top_idnum, index->idnum);
 			}
 			
 			// update last logon
@@ -680,6 +728,15 @@ void build_player_index(void) {
 			free_account(acct);
 		}
 	}
+	
+	// anything left over was deleted or renamed
+	HASH_ITER(name_hh, summary_table, index, next_index) {
+		HASH_DELETE(name_hh, summary_table, index);
+		free_player_index_data(index);
+	}
+	
+	log(" %d players indexed, %d of them loaded from player files", from_summary + from_file, from_file);
+	write_player_index_file();
 }
 
 
@@ -707,6 +764,7 @@ void check_delayed_load(char_data *ch) {
 		log("SYSERR: check_delayed_load: Unable to get delayed filename for '%s'", GET_PC_NAME(ch));
 		return;
 	}
+	flush_player_file_writes();
 	if (!(fl = fopen(filename, "r"))) {
 		// non-fatal: delay file does not exist
 		return;
@@ -1006,6 +1064,7 @@ char_data *load_player(char *name, bool normal) {
 		log("SYSERR: load_player: Unable to get player filename for '%s'", name);
 		return NULL;
 	}
+	flush_player_file_writes();
 	if (!(fl = fopen(filename, "r"))) {
 		// no character file exists
 		return NULL;
@@ -1932,16 +1991,15 @@ void remove_player_from_table(player_index_data *plr) {
 
 /*
  * write the vital data of a player to the player file -- this will not save
- * players who are disconnected.
+ * players who are disconnected. The files are written into memory here and
+ * put on disk by the player file writer.
  *
  * @param char_data *ch The player to save.
  * @param room_data *load_room (Optional) The location that the player will reappear on reconnect.
  */
 void save_char(char_data *ch, room_data *load_room) {
-	char filename[256], tempname[256];
 	player_index_data *index;
 	room_data *map;
-	FILE *fl;
 
 	if (IS_NPC(ch)) {
 		return;
@@ -1959,49 +2017,23 @@ void save_char(char_data *ch, room_data *load_room) {
 		}
 	}
 	
-	// PRIMARY data
-	if (!get_filename(GET_PC_NAME(ch), filename, PLR_FILE)) {
-		log("SYSERR: save_char: Unable to get player filename for '%s'", GET_PC_NAME(ch));
-		return;
+	// update the index in case any of this changed (its file stats are updated, and it's saved to the player index file, when the write finishes)
+	if ((index = find_player_index_by_idnum(GET_IDNUM(ch)))) {
+		update_player_index(index, ch);
+		
+		// match the last logon that was written to the file (see write_player_primary_data_to_file)
+		index->last_logon = PLR_FLAGGED(ch, PLR_KEEP_LAST_LOGIN_INFO) ? ch->prev_logon : ch->player.time.logon;
 	}
 	
-	// store to a temp name in order to avoid problems from crashes during save
-	snprintf(tempname, sizeof(tempname), "%s%s", filename, TEMP_SUFFIX);
-	if (!(fl = fopen(tempname, "w"))) {
-		log("SYSERR: save_char: Unable to open '%s' for writing", tempname);
+	// PRIMARY data
+	if (!queue_player_file(ch, PLR_FILE)) {
 		return;
 	}
 	
-	// write it
-	write_player_primary_data_to_file(fl, ch);
-	
-	fclose(fl);
-	rename(tempname, filename);
-	
 	// delayed data?
 	if (!NEEDS_DELAYED_LOAD(ch)) {
-		if (!get_filename(GET_PC_NAME(ch), filename, DELAYED_FILE)) {
-			log("SYSERR: save_char: Unable to get delayed filename for '%s'", GET_PC_NAME(ch));
-			return;
-		}
-	
-		// store to a temp name in order to avoid problems from crashes during save
-		snprintf(tempname, sizeof(tempname), "%s%s", filename, TEMP_SUFFIX);
-		if (!(fl = fopen(tempname, "w"))) {
-			log("SYSERR: save_char: Unable to open '%s' for writing", tempname);
-			return;
-		}
-	
-		// write it
-		write_player_delayed_data_to_file(fl, ch);
-	
-		fclose(fl);
-		rename(tempname, filename);
+		queue_player_file(ch, DELAYED_FILE);
 	}
-	
-	// update the index in case any of this changed
-	index = find_player_index_by_idnum(GET_IDNUM(ch));
-	update_player_index(index, ch);
 }
 
 
@@ -2075,6 +2107,16 @@ void update_player_index(player_index_data *index, char_data *ch) {
 	index->loyalty = GET_LOYALTY(ch);
 	index->rank = GET_RANK(ch);
 	
+	// these are only correct if the whole character is loaded (gear is in the delayed file)
+	if (NEEDS_DELAYED_LOAD(ch)) {
+		index->summary_complete = FALSE;
+	}
+	else {
+		index->greatness = GET_GREATNESS(ch);
+		index->techs = get_player_techs(ch);
+		index->summary_complete = TRUE;
+	}
+	
 	if (ch->desc || ch->prev_host) {
 		if (index->last_host) {
 			free(index->last_host);
@@ -2599,6 +2641,519 @@ void write_player_delayed_data_to_file(FILE *fl, char_data *ch) {
 }
 
 
+ //////////////////////////////////////////////////////////////////////////////
+//// PLAYER INDEX FILE ///////////////////////////////////////////////////////
+
+// The player index file is a summary of every player's index entry, so that
+// the mud can boot without loading every player file. Each save_char() appends
+// a fresh copy of that player's entry; when the file is read, the last entry
+// for each player wins. It's rewritten without the old entries at startup and
+// whenever too many of them pile up.
+
+#define PLAYER_INDEX_COMPACT_MIN  1000	// always allow this many appended entries before rewriting the file
+#define PLAYER_INDEX_COMPACT_MULT  3	// also allow this many appended entries per player
+
+int player_index_file_entries = 0;	// number of entries appended since the last rewrite
+
+
+/**
+* Looks up the modified time and size of a player's primary file, which is how
+* the player index file detects entries that are out of date.
+*
+* @param char *name The player's login name.
+* @param time_t *file_time A place to store the last-modified time.
+* @param long *file_size A place to store the size.
+* @return bool TRUE if the file exists, FALSE if not.
+*/
+static bool get_player_file_stats(char *name, time_t *file_time, long *file_size) {
+	char filename[256];
+	struct stat st;
+	
+	*file_time = 0;
+	*file_size = 0;
+	
+	if (!name || !get_filename(name, filename, PLR_FILE) || stat(filename, &st) < 0) {
+		return FALSE;
+	}
+	
+	*file_time = st.st_mtime;
+	*file_size = (long) st.st_size;
+	return TRUE;
+}
+
+
+/**
+* Writes one player index entry to the player index file. The format is one
+* line of numbers followed by the name and host, and a second line with the
+* full name (which may contain spaces).
+*
+* @param FILE *fl The file to write to.
+* @param player_index_data *index The entry to write.
+*/
+static void write_player_index_entry(FILE *fl, player_index_data *index) {
+	char plr_flags[65], techs[65];
+	
+	strcpy(plr_flags, bitv_to_alpha(index->plr_flags));
+	strcpy(techs, bitv_to_alpha(index->techs));
+	
+	fprintf(fl, "#%d %d %ld %ld %d %d %s %d %d %d %s %d %ld %ld %s %s\n", index->idnum, index->account_id, (long) index->last_logon, (long) index->birth, index->played, index->access_level, plr_flags, index->loyalty ? EMPIRE_VNUM(index->loyalty) : NOTHING, index->rank, index->greatness, techs, index->summary_complete ? 1 : 0, (long) index->file_time, index->file_size, index->name, (index->last_host && *index->last_host) ? index->last_host : "*");
+	fprintf(fl, "%s\n", NULLSAFE(index->fullname));
+}
+
+
+/**
+* Adds a player's current index entry to the end of the player index file.
+* This is called by save_char() after the player file is written. If too many
+* entries have been appended, it rewrites the whole file instead.
+*
+* @param player_index_data *index The entry to save.
+*/
+void append_player_index_file(player_index_data *index) {
+	void write_player_index_file();
+	
+	FILE *fl;
+	
+	if (!index || !index->name) {
+		return;
+	}
+	
+	if (++player_index_file_entries > MAX(PLAYER_INDEX_COMPACT_MIN, PLAYER_INDEX_COMPACT_MULT * HASH_CNT(idnum_hh, player_table_by_idnum))) {
+		write_player_index_file();
+		return;
+	}
+	
+	if (!(fl = fopen(PLAYER_INDEX_FILE, "a"))) {
+		log("SYSERR: append_player_index_file: Unable to open %s for writing", PLAYER_INDEX_FILE);
+		return;
+	}
+	
+	write_player_index_entry(fl, index);
+	fclose(fl);
+}
+
+
+/**
+* Reads the player index file into a temporary table (by name), for use by
+* build_player_index(). When a player has more than one entry, the last one
+* wins. Empires must be loaded first.
+*
+* @return player_index_data* A hash table (using name_hh) of the entries; free these with free_player_index_data().
+*/
+player_index_data *load_player_index_file(void) {
+	player_index_data *table = NULL, *index, *find;
+	char line[MAX_STRING_LENGTH], fullname[MAX_STRING_LENGTH], name[MAX_INPUT_LENGTH], host[MAX_INPUT_LENGTH], plr_flags[65], techs[65];
+	long last_logon, birth, file_time, file_size;
+	int line_num = 0, loyalty, complete;
+	FILE *fl;
+	
+	if (!(fl = fopen(PLAYER_INDEX_FILE, "r"))) {
+		// non-fatal: players will be loaded from their files
+		return NULL;
+	}
+	
+	while (fgets(line, sizeof(line), fl)) {
+		++line_num;
+		if (*line != '#') {
+			continue;	// junk from an interrupted write?
+		}
+		
+		// an interrupted write can leave a partial entry: that player will just be loaded from file
+		CREATE(index, player_index_data, 1);
+		if (sscanf(line + 1, "%d %d %ld %ld %d %d %64s %d %d %d %64s %d %ld %ld %1023s %1023s", &index->idnum, &index->account_id, &last_logon, &birth, &index->played, &index->access_level, plr_flags, &loyalty, &index->rank, &index->greatness, techs, &complete, &file_time, &file_size, name, host) != 16) {
+			log("SYSERR: Bad entry in %s at line %d", PLAYER_INDEX_FILE, line_num);
+			free(index);
+			continue;
+		}
+		if (!fgets(fullname, sizeof(fullname), fl) || *fullname == '#') {
+			// missing the 2nd line: can't safely continue reading
+			log("SYSERR: Bad entry in %s at line %d", PLAYER_INDEX_FILE, line_num);
+			free(index);
+			break;
+		}
+		++line_num;
+		
+		if (*fullname && fullname[strlen(fullname) - 1] == '\n') {
+			fullname[strlen(fullname) - 1] = '\0';
+		}
+		
+		index->last_logon = last_logon;
+		index->birth = birth;
+		index->plr_flags = asciiflag_conv(plr_flags);
+		index->loyalty = real_empire(loyalty);
+		index->techs = asciiflag_conv(techs);
+		index->summary_complete = complete ? TRUE : FALSE;
+		index->file_time = file_time;
+		index->file_size = file_size;
+		index->name = str_dup(name);
+		strtolower(index->name);
+		index->fullname = str_dup(fullname);
+		index->last_host = strcmp(host, "*") ? str_dup(host) : NULL;
+		
+		// replace any older entry
+		HASH_FIND(name_hh, table, index->name, strlen(index->name), find);
+		if (find) {
+			HASH_DELETE(name_hh, table, find);
+			free_player_index_data(find);
+		}
+		HASH_ADD_KEYPTR(name_hh, table, index->name, strlen(index->name), index);
+	}
+	
+	fclose(fl);
+	return table;
+}
+
+
+/**
+* Saves the whole player table to the player index file, replacing any
+* appended entries.
+*/
+void write_player_index_file(void) {
+	player_index_data *index, *next_index;
+	char tempname[256];
+	FILE *fl;
+	
+	snprintf(tempname, sizeof(tempname), "%s%s", PLAYER_INDEX_FILE, TEMP_SUFFIX);
+	if (!(fl = fopen(tempname, "w"))) {
+		log("SYSERR: write_player_index_file: Unable to open %s for writing", tempname);
+		return;
+	}
+	
+	HASH_ITER(idnum_hh, player_table_by_idnum, index, next_index) {
+		write_player_index_entry(fl, index);
+	}
+	
+	fclose(fl);
+	rename(tempname, PLAYER_INDEX_FILE);
+	
+	player_index_file_entries = 0;
+}
+
+
+ //////////////////////////////////////////////////////////////////////////////
+//// PLAYER FILE WRITER //////////////////////////////////////////////////////
+
+// save_char() writes player files into memory, on the game thread, and queues
+// them here; a writer thread puts them on disk (temp file, fsync, rename) so
+// the game doesn't wait on the disk. Finished writes come back to the game
+// thread (check_player_file_writes) to update the player index. Anything that
+// reads, renames, or deletes player files must call flush_player_file_writes()
+// first. Without threads, the files are written immediately.
+
+#define PLAYER_SAVE_ROTATION  (5 * SECS_PER_REAL_MIN)	// each connected player is saved this often
+
+// a player file that's been written to memory and is waiting for the disk
+struct player_file_write_data {
+	char filename[256];	// final name; it's written to filename + TEMP_SUFFIX first
+	char *data;	// the whole file
+	size_t length;	// bytes in data
+	int idnum;	// player to update in the index when it's done (primary files only; otherwise NOTHING)
+	unsigned long long queued;	// microtime() when it was queued
+	
+	// set by the writer
+	int error;	// errno if it failed, otherwise 0
+	time_t file_time;	// last-modified time of the finished file
+	long file_size;	// size of the finished file
+	unsigned long long written;	// microtime() when it finished
+	
+	struct player_file_write_data *next;	// queue
+};
+
+int player_writes_queued = 0;	// waiting for the writer now
+int player_writes_queued_max = 0;	// most that have ever waited at once
+int player_writes_done = 0;	// finished (including failures)
+int player_writes_failed = 0;	// ... failures
+unsigned long long player_write_usec_total = 0;	// queued-to-finished time of all finished writes
+unsigned long long player_write_usec_max = 0;	// ... and the longest
+
+static struct player_file_write_data *player_write_results = NULL, *player_write_results_tail = NULL;	// writer -> game
+
+#ifdef EMPIRE_THREADS
+static bool player_writer_started = FALSE;	// the thread is only created on the first save
+static bool player_writer_busy = FALSE;	// TRUE while it has a write out of the queue
+static pthread_mutex_t player_writer_lock = PTHREAD_MUTEX_INITIALIZER;	// guards both queues and player_writer_busy
+static pthread_cond_t player_writer_wake = PTHREAD_COND_INITIALIZER;	// signals new writes
+static pthread_cond_t player_writer_idle = PTHREAD_COND_INITIALIZER;	// signals an empty queue
+static struct player_file_write_data *player_write_queue = NULL, *player_write_queue_tail = NULL;	// game -> writer
+#endif
+
+
+/**
+* Puts one queued file on disk. This runs on the writer thread, so it must not
+* touch any game data (or log).
+*
+* @param struct player_file_write_data *wr The file to write.
+*/
+static void perform_player_file_write(struct player_file_write_data *wr) {
+	char tempname[256 + 16];
+	struct stat st;
+	FILE *fl;
+	
+	snprintf(tempname, sizeof(tempname), "%s%s", wr->filename, TEMP_SUFFIX);
+	
+	if (!(fl = fopen(tempname, "w"))) {
+		wr->error = errno;
+	}
+	else {
+		if (fwrite(wr->data, 1, wr->length, fl) != wr->length || fflush(fl) != 0 || fsync(fileno(fl)) != 0) {
+			wr->error = errno ? errno : EIO;
+		}
+		if (fclose(fl) != 0 && !wr->error) {
+			wr->error = errno;
+		}
+		
+		// the old file is only replaced if the new one is complete
+		if (!wr->error && rename(tempname, wr->filename) < 0) {
+			wr->error = errno;
+		}
+		if (!wr->error && stat(wr->filename, &st) == 0) {
+			wr->file_time = st.st_mtime;
+			wr->file_size = (long) st.st_size;
+		}
+	}
+	
+	wr->written = microtime();
+}
+
+
+/**
+* Adds a finished write to the results for check_player_file_writes(). On the
+* threaded version, the caller must hold player_writer_lock.
+*
+* @param struct player_file_write_data *wr The finished write.
+*/
+static void add_player_write_result(struct player_file_write_data *wr) {
+	wr->next = NULL;
+	if (player_write_results_tail) {
+		player_write_results_tail->next = wr;
+	}
+	else {
+		player_write_results = wr;
+	}
+	player_write_results_tail = wr;
+}
+
+
+#ifdef EMPIRE_THREADS
+
+/**
+* Writer thread: writes queued player files in the order they were queued.
+*
+* @param void *arg Unused.
+* @return void* Never returns.
+*/
+static void *player_writer_thread(void *arg) {
+	struct player_file_write_data *wr;
+	
+	for (;;) {
+		pthread_mutex_lock(&player_writer_lock);
+		while (!player_write_queue) {
+			pthread_cond_wait(&player_writer_wake, &player_writer_lock);
+		}
+		wr = player_write_queue;
+		if (!(player_write_queue = wr->next)) {
+			player_write_queue_tail = NULL;
+		}
+		player_writer_busy = TRUE;
+		pthread_mutex_unlock(&player_writer_lock);
+		
+		perform_player_file_write(wr);
+		
+		pthread_mutex_lock(&player_writer_lock);
+		add_player_write_result(wr);
+		player_writer_busy = FALSE;
+		if (!player_write_queue) {
+			pthread_cond_broadcast(&player_writer_idle);
+		}
+		pthread_mutex_unlock(&player_writer_lock);
+	}
+	
+	return NULL;
+}
+
+
+/**
+* Starts the writer thread, if it isn't running yet.
+*
+* @return bool TRUE if the writer is available.
+*/
+static bool start_player_writer(void) {
+	pthread_attr_t attr;
+	pthread_t thread;
+	
+	if (player_writer_started) {
+		return TRUE;
+	}
+	
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	player_writer_started = (pthread_create(&thread, &attr, player_writer_thread, NULL) == 0);
+	pthread_attr_destroy(&attr);
+	
+	if (!player_writer_started) {
+		log("SYSERR: Unable to start the player file writer thread; saving players directly");
+	}
+	return player_writer_started;
+}
+
+#endif	/* EMPIRE_THREADS */
+
+
+/**
+* Hands a player file to the writer (or writes it now, if there's no writer).
+*
+* @param struct player_file_write_data *wr The file to write; the writer takes it over.
+*/
+static void queue_player_file_write(struct player_file_write_data *wr) {
+	wr->queued = microtime();
+	wr->next = NULL;
+	
+	if (++player_writes_queued > player_writes_queued_max) {
+		player_writes_queued_max = player_writes_queued;
+	}
+	
+#ifdef EMPIRE_THREADS
+	if (start_player_writer()) {
+		pthread_mutex_lock(&player_writer_lock);
+		if (player_write_queue_tail) {
+			player_write_queue_tail->next = wr;
+		}
+		else {
+			player_write_queue = wr;
+		}
+		player_write_queue_tail = wr;
+		pthread_cond_signal(&player_writer_wake);
+		pthread_mutex_unlock(&player_writer_lock);
+		return;
+	}
+#endif
+	
+	// no writer
+	perform_player_file_write(wr);
+	add_player_write_result(wr);
+	check_player_file_writes();
+}
+
+
+/**
+* Writes one of a player's files into memory and queues it for the writer.
+*
+* @param char_data *ch The player to save.
+* @param int type PLR_FILE or DELAYED_FILE.
+* @return bool TRUE if it was queued, FALSE if it couldn't be written.
+*/
+static bool queue_player_file(char_data *ch, int type) {
+	struct player_file_write_data *wr;
+	FILE *fl;
+	
+	CREATE(wr, struct player_file_write_data, 1);
+	wr->idnum = (type == PLR_FILE ? GET_IDNUM(ch) : NOTHING);
+	
+	if (!get_filename(GET_PC_NAME(ch), wr->filename, type)) {
+		log("SYSERR: save_char: Unable to get %s filename for '%s'", (type == PLR_FILE ? "player" : "delayed"), GET_PC_NAME(ch));
+		free(wr);
+		return FALSE;
+	}
+	if (!(fl = open_memstream(&wr->data, &wr->length))) {
+		log("SYSERR: save_char: Unable to open memory stream for '%s': %s", wr->filename, strerror(errno));
+		free(wr);
+		return FALSE;
+	}
+	
+	if (type == PLR_FILE) {
+		write_player_primary_data_to_file(fl, ch);
+	}
+	else {
+		write_player_delayed_data_to_file(fl, ch);
+	}
+	fclose(fl);	// sets data/length
+	
+	queue_player_file_write(wr);
+	return TRUE;
+}
+
+
+/**
+* Called every second (and by the flush): reports finished player file writes
+* and updates the player index for them.
+*/
+void check_player_file_writes(void) {
+	struct player_file_write_data *done, *wr;
+	player_index_data *index;
+	unsigned long long usec;
+	
+#ifdef EMPIRE_THREADS
+	pthread_mutex_lock(&player_writer_lock);
+#endif
+	done = player_write_results;
+	player_write_results = player_write_results_tail = NULL;
+#ifdef EMPIRE_THREADS
+	pthread_mutex_unlock(&player_writer_lock);
+#endif
+	
+	while ((wr = done)) {
+		done = wr->next;
+		
+		--player_writes_queued;
+		++player_writes_done;
+		usec = wr->written - wr->queued;
+		player_write_usec_total += usec;
+		player_write_usec_max = MAX(player_write_usec_max, usec);
+		
+		if (wr->error) {
+			++player_writes_failed;
+			log("SYSERR: save_char: Unable to write '%s': %s", wr->filename, strerror(wr->error));
+		}
+		else if (wr->idnum != NOTHING && (index = find_player_index_by_idnum(wr->idnum))) {
+			// save it to the player index file so the next boot doesn't have to load this player
+			index->file_time = wr->file_time;
+			index->file_size = wr->file_size;
+			append_player_index_file(index);
+		}
+		
+		free(wr->data);
+		free(wr);
+	}
+}
+
+
+/**
+* Waits until every queued player file is on disk. Call this before reading,
+* renaming, or deleting player files, and before the mud exits.
+*/
+void flush_player_file_writes(void) {
+#ifdef EMPIRE_THREADS
+	if (player_writer_started) {
+		pthread_mutex_lock(&player_writer_lock);
+		while (player_write_queue || player_writer_busy) {
+			pthread_cond_wait(&player_writer_idle, &player_writer_lock);
+		}
+		pthread_mutex_unlock(&player_writer_lock);
+	}
+#endif
+	
+	check_player_file_writes();
+}
+
+
+/**
+* Called every second: saves the connected players whose turn it is, so each
+* one is saved every PLAYER_SAVE_ROTATION seconds but they aren't all saved on
+* the same pulse.
+*/
+void save_players_in_rotation(void) {
+	static int slot = 0;
+	descriptor_data *desc;
+	
+	slot = (slot + 1) % PLAYER_SAVE_ROTATION;
+	
+	for (desc = descriptor_list; desc; desc = desc->next) {
+		if (STATE(desc) == CON_PLAYING && desc->character && !IS_NPC(desc->character) && GET_IDNUM(desc->character) % PLAYER_SAVE_ROTATION == slot) {
+			SAVE_CHAR(desc->character);
+		}
+	}
+}
+
+
  //////////////////////////////////////////////////////////////////////////////
 //// AUTOWIZ WIZLIST GENERATOR ///////////////////////////////////////////////
 
@@ -3164,7 +3719,8 @@ void delete_player_character(char_data *ch) {
 		free_player_index_data(index);
 	}
 	
-	// various file deletes
+	// various file deletes (after any saves that are still being written)
+	flush_player_file_writes();
 	if (get_filename(GET_NAME(ch), filename, PLR_FILE)) {
 		if (remove(filename) < 0 && errno != ENOENT) {
 			log("SYSERR: deleting player file %s: %s", filename, strerror(errno));
@@ -4037,11 +4593,13 @@ void read_empire_members(empire_data *only_empire, bool read_techs) {
 	bool should_delete_empire(empire_data *emp);
 	
 	struct empire_member_reader_data *account_list = NULL, *emrd;
+	int access_level, account_id, greatness, played;
 	player_index_data *index, *next_index;
 	empire_data *e, *emp, *next_emp;
+	bitvector_t techs;
+	bool timed_out;
 	char_data *ch;
 	time_t logon;
-	bool is_file;
 
 	HASH_ITER(hh, empire_table, emp, next_emp) {
 		if (!only_empire || emp == only_empire) {
@@ -4059,21 +4617,44 @@ void read_empire_members(empire_data *only_empire, bool read_techs) {
 			continue;
 		}
 		
-		// new way of loading data
-		if ((ch = find_or_load_player(index->name, &is_file))) {
-			check_delayed_load(ch);
-			affect_total(ch);
+		// players in-game are read live
+		if ((ch = is_playing(index->idnum))) {
+			e = GET_LOYALTY(ch);
+			logon = time(0);
+			access_level = GET_ACCESS_LEVEL(ch);
+			account_id = GET_ACCOUNT(ch)->id;
+			greatness = GET_GREATNESS(ch);
+			played = ch->player.time.played;
+			techs = get_player_techs(ch);
+			timed_out = FALSE;
+		}
+		else {
+			// the index has everything else, unless it was saved without the player's delayed data
+			if (!index->summary_complete && (ch = load_player(index->name, TRUE))) {
+				check_delayed_load(ch);
+				affect_total(ch);
+				update_player_index(index, ch);
+				free_char(ch);
+			}
+			
+			e = index->loyalty;
+			logon = index->last_logon;
+			access_level = index->access_level;
+			account_id = index->account_id;
+			greatness = index->greatness;
+			played = index->played;
+			techs = index->techs;
+			timed_out = member_is_timed_out_index(index);
 		}
 		
-		// check ch for empire traits
-		if (ch && (e = GET_LOYALTY(ch))) {
+		// check for empire traits
+		if (e) {
 			// record last-logon whether or not timed out
-			logon = is_file ? ch->prev_logon : time(0);
 			if (logon > EMPIRE_LAST_LOGON(e)) {
 				EMPIRE_LAST_LOGON(e) = logon;
 			}
 
-			if (GET_ACCESS_LEVEL(ch) >= LVL_GOD) {
+			if (access_level >= LVL_GOD) {
 				EMPIRE_IMM_ONLY(e) = 1;
 			}
 			
@@ -4081,21 +4662,17 @@ void read_empire_members(empire_data *only_empire, bool read_techs) {
 			EMPIRE_TOTAL_MEMBER_COUNT(e) += 1;
 			
 			// only count players who have logged on in recent history
-			if (!is_file || !member_is_timed_out_ch(ch)) {
-				add_to_account_list(&account_list, e, GET_ACCOUNT(ch)->id, GET_GREATNESS(ch));
+			if (!timed_out) {
+				add_to_account_list(&account_list, e, account_id, greatness);
 				
 				// not account-restricted
-				EMPIRE_TOTAL_PLAYTIME(e) += (ch->player.time.played / SECS_PER_REAL_HOUR);
+				EMPIRE_TOTAL_PLAYTIME(e) += (played / SECS_PER_REAL_HOUR);
 
 				if (read_techs) {
-					adjust_abilities_to_empire(ch, e, TRUE);
+					adjust_techs_to_empire(techs, e, TRUE);
 				}
 			}
 		}
-		
-		if (ch && is_file) {
-			free_char(ch);
-		}
 	}
 	
 	// now apply the best from each account, and clear out the list
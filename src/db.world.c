@@ -10,6 +10,8 @@
 *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
 ************************************************************************ */
 
+#define __DB_WORLD_C__
+
 #include <math.h>
 
 #include "conf.h"
@@ -45,9 +47,24 @@ extern const sector_vnum climate_default_sector[NUM_CLIMATES];
 extern bool need_world_index;
 extern const int rev_dir[];
 extern bool world_map_needs_save;
-extern struct map_data *last_evo_tile;
+extern int last_evo_pos;
 extern sector_data *last_evo_sect;
 extern int evos_per_hour;
+extern int last_world_save_blocks;
+extern unsigned long long last_world_save_usec;
+
+
+// evolution passes: big passes are evaluated on this many threads
+#define NUM_EVOLUTION_THREADS  4
+#define MIN_THREADED_EVOLUTIONS  2048	// smaller passes aren't worth the threads
+#define EVOLUTION_RANDOM_MOD  2147483647	// modulus of empire_random_r()
+
+// one evolution worker's share of a pass
+struct evolution_batch_data {
+	struct map_evolution_data *list;
+	int start, end;	// range of the list to evaluate
+	unsigned long seed;	// random seed for the pass
+};
 
 
 // external funcs
@@ -55,14 +72,15 @@ void add_room_to_world_tables(room_data *room);
 extern struct resource_data *combine_resources(struct resource_data *combine_a, struct resource_data *combine_b);
 void complete_building(room_data *room);
 void delete_territory_entry(empire_data *emp, struct empire_territory_data *ter);
+unsigned long empire_random();
+unsigned long empire_random_r(unsigned long *state);
 extern struct complex_room_data *init_complex_data();
 void free_complex_data(struct complex_room_data *bld);
 extern FILE *open_world_file(int block);
 void remove_room_from_world_tables(room_data *room);
-void save_and_close_world_file(FILE *fl, int block);
+bool save_and_close_world_file(FILE *fl, int block);
 void setup_start_locations();
 void sort_exits(struct room_direction_data **list);
-void sort_world_table();
 void write_room_to_file(FILE *fl, room_data *room);
 
 // locals
@@ -75,7 +93,7 @@ void grow_crop(room_data *room);
 void init_room(room_data *room, room_vnum vnum);
 void naturalize_newbie_islands();
 void ruin_one_building(room_data *room);
-void save_world_map_to_file();
+bool save_world_map_to_file();
 extern int sort_empire_islands(struct empire_island *a, struct empire_island *b);
 void update_island_names();
 void update_tavern(room_data *room);
@@ -99,7 +117,7 @@ void change_base_sector(room_data *room, sector_data *sect) {
 	}
 	
 	// TODO there is a 90% chance change_base_sector can be completely replaced by this:
-	perform_change_base_sect(room, NULL, sect);
+	perform_change_base_sect(room, NOWHERE, sect);
 }
 
 
@@ -148,7 +166,7 @@ void change_terrain(room_data *room, sector_vnum sect) {
 	void lock_icon(room_data *room, struct icon_data *use_icon);
 	
 	sector_data *old_sect = SECT(room), *st = sector_proto(sect);
-	struct map_data *map, *temp;
+	room_vnum map, temp;
 	crop_data *new_crop = NULL;
 	empire_data *emp;
 	
@@ -171,8 +189,8 @@ void change_terrain(room_data *room, sector_vnum sect) {
 	}
 	
 	// change sect
-	perform_change_sect(room, NULL, st);
-	perform_change_base_sect(room, NULL, st);
+	perform_change_sect(room, NOWHERE, st);
+	perform_change_base_sect(room, NOWHERE, st);
 		
 	// need room data?
 	if ((IS_ANY_BUILDING(room) || IS_ADVENTURE_ROOM(room)) && !COMPLEX_DATA(room)) {
@@ -208,16 +226,23 @@ void change_terrain(room_data *room, sector_vnum sect) {
 	
 	// need land-map update?
 	if (st != old_sect) {
-		map = &(world_map[FLAT_X_COORD(room)][FLAT_Y_COORD(room)]);
+		map = GET_ROOM_VNUM(room);
 		if (GET_SECT_VNUM(old_sect) == BASIC_OCEAN) {
 			// add to land_map (at the start is fine)
-			map->next = land_map;
+			MAP_NEXT_LAND(map) = land_map;
 			land_map = map;
 		}
 		else if (GET_SECT_VNUM(st) == BASIC_OCEAN) {
-			// remove from land_map
-			REMOVE_FROM_LIST(map, land_map, next);
-			// do NOT free map -- it's a pointer to something in world_map
+			// remove from land_map (leaves its own 'next' intact for anybody iterating)
+			if (land_map == map) {
+				land_map = MAP_NEXT_LAND(map);
+			}
+			else {
+				for (temp = land_map; temp != NOWHERE && MAP_NEXT_LAND(temp) != map; temp = MAP_NEXT_LAND(temp));
+				if (temp != NOWHERE) {
+					MAP_NEXT_LAND(temp) = MAP_NEXT_LAND(map);
+				}
+			}
 		}
 	}
 	
@@ -247,6 +272,11 @@ struct room_direction_data *create_exit(room_data *from, room_data *to, int dir,
 		return NULL;
 	}
 	
+	request_world_save(GET_ROOM_VNUM(from));
+	if (back && to) {
+		request_world_save(GET_ROOM_VNUM(to));
+	}
+	
 	if (!(ex = find_exit(from, dir)) && COMPLEX_DATA(from)) {
 		CREATE(ex, struct room_direction_data, 1);
 		ex->dir = dir;
@@ -322,6 +352,7 @@ room_data *create_room(void) {
 	// only if saveable
 	if (!CAN_UNLOAD_MAP_ROOM(room)) {
 		need_world_index = TRUE;
+		request_world_save(GET_ROOM_VNUM(room));
 	}
 	
 	return room;
@@ -713,7 +744,7 @@ void untrench_room(room_data *room) {
 	void stop_room_action(room_data *room, int action, int chore);
 	
 	sector_data *to_sect = NULL;
-	struct map_data *map;
+	room_vnum map;
 	
 	if (!ROOM_SECT_FLAGGED(room, SECTF_IS_TRENCH) || GET_ROOM_VNUM(room) >= MAP_SIZE) {
 		return;
@@ -723,10 +754,10 @@ void untrench_room(room_data *room) {
 	stop_room_action(room, ACT_FILLING_IN, NOTHING);
 	stop_room_action(room, ACT_EXCAVATING, NOTHING);
 	
-	map = &(world_map[FLAT_X_COORD(room)][FLAT_Y_COORD(room)]);
-	if (SECT(room) !=  map->natural_sector) {
+	map = GET_ROOM_VNUM(room);
+	if (SECT(room) !=  MAP_NATURAL_SECT(map)) {
 		// return to nature
-		to_sect = map->natural_sector;
+		to_sect = MAP_NATURAL_SECT(map);
 	}
 	else {
 		// de-evolve sect
@@ -751,9 +782,11 @@ void set_crop_type(room_data *room, crop_data *cp) {
 	}
 	
 	ROOM_CROP(room) = cp;
+	request_world_save(GET_ROOM_VNUM(room));
 	if (GET_ROOM_VNUM(room) < MAP_SIZE) {
-		world_map[FLAT_X_COORD(room)][FLAT_Y_COORD(room)].crop_type = cp;
+		SET_MAP_CROP(GET_ROOM_VNUM(room), cp);
 		world_map_needs_save = TRUE;
+		invalidate_map_icon(GET_ROOM_VNUM(room));
 	}
 }
 
@@ -763,94 +796,240 @@ void set_crop_type(room_data *room, crop_data *cp) {
 
 /**
 * Save a fresh index file for the world.
+*
+* @return bool TRUE if the index saved (or didn't need to); FALSE if it couldn't be written.
 */
-void save_world_index(void) {
+bool save_world_index(void) {
 	char filename[64], tempfile[64];
-	room_data *iter, *next_iter;
-	room_vnum vnum;
-	int this, last;
+	bool failed;
+	int block;
 	FILE *fl;
 	
 	// we only need this if the size of the world changed
 	if (!need_world_index) {
-		return;
+		return TRUE;
 	}
 	
-	sort_world_table();
-	
 	sprintf(filename, "%s%s", WLD_PREFIX, INDEX_FILE);
 	strcpy(tempfile, filename);
 	strcat(tempfile, TEMP_SUFFIX);
 	
 	if (!(fl = fopen(tempfile, "w"))) {
 		syslog(SYS_ERROR, LVL_START_IMM, TRUE, "SYSERR: Unable to write index file '%s': %s", filename, strerror(errno));
-		return;
+		return FALSE;
 	}
 	
-	last = -1;
-	HASH_ITER(hh, world_table, iter, next_iter) {
-		vnum = GET_ROOM_VNUM(iter);
-		this = GET_WORLD_BLOCK(vnum);
-		
-		if (this != last) {
-			fprintf(fl, "%d%s\n", this, WLD_SUFFIX);
-			last = this;
+	// every block that has rooms, in order
+	for (block = 0; block < num_world_blocks; ++block) {
+		if (world_blocks[block].rooms > 0) {
+			fprintf(fl, "%d%s\n", block, WLD_SUFFIX);
 		}
 	}
 	
 	fprintf(fl, "$\n");
-	fclose(fl);
+	failed = (ferror(fl) != 0);
 	
 	// and move the temp file over
-	rename(tempfile, filename);
+	if (fclose(fl) != 0 || failed || rename(tempfile, filename) != 0) {
+		syslog(SYS_ERROR, LVL_START_IMM, TRUE, "SYSERR: Unable to write index file '%s': %s", filename, strerror(errno));
+		return FALSE;
+	}
 	need_world_index = FALSE;
+	return TRUE;
 }
 
 
 /**
-* Executes a full-world save.
+* Writes one world block file, from the live world table, and marks it as
+* saved. Blocks with no rooms in memory are not written at all.
+*
+* @param int block The world block to save.
+* @return int 1 if a file was written, 0 if there was nothing to write, or -1 if the write failed (the block stays marked).
 */
-void save_whole_world(void) {
-	void save_instances();
-	
-	room_data *iter, *next_iter;
-	room_vnum vnum;
-	int block, last;
+int save_world_block(int block) {
+	room_vnum vnum, first = block * WORLD_BLOCK_SIZE;
+	room_data *room;
 	FILE *fl = NULL;
 	
-	last = -1;
+	if (block < 0 || block >= num_world_blocks) {
+		return 0;
+	}
 	
-	// must sort first
-	sort_world_table();
+	// clear this first, in case anything changes it during the save
+	world_blocks[block].dirty = FALSE;
 	
-	HASH_ITER(hh, world_table, iter, next_iter) {
-		vnum = GET_ROOM_VNUM(iter);
-		block = GET_WORLD_BLOCK(vnum);
-		
-		if (block != last || !fl) {
-			if (fl) {
-				save_and_close_world_file(fl, last);
-				fl = NULL;
-			}
-			fl = open_world_file(block);
-			last = block;
+	if (world_blocks[block].rooms <= 0) {
+		return 0;
+	}
+	
+	for (vnum = first; vnum < first + WORLD_BLOCK_SIZE; ++vnum) {
+		if (!(room = real_real_room(vnum))) {
+			continue;
+		}
+		if (!fl && !(fl = open_world_file(block))) {
+			world_blocks[block].dirty = TRUE;
+			return -1;
 		}
 		
 		// only save a room at all if it couldn't be unloaded
-		if (!CAN_UNLOAD_MAP_ROOM(iter)) {
-			write_room_to_file(fl, iter);
+		if (!CAN_UNLOAD_MAP_ROOM(room)) {
+			write_room_to_file(fl, room);
 		}
 	}
 	
-	// cleanup
 	if (fl) {
-		save_and_close_world_file(fl, last);
+		if (!save_and_close_world_file(fl, block)) {
+			world_blocks[block].dirty = TRUE;
+			return -1;
+		}
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+* Most room changes happen through player commands (including string editors
+* that finish later) and workforce chores, which are too scattered to mark
+* one by one. So before a world save, the blocks of any room with a player or
+* an empire mob in it are marked for saving too.
+*/
+static void request_occupied_world_saves(void) {
+	char_data *ch;
+	
+	for (ch = character_list; ch; ch = ch->next) {
+		if (IN_ROOM(ch) && (!IS_NPC(ch) || MOB_FLAGGED(ch, MOB_EMPIRE))) {
+			request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
+		}
 	}
+}
+
+
+/**
+* Executes a full-world save: every block file is written, whether or not it
+* changed. This is used on shutdown and by anything that changes the world
+* without marking it.
+*/
+void save_whole_world(void) {
+	bool save_instances();
+	
+	unsigned long long start;
+	int block, count = 0;
+	
+	wait_for_snapshot_save();
+	start = microtime();
+	
+	for (block = 0; block < num_world_blocks; ++block) {
+		if (save_world_block(block) > 0) {
+			++count;
+		}
+	}
+	
+	last_world_save_blocks = count;
+	last_world_save_usec = microtime() - start;
+	
+	// ensure this
+	save_world_index();
+	save_instances();
+	save_world_map_to_file();
+}
+
+
+/**
+* Saves only the world blocks that have changed since they were last written
+* (see request_world_save), plus the index, instances, and map file.
+*
+* @return bool TRUE if everything saved; FALSE if any file couldn't be written.
+*/
+bool save_world_changes(void) {
+	bool save_instances();
+	
+	unsigned long long start;
+	int block, result, count = 0;
+	bool ok = TRUE;
+	
+	wait_for_snapshot_save();
+	request_occupied_world_saves();
+	start = microtime();
+	
+	for (block = 0; block < num_world_blocks; ++block) {
+		if (world_blocks[block].dirty) {
+			if ((result = save_world_block(block)) > 0) {
+				++count;
+			}
+			else if (result < 0) {
+				ok = FALSE;
+			}
+		}
+	}
+	
+	last_world_save_blocks = count;
+	last_world_save_usec = microtime() - start;
+	
+	if (!save_world_index()) {
+		ok = FALSE;
+	}
+	if (!save_instances()) {
+		ok = FALSE;
+	}
+	if (!save_world_map_to_file()) {
+		ok = FALSE;
+	}
+	return ok;
+}
+
+
+/**
+* Budgeted version of save_world_changes(), for the daily save. Each call
+* saves changed blocks until it runs out of time, so a block file is never
+* left open between pulses. The index, instances, and map file are saved last.
+*
+* @param bool start TRUE on the first call of a new save.
+* @param unsigned long long deadline microtime() to stop by.
+* @return bool TRUE when the save is finished.
+*/
+BUDGET_JOB(save_whole_world_job) {
+	bool save_instances();
+	
+	static int block = 0, saved = 0;
+	static unsigned long long spent = 0;
+	unsigned long long call_start;
+	int count = 0;
+	
+	if (start) {
+		request_occupied_world_saves();
+		block = saved = 0;
+		spent = 0;
+		return FALSE;
+	}
+	
+	call_start = microtime();
+	while (block < num_world_blocks) {
+		if (count > 0 && microtime() >= deadline) {
+			spent += microtime() - call_start;
+			return FALSE;
+		}
+		if (world_blocks[block].dirty && save_world_block(block) > 0) {
+			++count;
+			++saved;
+		}
+		++block;
+	}
+	spent += microtime() - call_start;
+	
+	// the rest gets a pulse of its own
+	if (count > 0) {
+		return FALSE;
+	}
+	
+	last_world_save_blocks = saved;
+	last_world_save_usec = spent;
 	
 	// ensure this
 	save_world_index();
 	save_instances();
 	save_world_map_to_file();
+	return TRUE;
 }
 
 
@@ -945,6 +1124,7 @@ void annual_update_map_tile(room_data *room) {
 		
 		// apply damage
 		COMPLEX_DATA(room)->damage += dmg;
+		request_world_save(GET_ROOM_VNUM(room));
 		
 		// apply maintenance resources (if any, and if it's not being dismantled)
 		if (GET_BLD_YEARLY_MAINTENANCE(GET_BUILDING(room)) && !IS_DISMANTLING(room)) {
@@ -1007,6 +1187,10 @@ void annual_update_map_tile(room_data *room) {
 static void annual_update_room(room_data *room) {
 	struct depletion_data *dep, *next_dep, *temp;
 	
+	if (ROOM_DEPLETION(room)) {
+		request_world_save(GET_ROOM_VNUM(room));
+	}
+	
 	// depletions
 	for (dep = ROOM_DEPLETION(room); dep; dep = next_dep) {
 		next_dep = dep->next;
@@ -1082,7 +1266,7 @@ void annual_world_update(void) {
 	// MESSAGE TO ALL
 	for (d = descriptor_list; d; d = d->next) {
 		if (STATE(d) == CON_PLAYING && d->character) {
-			write_to_descriptor(d->descriptor, message);
+			ProtocolWrite(d, message);
 			d->has_prompt = FALSE;
 			
 			if (!IS_IMMORTAL(d->character)) {
@@ -1090,7 +1274,7 @@ void annual_world_update(void) {
 					if (IS_RIDING(d->character)) {
 						perform_dismount(d->character);
 					}
-					write_to_descriptor(d->descriptor, "You're knocked to the ground!\r\n");
+					ProtocolWrite(d, "You're knocked to the ground!\r\n");
 					act("$n is knocked to the ground!", TRUE, d->character, NULL, NULL, TO_ROOM);
 					GET_POS(d->character) = POS_SITTING;
 				}
@@ -1117,7 +1301,7 @@ void annual_world_update(void) {
 	
 	// rename islands
 	update_island_names();
-	save_whole_world();
+	save_world_changes();
 	
 	// store the time now
 	data_set_long(DATA_LAST_NEW_YEAR, time(0));
@@ -1132,7 +1316,7 @@ void annual_world_update(void) {
 void naturalize_newbie_islands(void) {
 	struct island_info *isle = NULL;
 	int count = 0, last_isle = -1;
-	struct map_data *map;
+	room_vnum map;
 	room_data *room;
 	bool do_unclaim;
 	
@@ -1142,23 +1326,23 @@ void naturalize_newbie_islands(void) {
 	
 	do_unclaim = config_get_bool("naturalize_unclaimable");
 	
-	LL_FOREACH(land_map, map) {
+	for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
 		// simple checks
-		if (map->sector_type == map->natural_sector) {
+		if (MAP_SECT(map) == MAP_NATURAL_SECT(map)) {
 			continue;	// already same
 		}
 		
 		// check island
-		if (!isle || last_isle != map->island) {
-			isle = get_island(map->island, TRUE);
-			last_isle = map->island;
+		if (!isle || last_isle != MAP_ISLAND(map)) {
+			isle = get_island(MAP_ISLAND(map), TRUE);
+			last_isle = MAP_ISLAND(map);
 		}
 		if (!IS_SET(isle->flags, ISLE_NEWBIE)) {
 			continue;
 		}
 		
 		// checks needed if the room exists
-		if ((room = real_real_room(map->vnum))) {
+		if ((room = real_real_room(map))) {
 			if (ROOM_OWNER(room)) {
 				continue;
 			}
@@ -1172,21 +1356,21 @@ void naturalize_newbie_islands(void) {
 		
 		// looks good: naturalize it
 		if (room) {
-			change_terrain(room, GET_SECT_VNUM(map->natural_sector));
+			change_terrain(room, GET_SECT_VNUM(MAP_NATURAL_SECT(map)));
 			if (ROOM_PEOPLE(room)) {
 				act("The area returns to nature!", FALSE, ROOM_PEOPLE(room), NULL, NULL, TO_CHAR | TO_ROOM);
 			}
 		}
 		else {
-			perform_change_sect(NULL, map, map->natural_sector);
-			perform_change_base_sect(NULL, map, map->natural_sector);
+			perform_change_sect(NULL, map, MAP_NATURAL_SECT(map));
+			perform_change_base_sect(NULL, map, MAP_NATURAL_SECT(map));
 			
-			if (SECT_FLAGGED(map->natural_sector, SECTF_HAS_CROP_DATA)) {
-				room = real_room(map->vnum);	// need it loaded after all
+			if (SECT_FLAGGED(MAP_NATURAL_SECT(map), SECTF_HAS_CROP_DATA)) {
+				room = real_room(map);	// need it loaded after all
 				set_crop_type(room, get_potential_crop_for_location(room));
 			}
 			else {
-				map->crop_type = NULL;
+				SET_MAP_CROP(map, NULL);
 			}
 		}
 		++count;
@@ -1350,6 +1534,8 @@ struct empire_city_data *create_city_entry(empire_data *emp, char *name, room_da
 	city->name = str_dup(name);
 	city->location = location;
 	city->type = type;
+	invalidate_map_icon(GET_ROOM_VNUM(location));	// city center icon
+	reset_city_coverage(emp);
 
 	city->population = 0;
 	city->military = 0;
@@ -1562,19 +1748,191 @@ struct sector_index_type *find_sector_index(sector_vnum vnum) {
 }
 
 
+/**
+* Adds a map tile to the end of a sector's sect_rooms array.
+*
+* @param struct sector_index_type *idx The sector index entry.
+* @param room_vnum tile The map tile to add.
+*/
+static void add_to_sect_rooms(struct sector_index_type *idx, room_vnum tile) {
+	if (idx->num_sect_rooms >= idx->max_sect_rooms) {
+		idx->max_sect_rooms = MAX(64, idx->max_sect_rooms * 2);
+		if (idx->sect_rooms) {
+			RECREATE(idx->sect_rooms, room_vnum, idx->max_sect_rooms);
+		}
+		else {
+			CREATE(idx->sect_rooms, room_vnum, idx->max_sect_rooms);
+		}
+	}
+	
+	world_map.sect_pos[tile] = idx->num_sect_rooms;
+	idx->sect_rooms[idx->num_sect_rooms++] = tile;
+}
+
+
+/**
+* Moves one entry in a sect_rooms array to another position, overwriting it.
+*
+* @param struct sector_index_type *idx The sector index entry.
+* @param int from The position to move.
+* @param int to The position to move it to.
+*/
+static void move_in_sect_rooms(struct sector_index_type *idx, int from, int to) {
+	if (from != to) {
+		idx->sect_rooms[to] = idx->sect_rooms[from];
+		world_map.sect_pos[idx->sect_rooms[to]] = to;
+	}
+}
+
+
+/**
+* Removes a map tile from a sector's sect_rooms array in constant time, by
+* moving the last tile in the array into its place.
+*
+* Map evolutions resume at last_evo_pos in last_evo_sect, so everything before
+* that position has already had its turn this cycle. When a tile is removed
+* from that part, the last visited tile fills the hole instead, and the
+* visited part shrinks by one, so no unvisited tile gets skipped.
+*
+* @param struct sector_index_type *idx The sector index entry.
+* @param room_vnum tile The map tile to remove.
+*/
+static void remove_from_sect_rooms(struct sector_index_type *idx, room_vnum tile) {
+	int pos = world_map.sect_pos[tile], last;
+	
+	if (pos < 0 || pos >= idx->num_sect_rooms || idx->sect_rooms[pos] != tile) {
+		log("SYSERR: remove_from_sect_rooms: tile %d is not in the list for sector %d", tile, idx->vnum);
+		return;
+	}
+	
+	last = --idx->num_sect_rooms;
+	
+	if (last_evo_sect && GET_SECT_VNUM(last_evo_sect) == idx->vnum && pos < last_evo_pos) {
+		--last_evo_pos;
+		move_in_sect_rooms(idx, last_evo_pos, pos);	// a visited tile fills the hole
+		move_in_sect_rooms(idx, last, last_evo_pos);	// and the last tile fills its spot
+	}
+	else {
+		move_in_sect_rooms(idx, last, pos);
+	}
+	
+	world_map.sect_pos[tile] = -1;
+}
+
+
+/**
+* Gets the list of x/y offsets that are within a given distance, as measured
+* by compute_map_distance(). The list is kept until a different distance is
+* requested.
+*
+* @param int distance The radius.
+* @param int *count A variable to store the number of offsets in.
+* @return int* The offsets, as dx,dy pairs (2 * count ints).
+*/
+static int *get_near_offsets(int distance, int *count) {
+	static int *offsets = NULL, num_offsets = 0, last_distance = -1;
+	int x, y;
+	
+	if (distance != last_distance) {
+		if (offsets) {
+			free(offsets);
+		}
+		CREATE(offsets, int, 2 * (2 * distance + 1) * (2 * distance + 1));
+		num_offsets = 0;
+		
+		for (x = -1 * distance; x <= distance; ++x) {
+			for (y = -1 * distance; y <= distance; ++y) {
+				if ((int) sqrt(x * x + y * y) <= distance) {
+					offsets[2 * num_offsets] = x;
+					offsets[2 * num_offsets + 1] = y;
+					++num_offsets;
+				}
+			}
+		}
+		
+		last_distance = distance;
+	}
+	
+	*count = num_offsets;
+	return offsets;
+}
+
+
+/**
+* Adds or removes one tile of a sector in that sector's distance field: every
+* tile within range of it has its count raised or lowered.
+*
+* @param struct sector_index_type *idx The sector index entry, which has a near_count field.
+* @param room_vnum tile The map tile that is (or was) this sector.
+* @param int amount 1 to add the tile, -1 to remove it.
+*/
+static void mark_sector_distance(struct sector_index_type *idx, room_vnum tile, int amount) {
+	int iter, num, *offsets, x, y;
+	
+	offsets = get_near_offsets(idx->near_distance, &num);
+	for (iter = 0; iter < num; ++iter) {
+		if (get_coord_shift(MAP_X_COORD(tile), MAP_Y_COORD(tile), offsets[2 * iter], offsets[2 * iter + 1], &x, &y)) {
+			idx->near_count[MAP_TILE(x, y)] += amount;
+		}
+	}
+}
+
+
+/**
+* Determines if a map tile is within nearby_sector_distance of a given sector,
+* for the EVO_NEAR_SECTOR and EVO_NOT_NEAR_SECTOR evolutions. This gives the
+* same result as find_sect_within_distance_from_room() but is a single lookup:
+* the first call for a sector builds a distance field for it, which
+* perform_change_sect() then keeps up to date. The field is rebuilt if the
+* config changes.
+*
+* @param room_vnum tile The map tile to check.
+* @param sector_vnum sect The sector to look for.
+* @return bool TRUE if a tile of that sector is in range, FALSE if not.
+*/
+bool map_tile_near_sector(room_vnum tile, sector_vnum sect) {
+	int distance = config_get_int("nearby_sector_distance");
+	struct sector_index_type *idx;
+	int iter;
+	
+	if (tile < 0 || tile >= MAP_SIZE || distance < 0) {
+		return FALSE;
+	}
+	
+	idx = find_sector_index(sect);
+	
+	// build (or rebuild) the field from the sector's tile list
+	if (!idx->near_count || idx->near_distance != distance) {
+		if (idx->near_count) {
+			memset(idx->near_count, 0, MAP_SIZE * sizeof(int));
+		}
+		else {
+			CREATE(idx->near_count, int, MAP_SIZE);
+		}
+		idx->near_distance = distance;
+		
+		for (iter = 0; iter < idx->num_sect_rooms; ++iter) {
+			mark_sector_distance(idx, idx->sect_rooms[iter], 1);
+		}
+	}
+	
+	return (idx->near_count[tile] > 0);
+}
+
+
 /**
 * Change a room's base sector (and the world_map) from one type to another, and
 * update counts. ALL base sector changes should be done through this function.
 *
 * @param room_data *loc The location to change (optional, or provide map).
-* @param struct map_data *map The location to change (optional, or provide room).
+* @param room_vnum map The map tile to change (optional NOWHERE, or provide room).
 * @param sector_data *sect The type to change it to.
 */
-void perform_change_base_sect(room_data *loc, struct map_data *map, sector_data *sect) {
+void perform_change_base_sect(room_data *loc, room_vnum map, sector_data *sect) {
 	struct sector_index_type *idx;
 	sector_data *old_sect;
 	
-	if (!loc && !map) {
+	if (!loc && map == NOWHERE) {
 		log("SYSERR: perform_change_base_sect called without loc or map");
 		return;
 	}
@@ -1584,34 +1942,30 @@ void perform_change_base_sect(room_data *loc, struct map_data *map, sector_data
 	}
 	
 	// preserve
-	old_sect = (loc ? BASE_SECT(loc) : map->base_sector);
+	old_sect = (loc ? BASE_SECT(loc) : MAP_BASE_SECT(map));
 	
 	// update room
-	if (loc || (loc = real_real_room(map->vnum))) {
+	if (loc || (loc = real_real_room(map))) {
 		BASE_SECT(loc) = sect;
+		request_world_save(GET_ROOM_VNUM(loc));
 	}
 	
 	// update the world map
-	if (map || (GET_ROOM_VNUM(loc) < MAP_SIZE && (map = &(world_map[FLAT_X_COORD(loc)][FLAT_Y_COORD(loc)])))) {
-		map->base_sector = sect;
+	if (map != NOWHERE || (GET_ROOM_VNUM(loc) < MAP_SIZE && (map = GET_ROOM_VNUM(loc)) != NOWHERE)) {
+		world_map.base_sector[map] = map_sect_index(sect);
 		world_map_needs_save = TRUE;
+		invalidate_map_icon(map);
 	}
 	
 	// old index
 	if (old_sect) {	// does not exist at first instantiation/set
 		idx = find_sector_index(GET_SECT_VNUM(old_sect));
 		--idx->base_count;
-		if (map) {
-			LL_DELETE2(idx->base_rooms, map, next_in_base_sect);
-		}
 	}
 	
 	// new index
 	idx = find_sector_index(GET_SECT_VNUM(sect));
 	++idx->base_count;
-	if (map) {
-		LL_PREPEND2(idx->base_rooms, map, next_in_base_sect);
-	}
 }
 
 
@@ -1620,17 +1974,17 @@ void perform_change_base_sect(room_data *loc, struct map_data *map, sector_data
 * update counts. ALL sector changes should be done through this function.
 *
 * @param room_data *loc The location to change (optional, or provide map).
-* @param struct map_data *map The location to change (optional, or provide room).
+* @param room_vnum map The map tile to change (optional NOWHERE, or provide room).
 * @param sector_data *sect The type to change it to.
 */
-void perform_change_sect(room_data *loc, struct map_data *map, sector_data *sect) {
+void perform_change_sect(room_data *loc, room_vnum map, sector_data *sect) {
 	bool belongs = (loc && SECT(loc) && BELONGS_IN_TERRITORY_LIST(loc));
 	struct empire_territory_data *ter;
 	bool was_large, was_in_city, junk;
 	struct sector_index_type *idx;
 	sector_data *old_sect;
 	
-	if (!loc && !map) {
+	if (!loc && map == NOWHERE) {
 		log("SYSERR: perform_change_sect called without loc or map");
 		return;
 	}
@@ -1641,7 +1995,7 @@ void perform_change_sect(room_data *loc, struct map_data *map, sector_data *sect
 	
 	// ensure we have loc if possible
 	if (!loc) {
-		loc = real_real_room(map->vnum);
+		loc = real_real_room(map);
 	}
 	
 	// for updating territory counts
@@ -1649,37 +2003,42 @@ void perform_change_sect(room_data *loc, struct map_data *map, sector_data *sect
 	was_in_city = (loc && ROOM_OWNER(loc)) ? is_in_city_for_empire(loc, ROOM_OWNER(loc), FALSE, &junk) : FALSE;
 	
 	// preserve
-	old_sect = (loc ? SECT(loc) : map->sector_type);
+	old_sect = (loc ? SECT(loc) : MAP_SECT(map));
 	
 	// update room
 	if (loc) {
 		SECT(loc) = sect;
+		request_world_save(GET_ROOM_VNUM(loc));
 	}
 	
-	// update the world map
-	if (map || (GET_ROOM_VNUM(loc) < MAP_SIZE && (map = &(world_map[FLAT_X_COORD(loc)][FLAT_Y_COORD(loc)])))) {
-		map->sector_type = sect;
+	// update the world map (and its index, which goes by the map's own sect)
+	if (map != NOWHERE || (GET_ROOM_VNUM(loc) < MAP_SIZE && (map = GET_ROOM_VNUM(loc)) != NOWHERE)) {
+		if (MAP_SECT(map) && world_map.sect_pos[map] != -1) {
+			idx = find_sector_index(GET_SECT_VNUM(MAP_SECT(map)));
+			remove_from_sect_rooms(idx, map);
+			if (idx->near_count) {
+				mark_sector_distance(idx, map, -1);
+			}
+		}
+		world_map.sector_type[map] = map_sect_index(sect);
+		idx = find_sector_index(GET_SECT_VNUM(sect));
+		add_to_sect_rooms(idx, map);
+		if (idx->near_count) {
+			mark_sector_distance(idx, map, 1);
+		}
 		world_map_needs_save = TRUE;
+		invalidate_map_icon(map);
 	}
 	
 	// old index
 	if (old_sect) {	// does not exist at first instantiation/set
 		idx = find_sector_index(GET_SECT_VNUM(old_sect));
 		--idx->sect_count;
-		if (map) {
-			if (last_evo_tile == map) {
-				last_evo_tile = map->next_in_sect;
-			}
-			LL_DELETE2(idx->sect_rooms, map, next_in_sect);
-		}
 	}
 	
 	// new index
 	idx = find_sector_index(GET_SECT_VNUM(sect));
 	++idx->sect_count;
-	if (map) {
-		LL_PREPEND2(idx->sect_rooms, map, next_in_sect);
-	}
 	
 	// check for territory updates
 	if (loc && ROOM_OWNER(loc)) {
@@ -1813,12 +2172,15 @@ struct empire_territory_data *create_territory_entry(empire_data *emp, room_data
 	
 	CREATE(ter, struct empire_territory_data, 1);
 	ter->room = room;
+	ter->vnum = GET_ROOM_VNUM(room);
 	ter->population_timer = config_get_int("building_population_timer");
 	ter->npcs = NULL;
 	ter->marked = FALSE;
 	
 	// put it at the end
 	LL_APPEND(EMPIRE_TERRITORY_LIST(emp), ter);
+	HASH_ADD_INT(EMPIRE_TERRITORY_BY_VNUM(emp), vnum, ter);
+	reset_territory_indexes(emp);
 	
 	return ter;
 }
@@ -1843,6 +2205,8 @@ void delete_territory_entry(empire_data *emp, struct empire_territory_data *ter)
 	ter->npcs = NULL;
 	
 	LL_DELETE(EMPIRE_TERRITORY_LIST(emp), ter);
+	HASH_DEL(EMPIRE_TERRITORY_BY_VNUM(emp), ter);
+	reset_territory_indexes(emp);
 	free(ter);
 }
 
@@ -1863,6 +2227,9 @@ void read_empire_territory(empire_data *emp, bool check_tech) {
 	room_data *iter, *next_iter;
 	empire_data *e, *next_e;
 	bool junk;
+	
+	// building and island data may have changed
+	reset_territory_indexes(emp);
 
 	/* Init empires */
 	HASH_ITER(hh, empire_table, e, next_e) {
@@ -2055,105 +2422,289 @@ void detect_evos_per_hour(void) {
 
 
 /**
-* Checks and runs evolutions for a single map tile.
+* Counts how many adjacent map tiles have the given sector type, like
+* count_adjacent_sectors(), but reads only the world_map. This is safe to use
+* on an evolution worker thread.
 *
-* @param struct map_data *tile The map location to evolve.
+* @param room_vnum tile The map tile to check around.
+* @param sector_vnum sect The sector vnum to find.
+* @param bool count_original_sect If TRUE, also checks the base sector.
+* @return int The number of matching adjacent tiles.
 */
-static void evolve_one_map_tile(struct map_data *tile) {
-	extern bool is_entrance(room_data *room);
+static int count_adjacent_map_sectors(room_vnum tile, sector_vnum sect, bool count_original_sect) {
+	sector_data *find = sector_proto(sect);
+	int iter, x, y, count = 0;
+	room_vnum to_tile;
 	
+	if (!find) {
+		return 0;
+	}
+	
+	for (iter = 0; iter < NUM_2D_DIRS; ++iter) {
+		if (get_coord_shift(MAP_X_COORD(tile), MAP_Y_COORD(tile), shift_dir[iter][0], shift_dir[iter][1], &x, &y)) {
+			to_tile = MAP_TILE(x, y);
+			if (MAP_SECT(to_tile) == find || (count_original_sect && MAP_BASE_SECT(to_tile) == find)) {
+				++count;
+			}
+		}
+	}
+	
+	return count;
+}
+
+
+/**
+* Gets an evolution of the given type, if its percentage passes, like
+* get_evolution_by_type(), but it rolls with a local random state instead of
+* number() so that it's safe on an evolution worker thread.
+*
+* @param sector_data *st The sector to check.
+* @param int type The EVO_x type to get.
+* @param unsigned long *state The tile's random state (see empire_random_r).
+* @return struct evolution_data* The found evolution, or NULL.
+*/
+static struct evolution_data *roll_evolution_by_type(sector_data *st, int type, unsigned long *state) {
 	struct evolution_data *evo;
-	sector_data *original;
+	
+	if (!st) {
+		return NULL;
+	}
+	
+	for (evo = GET_SECT_EVOS(st); evo; evo = evo->next) {
+		if (evo->type == type && (int) (empire_random_r(state) % 10000) + 1 <= ((int) 100 * evo->percent)) {
+			return evo;
+		}
+	}
+	
+	return NULL;
+}
+
+
+/**
+* Works out what one map tile will evolve into, without changing anything.
+* This runs on evolution worker threads, so it may only read the world_map,
+* the sector prototypes, and the distance fields (which must already exist;
+* see prepare_map_evolutions). Each tile gets its own random state from the
+* pass's seed, so the result doesn't depend on which thread evaluates it.
+*
+* @param struct map_evolution_data *data The tile to evaluate; its original and becomes are set.
+* @param unsigned long seed The random seed for the whole pass.
+*/
+static void evaluate_map_evolution(struct map_evolution_data *data, unsigned long seed) {
+	room_vnum tile = data->tile;
+	struct evolution_data *evo;
+	unsigned long state;
 	sector_vnum become;
 	room_data *room;
 	
+	data->original = MAP_SECT(tile);
+	data->becomes = NOTHING;
+	
 	// this may return NULL -- we don't need it if so
-	room = real_real_room(tile->vnum);
+	room = real_real_room(tile);
 	
 	// no further action if !evolve or if no evos
-	if ((room && ROOM_AFF_FLAGGED(room, ROOM_AFF_NO_EVOLVE)) || !GET_SECT_EVOS(tile->sector_type)) {
+	if ((room && ROOM_AFF_FLAGGED(room, ROOM_AFF_NO_EVOLVE)) || !data->original || !GET_SECT_EVOS(data->original)) {
 		return;
 	}
 	
+	// 1 to EVOLUTION_RANDOM_MOD-1, as empire_random_r requires
+	state = 1 + ((seed ^ ((unsigned long) tile * 2654435761UL)) % (EVOLUTION_RANDOM_MOD - 1));
+	
 	// to avoid running more than one:
-	original = tile->sector_type;
 	become = NOTHING;
 	
 	// run some evolutions!
-	if (become == NOTHING && (evo = get_evolution_by_type(tile->sector_type, EVO_RANDOM))) {
+	if (become == NOTHING && (evo = roll_evolution_by_type(data->original, EVO_RANDOM, &state))) {
 		become = evo->becomes;
 	}
 	
-	if (become == NOTHING && (evo = get_evolution_by_type(tile->sector_type, EVO_ADJACENT_ONE))) {
-		room = room ? room : real_room(tile->vnum);
-		if (count_adjacent_sectors(room, evo->value, TRUE) >= 1) {
+	if (become == NOTHING && (evo = roll_evolution_by_type(data->original, EVO_ADJACENT_ONE, &state))) {
+		if (count_adjacent_map_sectors(tile, evo->value, TRUE) >= 1) {
 			become = evo->becomes;
 		}
 	}
 	
-	if (become == NOTHING && (evo = get_evolution_by_type(tile->sector_type, EVO_NOT_ADJACENT))) {
-		room = room ? room : real_room(tile->vnum);
-		if (count_adjacent_sectors(room, evo->value, TRUE) < 1) {
+	if (become == NOTHING && (evo = roll_evolution_by_type(data->original, EVO_NOT_ADJACENT, &state))) {
+		if (count_adjacent_map_sectors(tile, evo->value, TRUE) < 1) {
 			become = evo->becomes;
 		}
 	}
 	
-	if (become == NOTHING && (evo = get_evolution_by_type(tile->sector_type, EVO_ADJACENT_MANY))) {
-		room = room ? room : real_room(tile->vnum);
-		if (count_adjacent_sectors(room, evo->value, TRUE) >= 6) {
+	if (become == NOTHING && (evo = roll_evolution_by_type(data->original, EVO_ADJACENT_MANY, &state))) {
+		if (count_adjacent_map_sectors(tile, evo->value, TRUE) >= 6) {
 			become = evo->becomes;
 		}
 	}
 	
-	if (become == NOTHING && (evo = get_evolution_by_type(tile->sector_type, EVO_NEAR_SECTOR))) {
-		room = room ? room : real_room(tile->vnum);
-		if (find_sect_within_distance_from_room(room, evo->value, config_get_int("nearby_sector_distance"))) {
+	if (become == NOTHING && (evo = roll_evolution_by_type(data->original, EVO_NEAR_SECTOR, &state))) {
+		if (map_tile_near_sector(tile, evo->value)) {
 			become = evo->becomes;
 		}
 	}
 	
-	if (become == NOTHING && (evo = get_evolution_by_type(tile->sector_type, EVO_NOT_NEAR_SECTOR))) {
-		room = room ? room : real_room(tile->vnum);
-		if (!find_sect_within_distance_from_room(room, evo->value, config_get_int("nearby_sector_distance"))) {
+	if (become == NOTHING && (evo = roll_evolution_by_type(data->original, EVO_NOT_NEAR_SECTOR, &state))) {
+		if (!map_tile_near_sector(tile, evo->value)) {
 			become = evo->becomes;
 		}
 	}
 	
-	// DONE: now change it
-	if (become != NOTHING && sector_proto(become)) {
-		// in case we didn't get it earlier
-		if (!room) {
-			room = real_room(tile->vnum);
+	data->becomes = become;
+}
+
+
+/**
+* Carries out an evolution that evaluate_map_evolution() proposed. This is
+* only done on the main thread, in list order.
+*
+* @param struct map_evolution_data *data The evaluated tile.
+*/
+static void apply_map_evolution(struct map_evolution_data *data) {
+	extern bool is_entrance(room_data *room);
+	room_data *room;
+	
+	if (data->becomes == NOTHING || !sector_proto(data->becomes)) {
+		return;
+	}
+	if (MAP_SECT(data->tile) != data->original) {
+		return;	// already changed earlier in this pass
+	}
+	
+	room = real_room(data->tile);
+	
+	if (room && !is_entrance(room)) {
+		change_terrain(room, data->becomes);
+		
+		// If the new sector has crop data, we should store the original (e.g. a desert that randomly grows into a crop)
+		if (ROOM_SECT_FLAGGED(room, SECTF_HAS_CROP_DATA) && BASE_SECT(room) == SECT(room)) {
+			change_base_sector(room, data->original);
 		}
 		
-	 	if (room && !is_entrance(room)) {
-			change_terrain(room, become);
-			
-			// If the new sector has crop data, we should store the original (e.g. a desert that randomly grows into a crop)
-			if (ROOM_SECT_FLAGGED(room, SECTF_HAS_CROP_DATA) && BASE_SECT(room) == SECT(room)) {
-				change_base_sector(room, original);
+		if (ROOM_OWNER(room)) {
+			void deactivate_workforce_room(empire_data *emp, room_data *room);
+			deactivate_workforce_room(ROOM_OWNER(room), room);
+		}
+	}
+}
+
+
+/**
+* Builds any near-sector distance fields the evolutions will need, so that
+* the worker threads only ever read them.
+*/
+static void prepare_map_evolutions(void) {
+	sector_data *sect, *next_sect;
+	struct evolution_data *evo;
+	
+	HASH_ITER(hh, sector_table, sect, next_sect) {
+		LL_FOREACH(GET_SECT_EVOS(sect), evo) {
+			if (evo->type == EVO_NEAR_SECTOR || evo->type == EVO_NOT_NEAR_SECTOR) {
+				map_tile_near_sector(0, evo->value);	// builds the field if needed
 			}
-			
-			if (ROOM_OWNER(room)) {
-				void deactivate_workforce_room(empire_data *emp, room_data *room);
-				deactivate_workforce_room(ROOM_OWNER(room), room);
+		}
+	}
+}
+
+
+#ifdef EMPIRE_THREADS
+
+/**
+* Evolution worker thread: evaluates one share of the pass's tiles. This must
+* not change any game data.
+*
+* @param void *arg The struct evolution_batch_data to work on.
+* @return void* Always NULL.
+*/
+static void *evolution_worker(void *arg) {
+	struct evolution_batch_data *batch = (struct evolution_batch_data*) arg;
+	int iter;
+	
+	for (iter = batch->start; iter < batch->end; ++iter) {
+		evaluate_map_evolution(batch->list + iter, batch->seed);
+	}
+	
+	return NULL;
+}
+
+#endif	/* EMPIRE_THREADS */
+
+
+/**
+* Evaluation phase of a map evolution pass: works out what each tile in the
+* list will become. Large lists are split across worker threads (if the mud
+* has them); the results are the same either way.
+*
+* @param struct map_evolution_data *list The tiles to evaluate.
+* @param int count How many tiles are in the list.
+* @param unsigned long seed Random seed for the pass.
+* @param bool allow_threads If FALSE, evaluates everything on this thread.
+*/
+void evaluate_map_evolutions(struct map_evolution_data *list, int count, unsigned long seed, bool allow_threads) {
+	int iter;
+	
+	prepare_map_evolutions();
+	
+#ifdef EMPIRE_THREADS
+	if (allow_threads && count >= MIN_THREADED_EVOLUTIONS) {
+		struct evolution_batch_data batch[NUM_EVOLUTION_THREADS];
+		pthread_t thread[NUM_EVOLUTION_THREADS];
+		bool started[NUM_EVOLUTION_THREADS];
+		
+		for (iter = 0; iter < NUM_EVOLUTION_THREADS; ++iter) {
+			batch[iter].list = list;
+			batch[iter].start = iter * count / NUM_EVOLUTION_THREADS;
+			batch[iter].end = (iter + 1) * count / NUM_EVOLUTION_THREADS;
+			batch[iter].seed = seed;
+			started[iter] = (pthread_create(&thread[iter], NULL, evolution_worker, &batch[iter]) == 0);
+		}
+		for (iter = 0; iter < NUM_EVOLUTION_THREADS; ++iter) {
+			if (started[iter]) {
+				pthread_join(thread[iter], NULL);
+			}
+			else {	// couldn't start it: do its share here
+				evolution_worker(&batch[iter]);
 			}
 		}
+		return;
+	}
+#endif
+	
+	for (iter = 0; iter < count; ++iter) {
+		evaluate_map_evolution(list + iter, seed);
 	}
 }
 
 
 /**
-* Runs evolutions on 1/24 of evolvable map tiles per hour.
+* Runs evolutions on 1/24 of evolvable map tiles per hour. This is done in two
+* phases: first every tile in this hour's share is evaluated against the map
+* as it stands (in parallel, for big maps), then the changes are applied here
+* in order. A tile's result doesn't depend on changes made to its neighbors
+* earlier in the same pass. Tiles that change sector leave the sect_rooms
+* array without moving unvisited tiles behind last_evo_pos (see
+* remove_from_sect_rooms), so every tile still gets one turn per cycle.
 */
 void run_map_evolutions(void) {
-	struct map_data *map, *next_map, *map_start;
+	static struct map_evolution_data *list = NULL;
+	static int list_size = 0;
+	
 	struct sector_index_type *idx;
 	sector_data *sect, *next_sect;
+	int try, to_do, pos, count, iter;
 	bool found_start;
-	int try, to_do;
 	
 	to_do = evos_per_hour;	// how many tiles to evolve before we quit
+	count = 0;
+	
+	if (list_size < to_do) {
+		list_size = to_do;
+		if (list) {
+			RECREATE(list, struct map_evolution_data, list_size);
+		}
+		else {
+			CREATE(list, struct map_evolution_data, list_size);
+		}
+	}
 	
 	// going to loop through sectors twice: once to find the last starting pos, and a second time if we have to wrap around
 	found_start = FALSE;
@@ -2164,13 +2715,15 @@ void run_map_evolutions(void) {
 				break;
 			}
 			
+			idx = find_sector_index(GET_SECT_VNUM(sect));
+			
 			// finding where we left off
 			if (try == 1 && sect == last_evo_sect) {
 				// mark that we found the sector to start on
 				found_start = TRUE;
 				
 				// we will skip this sector if there's no work to be done in it
-				if (last_evo_tile == NULL) {
+				if (last_evo_pos >= idx->num_sect_rooms) {
 					continue;
 				}
 			}
@@ -2188,22 +2741,15 @@ void run_map_evolutions(void) {
 			}
 			
 			// READY: figure out where to start
-			if (last_evo_tile && last_evo_tile->next_in_sect && last_evo_tile->sector_type == sect) {
-				map_start = last_evo_tile->next_in_sect;
-			}
-			else {
-				idx = find_sector_index(GET_SECT_VNUM(sect));
-				map_start = idx->sect_rooms;
-			}
+			pos = (sect == last_evo_sect && last_evo_pos > 0) ? last_evo_pos : 0;
 			
 			// update this now, just in case
 			last_evo_sect = sect;
 			
-			// now attempt to evolve rooms in the list
-			LL_FOREACH_SAFE2(map_start, map, next_map, next_in_sect) {
-				last_evo_tile = map;	// update this NOW
-				
-				evolve_one_map_tile(map);
+			// now queue up rooms in the list
+			while (pos < idx->num_sect_rooms) {
+				list[count++].tile = idx->sect_rooms[pos++];
+				last_evo_pos = pos;
 				
 				// end if done
 				if (--to_do <= 0) {
@@ -2212,6 +2758,14 @@ void run_map_evolutions(void) {
 			}
 		}
 	}
+	
+	// phase 1: work out what everything becomes
+	evaluate_map_evolutions(list, count, empire_random(), TRUE);
+	
+	// phase 2: make the changes, in order
+	for (iter = 0; iter < count; ++iter) {
+		apply_map_evolution(list + iter);
+	}
 }
 
 
@@ -2273,7 +2827,7 @@ void clear_private_owner(int id) {
 	
 	HASH_ITER(hh, world_table, iter, next_iter) {
 		if (COMPLEX_DATA(iter) && ROOM_PRIVATE_OWNER(iter) == id) {
-			COMPLEX_DATA(iter)->private_owner = NOBODY;
+			set_private_owner(iter, NOBODY);
 		
 			// TODO some way to generalize this, please
 			if (BUILDING_VNUM(iter) == RTYPE_BEDROOM) {
@@ -2342,7 +2896,6 @@ room_data *dir_to_room(room_data *room, int dir, bool ignore_entrance) {
 * @return room_data* A fresh map room.
 */
 room_data *load_map_room(room_vnum vnum) {
-	struct map_data *map;
 	room_data *room;
 	
 	if (vnum < 0 || vnum >= MAP_SIZE) {
@@ -2350,23 +2903,22 @@ room_data *load_map_room(room_vnum vnum) {
 		return NULL;
 	}
 	
-	// find map data
-	map = &(world_map[MAP_X_COORD(vnum)][MAP_Y_COORD(vnum)]);
-	
 	CREATE(room, room_data, 1);
 	room->vnum = vnum;
 	add_room_to_world_tables(room);
+	++map_rooms_loaded;
 	
 	// do not use perform_change_sect here because we're only loading from the existing data
-	SECT(room) = map->sector_type;
-	BASE_SECT(room) = map->base_sector;
-	SET_ISLAND_ID(room, map->island);
+	SECT(room) = MAP_SECT(vnum);
+	BASE_SECT(room) = MAP_BASE_SECT(vnum);
+	SET_ISLAND_ID(room, MAP_ISLAND(vnum));
 	
-	ROOM_CROP(room) = map->crop_type;
+	ROOM_CROP(room) = MAP_CROP(vnum);
 	
 	// only if saveable
 	if (!CAN_UNLOAD_MAP_ROOM(room)) {
 		need_world_index = TRUE;
+		request_world_save(GET_ROOM_VNUM(room));
 	}
 	
 	return room;
@@ -2379,6 +2931,8 @@ room_data *load_map_room(room_vnum vnum) {
 * @param room_data *room
 */
 void decustomize_room(room_data *room) {
+	request_world_save(GET_ROOM_VNUM(room));
+	
 	if (ROOM_CUSTOM_NAME(room)) {
 		free(ROOM_CUSTOM_NAME(room));
 		ROOM_CUSTOM_NAME(room) = NULL;
@@ -2390,6 +2944,7 @@ void decustomize_room(room_data *room) {
 	if (ROOM_CUSTOM_ICON(room)) {
 		free(ROOM_CUSTOM_ICON(room));
 		ROOM_CUSTOM_ICON(room) = NULL;
+		invalidate_map_icon(GET_ROOM_VNUM(room));
 	}
 }
 
@@ -2602,11 +3157,13 @@ void init_room(room_data *room, room_vnum vnum) {
 
 	room->owner = NULL;
 	
-	perform_change_sect(room, NULL, inside);
-	perform_change_base_sect(room, NULL, inside);
+	perform_change_sect(room, NOWHERE, inside);
+	perform_change_base_sect(room, NOWHERE, inside);
 	
 	COMPLEX_DATA(room) = init_complex_data();	// no type at this point
 	room->light = 0;
+	room->command_trig_objs = 0;
+	room->command_trig_mobs = 0;
 	
 	room->name = NULL;
 	room->description = NULL;
@@ -2679,6 +3236,7 @@ void ruin_one_building(room_data *room) {
 		}
 		ROOM_CUSTOM_NAME(room) = str_dup(buf);
 		set_room_extra_data(room, ROOM_EXTRA_RUINS_ICON, number(0, NUM_RUINS_ICONS-1));
+		invalidate_map_icon(GET_ROOM_VNUM(room));
 		
 		// run completion on the ruins
 		complete_building(room);
@@ -2731,37 +3289,44 @@ void update_tavern(room_data *room) {
 
 /**
 * Writes the data files used to generate graphical maps.
+*
+* @return bool TRUE if all the files were written; FALSE if any failed.
 */
-void output_map_to_file(void) {
+bool output_map_to_file(void) {
 	extern const char banner_to_mapout_token[][2];
 	extern const char mapout_color_tokens[];
 	
 	FILE *out, *pol, *cit;
 	int num, color = 0, x, y;
+	bool failed, ok = TRUE;
 	struct empire_city_data *city;
 	room_data *room;
 	empire_data *emp, *next_emp;
 	sector_data *ocean = sector_proto(BASIC_OCEAN);
 	sector_data *sect;
 	
+	wait_for_snapshot_save();
+	
 	// basic ocean sector is required
 	if (!ocean) {
 		log("SYSERR: Basic ocean sector %d is missing", BASIC_OCEAN);
-		return;
+		return FALSE;
 	}
 	
-	sort_world_table();
+	// no sort_world_table() needed: this walks the map by coordinates (and a
+	// sort would copy most of a snapshot child's memory)
 
 	// NORMAL MAP
 	if (!(out = fopen(GEOGRAPHIC_MAP_FILE TEMP_SUFFIX, "w"))) {
 		log("SYSERR: Unable to open file '%s' for writing", GEOGRAPHIC_MAP_FILE TEMP_SUFFIX);
-		return;
+		return FALSE;
 	}
 	
 	// POLITICAL MAP
 	if (!(pol = fopen(POLITICAL_MAP_FILE TEMP_SUFFIX, "w"))) {
 		log("SYSERR: Unable to open file '%s' for writing", POLITICAL_MAP_FILE TEMP_SUFFIX);
-		return;
+		fclose(out);
+		return FALSE;
 	}
 	
 	fprintf(out, "%dx%d\n", MAP_WIDTH, MAP_HEIGHT);
@@ -2770,15 +3335,15 @@ void output_map_to_file(void) {
 	for (y = 0; y < MAP_HEIGHT; ++y) {
 		for (x = 0; x < MAP_WIDTH; ++x) {
 			// load room only if in memory
-			room = real_real_room(world_map[x][y].vnum);
-			sect = world_map[x][y].sector_type;
+			room = real_real_room(MAP_TILE(x, y));
+			sect = MAP_SECT(MAP_TILE(x, y));
 			if (room && ROOM_AFF_FLAGGED(room, ROOM_AFF_CHAMELEON) && IS_COMPLETE(room)) {
-				sect = world_map[x][y].base_sector;
+				sect = MAP_BASE_SECT(MAP_TILE(x, y));
 			}
 			
 			// normal map output
-			if (SECT_FLAGGED(sect, SECTF_HAS_CROP_DATA) && world_map[x][y].crop_type) {
-				fprintf(out, "%c", mapout_color_tokens[GET_CROP_MAPOUT(world_map[x][y].crop_type)]);
+			if (SECT_FLAGGED(sect, SECTF_HAS_CROP_DATA) && MAP_CROP(MAP_TILE(x, y))) {
+				fprintf(out, "%c", mapout_color_tokens[GET_CROP_MAPOUT(MAP_CROP(MAP_TILE(x, y)))]);
 			}
 			else {
 				fprintf(out, "%c", mapout_color_tokens[GET_SECT_MAPOUT(sect)]);
@@ -2813,15 +3378,21 @@ void output_map_to_file(void) {
 		fprintf(pol, "\n");	
 	}
 
-	fclose(out);
-	rename(GEOGRAPHIC_MAP_FILE TEMP_SUFFIX, GEOGRAPHIC_MAP_FILE);
-	fclose(pol);
-	rename(POLITICAL_MAP_FILE TEMP_SUFFIX, POLITICAL_MAP_FILE);
+	failed = (ferror(out) != 0);
+	if (fclose(out) != 0 || failed || rename(GEOGRAPHIC_MAP_FILE TEMP_SUFFIX, GEOGRAPHIC_MAP_FILE) != 0) {
+		log("SYSERR: Unable to write %s: %s", GEOGRAPHIC_MAP_FILE, strerror(errno));
+		ok = FALSE;
+	}
+	failed = (ferror(pol) != 0);
+	if (fclose(pol) != 0 || failed || rename(POLITICAL_MAP_FILE TEMP_SUFFIX, POLITICAL_MAP_FILE) != 0) {
+		log("SYSERR: Unable to write %s: %s", POLITICAL_MAP_FILE, strerror(errno));
+		ok = FALSE;
+	}
 	
 	// and city data
 	if (!(cit = fopen(CITY_DATA_FILE TEMP_SUFFIX, "w"))) {
 		log("SYSERR: Unable to open file '%s' for writing", CITY_DATA_FILE TEMP_SUFFIX);
-		return;
+		return FALSE;
 	}
 	
 	HASH_ITER(hh, empire_table, emp, next_emp) {
@@ -2835,8 +3406,13 @@ void output_map_to_file(void) {
 	}
 	
 	fprintf(cit, "$\n");
-	fclose(cit);
-	rename(CITY_DATA_FILE TEMP_SUFFIX, CITY_DATA_FILE);
+	failed = (ferror(cit) != 0);
+	if (fclose(cit) != 0 || failed || rename(CITY_DATA_FILE TEMP_SUFFIX, CITY_DATA_FILE) != 0) {
+		log("SYSERR: Unable to write %s: %s", CITY_DATA_FILE, strerror(errno));
+		ok = FALSE;
+	}
+	
+	return ok;
 }
 
 
@@ -2844,13 +3420,94 @@ void output_map_to_file(void) {
 //// WORLD MAP SYSTEM ////////////////////////////////////////////////////////
 
 /**
-* Validates sectors and sets up the land_map linked list. This should be done
-* at the end of world startup. Run this AFTER build_world_map().
+* Finds (or assigns) the 16-bit world_map index for a sector. Index 0 is
+* always NULL.
+*
+* @param sector_data *st The sector (may be NULL).
+* @return ush_int The map_sect_table index for it.
+*/
+ush_int map_sect_index(sector_data *st) {
+	extern int map_sect_table_size;
+	int iter;
+	
+	if (!st) {
+		return 0;
+	}
+	if (st->map_idx > 0 && st->map_idx < map_sect_table_size && map_sect_table[st->map_idx] == st) {
+		return st->map_idx;
+	}
+	
+	// find a free slot (slots are freed when sectors are deleted)
+	for (iter = 1; iter < map_sect_table_size; ++iter) {
+		if (!map_sect_table[iter]) {
+			break;
+		}
+	}
+	if (iter >= map_sect_table_size) {
+		if (map_sect_table_size >= USHRT_MAX) {
+			log("SYSERR: map_sect_index: too many sectors on the map");
+			exit(1);
+		}
+		map_sect_table_size = MIN(USHRT_MAX, MAX(32, map_sect_table_size * 2));
+		RECREATE(map_sect_table, sector_data*, map_sect_table_size);
+		memset(map_sect_table + iter, 0, (map_sect_table_size - iter) * sizeof(sector_data*));
+	}
+	
+	map_sect_table[iter] = st;
+	st->map_idx = iter;
+	return st->map_idx;
+}
+
+
+/**
+* Finds (or assigns) the 16-bit world_map index for a crop. Index 0 is always
+* NULL.
+*
+* @param crop_data *cp The crop (may be NULL).
+* @return ush_int The map_crop_table index for it.
+*/
+ush_int map_crop_index(crop_data *cp) {
+	extern int map_crop_table_size;
+	int iter;
+	
+	if (!cp) {
+		return 0;
+	}
+	if (cp->map_idx > 0 && cp->map_idx < map_crop_table_size && map_crop_table[cp->map_idx] == cp) {
+		return cp->map_idx;
+	}
+	
+	// find a free slot (slots are freed when crops are deleted)
+	for (iter = 1; iter < map_crop_table_size; ++iter) {
+		if (!map_crop_table[iter]) {
+			break;
+		}
+	}
+	if (iter >= map_crop_table_size) {
+		if (map_crop_table_size >= USHRT_MAX) {
+			log("SYSERR: map_crop_index: too many crops on the map");
+			exit(1);
+		}
+		map_crop_table_size = MIN(USHRT_MAX, MAX(32, map_crop_table_size * 2));
+		RECREATE(map_crop_table, crop_data*, map_crop_table_size);
+		memset(map_crop_table + iter, 0, (map_crop_table_size - iter) * sizeof(crop_data*));
+	}
+	
+	map_crop_table[iter] = cp;
+	cp->map_idx = iter;
+	return cp->map_idx;
+}
+
+
+/**
+* Validates sectors and sets up the land_map linked list and the per-sector
+* sect_rooms arrays. This should be done at the end of world startup. Run this
+* AFTER build_world_map().
 */
 void build_land_map(void) {
-	struct map_data *map, *last = NULL;
+	struct sector_index_type *idx, *next_idx;
 	sector_data *ocean = sector_proto(BASIC_OCEAN);
-	struct sector_index_type *idx;
+	room_vnum map, last = NOWHERE;
 	room_data *room;
 	int x, y;
 	
@@ -2859,28 +3516,33 @@ void build_land_map(void) {
 		exit(1);
 	}
 	
-	land_map = NULL;
+	land_map = NOWHERE;
+	
+	// the sect_rooms arrays are rebuilt from scratch
+	HASH_ITER(hh, sector_index, idx, next_idx) {
+		idx->num_sect_rooms = 0;
+	}
 	
-	for (x = 0; x < MAP_WIDTH; ++x) {
-		for (y = 0; y < MAP_HEIGHT; ++y) {
-			map = &(world_map[x][y]);
+	for (y = 0; y < MAP_HEIGHT; ++y) {
+		for (x = 0; x < MAP_WIDTH; ++x) {
+			map = MAP_TILE(x, y);
 			
 			// ensure data
-			if (!map->sector_type) {
-				map->sector_type = ocean;
+			if (!MAP_SECT(map)) {
+				world_map.sector_type[map] = map_sect_index(ocean);
 			}
-			if (!map->base_sector) {
-				map->base_sector = ocean;
+			if (!MAP_BASE_SECT(map)) {
+				world_map.base_sector[map] = map_sect_index(ocean);
 			}
-			if (!map->natural_sector) {
-				map->natural_sector = ocean;
+			if (!MAP_NATURAL_SECT(map)) {
+				SET_MAP_NATURAL_SECT(map, ocean);
 			}
 			
 			// update land_map
-			map->next = NULL;
-			if (map->sector_type != ocean) {
-				if (last) {
-					last->next = map;
+			MAP_NEXT_LAND(map) = NOWHERE;
+			if (MAP_SECT(map) != ocean) {
+				if (last != NOWHERE) {
+					MAP_NEXT_LAND(last) = map;
 				}
 				else {
 					land_map = map;
@@ -2889,16 +3551,15 @@ void build_land_map(void) {
 			}
 			
 			// index sector
-			idx = find_sector_index(GET_SECT_VNUM(map->sector_type));
+			idx = find_sector_index(GET_SECT_VNUM(MAP_SECT(map)));
 			++idx->sect_count;
-			LL_PREPEND2(idx->sect_rooms, map, next_in_sect);
+			add_to_sect_rooms(idx, map);
 			
 			// index base
-			if (map->base_sector != map->sector_type) {
-				idx = find_sector_index(GET_SECT_VNUM(map->base_sector));
+			if (MAP_BASE_SECT(map) != MAP_SECT(map)) {
+				idx = find_sector_index(GET_SECT_VNUM(MAP_BASE_SECT(map)));
 			}
 			++idx->base_count;
-			LL_PREPEND2(idx->base_rooms, map, next_in_base_sect);
 		}
 	}
 	
@@ -2923,31 +3584,161 @@ void build_land_map(void) {
 */
 void build_world_map(void) {
 	room_data *room, *next_room;
-	int x, y;
+	room_vnum map;
 	
 	HASH_ITER(hh, world_table, room, next_room) {
 		if (GET_ROOM_VNUM(room) >= MAP_SIZE) {
 			continue;
 		}
 		
-		x = FLAT_X_COORD(room);
-		y = FLAT_Y_COORD(room);
+		map = GET_ROOM_VNUM(room);
 		
-		world_map[x][y].island = GET_ISLAND_ID(room);
+		MAP_ISLAND(map) = GET_ISLAND_ID(room);
 		
 		if (SECT(room)) {
-			world_map[x][y].sector_type = SECT(room);
+			world_map.sector_type[map] = map_sect_index(SECT(room));
 		}
 		if (BASE_SECT(room)) {
-			world_map[x][y].base_sector = BASE_SECT(room);
+			world_map.base_sector[map] = map_sect_index(BASE_SECT(room));
 		}
 		
 		// we only update the natural sector if it doesn't have one
-		if (!world_map[x][y].natural_sector) {
+		if (!MAP_NATURAL_SECT(map)) {
 			// it's PROBABLY the room's original sect
-			world_map[x][y].natural_sector = BASE_SECT(room);
+			SET_MAP_NATURAL_SECT(map, BASE_SECT(room));
+		}
+	}
+}
+
+
+/**
+* Computes the checksum for a binary base map's tile records (32-bit FNV-1a).
+*
+* @param const struct world_map_file_tile *tiles The tile records.
+* @param int num_tiles How many records there are.
+* @return unsigned int The checksum.
+*/
+static unsigned int world_map_file_checksum(const struct world_map_file_tile *tiles, int num_tiles) {
+	const unsigned char *ptr = (const unsigned char*) tiles;
+	size_t iter, size = num_tiles * sizeof(struct world_map_file_tile);
+	unsigned int hash = 2166136261U;
+	
+	for (iter = 0; iter < size; ++iter) {
+		hash ^= ptr[iter];
+		hash *= 16777619U;
+	}
+	
+	return hash;
+}
+
+
+/**
+* Applies one base map record (from either file format) to the world_map.
+*
+* @param const struct world_map_file_tile *tile The record to load.
+*/
+static void load_world_map_tile(const struct world_map_file_tile *tile) {
+	room_vnum map;
+	
+	if (tile->x < 0 || tile->x >= MAP_WIDTH || tile->y < 0 || tile->y >= MAP_HEIGHT) {
+		log("Encountered bad location in world map file: (%d, %d)", tile->x, tile->y);
+		return;
+	}
+	
+	map = MAP_TILE(tile->x, tile->y);
+	
+	MAP_ISLAND(map) = tile->island;
+	
+	// these will be validated later
+	world_map.sector_type[map] = map_sect_index(sector_proto(tile->sector_type));
+	world_map.base_sector[map] = map_sect_index(sector_proto(tile->base_sector));
+	SET_MAP_NATURAL_SECT(map, sector_proto(tile->natural_sector));
+	SET_MAP_CROP(map, crop_proto(tile->crop_type));
+}
+
+
+/**
+* Loads the binary base map, which is memory-mapped where possible. If the
+* file is missing or doesn't validate, the caller should fall back to the text
+* base map.
+*
+* @return bool TRUE if the binary map was loaded, FALSE if not.
+*/
+static bool load_binary_world_map(void) {
+	const struct world_map_file_header *header;
+	const struct world_map_file_tile *tiles;
+	struct stat statbuf;
+	char *data, *error = NULL;
+	int fd, iter;
+	
+	if ((fd = open(WORLD_MAP_BINARY_FILE, O_RDONLY)) < 0) {
+		return FALSE;
+	}
+	if (fstat(fd, &statbuf) < 0 || statbuf.st_size < sizeof(struct world_map_file_header)) {
+		log("SYSERR: %s is too short to be a base map", WORLD_MAP_BINARY_FILE);
+		close(fd);
+		return FALSE;
+	}
+	
+#ifdef HAVE_SYS_MMAN_H
+	if ((data = mmap(NULL, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+		log("SYSERR: Unable to mmap %s: %s", WORLD_MAP_BINARY_FILE, strerror(errno));
+		close(fd);
+		return FALSE;
+	}
+#else
+	{
+		ssize_t got, size = 0;
+		CREATE(data, char, statbuf.st_size);
+		while (size < statbuf.st_size && (got = read(fd, data + size, statbuf.st_size - size)) > 0) {
+			size += got;
+		}
+		if (size < statbuf.st_size) {
+			error = "short read";
+		}
+	}
+#endif
+	
+	header = (const struct world_map_file_header*) data;
+	tiles = (const struct world_map_file_tile*) (data + sizeof(struct world_map_file_header));
+	
+	// validate
+	if (error) {
+		// already failed
+	}
+	else if (memcmp(header->magic, WORLD_MAP_FILE_MAGIC, sizeof(header->magic))) {
+		error = "not a base map file";
+	}
+	else if (header->byte_order != WORLD_MAP_FILE_BYTE_ORDER) {
+		error = "saved with a different byte order";
+	}
+	else if (header->version != WORLD_MAP_FILE_VERSION || header->tile_size != sizeof(struct world_map_file_tile)) {
+		error = "unknown version";
+	}
+	else if (header->num_tiles < 0 || statbuf.st_size != sizeof(struct world_map_file_header) + (off_t) header->num_tiles * sizeof(struct world_map_file_tile)) {
+		error = "wrong file size";
+	}
+	else if (header->checksum != world_map_file_checksum(tiles, header->num_tiles)) {
+		error = "bad checksum";
+	}
+	
+	if (!error) {
+		for (iter = 0; iter < header->num_tiles; ++iter) {
+			load_world_map_tile(&tiles[iter]);
 		}
+		log(" - loaded %d tiles from %s", header->num_tiles, WORLD_MAP_BINARY_FILE);
+	}
+	else {
+		log("SYSERR: Unable to load %s: %s", WORLD_MAP_BINARY_FILE, error);
 	}
+	
+#ifdef HAVE_SYS_MMAN_H
+	munmap(data, statbuf.st_size);
+#else
+	free(data);
+#endif
+	close(fd);
+	return error ? FALSE : TRUE;
 }
 
 
@@ -2955,25 +3746,41 @@ void build_world_map(void) {
 * This loads the world_map array from file. This is optional, and this data
 * can be overwritten by the actual rooms from the .wld files. This should be
 * run after sectors are loaded, and before the .wld files are read in.
+*
+* The binary base map is preferred; the text one is read only if there's no
+* usable binary file (e.g. a world from before the binary format), and the
+* next save will write it out as binary.
 */
 void load_world_map_from_file(void) {
-	struct map_data *map;
-	int var[7], x, y;
+	extern int map_sect_table_size, map_crop_table_size;
+	
+	struct world_map_file_tile tile;
 	char line[256];
+	room_vnum map;
 	FILE *fl;
 	
-	// init
-	land_map = NULL;
-	for (x = 0; x < MAP_WIDTH; ++x) {
-		for (y = 0; y < MAP_HEIGHT; ++y) {
-			world_map[x][y].vnum = (y * MAP_WIDTH) + x;
-			world_map[x][y].island = NO_ISLAND;
-			world_map[x][y].sector_type = NULL;
-			world_map[x][y].base_sector = NULL;
-			world_map[x][y].natural_sector = NULL;
-			world_map[x][y].crop_type = NULL;
-			world_map[x][y].next = NULL;
-		}
+	// init: index 0 in each table is 'none'
+	if (!map_sect_table) {
+		map_sect_table_size = 32;
+		CREATE(map_sect_table, sector_data*, map_sect_table_size);
+	}
+	if (!map_crop_table) {
+		map_crop_table_size = 32;
+		CREATE(map_crop_table, crop_data*, map_crop_table_size);
+	}
+	land_map = NOWHERE;
+	for (map = 0; map < MAP_SIZE; ++map) {
+		MAP_ISLAND(map) = NO_ISLAND;
+		world_map.sector_type[map] = 0;
+		world_map.base_sector[map] = 0;
+		world_map.natural_sector[map] = 0;
+		world_map.crop_type[map] = 0;
+		world_map.sect_pos[map] = -1;
+		MAP_NEXT_LAND(map) = NOWHERE;
+	}
+	
+	if (load_binary_world_map()) {
+		return;
 	}
 	
 	if (!(fl = fopen(WORLD_MAP_FILE, "r"))) {
@@ -2988,54 +3795,90 @@ void load_world_map_from_file(void) {
 		}
 		
 		// x y island sect base natural crop
-		if (sscanf(line, "%d %d %d %d %d %d %d", &var[0], &var[1], &var[2], &var[3], &var[4], &var[5], &var[6]) != 7) {
+		if (sscanf(line, "%d %d %d %d %d %d %d", &tile.x, &tile.y, &tile.island, &tile.sector_type, &tile.base_sector, &tile.natural_sector, &tile.crop_type) != 7) {
 			log("Encountered bad line in world map file: %s", line);
 			continue;
 		}
-		if (var[0] < 0 || var[0] >= MAP_WIDTH || var[1] < 0 || var[1] >= MAP_HEIGHT) {
-			log("Encountered bad location in world map file: (%d, %d)", var[0], var[1]);
-			continue;
-		}
-		
-		map = &(world_map[var[0]][var[1]]);
 		
-		map->island = var[2];
-		
-		// these will be validated later
-		map->sector_type = sector_proto(var[3]);
-		map->base_sector = sector_proto(var[4]);
-		map->natural_sector = sector_proto(var[5]);
-		map->crop_type = crop_proto(var[6]);
+		load_world_map_tile(&tile);
 	}
 	
 	fclose(fl);
+	
+	// make sure it gets converted
+	world_map_needs_save = TRUE;
 }
 
 
 /**
-* Outputs the land portion of the world map to the map file.
+* Outputs the land portion of the world map to the binary map file, as a
+* single write.
+*
+* @return bool TRUE if the file saved (or didn't need to); FALSE if it couldn't be written.
 */
-void save_world_map_to_file(void) {	
-	struct map_data *iter;
+bool save_world_map_to_file(void) {
+	struct world_map_file_header *header;
+	struct world_map_file_tile *tiles;
+	int num_tiles, pos;
+	room_vnum iter;
+	bool written;
+	size_t size;
+	char *data;
 	FILE *fl;
 	
 	// shortcut
 	if (!world_map_needs_save) {
-		return;
-	}
-	
-	if (!(fl = fopen(WORLD_MAP_FILE TEMP_SUFFIX, "w"))) {
-		log("Unable to open %s for writing", WORLD_MAP_FILE TEMP_SUFFIX);
-		return;
+		return TRUE;
 	}
 	
 	// only bother with ones that aren't base ocean
-	for (iter = land_map; iter; iter = iter->next) {
-		// x y island sect base natural crop
-		fprintf(fl, "%d %d %d %d %d %d %d\n", MAP_X_COORD(iter->vnum), MAP_Y_COORD(iter->vnum), iter->island, (iter->sector_type ? GET_SECT_VNUM(iter->sector_type) : -1), (iter->base_sector ? GET_SECT_VNUM(iter->base_sector) : -1), (iter->natural_sector ? GET_SECT_VNUM(iter->natural_sector) : -1), (iter->crop_type ? GET_CROP_VNUM(iter->crop_type) : -1));
+	num_tiles = 0;
+	for (iter = land_map; iter != NOWHERE; iter = MAP_NEXT_LAND(iter)) {
+		++num_tiles;
+	}
+	
+	size = sizeof(struct world_map_file_header) + num_tiles * sizeof(struct world_map_file_tile);
+	CREATE(data, char, size);
+	header = (struct world_map_file_header*) data;
+	tiles = (struct world_map_file_tile*) (data + sizeof(struct world_map_file_header));
+	
+	pos = 0;
+	for (iter = land_map; iter != NOWHERE && pos < num_tiles; iter = MAP_NEXT_LAND(iter), ++pos) {
+		tiles[pos].x = MAP_X_COORD(iter);
+		tiles[pos].y = MAP_Y_COORD(iter);
+		tiles[pos].island = MAP_ISLAND(iter);
+		tiles[pos].sector_type = MAP_SECT(iter) ? GET_SECT_VNUM(MAP_SECT(iter)) : -1;
+		tiles[pos].base_sector = MAP_BASE_SECT(iter) ? GET_SECT_VNUM(MAP_BASE_SECT(iter)) : -1;
+		tiles[pos].natural_sector = MAP_NATURAL_SECT(iter) ? GET_SECT_VNUM(MAP_NATURAL_SECT(iter)) : -1;
+		tiles[pos].crop_type = MAP_CROP(iter) ? GET_CROP_VNUM(MAP_CROP(iter)) : -1;
+	}
+	
+	memcpy(header->magic, WORLD_MAP_FILE_MAGIC, sizeof(header->magic));
+	header->version = WORLD_MAP_FILE_VERSION;
+	header->byte_order = WORLD_MAP_FILE_BYTE_ORDER;
+	header->tile_size = sizeof(struct world_map_file_tile);
+	header->width = MAP_WIDTH;
+	header->height = MAP_HEIGHT;
+	header->num_tiles = num_tiles;
+	header->checksum = world_map_file_checksum(tiles, num_tiles);
+	
+	if (!(fl = fopen(WORLD_MAP_BINARY_FILE TEMP_SUFFIX, "wb"))) {
+		log("Unable to open %s for writing", WORLD_MAP_BINARY_FILE TEMP_SUFFIX);
+		free(data);
+		return FALSE;
+	}
+	written = (fwrite(data, size, 1, fl) == 1);
+	if (fclose(fl) != 0 || !written) {
+		log("SYSERR: Unable to write %s: %s", WORLD_MAP_BINARY_FILE TEMP_SUFFIX, strerror(errno));
+		free(data);
+		return FALSE;
+	}
+	
+	free(data);
+	if (rename(WORLD_MAP_BINARY_FILE TEMP_SUFFIX, WORLD_MAP_BINARY_FILE) != 0) {
+		log("SYSERR: Unable to rename %s: %s", WORLD_MAP_BINARY_FILE TEMP_SUFFIX, strerror(errno));
+		return FALSE;
 	}
-	
-	fclose(fl);
-	rename(WORLD_MAP_FILE TEMP_SUFFIX, WORLD_MAP_FILE);
 	world_map_needs_save = FALSE;
+	return TRUE;
 }
@@ -32,6 +32,8 @@ extern int max_vehicle_id;
 extern struct reboot_control_data reboot_control;
 
 // external fucs
+void compile_script_lines(struct cmdlist_element *list);
+void free_compiled_expr(struct dg_compiled_expr *expr);
 extern void half_chop(char *string, char *arg1, char *arg2);
 
 // locals
@@ -67,10 +69,30 @@ struct cmdlist_element *compile_command_list(char *input) {
 		list->cmd = strdup("* No Script");
 	}
 
+	compile_script_lines(list);
 	return list;
 }
 
 
+/**
+* Frees a command list from compile_command_list() or parse_trigger().
+*
+* @param struct cmdlist_element *list The command list to free.
+*/
+void free_command_list(struct cmdlist_element *list) {
+	struct cmdlist_element *cmd, *next_cmd;
+	
+	for (cmd = list; cmd; cmd = next_cmd) {
+		next_cmd = cmd->next;
+		if (cmd->cmd) {
+			free(cmd->cmd);
+		}
+		free_compiled_expr(cmd->expr);
+		free(cmd);
+	}
+}
+
+
 void parse_trigger(FILE *trig_f, int nr) {
 	void add_trigger_to_table(trig_data *trig);
 
@@ -106,6 +128,7 @@ void parse_trigger(FILE *trig_f, int nr) {
 		cle = cle->next;
 		cle->cmd = strdup(s);
 	}
+	compile_script_lines(trig->cmdlist);
 
 	free(cmds);
 }
@@ -112,11 +112,18 @@ long event_time(struct event *event) {
 /* frees all events in the queue */
 void event_free_all(void) {
 	struct event *the_event;
-
-	while ((the_event = (struct event *) queue_head(event_q))) {
-		if (the_event->event_obj)
-			free(the_event->event_obj);
-		free(the_event);
+	struct q_element *qe;
+	int level, slot;
+
+	for (level = 0; level < EVENT_WHEEL_LEVELS; ++level) {
+		for (slot = 0; slot < EVENT_WHEEL_SLOTS; ++slot) {
+			for (qe = event_q->head[level][slot]; qe; qe = qe->next) {
+				the_event = (struct event *) qe->data;
+				if (the_event->event_obj)
+					free(the_event->event_obj);
+				free(the_event);
+			}
+		}
 	}
 
 	queue_free(event_q);
@@ -141,49 +148,96 @@ struct queue *queue_init(void) {
 	struct queue *q;
 
 	CREATE(q, struct queue, 1);
+	q->now = pulse;
 
 	return q;
 }
 
 
-/* add data into the priority queue q with key */
-struct q_element *queue_enq(struct queue *q, void *data, long key) {
-	struct q_element *qe, *i;
-	int bucket;
+/* links qe into the wheel slot for its key, relative to q->now */
+static void queue_place(struct queue *q, struct q_element *qe) {
+	long key = MAX(qe->key, q->now);	// overdue elements go in the current slot
+	int level;
 
-	CREATE(qe, struct q_element, 1);
-	qe->data = data;
-	qe->key = key;
+	// lowest level whose higher bits match 'now' (top level takes the rest)
+	for (level = 0; level < EVENT_WHEEL_LEVELS - 1; ++level) {
+		if ((key >> (EVENT_WHEEL_BITS * (level + 1))) == (q->now >> (EVENT_WHEEL_BITS * (level + 1)))) {
+			break;
+		}
+	}
 
-	bucket = key % NUM_EVENT_QUEUES;   /* which queue does this go in */
+	qe->level = level;
+	qe->slot = (key >> (EVENT_WHEEL_BITS * level)) & EVENT_WHEEL_MASK;
+	qe->next = NULL;
+	qe->prev = q->tail[level][qe->slot];
 
-	if (!q->head[bucket]) { /* queue is empty */
-		q->head[bucket] = qe;
-		q->tail[bucket] = qe;
+	if (qe->prev) {
+		qe->prev->next = qe;
 	}
-
 	else {
-		for (i = q->tail[bucket]; i; i = i->prev) {
-			if (i->key < key) { /* found insertion point */
-				if (i == q->tail[bucket])
-					q->tail[bucket] = qe;
-				else {
-					qe->next = i->next;
-					i->next->prev = qe;
-				}
-
-				qe->prev = i;
-				i->next = qe;
-				break;
-			}
+		q->head[level][qe->slot] = qe;
+	}
+	q->tail[level][qe->slot] = qe;
+}
+
+
+/* unlinks qe from its wheel slot without freeing it */
+static void queue_unlink(struct queue *q, struct q_element *qe) {
+	if (qe->prev == NULL)
+		q->head[qe->level][qe->slot] = qe->next;
+	else
+		qe->prev->next = qe->next;
+
+	if (qe->next == NULL)
+		q->tail[qe->level][qe->slot] = qe->prev;
+	else
+		qe->next->prev = qe->prev;
+
+	qe->prev = qe->next = NULL;
+}
+
+
+/*
+* moves q->now ahead one pulse, cascading higher-level slots down into the
+* lower levels whenever a level wraps
+*/
+static void queue_tick(struct queue *q) {
+	struct q_element *qe, *next_qe;
+	int level, top, slot;
+
+	++q->now;
+
+	// find the highest level that wrapped on this tick
+	for (top = 0; top < EVENT_WHEEL_LEVELS - 1; ++top) {
+		if ((q->now >> (EVENT_WHEEL_BITS * top)) & EVENT_WHEEL_MASK) {
+			break;
 		}
+	}
+
+	// cascade from the top down, so entries can fall more than one level
+	for (level = top; level > 0; --level) {
+		slot = (q->now >> (EVENT_WHEEL_BITS * level)) & EVENT_WHEEL_MASK;
+		qe = q->head[level][slot];
+		q->head[level][slot] = q->tail[level][slot] = NULL;
 
-		if (i == NULL) { /* insertion point is front of list */
-			qe->next = q->head[bucket];
-			q->head[bucket] = qe;
-			qe->next->prev = qe;
+		for (; qe; qe = next_qe) {
+			next_qe = qe->next;
+			queue_place(q, qe);
 		}
 	}
+}
+
+
+/* add data into the priority queue q with key */
+struct q_element *queue_enq(struct queue *q, void *data, long key) {
+	struct q_element *qe;
+
+	CREATE(qe, struct q_element, 1);
+	qe->data = data;
+	qe->key = key;
+
+	queue_place(q, qe);
+	++q->count;
 
 	return qe;
 }
@@ -191,22 +245,10 @@ struct q_element *queue_enq(struct queue *q, void *data, long key) {
 
 /* remove queue element qe from the priority queue q */
 void queue_deq(struct queue *q, struct q_element *qe) {
-	int i;
-
 	assert(qe);
 
-	i = qe->key % NUM_EVENT_QUEUES;
-
-	if (qe->prev == NULL)
-		q->head[i] = qe->next;
-	else
-		qe->prev->next = qe->next;
-
-	if (qe->next == NULL)
-		q->tail[i] = qe->prev;
-	else
-		qe->next->prev = qe->prev;
-
+	queue_unlink(q, qe);
+	--q->count;
 	free(qe);
 }
 
@@ -214,35 +256,36 @@ void queue_deq(struct queue *q, struct q_element *qe) {
 /*
 * removes and returns the data of the
 * first element of the priority queue q
+* (call queue_key() first to bring the wheel up to date)
 */
 void *queue_head(struct queue *q) {
+	struct q_element *qe;
 	void *data;
-	int i;
-
-	i = pulse % NUM_EVENT_QUEUES;
 
-	if (!q->head[i])
+	if (!(qe = q->head[0][q->now & EVENT_WHEEL_MASK]))
 		return NULL;
 
-	data = q->head[i]->data;
-	queue_deq(q, q->head[i]);
+	data = qe->data;
+	queue_deq(q, qe);
 	return data;
 }
 
 
 /*
-* returns the key of the head element of the priority queue
-* if q is NULL, then return the largest unsigned number
+* returns the key of the head element of the priority queue, advancing the
+* wheel up to the current pulse; returns LONG_MAX if nothing is due yet
 */
 long queue_key(struct queue *q) {
-	int i;
+	struct q_element *qe;
 
-	i = pulse % NUM_EVENT_QUEUES;
+	for (;;) {
+		if ((qe = q->head[0][q->now & EVENT_WHEEL_MASK]))
+			return MIN(qe->key, q->now);
+		if (q->now >= (long) pulse)
+			return LONG_MAX;
 
-	if (q->head[i])
-		return q->head[i]->key;
-	else
-		return LONG_MAX;
+		queue_tick(q);
+	}
 }
 
 
@@ -252,16 +295,23 @@ long queue_elmt_key(struct q_element *qe) {
 }
 
 
+/* returns the number of elements in the queue */
+int queue_count(struct queue *q) {
+	return q->count;
+}
+
+
 /* free q and contents */
 void queue_free(struct queue *q) {
-	int i;
+	int level, slot;
 	struct q_element *qe, *next_qe;
 
-	for (i = 0; i < NUM_EVENT_QUEUES; i++)
-		for (qe = q->head[i]; qe; qe = next_qe) {
-			next_qe = qe->next;
-			free(qe);
-		}
+	for (level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+		for (slot = 0; slot < EVENT_WHEEL_SLOTS; ++slot)
+			for (qe = q->head[level][slot]; qe; qe = next_qe) {
+				next_qe = qe->next;
+				free(qe);
+			}
 
 	free(q);
 }
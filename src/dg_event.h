@@ -36,16 +36,28 @@ struct event {
 
 /***** Queue related info ******/
 
-/* number of queues to use (reduces enqueue cost) */
-#define NUM_EVENT_QUEUES    10
+/*
+* The event queue is a hierarchical timing wheel: each level has
+* EVENT_WHEEL_SLOTS unsorted lists, and each level covers EVENT_WHEEL_BITS
+* more bits of the pulse than the one below it. Scheduling and canceling are
+* O(1); entries cascade down a level each time the level below wraps.
+*/
+#define EVENT_WHEEL_BITS  8
+#define EVENT_WHEEL_SLOTS  (1 << EVENT_WHEEL_BITS)
+#define EVENT_WHEEL_MASK  (EVENT_WHEEL_SLOTS - 1)
+#define EVENT_WHEEL_LEVELS  4	// 4 levels of 8 bits covers 2^32 pulses (~13 years)
 
 struct queue {
-	struct q_element *head[NUM_EVENT_QUEUES], *tail[NUM_EVENT_QUEUES];
+	struct q_element *head[EVENT_WHEEL_LEVELS][EVENT_WHEEL_SLOTS];
+	struct q_element *tail[EVENT_WHEEL_LEVELS][EVENT_WHEEL_SLOTS];
+	long now;	// the pulse whose level-0 slot is current
+	int count;	// number of queued elements
 };
 
 struct q_element {
 	void *data;
-	long key;
+	long key;	// the pulse it's due
+	int level, slot;	// where it is in the wheel
 	struct q_element *prev, *next;
 };
 /****** End of Queue related info ********/
@@ -65,5 +77,6 @@ void queue_deq(struct queue *q, struct q_element *qe);
 void *queue_head(struct queue *q);
 long queue_key(struct queue *q);
 long queue_elmt_key(struct q_element *qe);
+int queue_count(struct queue *q);
 void queue_free(struct queue *q);
 int  event_is_queued(struct event *event);
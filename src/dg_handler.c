@@ -86,6 +86,54 @@ struct script_data *create_script_data(void *attach_to, int type) {
 }
 
 
+/**
+* Keeps the per-room and per-character command trigger counts in step when a
+* mob's or object's script gains or loses command triggers. Call this after
+* changing SCRIPT_TYPES(sc), with the types it had before the change.
+*
+* @param struct script_data *sc The script that changed.
+* @param bitvector_t old_types The SCRIPT_TYPES() before the change.
+*/
+void update_command_trigger_counts(struct script_data *sc, bitvector_t old_types) {
+	char_data *mob;
+	obj_data *obj;
+	int change;
+	
+	if (!sc || !sc->attached_to) {
+		return;
+	}
+	
+	switch (sc->attached_type) {
+		case MOB_TRIGGER: {
+			mob = (char_data*)sc->attached_to;
+			change = (IS_SET(SCRIPT_TYPES(sc), MTRIG_COMMAND) ? 1 : 0) - (IS_SET(old_types, MTRIG_COMMAND) ? 1 : 0);
+			if (change && IN_ROOM(mob)) {
+				ROOM_COMMAND_TRIG_MOBS(IN_ROOM(mob)) += change;
+			}
+			break;
+		}
+		case OBJ_TRIGGER: {
+			obj = (obj_data*)sc->attached_to;
+			change = (IS_SET(SCRIPT_TYPES(sc), OTRIG_COMMAND) ? 1 : 0) - (IS_SET(old_types, OTRIG_COMMAND) ? 1 : 0);
+			if (!change) {
+				break;
+			}
+			if (obj->carried_by) {
+				GET_COMMAND_TRIG_OBJS(obj->carried_by) += change;
+			}
+			else if (obj->worn_by) {
+				GET_COMMAND_TRIG_OBJS(obj->worn_by) += change;
+			}
+			else if (IN_ROOM(obj)) {
+				ROOM_COMMAND_TRIG_OBJS(IN_ROOM(obj)) += change;
+			}
+			break;
+		}
+		// rooms and vehicles are checked directly
+	}
+}
+
+
 /* release memory allocated for a variable list */
 void free_varlist(struct trig_var_data *vd) {
 	struct trig_var_data *i, *j;
@@ -183,6 +231,12 @@ void extract_script(void *thing, int type) {
 			return;
 		}
 	}
+	
+	if (sc && SCRIPT_TYPES(sc)) {
+		bitvector_t old_types = SCRIPT_TYPES(sc);
+		SCRIPT_TYPES(sc) = 0;
+		update_command_trigger_counts(sc, old_types);
+	}
 
 	#if 0 /* debugging */
 	{
@@ -74,7 +74,7 @@ room_data *do_dg_add_room_dir(room_data *from, int dir, bld_data *bld) {
 		COMPLEX_DATA(new)->vehicle = GET_ROOM_VEHICLE(from);
 		add_room_to_vehicle(new, GET_ROOM_VEHICLE(from));
 		SET_BIT(ROOM_AFF_FLAGS(new), ROOM_AFF_IN_VEHICLE);
-		SET_BIT(ROOM_BASE_FLAGS(new), ROOM_AFF_IN_VEHICLE);
+		set_room_base_flags(new, ROOM_AFF_IN_VEHICLE);
 	}
 	
 	if (ROOM_OWNER(home)) {
@@ -374,7 +374,7 @@ void do_dg_own(empire_data *emp, char_data *vict, obj_data *obj, room_data *room
 				abandon_room(VEH_INTERIOR_HOME_ROOM(veh));
 			}
 		}
-		VEH_OWNER(veh) = emp;
+		set_vehicle_owner(veh, emp);
 		if (emp && VEH_INTERIOR_HOME_ROOM(veh)) {
 			claim_room(VEH_INTERIOR_HOME_ROOM(veh), emp);
 		}
@@ -1222,6 +1222,7 @@ ACMD(do_mrestore) {
 			GET_BUILDING_RESOURCES(room) = NULL;
 			COMPLEX_DATA(room)->damage = 0;
 			COMPLEX_DATA(room)->burning = 0;
+			request_world_save(GET_ROOM_VNUM(room));
 		}
 	}
 }
@@ -1979,6 +1980,7 @@ ACMD(do_mtransform) {
 		}
 		GET_POS(&tmpmob) = GET_POS(ch);
 		IS_CARRYING_N(&tmpmob) = IS_CARRYING_N(ch);
+		GET_COMMAND_TRIG_OBJS(&tmpmob) = GET_COMMAND_TRIG_OBJS(ch);
 		FIGHTING(&tmpmob) = FIGHTING(ch);
 		HUNTING(&tmpmob) = HUNTING(ch);
 		memcpy(ch, &tmpmob, sizeof(*ch));
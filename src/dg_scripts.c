@@ -33,6 +33,9 @@
 /* external vars from db.c */
 extern unsigned long pulse;
 
+// when TRUE, var_subst() copies text as-is; used by "util scriptbench"
+bool script_dry_run = FALSE;
+
 /* other external vars */
 extern const char *action_bits[];
 extern const char *affected_bits[];
@@ -211,7 +214,7 @@ int can_wear_on_pos(obj_data *obj, int pos) {
 * @return bool TRUE if there are players nearby.
 */
 static bool players_nearby_script(room_data *loc) {
-	return distance_to_nearest_player(loc) <= player_script_radius;
+	return is_player_nearby(loc, player_script_radius);
 }
 
 
@@ -1335,6 +1338,7 @@ void do_sstat_character(char_data *ch, char_data *k) {
 * add to the end, loc = 0 means add before all other triggers.
 */
 void add_trigger(struct script_data *sc, trig_data *t, int loc) {
+	bitvector_t old_types = SCRIPT_TYPES(sc);
 	trig_data *i;
 	int n;
 
@@ -1353,6 +1357,7 @@ void add_trigger(struct script_data *sc, trig_data *t, int loc) {
 
 	SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(t);
 	t->attached_to = sc;
+	update_command_trigger_counts(sc, old_types);
 	
 	// add to lists
 	LL_PREPEND2(trigger_list, t, next_in_world);
@@ -1583,6 +1588,7 @@ void add_var(struct trig_var_data **var_list, char *name, char *value, int id) {
 *  this function returns, in order to remove the script.
 */
 int remove_trigger(struct script_data *sc, char *name) {
+	bitvector_t old_types;
 	trig_data *i, *j;
 	int num = 0, string = FALSE, n;
 	char *cname;
@@ -1628,9 +1634,11 @@ int remove_trigger(struct script_data *sc, char *name) {
 		}
 
 		/* update the script type bitvector */
+		old_types = SCRIPT_TYPES(sc);
 		SCRIPT_TYPES(sc) = 0;
 		for (i = TRIGGERS(sc); i; i = i->next)
 			SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(i);
+		update_command_trigger_counts(sc, old_types);
 
 		return 1;
 	}
@@ -4795,7 +4803,7 @@ void var_subst(void *go, struct script_data *sc, trig_data *trig, int type, char
 	int dots = 0;
 
 	/* skip out if no %'s */
-	if (!strchr(line, '%')) {
+	if (script_dry_run || !strchr(line, '%')) {
 		strcpy(buf, line);
 		return;
 	}
@@ -5063,12 +5071,12 @@ void eval_expr(char *line, char *result, void *go, struct script_data *sc, trig_
 
 
 /*
-* evaluates expr if it is in the form lhs op rhs, and copies
-* answer in result.  returns 1 if expr is evaluated, else 0
+* splits line (in place) if it is in the form lhs op rhs: line becomes the
+* lhs, and rhs is set to the text after the op. returns the op, or NULL if
+* there isn't one. line must be shorter than MAX_INPUT_LENGTH.
 */
-int eval_lhs_op_rhs(char *expr, char *result, void *go, struct script_data *sc, trig_data *trig, int type) {
+static char *split_lhs_op_rhs(char *line, char **rhs) {
 	char *p, *tokens[MAX_INPUT_LENGTH];
-	char line[MAX_INPUT_LENGTH], lhr[MAX_INPUT_LENGTH], rhr[MAX_INPUT_LENGTH];
 	int i, j, oplist, tsize;
 	char *found;
 
@@ -5092,7 +5100,7 @@ int eval_lhs_op_rhs(char *expr, char *result, void *go, struct script_data *sc,
 	// symbols used in operators
 	const char *opsymbols = "!/*+-<>=~&|";
 
-	p = strcpy(line, expr);
+	p = line;
 
 	/*
 	* initialize tokens, an array of pointers to locations
@@ -5130,18 +5138,33 @@ int eval_lhs_op_rhs(char *expr, char *result, void *go, struct script_data *sc,
 	
 			if (found) {
 				*tokens[j] = '\0';
-				p = tokens[j] + strlen(found);
-
-				eval_expr(line, lhr, go, sc, trig, type);
-				eval_expr(p, rhr, go, sc, trig, type);
-				eval_op(found, lhr, rhr, result, go, sc, trig);
-
-				return 1;
+				*rhs = tokens[j] + strlen(found);
+				return found;
 			}
 		}
 	}
 
-	return 0;
+	return NULL;
+}
+
+
+/*
+* evaluates expr if it is in the form lhs op rhs, and copies
+* answer in result.  returns 1 if expr is evaluated, else 0
+*/
+int eval_lhs_op_rhs(char *expr, char *result, void *go, struct script_data *sc, trig_data *trig, int type) {
+	char line[MAX_INPUT_LENGTH], lhr[MAX_INPUT_LENGTH], rhr[MAX_INPUT_LENGTH];
+	char *op, *rhs;
+	
+	strcpy(line, expr);
+	if (!(op = split_lhs_op_rhs(line, &rhs))) {
+		return 0;
+	}
+	
+	eval_expr(line, lhr, go, sc, trig, type);
+	eval_expr(rhs, rhr, go, sc, trig, type);
+	eval_op(op, lhr, rhr, result, go, sc, trig);
+	return 1;
 }
 
 
@@ -5224,6 +5247,390 @@ struct cmdlist_element *find_else_end(trig_data *trig, struct cmdlist_element *c
 }
 
 
+/*
+* Compiles a condition into a tree, splitting it exactly as eval_expr() would
+* split the same text each time it ran.
+*
+* @param char *line The condition text; must be shorter than MAX_INPUT_LENGTH.
+* @return struct dg_compiled_expr* The compiled condition.
+*/
+static struct dg_compiled_expr *compile_expr(char *line) {
+	char copy[MAX_INPUT_LENGTH], *op, *rhs;
+	struct dg_compiled_expr *expr;
+	
+	while (*line && isspace(*line)) {
+		line++;
+	}
+	
+	strcpy(copy, line);
+	if ((op = split_lhs_op_rhs(copy, &rhs))) {
+		CREATE(expr, struct dg_compiled_expr, 1);
+		expr->op = op;
+		expr->lhs = compile_expr(copy);
+		expr->rhs = compile_expr(rhs);
+		return expr;
+	}
+	else if (*line == '(') {
+		strcpy(copy, line);
+		*matching_paren(copy) = '\0';
+		return compile_expr(copy + 1);
+	}
+	else {
+		CREATE(expr, struct dg_compiled_expr, 1);
+		expr->text = str_dup(line);
+		return expr;
+	}
+}
+
+
+/**
+* Frees a compiled condition.
+*
+* @param struct dg_compiled_expr *expr The condition to free.
+*/
+void free_compiled_expr(struct dg_compiled_expr *expr) {
+	if (expr) {
+		free_compiled_expr(expr->lhs);
+		free_compiled_expr(expr->rhs);
+		if (expr->text) {
+			free(expr->text);
+		}
+		free(expr);
+	}
+}
+
+
+/* evaluates a compiled condition, the same as eval_expr() on its text */
+static void eval_compiled_expr(struct dg_compiled_expr *expr, char *result, void *go, struct script_data *sc, trig_data *trig, int type) {
+	char lhr[MAX_INPUT_LENGTH], rhr[MAX_INPUT_LENGTH];
+	
+	if (expr->op) {
+		eval_compiled_expr(expr->lhs, lhr, go, sc, trig, type);
+		eval_compiled_expr(expr->rhs, rhr, go, sc, trig, type);
+		eval_op(expr->op, lhr, rhr, result, go, sc, trig);
+	}
+	else {
+		var_subst(go, sc, trig, type, expr->text, result);
+	}
+}
+
+
+/**
+* Determines what kind of line script_driver() is looking at, in the same
+* order it always checked them.
+*
+* @param char *p The line, after any leading spaces.
+* @return int A DG_LINE_x type.
+*/
+static int get_script_line_type(char *p) {
+	if (*p == '*') {
+		return DG_LINE_COMMENT;
+	}
+	else if (!strn_cmp(p, "if ", 3)) {
+		return DG_LINE_IF;
+	}
+	else if (!strn_cmp("elseif ", p, 7)) {
+		return DG_LINE_ELSEIF;
+	}
+	else if (!strn_cmp("else", p, 4)) {
+		return DG_LINE_ELSE;
+	}
+	else if (!strn_cmp("while ", p, 6)) {
+		return DG_LINE_WHILE;
+	}
+	else if (!strn_cmp("switch ", p, 7)) {
+		return DG_LINE_SWITCH;
+	}
+	else if (!strn_cmp("end", p, 3)) {
+		return DG_LINE_END;
+	}
+	else if (!strn_cmp("done", p, 4)) {
+		return DG_LINE_DONE;
+	}
+	else if (!strn_cmp("break", p, 5)) {
+		return DG_LINE_BREAK;
+	}
+	else if (!strn_cmp("case", p, 4)) {
+		return DG_LINE_CASE;
+	}
+	else {
+		return DG_LINE_COMMAND;
+	}
+}
+
+
+/*
+* find_else_end() without evaluating anything: returns the next elseif, else,
+* or end it would stop at (found = TRUE), or where it would run off the end
+* of the script (found = FALSE).
+*/
+static struct cmdlist_element *scan_else_end(struct cmdlist_element *cl, bool *found) {
+	struct cmdlist_element *c;
+	char *p;
+	
+	*found = FALSE;
+	if (!(cl->next))
+		return cl;
+
+	for (c = cl->next; c && c->next; c = c ? c->next : NULL) {
+		for (p = c->cmd; *p && isspace(*p); p++); /* skip spaces */
+
+		if (!strn_cmp("if ", p, 3))
+			c = find_end(c);
+		else if (!strn_cmp("elseif ", p, 7) || !strn_cmp("else", p, 4) || !strn_cmp("end", p, 3)) {
+			*found = TRUE;
+			return c;
+		}
+	}
+
+	return c;
+}
+
+
+/*
+* find_case() without evaluating anything: returns the next case, default,
+* or done it would stop at (found = TRUE), or where it would run off the end
+* of the script (found = FALSE).
+*/
+static struct cmdlist_element *scan_case(struct cmdlist_element *cl, bool *found) {
+	struct cmdlist_element *c;
+	char *p;
+	
+	*found = FALSE;
+	if (!(cl->next))
+		return cl;
+
+	for (c = cl->next; c && c->next; c = c->next) {
+		for (p = c->cmd; *p && isspace(*p); p++);
+
+		if (!strn_cmp("while ", p, 6) || !strn_cmp("switch", p, 6)) {
+			if (!(c = find_done(c)))
+				break;	// malformed
+		}
+		else if (!strn_cmp("case ", p, 5) || !strn_cmp("default", p, 7) || !strn_cmp("done", p, 3)) {
+			*found = TRUE;
+			return c;
+		}
+	}
+	return c;
+}
+
+
+/**
+* Precompiles a trigger's command list so script_driver() doesn't re-parse
+* it every run: each line gets its type, its condition as a tree, and the
+* lines that find_end(), find_done(), find_else_end() and find_case() would
+* have searched for. Only the text of the lines is used; nothing is
+* evaluated.
+*
+* @param struct cmdlist_element *list The command list to compile.
+*/
+void compile_script_lines(struct cmdlist_element *list) {
+	struct cmdlist_element *cl;
+	char *p, *cond;
+	
+	for (cl = list; cl; cl = cl->next) {
+		for (p = cl->cmd; *p && isspace(*p); p++);
+		cl->type = get_script_line_type(p);
+		
+		switch (cl->type) {
+			case DG_LINE_IF: {
+				cond = p + 3;
+				cl->jump = scan_else_end(cl, &cl->jump_found);
+				break;
+			}
+			case DG_LINE_ELSEIF: {
+				cond = p + 7;
+				cl->jump = scan_else_end(cl, &cl->jump_found);
+				cl->block_end = find_end(cl);
+				break;
+			}
+			case DG_LINE_ELSE: {
+				cond = NULL;
+				cl->block_end = find_end(cl);
+				break;
+			}
+			case DG_LINE_WHILE: {
+				cond = p + 6;
+				cl->block_end = find_done(cl);
+				break;
+			}
+			case DG_LINE_SWITCH: {
+				cond = p + 7;
+				cl->jump = scan_case(cl, &cl->jump_found);
+				break;
+			}
+			case DG_LINE_BREAK: {
+				cond = NULL;
+				cl->block_end = find_done(cl);
+				break;
+			}
+			default: {
+				cond = NULL;
+				break;
+			}
+		}
+		
+		// lines that find_case() may stop at (not quite the same test as DG_LINE_CASE)
+		if (!strn_cmp("case ", p, 5)) {
+			cl->jump = scan_case(cl, &cl->jump_found);
+		}
+		
+		if (cond && strlen(cond) < MAX_INPUT_LENGTH) {
+			cl->expr = compile_expr(cond);
+		}
+	}
+}
+
+
+/* process_if() for a script line, using its compiled condition if possible */
+static int process_if_line(struct cmdlist_element *cl, char *cond, void *go, struct script_data *sc, trig_data *trig, int type) {
+	char result[MAX_INPUT_LENGTH], *p;
+	
+	if (cl->type == DG_LINE_UNKNOWN || !cl->expr) {
+		return process_if(cond, go, sc, trig, type);
+	}
+	
+	eval_compiled_expr(cl->expr, result, go, sc, trig, type);
+
+	p = result;
+	skip_spaces(&p);
+
+	if (!*p || *p == '0')
+		return 0;
+	else
+		return 1;
+}
+
+
+/* find_else_end() using the precompiled jumps, if the line has them */
+static struct cmdlist_element *find_else_end_line(trig_data *trig, struct cmdlist_element *cl, void *go, struct script_data *sc, int type) {
+	struct cmdlist_element *c;
+	bool found;
+	char *p;
+	
+	if (cl->type == DG_LINE_UNKNOWN) {
+		return find_else_end(trig, cl, go, sc, type);
+	}
+	
+	for (c = cl->jump, found = cl->jump_found; found; found = c->jump_found, c = c->jump) {
+		if (c->type == DG_LINE_ELSEIF) {
+			for (p = c->cmd; *p && isspace(*p); p++);
+			if (process_if_line(c, p + 7, go, sc, trig, type)) {
+				GET_TRIG_DEPTH(trig)++;
+				return c;
+			}
+		}
+		else if (c->type == DG_LINE_ELSE) {
+			GET_TRIG_DEPTH(trig)++;
+			return c;
+		}
+		else {	// end
+			return c;
+		}
+	}
+	
+	return c;
+}
+
+
+/* find_case() using the precompiled jumps, if the line has them */
+static struct cmdlist_element *find_case_line(trig_data *trig, struct cmdlist_element *cl, void *go, struct script_data *sc, int type, char *cond) {
+	char result[MAX_INPUT_LENGTH], buf[MAX_STRING_LENGTH];
+	struct cmdlist_element *c;
+	bool found;
+	char *p;
+	
+	if (cl->type == DG_LINE_UNKNOWN || !cl->expr) {
+		return find_case(trig, cl, go, sc, type, cond);
+	}
+	
+	eval_compiled_expr(cl->expr, result, go, sc, trig, type);
+	
+	for (c = cl->jump, found = cl->jump_found; found; found = c->jump_found, c = c->jump) {
+		for (p = c->cmd; *p && isspace(*p); p++);
+		if (strn_cmp("case ", p, 5)) {
+			return c;	// default or done
+		}
+		
+		eval_op("==", result, p + 5, buf, go, sc, trig);
+		if (*buf && *buf != '0') {
+			return c;
+		}
+	}
+	
+	return c;
+}
+
+
+/* find_end() or find_done() for a script line, precompiled if possible */
+static struct cmdlist_element *find_block_end_line(struct cmdlist_element *cl, bool done) {
+	if (cl->type == DG_LINE_UNKNOWN) {
+		return done ? find_done(cl) : find_end(cl);
+	}
+	return cl->block_end;
+}
+
+
+/**
+* Runs the parts of a trigger that compiling replaces -- line types, jumps,
+* and conditions -- over every line once, without running any commands. Use
+* this with script_dry_run so that no variables are looked up.
+*
+* @param trig_data *trig The trigger (its depth is restored afterwards).
+* @param bool compiled If TRUE, uses the compiled lines; otherwise re-parses the text.
+* @return unsigned int A checksum of the outcomes, which must be the same either way.
+*/
+unsigned int run_script_control_flow(trig_data *trig, bool compiled) {
+	struct cmdlist_element *cl, *target;
+	unsigned int hash = 2166136261U;
+	int line_type, result, depth;
+	char *p;
+	
+	depth = GET_TRIG_DEPTH(trig);
+	
+	for (cl = trig->cmdlist; cl; cl = cl->next) {
+		for (p = cl->cmd; *p && isspace(*p); p++);
+		line_type = compiled ? cl->type : get_script_line_type(p);
+		target = NULL;
+		result = 0;
+		
+		switch (line_type) {
+			case DG_LINE_IF: {
+				result = compiled ? process_if_line(cl, p + 3, NULL, NULL, trig, trig->attach_type) : process_if(p + 3, NULL, NULL, trig, trig->attach_type);
+				target = compiled ? find_else_end_line(trig, cl, NULL, NULL, trig->attach_type) : find_else_end(trig, cl, NULL, NULL, trig->attach_type);
+				break;
+			}
+			case DG_LINE_ELSEIF:
+			case DG_LINE_ELSE: {
+				target = compiled ? find_block_end_line(cl, FALSE) : find_end(cl);
+				break;
+			}
+			case DG_LINE_WHILE: {
+				result = compiled ? process_if_line(cl, p + 6, NULL, NULL, trig, trig->attach_type) : process_if(p + 6, NULL, NULL, trig, trig->attach_type);
+				target = compiled ? find_block_end_line(cl, TRUE) : find_done(cl);
+				break;
+			}
+			case DG_LINE_SWITCH: {
+				target = compiled ? find_case_line(trig, cl, NULL, NULL, trig->attach_type, p + 7) : find_case(trig, cl, NULL, NULL, trig->attach_type, p + 7);
+				break;
+			}
+			case DG_LINE_BREAK: {
+				target = compiled ? find_block_end_line(cl, TRUE) : find_done(cl);
+				break;
+			}
+		}
+		
+		hash = (hash ^ line_type) * 16777619U;
+		hash = (hash ^ result) * 16777619U;
+		hash = (hash ^ (unsigned int)(size_t) target) * 16777619U;
+	}
+	
+	GET_TRIG_DEPTH(trig) = depth;
+	return hash;
+}
+
+
 /* processes any 'wait' commands in a trigger */
 void process_wait(void *go, trig_data *trig, int type, char *cmd, struct cmdlist_element *cl) {
 	char buf[MAX_INPUT_LENGTH], *arg;
@@ -5755,11 +6162,14 @@ void process_remote(struct script_data *sc, trig_data *trig, char *cmd) {
 
 	if ((room = find_room(uid))) {
 		sc_remote = SCRIPT(room);
+		request_world_save(GET_ROOM_VNUM(room));
 	}
 	else if ((mob = find_char(uid))) {
 		sc_remote = SCRIPT(mob);
 		if (!IS_NPC(mob))
 			context = 0;
+		else if (IN_ROOM(mob))	// saved with the room
+			request_world_save(GET_ROOM_VNUM(IN_ROOM(mob)));
 	}
 	else if ((obj = find_obj(uid, FALSE))) {
 		sc_remote = SCRIPT(obj);
@@ -5900,9 +6310,12 @@ void process_rdelete(struct script_data *sc, trig_data *trig, char *cmd) {
 
 	if ((room = find_room(uid))) {
 		sc_remote = SCRIPT(room);
+		request_world_save(GET_ROOM_VNUM(room));
 	}
 	else if ((mob = find_char(uid))) {
 		sc_remote = SCRIPT(mob);
+		if (IS_NPC(mob) && IN_ROOM(mob))	// saved with the room
+			request_world_save(GET_ROOM_VNUM(IN_ROOM(mob)));
 		/*
 		// this was set but never used
 		if (!IS_NPC(mob))
@@ -6019,7 +6432,7 @@ void extract_value(struct script_data *sc, trig_data *trig, char *cmd) {
 //int script_driver(void **go_adress, trig_data *trig, int type, int mode)
 int script_driver(union script_driver_data_u *sdd, trig_data *trig, int type, int mode) {
 	static int depth = 0;
-	int ret_val = 1;
+	int ret_val = 1, line_type;
 	struct cmdlist_element *cl;
 	char cmd[MAX_INPUT_LENGTH], *p;
 	struct script_data *sc = 0;
@@ -6080,18 +6493,19 @@ int script_driver(union script_driver_data_u *sdd, trig_data *trig, int type, in
 
 	for (cl = (mode == TRIG_NEW) ? trig->cmdlist : trig->curr_state; cl && GET_TRIG_DEPTH(trig); cl = cl ? cl->next : NULL) {
 		for (p = cl->cmd; *p && isspace(*p); p++);
+		line_type = (cl->type != DG_LINE_UNKNOWN) ? cl->type : get_script_line_type(p);
 
-		if (*p == '*') /* comment */
+		if (line_type == DG_LINE_COMMENT)
 			continue;
 
-		else if (!strn_cmp(p, "if ", 3)) {
-			if (process_if(p + 3, go, sc, trig, type))
+		else if (line_type == DG_LINE_IF) {
+			if (process_if_line(cl, p + 3, go, sc, trig, type))
 				GET_TRIG_DEPTH(trig)++;
 			else
-				cl = find_else_end(trig, cl, go, sc, type);
+				cl = find_else_end_line(trig, cl, go, sc, type);
 		}
 
-		else if (!strn_cmp("elseif ", p, 7) || !strn_cmp("else", p, 4)) {
+		else if (line_type == DG_LINE_ELSEIF || line_type == DG_LINE_ELSE) {
 			/*
 			* if not in an if-block, ignore the extra 'else[if]' and warn about it
 			*/
@@ -6100,16 +6514,16 @@ int script_driver(union script_driver_data_u *sdd, trig_data *trig, int type, in
 				GET_TRIG_VNUM(trig));
 				continue; 
 			}
-			cl = find_end(cl);
+			cl = find_block_end_line(cl, FALSE);
 			GET_TRIG_DEPTH(trig)--;
 		}
-		else if (!strn_cmp("while ", p, 6)) {
-			temp = find_done(cl);  
+		else if (line_type == DG_LINE_WHILE) {
+			temp = find_block_end_line(cl, TRUE);
 			if (!temp) {
 				script_log("Trigger VNum %d has 'while' without 'done'.", GET_TRIG_VNUM(trig));
 				return ret_val;
 			}
-			if (process_if(p + 6, go, sc, trig, type)) {
+			if (process_if_line(cl, p + 6, go, sc, trig, type)) {
 				temp->original = cl;
 			}
 			else {
@@ -6117,10 +6531,10 @@ int script_driver(union script_driver_data_u *sdd, trig_data *trig, int type, in
 				loops = 0;
 			}
 		}
-		else if (!strn_cmp("switch ", p, 7)) {
-			cl = find_case(trig, cl, go, sc, type, p + 7);
+		else if (line_type == DG_LINE_SWITCH) {
+			cl = find_case_line(trig, cl, go, sc, type, p + 7);
 		}
-		else if (!strn_cmp("end", p, 3)) {   
+		else if (line_type == DG_LINE_END) {
 			/*
 			* if not in an if-block, ignore the extra 'end' and warn about it.
 			*/
@@ -6130,13 +6544,13 @@ int script_driver(union script_driver_data_u *sdd, trig_data *trig, int type, in
 			}
 			GET_TRIG_DEPTH(trig)--;
 		}
-		else if (!strn_cmp("done", p, 4)) {
+		else if (line_type == DG_LINE_DONE) {
 			/* if in a while loop, cl->original is non-NULL */
 			if (cl->original) {
 				char *orig_cmd = cl->original->cmd;
 				while (*orig_cmd && isspace(*orig_cmd))
 					orig_cmd++;
-				if (cl->original && process_if(orig_cmd + 6, go, sc, trig, type)) {
+				if (cl->original && process_if_line(cl->original, orig_cmd + 6, go, sc, trig, type)) {
 					cl = cl->original;
 					loops++;   
 					GET_TRIG_LOOPS(trig)++;
@@ -6156,10 +6570,10 @@ int script_driver(union script_driver_data_u *sdd, trig_data *trig, int type, in
 				}
 			}
 		}
-		else if (!strn_cmp("break", p, 5)) {
-			cl = find_done(cl);
+		else if (line_type == DG_LINE_BREAK) {
+			cl = find_block_end_line(cl, TRUE);
 		}
-		else if (!strn_cmp("case", p, 4)) { 
+		else if (line_type == DG_LINE_CASE) {
 			/* Do nothing, this allows multiple cases to a single instance */
 		}
 
@@ -6185,8 +6599,17 @@ int script_driver(union script_driver_data_u *sdd, trig_data *trig, int type, in
 			else if (!strn_cmp(cmd, "dg_affect_room ", 15))
 				do_dg_affect_room(go, sc, trig, type, cmd);
 
-			else if (!strn_cmp(cmd, "global ", 7))
+			else if (!strn_cmp(cmd, "global ", 7)) {
 				process_global(sc, trig, cmd, sc->context);
+				
+				// room and mob globals are saved with the room
+				if (type == WLD_TRIGGER || type == RMT_TRIGGER || type == BLD_TRIGGER || type == ADV_TRIGGER) {
+					request_world_save(GET_ROOM_VNUM((room_data*) go));
+				}
+				else if (type == MOB_TRIGGER && IN_ROOM((char_data*) go)) {
+					request_world_save(GET_ROOM_VNUM(IN_ROOM((char_data*) go)));
+				}
+			}
 
 			else if (!strn_cmp(cmd, "context ", 8))
 				process_context(sc, trig, cmd);
@@ -6375,35 +6798,117 @@ int fgetline(FILE *file, char *p) {
 
 /* find_char() helpers */
 
-// Must be power of 2
-#define BUCKET_COUNT 64
-// to recognize an empty bucket
-#define UID_OUT_OF_RANGE 1000000000
+// open-addressing uid table with linear probing; sizes must be powers of 2
+#define LOOKUP_TABLE_MIN_SIZE  1024
+#define LOOKUP_TABLE_MAX_LOAD  70	// percent full before it doubles
+#define LOOKUP_TABLE_MIN_LOAD  15	// percent full before it halves (down to the min size)
 
 struct lookup_table_t {
 	int uid;
-	void * c; 
-	struct lookup_table_t *next;
+	void *c;	// NULL = empty slot
 };
-struct lookup_table_t lookup_table[BUCKET_COUNT];
+
+struct lookup_table_t *lookup_table = NULL;
+int lookup_table_size = 0;	// number of slots
+int lookup_table_bits = 0;	// lookup_table_size is 2^bits
+int lookup_table_count = 0;	// number of slots in use
+
+
+// hashes a uid to its home slot (fibonacci hashing: the top bits of uid * 2^32/phi)
+static inline int lookup_table_slot(int uid) {
+	return (int) (((unsigned int) uid * 2654435769U) >> (32 - lookup_table_bits));
+}
+
+
+/**
+* Moves the lookup table into a new array of a different size.
+*
+* @param int size The new number of slots (a power of 2).
+*/
+static void resize_lookup_table(int size) {
+	struct lookup_table_t *old = lookup_table;
+	int iter, slot, old_size = lookup_table_size;
+	
+	CREATE(lookup_table, struct lookup_table_t, size);
+	lookup_table_size = size;
+	for (lookup_table_bits = 0; (1 << lookup_table_bits) < size; ++lookup_table_bits);
+	
+	for (iter = 0; iter < old_size; ++iter) {
+		if (old[iter].c) {
+			for (slot = lookup_table_slot(old[iter].uid); lookup_table[slot].c; slot = (slot + 1) & (size - 1));
+			lookup_table[slot] = old[iter];
+		}
+	}
+	
+	if (old) {
+		free(old);
+	}
+}
+
+
+/**
+* Finds the slot a uid is in.
+*
+* @param int uid The uid to find.
+* @return int The slot, or -1 if it's not in the table.
+*/
+static int find_lookup_table_slot(int uid) {
+	int slot;
+	
+	if (!lookup_table) {
+		return -1;
+	}
+	
+	for (slot = lookup_table_slot(uid); lookup_table[slot].c; slot = (slot + 1) & (lookup_table_size - 1)) {
+		if (lookup_table[slot].uid == uid) {
+			return slot;
+		}
+	}
+	
+	return -1;
+}
+
 
 void init_lookup_table(void) {
-	int i;
-	for (i = 0; i < BUCKET_COUNT; i++) {
-		lookup_table[i].uid = UID_OUT_OF_RANGE;
-		lookup_table[i].c = NULL;
-		lookup_table[i].next = NULL;
+	if (lookup_table) {
+		free(lookup_table);
+		lookup_table = NULL;
 	}
+	lookup_table_size = 0;
+	lookup_table_count = 0;
+	resize_lookup_table(LOOKUP_TABLE_MIN_SIZE);
 }
 
-char_data *find_char_by_uid_in_lookup_table(int uid) {
-	int bucket = (int) (uid & (BUCKET_COUNT - 1));
-	struct lookup_table_t *lt = &lookup_table[bucket];
 
-	for (;lt && lt->uid != uid ; lt = lt->next) ;
+/**
+* Gathers stats on the uid lookup table for the "show stats" screen.
+*
+* @param int *size Will be set to the number of slots.
+* @param int *longest Will be set to the longest probe any lookup needs.
+* @return int The number of entries in the table.
+*/
+int get_lookup_table_stats(int *size, int *longest) {
+	int iter, dist;
+	
+	*size = lookup_table_size;
+	*longest = 0;
+	
+	for (iter = 0; iter < lookup_table_size; ++iter) {
+		if (lookup_table[iter].c) {
+			dist = ((iter - lookup_table_slot(lookup_table[iter].uid)) & (lookup_table_size - 1)) + 1;
+			*longest = MAX(*longest, dist);
+		}
+	}
+	
+	return lookup_table_count;
+}
+
 
-	if (lt)
-		return (char_data*)(lt->c);
+char_data *find_char_by_uid_in_lookup_table(int uid) {
+	int slot = find_lookup_table_slot(uid);
+
+	if (slot != -1)
+		return (char_data*)(lookup_table[slot].c);
 
 	log("find_char_by_uid_in_lookup_table : No entity with number %d in lookup table", uid);
 	return NULL;
@@ -6419,13 +6924,10 @@ char_data *find_char_by_uid_in_lookup_table(int uid) {
 * @return obj_data* The found object, or NULL if it doesn't exist.
 */
 obj_data *find_obj_by_uid_in_lookup_table(int uid, bool error) {
-	int bucket = (int) (uid & (BUCKET_COUNT - 1));
-	struct lookup_table_t *lt = &lookup_table[bucket];
-
-	for (;lt && lt->uid != uid ; lt = lt->next) ;
+	int slot = find_lookup_table_slot(uid);
 
-	if (lt)
-		return (obj_data*)(lt->c);
+	if (slot != -1)
+		return (obj_data*)(lookup_table[slot].c);
 	
 	if (error) {
 		log("find_obj_by_uid_in_lookup_table : No entity with number %d in lookup table", uid);
@@ -6435,53 +6937,71 @@ obj_data *find_obj_by_uid_in_lookup_table(int uid, bool error) {
 }
 
 vehicle_data *find_vehicle_by_uid_in_lookup_table(int uid) {
-	int bucket = (int) (uid & (BUCKET_COUNT - 1));
-	struct lookup_table_t *lt = &lookup_table[bucket];
+	int slot = find_lookup_table_slot(uid);
 
-	for (;lt && lt->uid != uid ; lt = lt->next) ;
-
-	if (lt)
-		return (vehicle_data*)(lt->c);
+	if (slot != -1)
+		return (vehicle_data*)(lookup_table[slot].c);
 
 	log("find_vehicle_by_uid_in_lookup_table : No entity with number %d in lookup table", uid);
 	return NULL;
 }
 
 void add_to_lookup_table(int uid, void *c) {
-	int bucket = (int) (uid & (BUCKET_COUNT - 1));
-	struct lookup_table_t *lt = &lookup_table[bucket];
-
-	for (;lt->next; lt = lt->next)
-		if (lt->c == c) {
+	int slot;
+	
+	if (!c) {
+		return;
+	}
+	
+	if ((slot = find_lookup_table_slot(uid)) != -1) {
+		if (lookup_table[slot].c == c) {
 			log ("Add_to_lookup failed. Already there.");
-			return;
 		}
-
-	CREATE(lt->next, struct lookup_table_t, 1);
-	lt->next->uid = uid;
-	lt->next->c = c;
+		else {
+			// only one entity can have a uid; the new one is the live one
+			log("Add_to_lookup: UID %d was already in use; replacing it.", uid);
+			lookup_table[slot].c = c;
+		}
+		return;
+	}
+	
+	if (!lookup_table || (lookup_table_count + 1) * 100LL > lookup_table_size * (long long) LOOKUP_TABLE_MAX_LOAD) {
+		resize_lookup_table(lookup_table ? lookup_table_size * 2 : LOOKUP_TABLE_MIN_SIZE);
+	}
+	
+	for (slot = lookup_table_slot(uid); lookup_table[slot].c; slot = (slot + 1) & (lookup_table_size - 1));
+	lookup_table[slot].uid = uid;
+	lookup_table[slot].c = c;
+	++lookup_table_count;
 }
 
 void remove_from_lookup_table(int uid) {
-	int bucket = (int) (uid & (BUCKET_COUNT - 1));
-	struct lookup_table_t *lt = &lookup_table[bucket], *flt = NULL;
+	int slot, next, home;
 	
 	// no work -- no assigned id
 	if (uid == 0) {
 		return;
 	}
 
-	// TODO saw a crash here where lt seemed to have been freed... lt->uid crashed, no clear reason why because lookup_table[bucket] seemed to exist.
-	for (;lt;lt = lt->next)
-		if (lt->uid == uid)
-			flt = lt;
-
-	if (flt) {
-		for (lt = &lookup_table[bucket];lt->next != flt;lt = lt->next);
-		lt->next = flt->next;
-		free(flt);
+	if ((slot = find_lookup_table_slot(uid)) == -1) {
+		log("remove_from_lookup. UID %d not found.", uid);
 		return;
 	}
-
-	log("remove_from_lookup. UID %d not found.", uid);
+	
+	// backward-shift deletion: pull later entries of the run back into the gap, so no tombstones are needed
+	for (next = (slot + 1) & (lookup_table_size - 1); lookup_table[next].c; next = (next + 1) & (lookup_table_size - 1)) {
+		home = lookup_table_slot(lookup_table[next].uid);
+		// it can move back only if its home slot isn't (cyclically) after the gap
+		if (((next - home) & (lookup_table_size - 1)) >= ((next - slot) & (lookup_table_size - 1))) {
+			lookup_table[slot] = lookup_table[next];
+			slot = next;
+		}
+	}
+	lookup_table[slot].uid = 0;
+	lookup_table[slot].c = NULL;
+	--lookup_table_count;
+	
+	if (lookup_table_size > LOOKUP_TABLE_MIN_SIZE && lookup_table_count * 100LL < lookup_table_size * (long long) LOOKUP_TABLE_MIN_LOAD) {
+		resize_lookup_table(lookup_table_size / 2);
+	}
 }
@@ -162,11 +162,41 @@
 #define CMDTRG_ABBREV  1
 
 
+// DG_LINE_x: types of script lines, set when a command list is compiled
+#define DG_LINE_UNKNOWN  0	// not compiled: script_driver() reads the text
+#define DG_LINE_COMMENT  1	// * comment
+#define DG_LINE_IF  2
+#define DG_LINE_ELSEIF  3
+#define DG_LINE_ELSE  4
+#define DG_LINE_WHILE  5
+#define DG_LINE_SWITCH  6
+#define DG_LINE_END  7
+#define DG_LINE_DONE  8
+#define DG_LINE_BREAK  9
+#define DG_LINE_CASE  10
+#define DG_LINE_COMMAND  11	// anything else: var_subst'd and run
+
+
+/* a condition from a script line, parsed once by compile_command_list() */
+struct dg_compiled_expr {
+	char *op;	// operator (from eval_lhs_op_rhs's table), or NULL for a plain value
+	struct dg_compiled_expr *lhs, *rhs;	// operands, if op
+	char *text;	// value to var_subst, if no op
+};
+
+
 /* one line of the trigger */
 struct cmdlist_element {
 	char *cmd;				/* one line of a trigger */
 	struct cmdlist_element *original;
 	struct cmdlist_element *next;
+	
+	// precompiled by compile_command_list()
+	int type;	// DG_LINE_x
+	struct dg_compiled_expr *expr;	// condition for if/elseif/while/switch (NULL if too long to parse)
+	struct cmdlist_element *jump;	// if/elseif: next elseif/else/end; switch/case: next case/default/done
+	bool jump_found;	// FALSE if the jump search ran off the end of the script
+	struct cmdlist_element *block_end;	// else/elseif: matching end; while/break: matching done
 };
 
 struct trig_var_data {
@@ -320,6 +350,7 @@ void parse_trigger(FILE *trig_f, int nr);
 void parse_trig_proto(char *line, struct trig_proto_list **list, char *error_str);
 extern trig_data *real_trigger(trig_vnum vnum);
 void extract_script(void *thing, int type);
+void update_command_trigger_counts(struct script_data *sc, bitvector_t old_types);
 void extract_script_mem(struct script_memory *sc);
 void free_proto_scripts(struct trig_proto_list **list);
 void free_script(void *thing, int type);
@@ -419,6 +450,7 @@ obj_data *find_obj_by_uid_in_lookup_table(int uid, bool error);
 vehicle_data *find_vehicle_by_uid_in_lookup_table(int uid);
 void add_to_lookup_table(int uid, void *c);
 void remove_from_lookup_table(int uid);
+int get_lookup_table_stats(int *size, int *longest);
 
 // find helpers
 extern char_data *find_char(int n);
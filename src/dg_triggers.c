@@ -356,6 +356,11 @@ int command_mtrigger(char_data *actor, char *cmd, char *argument, int mode) {
 	/* prevent people we like from becoming trapped :P */
 	if (!valid_dg_target(actor, 0))
 		return 0;
+	
+	// nobody here has a command trigger
+	if (ROOM_COMMAND_TRIG_MOBS(IN_ROOM(actor)) <= 0) {
+		return 0;
+	}
 
 	for (ch = ROOM_PEOPLE(IN_ROOM(actor)); ch; ch = ch_next) {
 		ch_next = ch->next_in_room;
@@ -870,17 +875,23 @@ int command_otrigger(char_data *actor, char *cmd, char *argument, int mode) {
 	if (!valid_dg_target(actor, 0))
 		return 0;
 
-	for (i = 0; i < NUM_WEARS; i++)
-		if (cmd_otrig(GET_EQ(actor, i), actor, cmd, argument, OCMD_EQUIP, mode))
-			return 1;
+	// only check gear and inventory if something there has a command trigger
+	if (GET_COMMAND_TRIG_OBJS(actor) > 0) {
+		for (i = 0; i < NUM_WEARS; i++)
+			if (cmd_otrig(GET_EQ(actor, i), actor, cmd, argument, OCMD_EQUIP, mode))
+				return 1;
 
-	for (obj = actor->carrying; obj; obj = obj->next_content)
-		if (cmd_otrig(obj, actor, cmd, argument, OCMD_INVEN, mode))
-			return 1;
-
-	for (obj = ROOM_CONTENTS(IN_ROOM(actor)); obj; obj = obj->next_content)
-		if (cmd_otrig(obj, actor, cmd, argument, OCMD_ROOM, mode))
-			return 1;
+		for (obj = actor->carrying; obj; obj = obj->next_content)
+			if (cmd_otrig(obj, actor, cmd, argument, OCMD_INVEN, mode))
+				return 1;
+	}
+	
+	// same for the room
+	if (ROOM_COMMAND_TRIG_OBJS(IN_ROOM(actor)) > 0) {
+		for (obj = ROOM_CONTENTS(IN_ROOM(actor)); obj; obj = obj->next_content)
+			if (cmd_otrig(obj, actor, cmd, argument, OCMD_ROOM, mode))
+				return 1;
+	}
 
 	return 0;
 }
@@ -1468,6 +1468,7 @@ VCMD(do_vrestore) {
 			GET_BUILDING_RESOURCES(room) = NULL;
 			COMPLEX_DATA(room)->damage = 0;
 			COMPLEX_DATA(room)->burning = 0;
+			request_world_save(GET_ROOM_VNUM(room));
 		}
 	}
 }
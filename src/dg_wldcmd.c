@@ -1426,6 +1426,7 @@ WCMD(do_wrestore) {
 			GET_BUILDING_RESOURCES(rtarg) = NULL;
 			COMPLEX_DATA(rtarg)->damage = 0;
 			COMPLEX_DATA(rtarg)->burning = 0;
+			request_world_save(GET_ROOM_VNUM(rtarg));
 		}
 	}
 }
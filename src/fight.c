@@ -1399,6 +1399,7 @@ obj_data *make_corpse(char_data *ch) {
 		}
 
 		IS_CARRYING_N(ch) = 0;
+		GET_COMMAND_TRIG_OBJS(ch) = 0;
 		ch->carrying = NULL;
 	}
 	else {
@@ -1751,9 +1752,10 @@ static bool tower_would_shoot(room_data *from_room, char_data *vict) {
 
 
 void process_tower(room_data *room) {
+	struct near_char_iterator near;
 	empire_data *emp;
 	int x, y;
-	room_data *to_room;
+	room_data *map;
 	char_data *ch, *found = NULL;
 	struct tower_victim_list *victim_list = NULL, *tvl;
 	int num_victs = 0, pick;
@@ -1778,22 +1780,35 @@ void process_tower(room_data *room) {
 		return;
 	}
 	
-	for (x = -3; x <= 3; ++x) {
-		for (y = -3; y <= 3; ++y) {
-			to_room = real_shift(room, x, y);
-			
-			if (to_room) {
-				for (ch = ROOM_PEOPLE(to_room); ch; ch = ch->next_in_room) {
-					if (tower_would_shoot(room, ch)) {
-						CREATE(tvl, struct tower_victim_list, 1);
-						tvl->ch = ch;
-					
-						tvl->next = victim_list;
-						victim_list = tvl;
-						++num_victs;
-					}
-				}
-			}
+	if (!(map = get_map_location_for(room))) {
+		return;
+	}
+	
+	// targets are on map tiles up to 3 tiles away in each direction
+	for (ch = first_char_near(&near, room, 3, FALSE); ch; ch = next_char_near(&near)) {
+		if (GET_ROOM_VNUM(IN_ROOM(ch)) >= MAP_SIZE) {
+			continue;
+		}
+		
+		x = FLAT_X_COORD(IN_ROOM(ch)) - FLAT_X_COORD(map);
+		y = FLAT_Y_COORD(IN_ROOM(ch)) - FLAT_Y_COORD(map);
+		if (WRAP_X && ABSOLUTE(x) > MAP_WIDTH / 2) {
+			x += (x < 0) ? MAP_WIDTH : -MAP_WIDTH;
+		}
+		if (WRAP_Y && ABSOLUTE(y) > MAP_HEIGHT / 2) {
+			y += (y < 0) ? MAP_HEIGHT : -MAP_HEIGHT;
+		}
+		if (ABSOLUTE(x) > 3 || ABSOLUTE(y) > 3) {
+			continue;
+		}
+		
+		if (tower_would_shoot(room, ch)) {
+			CREATE(tvl, struct tower_victim_list, 1);
+			tvl->ch = ch;
+		
+			tvl->next = victim_list;
+			victim_list = tvl;
+			++num_victs;
 		}
 	}
 
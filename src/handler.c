@@ -1095,6 +1095,8 @@ void extract_char(char_data *ch) {
  * be its own list, but that would change the '->next' pointer, potentially
  * confusing some code. -gg This doesn't handle recursive extractions. */
 void extract_pending_chars(void) {
+	extern char_data *point_update_next_char;
+	
 	char_data *vict, *next_vict, *prev_vict;
 
 	if (extractions_pending < 0) {
@@ -1122,6 +1124,11 @@ void extract_pending_chars(void) {
 		else {
 			character_list = next_vict;
 		}
+		
+		// don't leave the point update pointing at a freed char
+		if (vict == point_update_next_char) {
+			point_update_next_char = next_vict;
+		}
 
 		// moving this down below the prev_vict block because ch was still in
 		// the character list late in the process, causing a crash in some rare
@@ -1252,6 +1259,254 @@ void perform_idle_out(char_data *ch) {
  //////////////////////////////////////////////////////////////////////////////
 //// CHARACTER LOCATION HANDLERS /////////////////////////////////////////////
 
+// The character location grid lists every character in a room by the area of
+// the map they're in, so "who's near here" only has to look at a few cells.
+// Characters whose map location can change without a char_to_room() (inside
+// vehicles) or who have no map location at all go on an "unplaced" list that
+// every search also checks.
+
+#define CHAR_GRID_CELL  16	// width and height of a grid cell, in map tiles
+#define CHAR_GRID_WIDTH  ((MAP_WIDTH + CHAR_GRID_CELL - 1) / CHAR_GRID_CELL)
+#define CHAR_GRID_HEIGHT  ((MAP_HEIGHT + CHAR_GRID_CELL - 1) / CHAR_GRID_CELL)
+
+struct char_grid_cell char_grid[CHAR_GRID_WIDTH * CHAR_GRID_HEIGHT];
+struct char_grid_cell char_grid_unplaced;	// characters in vehicles or off the map
+
+
+/**
+* Determines whether a room's map location can change while characters stay in
+* it (because it's inside a vehicle, directly or through an instance/home room).
+* This follows the same path as get_map_location_for().
+*
+* @param room_data *room The room to check.
+* @return bool TRUE if the room can move around the map.
+*/
+static bool room_location_can_move(room_data *room) {
+	room_data *next;
+	int safety;
+	
+	for (safety = 0; room && GET_ROOM_VNUM(room) >= MAP_SIZE && safety < 20; ++safety) {
+		if (GET_ROOM_VEHICLE(room)) {
+			return TRUE;
+		}
+		
+		if (COMPLEX_DATA(room) && COMPLEX_DATA(room)->instance && COMPLEX_DATA(room)->instance->location) {
+			next = COMPLEX_DATA(room)->instance->location;
+		}
+		else {
+			next = HOME_ROOM(room);
+		}
+		
+		if (next == room) {
+			break;
+		}
+		room = next;
+	}
+	
+	return FALSE;
+}
+
+
+/**
+* Adds a character to the location grid, based on IN_ROOM(ch).
+*
+* @param char_data *ch The character, who was just put in a room.
+*/
+static void add_char_to_grid(char_data *ch) {
+	struct char_grid_cell *cell;
+	room_data *map;
+	
+	if (!(map = get_map_location_for(IN_ROOM(ch))) || room_location_can_move(IN_ROOM(ch))) {
+		cell = &char_grid_unplaced;
+	}
+	else {
+		cell = &char_grid[(FLAT_Y_COORD(map) / CHAR_GRID_CELL) * CHAR_GRID_WIDTH + (FLAT_X_COORD(map) / CHAR_GRID_CELL)];
+	}
+	
+	if (IS_NPC(ch)) {
+		DL_PREPEND2(cell->npcs, ch, prev_in_grid, next_in_grid);
+	}
+	else {
+		DL_PREPEND2(cell->players, ch, prev_in_grid, next_in_grid);
+	}
+	ch->grid_cell = cell;
+}
+
+
+/**
+* Removes a character from the location grid, if they're in it.
+*
+* @param char_data *ch The character.
+*/
+static void remove_char_from_grid(char_data *ch) {
+	struct char_grid_cell *cell = ch->grid_cell;
+	
+	if (!cell) {
+		return;
+	}
+	
+	if (IS_NPC(ch)) {
+		DL_DELETE2(cell->npcs, ch, prev_in_grid, next_in_grid);
+	}
+	else {
+		DL_DELETE2(cell->players, ch, prev_in_grid, next_in_grid);
+	}
+	ch->grid_cell = NULL;
+	ch->prev_in_grid = ch->next_in_grid = NULL;
+}
+
+
+/**
+* Finds the next character for a near_char_iterator, starting with it->next.
+*
+* @param struct near_char_iterator *it The iterator.
+* @return char_data* The next character, or NULL when there are no more.
+*/
+static char_data *advance_char_near(struct near_char_iterator *it) {
+	struct char_grid_cell *cell;
+	int x, y;
+	
+	while (!it->next) {
+		if (!it->npcs && !it->pc_only) {
+			// done with this cell's players: now its NPCs
+			it->npcs = TRUE;
+		}
+		else if (++it->pos > it->width * it->height) {
+			return NULL;	// done with the unplaced list, too
+		}
+		else {
+			it->npcs = FALSE;
+		}
+		
+		if (it->pos == it->width * it->height) {
+			cell = &char_grid_unplaced;
+		}
+		else {
+			x = (it->cell_x + (it->pos % it->width)) % CHAR_GRID_WIDTH;
+			y = (it->cell_y + (it->pos / it->width)) % CHAR_GRID_HEIGHT;
+			cell = &char_grid[y * CHAR_GRID_WIDTH + x];
+		}
+		it->next = it->npcs ? cell->npcs : cell->players;
+	}
+	
+	return it->next;
+}
+
+
+/**
+* Gets the grid cells (and how many of them) that cover one axis of a search.
+*
+* @param int coord The center coordinate.
+* @param int distance How far to look.
+* @param int map_size MAP_WIDTH or MAP_HEIGHT.
+* @param int grid_size CHAR_GRID_WIDTH or CHAR_GRID_HEIGHT.
+* @param bool wrap Whether this axis wraps around.
+* @param int *first Set to the first cell.
+* @param int *count Set to the number of cells, going up from first (and wrapping).
+*/
+static void get_char_grid_span(int coord, int distance, int map_size, int grid_size, bool wrap, int *first, int *count) {
+	int low = coord - distance, high = coord + distance;
+	
+	if (2 * distance + 1 >= map_size) {
+		*first = 0;
+		*count = grid_size;
+		return;
+	}
+	
+	if (wrap) {
+		low = (low + map_size) % map_size;
+		high = high % map_size;
+		*first = low / CHAR_GRID_CELL;
+		*count = (high / CHAR_GRID_CELL) - *first + 1;
+		if (*count <= 0) {
+			*count += grid_size;	// wrapped around the edge
+		}
+	}
+	else {
+		low = MAX(0, low);
+		high = MIN(map_size - 1, high);
+		*first = low / CHAR_GRID_CELL;
+		*count = (high / CHAR_GRID_CELL) - *first + 1;
+	}
+}
+
+
+/**
+* Starts going through the characters near a location, using the location
+* grid. This returns everyone within the distance (in a square around the
+* location) but may also return some characters who are a little farther
+* away, so callers should still check compute_distance(). Characters in vehicles and characters with no map
+* location are always included.
+*
+* Don't move characters between rooms while iterating.
+*
+* for (vict = first_char_near(&it, room, 10, TRUE); vict; vict = next_char_near(&it)) { ... }
+*
+* @param struct near_char_iterator *it An iterator to set up.
+* @param room_data *center The location to search around.
+* @param int distance How far to look, in map tiles.
+* @param bool pc_only If TRUE, skips NPCs.
+* @return char_data* The first character found, or NULL if none.
+*/
+char_data *first_char_near(struct near_char_iterator *it, room_data *center, int distance, bool pc_only) {
+	room_data *map;
+	
+	memset(it, 0, sizeof(struct near_char_iterator));
+	it->pc_only = pc_only;
+	
+	if (!(map = get_map_location_for(center))) {
+		// nobody on the map is "near" a room with no location: just the unplaced list
+		it->pos = it->width * it->height;
+		it->next = char_grid_unplaced.players;
+	}
+	else {
+		get_char_grid_span(FLAT_X_COORD(map), MAX(0, distance), MAP_WIDTH, CHAR_GRID_WIDTH, WRAP_X, &it->cell_x, &it->width);
+		get_char_grid_span(FLAT_Y_COORD(map), MAX(0, distance), MAP_HEIGHT, CHAR_GRID_HEIGHT, WRAP_Y, &it->cell_y, &it->height);
+		it->next = char_grid[it->cell_y * CHAR_GRID_WIDTH + it->cell_x].players;
+	}
+	
+	return advance_char_near(it);
+}
+
+
+/**
+* Continues an iteration started by first_char_near().
+*
+* @param struct near_char_iterator *it The iterator.
+* @return char_data* The next character, or NULL if there are no more.
+*/
+char_data *next_char_near(struct near_char_iterator *it) {
+	if (!it->next) {
+		return NULL;
+	}
+	
+	it->next = it->next->next_in_grid;
+	return advance_char_near(it);
+}
+
+
+/**
+* Determines whether any connected player is within a given distance of a
+* location, e.g. to decide if random triggers should run there.
+*
+* @param room_data *room The location.
+* @param int distance How far to look, in map tiles.
+* @return bool TRUE if there's a player with a descriptor that close.
+*/
+bool is_player_nearby(room_data *room, int distance) {
+	struct near_char_iterator it;
+	char_data *vict;
+	
+	for (vict = first_char_near(&it, room, distance, TRUE); vict; vict = next_char_near(&it)) {
+		if (vict->desc && compute_distance(room, IN_ROOM(vict)) <= distance) {
+			return TRUE;
+		}
+	}
+	
+	return FALSE;
+}
+
+
 
 /**
 * move a player out of a room
@@ -1283,8 +1538,19 @@ void char_from_room(char_data *ch) {
 			ROOM_LIGHTS(IN_ROOM(ch))--;
 		}
 	}
+	
+	// update command trigger count
+	if (SCRIPT_CHECK(ch, MTRIG_COMMAND)) {
+		ROOM_COMMAND_TRIG_MOBS(IN_ROOM(ch))--;
+	}
+	
+	// mobs are saved with the room
+	if (IS_NPC(ch) && !MOB_FLAGGED(ch, MOB_EMPIRE | MOB_FAMILIAR)) {
+		request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
+	}
 
 	REMOVE_FROM_LIST(ch, ROOM_PEOPLE(IN_ROOM(ch)), next_in_room);
+	remove_char_from_grid(ch);
 	IN_ROOM(ch) = NULL;
 	ch->next_in_room = NULL;
 }
@@ -1319,6 +1585,12 @@ void char_to_room(char_data *ch, room_data *room) {
 		ch->next_in_room = ROOM_PEOPLE(room);
 		ROOM_PEOPLE(room) = ch;
 		IN_ROOM(ch) = room;
+		add_char_to_grid(ch);
+		
+		// mobs are saved with the room
+		if (IS_NPC(ch) && !MOB_FLAGGED(ch, MOB_EMPIRE | MOB_FAMILIAR)) {
+			request_world_save(GET_ROOM_VNUM(room));
+		}
 
 		// update lights
 		for (pos = 0; pos < NUM_WEARS; pos++) {
@@ -1331,6 +1603,11 @@ void char_to_room(char_data *ch, room_data *room) {
 				ROOM_LIGHTS(room)++;
 			}
 		}
+		
+		// update command trigger count
+		if (SCRIPT_CHECK(ch, MTRIG_COMMAND)) {
+			ROOM_COMMAND_TRIG_MOBS(room)++;
+		}
 
 		// check npc spawns whenever a player is places in a room
 		if (!IS_NPC(ch)) {
@@ -1359,6 +1636,31 @@ void char_to_room(char_data *ch, room_data *room) {
 //// CHARACTER TARGETING HANDLERS ////////////////////////////////////////////
 
 
+#define CLOSEST_CHAR_GRID_DISTANCE  32	// find_closest_char() checks this far using the location grid before it checks everyone
+
+/**
+* Part of find_closest_char(): whether one character is a possible match.
+*
+* @param char_data *ch The finder.
+* @param char_data *vict The possible match.
+* @param char *arg The argument/name.
+* @param bool pc_only Whether to exclude NPCs.
+* @return bool TRUE if vict matches.
+*/
+static bool is_closest_char_candidate(char_data *ch, char_data *vict, char *arg, bool pc_only) {
+	if (pc_only && IS_NPC(vict)) {
+		return FALSE;
+	}
+	if (!CAN_SEE(ch, vict) || !CAN_SEE_IN_DARK_ROOM(ch, IN_ROOM(vict))) {
+		return FALSE;
+	}
+	if (!match_char_name(ch, vict, arg, MATCH_IN_ROOM)) {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+
 /**
 * Finds the closest visible character to ch. This checks in-room visibility
 * as it is used to find VISIBLE characters (even though they are likely not
@@ -1370,6 +1672,7 @@ void char_to_room(char_data *ch, room_data *room) {
 * @return char_data *The nearest matching character.
 */
 char_data *find_closest_char(char_data *ch, char *arg, bool pc_only) {
+	struct near_char_iterator near;
 	char_data *vict, *best = NULL;
 	int dist, best_dist = MAP_SIZE;
 	
@@ -1377,21 +1680,29 @@ char_data *find_closest_char(char_data *ch, char *arg, bool pc_only) {
 		return vict;
 	}
 	
-	LL_FOREACH(character_list, vict) {
-		if (pc_only && IS_NPC(vict)) {
-			continue;
-		}
-		if (!CAN_SEE(ch, vict) || !CAN_SEE_IN_DARK_ROOM(ch, IN_ROOM(vict))) {
-			continue;
-		}
-		if (!match_char_name(ch, vict, arg, MATCH_IN_ROOM)) {
-			continue;
+	// most targets are nearby: anything found within the grid distance is the closest
+	for (vict = first_char_near(&near, IN_ROOM(ch), CLOSEST_CHAR_GRID_DISTANCE, pc_only); vict; vict = next_char_near(&near)) {
+		if (is_closest_char_candidate(ch, vict, arg, pc_only)) {
+			dist = compute_distance(IN_ROOM(ch), IN_ROOM(vict));
+			if (!best || dist < best_dist) {
+				best_dist = dist;
+				best = vict;
+			}
 		}
-		
-		dist = compute_distance(IN_ROOM(ch), IN_ROOM(vict));
-		if (!best || dist < best_dist) {
-			best_dist = dist;
-			best = vict;
+	}
+	if (best && best_dist <= CLOSEST_CHAR_GRID_DISTANCE) {
+		return best;
+	}
+	
+	// otherwise check everyone
+	best = NULL;
+	LL_FOREACH(character_list, vict) {
+		if (is_closest_char_candidate(ch, vict, arg, pc_only)) {
+			dist = compute_distance(IN_ROOM(ch), IN_ROOM(vict));
+			if (!best || dist < best_dist) {
+				best_dist = dist;
+				best = vict;
+			}
 		}
 	}
 	
@@ -2429,13 +2740,14 @@ struct empire_political_data *find_relation(empire_data *from, empire_data *to)
 * @return struct empire_territory_data* the territory data, or NULL if not found
 */
 struct empire_territory_data *find_territory_entry(empire_data *emp, room_data *room) {
-	struct empire_territory_data *found = NULL, *ter_iter;
+	struct empire_territory_data *found = NULL;
+	room_vnum vnum;
 	
-	if (emp) {
-		for (ter_iter = EMPIRE_TERRITORY_LIST(emp); ter_iter && !found; ter_iter = ter_iter->next) {
-			if (ter_iter->room == room) {
-				found = ter_iter;
-			}
+	if (emp && room) {
+		vnum = GET_ROOM_VNUM(room);
+		HASH_FIND_INT(EMPIRE_TERRITORY_BY_VNUM(emp), &vnum, found);
+		if (found && found->room != room) {
+			found = NULL;	// an old entry for a room that was replaced
 		}
 	}
 	
@@ -2443,6 +2755,172 @@ struct empire_territory_data *find_territory_entry(empire_data *emp, room_data *
 }
 
 
+/**
+* Adds a territory entry to one key of a territory index.
+*
+* @param struct empire_territory_index **hash The index.
+* @param int key The building vnum or island id.
+* @param struct empire_territory_data *ter The entry.
+* @param bitvector_t functions FNC_x flags to store with it.
+*/
+static void add_to_territory_index(struct empire_territory_index **hash, int key, struct empire_territory_data *ter, bitvector_t functions) {
+	struct empire_territory_index *idx;
+	struct empire_territory_ref *ref;
+	
+	HASH_FIND_INT(*hash, &key, idx);
+	if (!idx) {
+		CREATE(idx, struct empire_territory_index, 1);
+		idx->key = key;
+		HASH_ADD_INT(*hash, key, idx);
+	}
+	
+	CREATE(ref, struct empire_territory_ref, 1);
+	ref->ter = ter;
+	ref->functions = functions;
+	
+	if (idx->last_ref) {
+		idx->last_ref->next = ref;
+	}
+	else {
+		idx->refs = ref;
+	}
+	idx->last_ref = ref;
+}
+
+
+/**
+* Frees a territory index.
+*
+* @param struct empire_territory_index **hash The index to free (it will be set to NULL).
+*/
+static void free_territory_index(struct empire_territory_index **hash) {
+	struct empire_territory_index *idx, *next_idx;
+	struct empire_territory_ref *ref;
+	
+	HASH_ITER(hh, *hash, idx, next_idx) {
+		HASH_DEL(*hash, idx);
+		while ((ref = idx->refs)) {
+			idx->refs = ref->next;
+			free(ref);
+		}
+		free(idx);
+	}
+	*hash = NULL;
+}
+
+
+/**
+* Marks an empire's building/function territory indexes as out of date. They
+* are rebuilt the next time they're needed. Call this whenever territory is
+* added or removed, or a territory room's building changes.
+*
+* @param empire_data *emp The empire, or NULL for all empires (e.g. when islands or building functions change).
+*/
+void reset_territory_indexes(empire_data *emp) {
+	empire_data *iter, *next_iter;
+	
+	if (emp) {
+		emp->territory_index_built = FALSE;
+	}
+	else {
+		HASH_ITER(hh, empire_table, iter, next_iter) {
+			iter->territory_index_built = FALSE;
+		}
+	}
+}
+
+
+/**
+* Frees all of an empire's territory indexes, including territory_by_vnum.
+* This does not free the territory entries themselves.
+*
+* @param empire_data *emp The empire.
+*/
+void free_territory_indexes(empire_data *emp) {
+	HASH_CLEAR(hh, EMPIRE_TERRITORY_BY_VNUM(emp));
+	free_territory_index(&emp->buildings_by_vnum);
+	free_territory_index(&emp->functions_by_island);
+	emp->territory_index_built = FALSE;
+}
+
+
+/**
+* Ensures an empire's buildings_by_vnum and functions_by_island indexes are
+* up to date. These list candidates only: callers still check IS_COMPLETE and
+* anything else that can change without a reset_territory_indexes().
+*
+* @param empire_data *emp The empire.
+*/
+static void build_territory_indexes(empire_data *emp) {
+	struct empire_territory_data *ter;
+	bitvector_t functions;
+	
+	if (emp->territory_index_built) {
+		return;
+	}
+	
+	free_territory_index(&emp->buildings_by_vnum);
+	free_territory_index(&emp->functions_by_island);
+	
+	LL_FOREACH(EMPIRE_TERRITORY_LIST(emp), ter) {
+		if (GET_BUILDING(ter->room)) {
+			add_to_territory_index(&emp->buildings_by_vnum, GET_BLD_VNUM(GET_BUILDING(ter->room)), ter, NOBITS);
+		}
+		
+		functions = (GET_BUILDING(ter->room) ? GET_BLD_FUNCTIONS(GET_BUILDING(ter->room)) : NOBITS) | (GET_ROOM_TEMPLATE(ter->room) ? GET_RMT_FUNCTIONS(GET_ROOM_TEMPLATE(ter->room)) : NOBITS);
+		if (functions) {
+			add_to_territory_index(&emp->functions_by_island, GET_ISLAND_ID(ter->room), ter, functions);
+		}
+	}
+	
+	emp->territory_index_built = TRUE;
+}
+
+
+/**
+* Gets the territory entries whose rooms have a given building, from the
+* building index. They may not be complete.
+*
+* @param empire_data *emp The empire.
+* @param bld_vnum vnum The building vnum.
+* @return struct empire_territory_ref* The list of candidates (may be NULL).
+*/
+struct empire_territory_ref *get_territory_by_building(empire_data *emp, bld_vnum vnum) {
+	struct empire_territory_index *idx;
+	int key = vnum;
+	
+	if (!emp) {
+		return NULL;
+	}
+	
+	build_territory_indexes(emp);
+	HASH_FIND_INT(emp->buildings_by_vnum, &key, idx);
+	return idx ? idx->refs : NULL;
+}
+
+
+/**
+* Gets the territory entries on an island whose rooms have any function flags,
+* from the function index. Each ref's 'functions' says which ones; callers
+* should still use room_has_function_and_city_ok() or similar.
+*
+* @param empire_data *emp The empire.
+* @param int island_id The island.
+* @return struct empire_territory_ref* The list of candidates (may be NULL).
+*/
+struct empire_territory_ref *get_territory_functions_on_island(empire_data *emp, int island_id) {
+	struct empire_territory_index *idx;
+	
+	if (!emp) {
+		return NULL;
+	}
+	
+	build_territory_indexes(emp);
+	HASH_FIND_INT(emp->functions_by_island, &island_id, idx);
+	return idx ? idx->refs : NULL;
+}
+
+
 /**
 * @param empire_data *emp The empire to search.
 * @param int type TRADE_IMPORT or TRADE_EXPORT
@@ -2507,6 +2985,8 @@ void perform_abandon_room(room_data *room) {
 	struct empire_territory_data *ter;
 	bool junk;
 	
+	request_world_save(GET_ROOM_VNUM(room));
+	
 	// updates based on owner
 	if (emp) {
 		deactivate_workforce_room(emp, room);
@@ -2536,13 +3016,12 @@ void perform_abandon_room(room_data *room) {
 	}
 	
 	ROOM_OWNER(room) = NULL;
+	invalidate_map_icon(GET_ROOM_VNUM(room));
 
-	REMOVE_BIT(ROOM_BASE_FLAGS(room), ROOM_AFF_PUBLIC | ROOM_AFF_NO_WORK);
+	remove_room_base_flags(room, ROOM_AFF_PUBLIC | ROOM_AFF_NO_WORK);
 	REMOVE_BIT(ROOM_AFF_FLAGS(room), ROOM_AFF_PUBLIC | ROOM_AFF_NO_WORK);
 
-	if (ROOM_PRIVATE_OWNER(room) != NOBODY) {
-		COMPLEX_DATA(room)->private_owner = NOBODY;
-	}
+	set_private_owner(room, NOBODY);
 	
 	// if a city center is abandoned, destroy it
 	if (IS_CITY_CENTER(room)) {
@@ -2565,6 +3044,8 @@ void perform_claim_room(room_data *room, empire_data *emp) {
 	
 	ROOM_OWNER(room) = emp;
 	remove_room_extra_data(room, ROOM_EXTRA_CEDED);	// not ceded if just claimed
+	request_world_save(GET_ROOM_VNUM(room));
+	invalidate_map_icon(GET_ROOM_VNUM(room));
 	
 	adjust_building_tech(emp, room, TRUE);
 	
@@ -2594,25 +3075,139 @@ void perform_claim_room(room_data *room, empire_data *emp) {
  //////////////////////////////////////////////////////////////////////////////
 //// EMPIRE TARGETING HANDLERS ///////////////////////////////////////////////
 
+/**
+* Marks an empire's city coverage lookup as out of date, so it's rebuilt the
+* next time it's needed. Call this whenever a city is added, removed, or
+* changes size.
+*
+* @param empire_data *emp The empire.
+*/
+void reset_city_coverage(empire_data *emp) {
+	struct city_coverage_cell *cell, *next_cell;
+	struct city_coverage_data *cov;
+	
+	if (!emp) {
+		return;
+	}
+	
+	HASH_ITER(hh, emp->city_coverage, cell, next_cell) {
+		HASH_DEL(emp->city_coverage, cell);
+		while ((cov = cell->cities)) {
+			cell->cities = cov->next;
+			free(cov);
+		}
+		free(cell);
+	}
+	emp->city_coverage = NULL;
+	emp->city_coverage_built = FALSE;
+}
+
+
+/**
+* Builds an empire's city coverage lookup: each map grid cell lists the
+* cities that could cover any tile in it (at up to 3x radius, for tiles with
+* LARGE_CITY_RADIUS).
+*
+* @param empire_data *emp The empire.
+*/
+static void build_city_coverage(empire_data *emp) {
+	extern struct city_metadata_type city_type[];
+	
+	int x, y, first_x, first_y, count_x, count_y, key;
+	struct city_coverage_data *cov;
+	struct city_coverage_cell *cell;
+	struct empire_city_data *city;
+	room_data *map;
+	
+	if (emp->city_coverage_built) {
+		return;
+	}
+	
+	reset_city_coverage(emp);
+	
+	LL_FOREACH(EMPIRE_CITY_LIST(emp), city) {
+		if (!(map = get_map_location_for(city->location))) {
+			continue;	// can't cover anything
+		}
+		
+		get_char_grid_span(FLAT_X_COORD(map), 3 * city_type[city->type].radius, MAP_WIDTH, CHAR_GRID_WIDTH, WRAP_X, &first_x, &count_x);
+		get_char_grid_span(FLAT_Y_COORD(map), 3 * city_type[city->type].radius, MAP_HEIGHT, CHAR_GRID_HEIGHT, WRAP_Y, &first_y, &count_y);
+		
+		for (y = 0; y < count_y; ++y) {
+			for (x = 0; x < count_x; ++x) {
+				key = ((first_y + y) % CHAR_GRID_HEIGHT) * CHAR_GRID_WIDTH + ((first_x + x) % CHAR_GRID_WIDTH);
+				HASH_FIND_INT(emp->city_coverage, &key, cell);
+				if (!cell) {
+					CREATE(cell, struct city_coverage_cell, 1);
+					cell->cell = key;
+					HASH_ADD_INT(emp->city_coverage, cell, cell);
+				}
+				
+				CREATE(cov, struct city_coverage_data, 1);
+				cov->city = city;
+				cov->x = FLAT_X_COORD(map);
+				cov->y = FLAT_Y_COORD(map);
+				cov->radius = city_type[city->type].radius;
+				
+				if (cell->last_city) {
+					cell->last_city->next = cov;
+				}
+				else {
+					cell->cities = cov;
+				}
+				cell->last_city = cov;
+			}
+		}
+	}
+	
+	emp->city_coverage_built = TRUE;
+}
+
+
+/**
+* Gets the cities that might cover a map location, from the empire's city
+* coverage lookup. Callers must still check the distance against each one's
+* radius.
+*
+* @param empire_data *emp The empire.
+* @param int x The map x-coordinate.
+* @param int y The map y-coordinate.
+* @return struct city_coverage_data* The list of possible cities (may be NULL).
+*/
+struct city_coverage_data *get_city_coverage(empire_data *emp, int x, int y) {
+	struct city_coverage_cell *cell;
+	int key;
+	
+	if (!emp || !CHECK_MAP_BOUNDS(x, y)) {
+		return NULL;
+	}
+	
+	build_city_coverage(emp);
+	key = (y / CHAR_GRID_CELL) * CHAR_GRID_WIDTH + (x / CHAR_GRID_CELL);
+	HASH_FIND_INT(emp->city_coverage, &key, cell);
+	return cell ? cell->cities : NULL;
+}
+
+
 /**
 * @param empire_data *emp Which empire to check for cities in
 * @param room_data *loc Location to check
 * @return struct empire_city_data* Returns the closest city that loc is inside, or NULL if none
 */
 struct empire_city_data *find_city(empire_data *emp, room_data *loc) {
-	extern struct city_metadata_type city_type[];
-
-	struct empire_city_data *city, *found = NULL;
+	struct empire_city_data *found = NULL;
+	struct city_coverage_data *cov;
 	int dist, min = -1;
+	room_data *map;
 
-	if (!emp) {
-		return FALSE;
+	if (!emp || !(map = get_map_location_for(loc))) {
+		return NULL;
 	}
 	
-	for (city = EMPIRE_CITY_LIST(emp); city; city = city->next) {
-		if ((dist = compute_distance(loc, city->location)) <= city_type[city->type].radius) {
+	for (cov = get_city_coverage(emp, FLAT_X_COORD(map), FLAT_Y_COORD(map)); cov; cov = cov->next) {
+		if ((dist = compute_map_distance(FLAT_X_COORD(map), FLAT_Y_COORD(map), cov->x, cov->y)) <= cov->radius) {
 			if (!found || min == -1 || dist < min) {
-				found = city;
+				found = cov->city;
 				min = dist;
 			}
 		}
@@ -4192,7 +4787,12 @@ bool parse_component(char *str, int *type, bitvector_t *flags) {
 * @param obj_data *obj The item to remove from the global object list.
 */
 void remove_from_object_list(obj_data *obj) {
+	extern obj_data *point_update_next_obj;
 	obj_data *temp;
+	
+	if (obj == point_update_next_obj) {
+		point_update_next_obj = obj->next;
+	}
 	REMOVE_FROM_LIST(obj, object_list, next);
 }
 
@@ -4455,6 +5055,11 @@ void equip_char(char_data *ch, obj_data *obj, int pos) {
 		if (IN_ROOM(ch) && OBJ_FLAGGED(obj, OBJ_LIGHT)) {
 			ROOM_LIGHTS(IN_ROOM(ch))++;
 		}
+		
+		// command triggers?
+		if (SCRIPT_CHECK(obj, OTRIG_COMMAND)) {
+			GET_COMMAND_TRIG_OBJS(ch)++;
+		}
 
 		if (wear_data[pos].count_stats) {
 			for (apply = GET_OBJ_APPLIES(obj); apply; apply = apply->next) {
@@ -4493,6 +5098,11 @@ void obj_from_char(obj_data *object) {
 			ROOM_LIGHTS(IN_ROOM(object->carried_by))--;
 		}
 		
+		// check command triggers
+		if (SCRIPT_CHECK(object, OTRIG_COMMAND)) {
+			GET_COMMAND_TRIG_OBJS(object->carried_by)--;
+		}
+		
 		qt_drop_obj(object->carried_by, object);
 
 		object->carried_by = NULL;
@@ -4539,6 +5149,14 @@ void obj_from_room(obj_data *object) {
 		if (OBJ_FLAGGED(object, OBJ_LIGHT)) {
 			ROOM_LIGHTS(IN_ROOM(object))--;
 		}
+		
+		// room contents are saved with the room
+		request_world_save(GET_ROOM_VNUM(IN_ROOM(object)));
+		
+		// update command triggers
+		if (SCRIPT_CHECK(object, OTRIG_COMMAND)) {
+			ROOM_COMMAND_TRIG_OBJS(IN_ROOM(object))--;
+		}
 
 		REMOVE_FROM_LIST(object, ROOM_CONTENTS(IN_ROOM(object)), next_content);
 		IN_ROOM(object) = NULL;
@@ -4623,6 +5241,11 @@ void obj_to_char(obj_data *object, char_data *ch) {
 			ROOM_LIGHTS(IN_ROOM(ch))++;
 		}
 		
+		// check command triggers
+		if (SCRIPT_CHECK(object, OTRIG_COMMAND)) {
+			GET_COMMAND_TRIG_OBJS(ch)++;
+		}
+		
 		qt_get_obj(ch, object);
 	}
 	else {
@@ -4759,12 +5382,18 @@ void obj_to_room(obj_data *object, room_data *room) {
 		ROOM_CONTENTS(room) = object;
 		IN_ROOM(object) = room;
 		object->carried_by = NULL;
+		request_world_save(GET_ROOM_VNUM(room));
 		
 		// check light
 		if (OBJ_FLAGGED(object, OBJ_LIGHT)) {
 			ROOM_LIGHTS(IN_ROOM(object))++;
 		}
 		
+		// check command triggers
+		if (SCRIPT_CHECK(object, OTRIG_COMMAND)) {
+			ROOM_COMMAND_TRIG_OBJS(room)++;
+		}
+		
 		// clear keep now
 		REMOVE_BIT(GET_OBJ_EXTRA(object), OBJ_KEEP);
 
@@ -4864,6 +5493,11 @@ obj_data *unequip_char(char_data *ch, int pos) {
 		if (IN_ROOM(ch) && OBJ_FLAGGED(obj, OBJ_LIGHT)) {
 			ROOM_LIGHTS(IN_ROOM(ch))--;
 		}
+		
+		// adjust command triggers
+		if (SCRIPT_CHECK(obj, OTRIG_COMMAND)) {
+			GET_COMMAND_TRIG_OBJS(ch)--;
+		}
 
 		// actual remove
 		GET_EQ(ch, pos) = NULL;
@@ -5903,6 +6537,8 @@ void add_depletion(room_data *room, int type, bool multiple) {
 	struct depletion_data *dep;
 	bool found = FALSE;
 	
+	request_world_save(GET_ROOM_VNUM(room));
+	
 	for (dep = ROOM_DEPLETION(room); dep && !found; dep = dep->next) {
 		if (dep->type == type) {
 			dep->count += 1 + ((multiple && !number(0, 3)) ? 1 : 0);
@@ -5953,6 +6589,7 @@ void remove_depletion(room_data *room, int type) {
 		next_dep = dep->next;
 		
 		if (dep->type == type) {
+			request_world_save(GET_ROOM_VNUM(room));
 			REMOVE_FROM_LIST(dep, ROOM_DEPLETION(room), next);
 		}
 	}
@@ -6018,6 +6655,11 @@ void attach_building_to_room(bld_data *bld, room_data *room, bool with_triggers)
 		COMPLEX_DATA(room) = init_complex_data();
 	}
 	COMPLEX_DATA(room)->bld_ptr = bld;
+	invalidate_map_icon(GET_ROOM_VNUM(room));
+	request_world_save(GET_ROOM_VNUM(room));
+	if (ROOM_OWNER(room)) {
+		reset_territory_indexes(ROOM_OWNER(room));
+	}
 
 	// copy proto script
 	if (with_triggers) {
@@ -6073,6 +6715,11 @@ void detach_building_from_room(room_data *room) {
 	}
 	
 	COMPLEX_DATA(room)->bld_ptr = NULL;
+	invalidate_map_icon(GET_ROOM_VNUM(room));
+	if (ROOM_OWNER(room)) {
+		reset_territory_indexes(ROOM_OWNER(room));
+	}
+	
 	LL_FOREACH_SAFE(room->proto_script, tpl, next_tpl) {
 		LL_SEARCH_SCALAR(GET_BLD_SCRIPTS(bld), search, vnum, tpl->vnum);
 		if (search) {	// matching vnum on the proto
@@ -6105,6 +6752,53 @@ void detach_building_from_room(room_data *room) {
 }
 
 
+/**
+* Removes saved (base) affect flags from a room, and marks it for the next
+* world save if that changed anything. This does not touch ROOM_AFF_FLAGS.
+*
+* @param room_data *room The room to change.
+* @param bitvector_t flags The ROOM_AFF_x flag(s) to remove.
+*/
+void remove_room_base_flags(room_data *room, bitvector_t flags) {
+	if (IS_SET(ROOM_BASE_FLAGS(room), flags)) {
+		REMOVE_BIT(ROOM_BASE_FLAGS(room), flags);
+		request_world_save(GET_ROOM_VNUM(room));
+	}
+}
+
+
+/**
+* Sets the private owner of a room (e.g. a home), and marks it for the next
+* world save. This does nothing to rooms with no complex data.
+*
+* @param room_data *room The room to change.
+* @param int idnum The player's idnum, or NOBODY.
+*/
+void set_private_owner(room_data *room, int idnum) {
+	if (!COMPLEX_DATA(room) || COMPLEX_DATA(room)->private_owner == idnum) {
+		return;
+	}
+	
+	COMPLEX_DATA(room)->private_owner = idnum;
+	request_world_save(GET_ROOM_VNUM(room));
+}
+
+
+/**
+* Adds saved (base) affect flags to a room, and marks it for the next world
+* save if that changed anything. This does not touch ROOM_AFF_FLAGS.
+*
+* @param room_data *room The room to change.
+* @param bitvector_t flags The ROOM_AFF_x flag(s) to add.
+*/
+void set_room_base_flags(room_data *room, bitvector_t flags) {
+	if ((ROOM_BASE_FLAGS(room) & flags) != flags) {
+		SET_BIT(ROOM_BASE_FLAGS(room), flags);
+		request_world_save(GET_ROOM_VNUM(room));
+	}
+}
+
+
  //////////////////////////////////////////////////////////////////////////////
 //// ROOM EXTRA HANDLERS /////////////////////////////////////////////////////
 
@@ -6120,6 +6814,7 @@ void add_to_room_extra_data(room_data *room, int type, int add_value) {
 	
 	if ((red = find_room_extra_data(room, type))) {
 		SAFE_ADD(red->value, add_value, INT_MIN, INT_MAX, TRUE);
+		request_world_save(GET_ROOM_VNUM(room));
 		
 		// delete zeroes for cleanliness
 		if (red->value == 0) {
@@ -6171,6 +6866,7 @@ void multiply_room_extra_data(room_data *room, int type, double multiplier) {
 	
 	if ((red = find_room_extra_data(room, type))) {
 		red->value = (int) (multiplier * red->value);
+		request_world_save(GET_ROOM_VNUM(room));
 		
 		// delete zeroes for cleanliness
 		if (red->value == 0) {
@@ -6192,6 +6888,7 @@ void remove_room_extra_data(room_data *room, int type) {
 	if (red) {
 		HASH_DEL(room->extra_data, red);
 		free(red);
+		request_world_save(GET_ROOM_VNUM(room));
 	}
 }
 
@@ -6213,6 +6910,9 @@ void set_room_extra_data(room_data *room, int type, int value) {
 		HASH_ADD_INT(room->extra_data, type, red);
 	}
 	
+	if (red->value != value) {
+		request_world_save(GET_ROOM_VNUM(room));
+	}
 	red->value = value;
 }
 
@@ -6496,7 +7196,7 @@ void sort_evolutions(sector_data *sect) {
 * @param int amount How much to add
 */
 void add_to_empire_storage(empire_data *emp, int island, obj_vnum vnum, int amount) {
-	struct empire_storage_data *temp, *store = find_stored_resource(emp, island, vnum);
+	struct empire_storage_data *store = find_stored_resource(emp, island, vnum);
 	
 	int old;
 	
@@ -6513,12 +7213,7 @@ void add_to_empire_storage(empire_data *emp, int island, obj_vnum vnum, int amou
 	}
 	
 	if (!store) {
-		CREATE(store, struct empire_storage_data, 1);
-		store->next = EMPIRE_STORAGE(emp);
-		EMPIRE_STORAGE(emp) = store;
-
-		store->vnum = vnum;
-		store->island = island;
+		store = create_storage_entry(emp, island, vnum);
 	}
 	
 	old = store->amount;
@@ -6538,14 +7233,143 @@ void add_to_empire_storage(empire_data *emp, int island, obj_vnum vnum, int amou
 	}
 	
 	if (store && store->amount <= 0) {
-		REMOVE_FROM_LIST(store, EMPIRE_STORAGE(emp), next);
-		free(store);
+		delete_storage_entry(emp, store);
+	}
+	else {
+		update_storage_order(emp, store);
 	}
 	
 	EMPIRE_NEEDS_SAVE(emp) = TRUE;
 }
 
 
+/**
+* Creates a new, empty einv entry for an empire and adds it to both the
+* storage list and the storage hash. The caller should set the amount, or
+* delete it again if it stays at 0.
+*
+* @param empire_data *emp The empire.
+* @param int island Which island the storage is on.
+* @param obj_vnum vnum Which item it is.
+* @return struct empire_storage_data* The new entry.
+*/
+struct empire_storage_data *create_storage_entry(empire_data *emp, int island, obj_vnum vnum) {
+	struct empire_storage_data *store;
+	
+	CREATE(store, struct empire_storage_data, 1);
+	store->vnum = vnum;
+	store->island = island;
+	store->hash_key = STORAGE_HASH_KEY(island, vnum);
+	
+	LL_PREPEND(EMPIRE_STORAGE(emp), store);
+	HASH_ADD(hh, EMPIRE_STORAGE_HASH(emp), hash_key, sizeof(store->hash_key), store);
+	EMPIRE_STORAGE_CHANGED(emp);
+	
+	return store;
+}
+
+
+/**
+* Removes an einv entry from an empire's storage list and hash, and frees it.
+* Always use this rather than removing it from EMPIRE_STORAGE() directly.
+*
+* @param empire_data *emp The empire.
+* @param struct empire_storage_data *store The entry to delete.
+*/
+void delete_storage_entry(empire_data *emp, struct empire_storage_data *store) {
+	LL_DELETE(EMPIRE_STORAGE(emp), store);
+	HASH_DELETE(hh, EMPIRE_STORAGE_HASH(emp), store);
+	EMPIRE_STORAGE_CHANGED(emp);
+	free(store);
+}
+
+
+// sorts the most-quantity-first storage view
+static int sort_storage_by_quantity(const void *a, const void *b) {
+	return (*(struct empire_storage_data**)b)->amount - (*(struct empire_storage_data**)a)->amount;
+}
+
+
+/**
+* Gets an empire's einv with the highest quantity first. This view is only
+* rebuilt when entries have been added or removed since the last call; amount
+* changes just move one entry (update_storage_order), so it's cheap for
+* callers that look at it repeatedly. Do not hold onto the array: any change
+* to storage may invalidate it.
+*
+* @param empire_data *emp The empire.
+* @param int *size Will be set to the number of entries in the array.
+* @return struct empire_storage_data** The ordered view (may be NULL if size is 0).
+*/
+struct empire_storage_data **get_storage_by_quantity(empire_data *emp, int *size) {
+	struct empire_storage_data *store;
+	int count, iter;
+	
+	if (emp->store_by_amount_dirty || !emp->store_by_amount) {
+		count = HASH_CNT(hh, EMPIRE_STORAGE_HASH(emp));
+		if (count > emp->store_by_amount_size || !emp->store_by_amount) {
+			if (emp->store_by_amount) {
+				free(emp->store_by_amount);
+			}
+			CREATE(emp->store_by_amount, struct empire_storage_data*, MAX(1, count));
+		}
+		
+		emp->store_by_amount_size = 0;
+		LL_FOREACH(EMPIRE_STORAGE(emp), store) {
+			emp->store_by_amount[emp->store_by_amount_size++] = store;
+		}
+		qsort(emp->store_by_amount, emp->store_by_amount_size, sizeof(struct empire_storage_data*), sort_storage_by_quantity);
+		for (iter = 0; iter < emp->store_by_amount_size; ++iter) {
+			emp->store_by_amount[iter]->by_amount_pos = iter;
+		}
+		emp->store_by_amount_dirty = FALSE;
+	}
+	
+	*size = emp->store_by_amount_size;
+	return emp->store_by_amount;
+}
+
+
+/**
+* Call this after changing the amount of one einv entry (instead of
+* EMPIRE_STORAGE_CHANGED). It slides that entry to its new place in the
+* most-quantity-first view, which is usually only a step or two for the small
+* changes chores make, rather than re-sorting the whole einv.
+*
+* @param empire_data *emp The empire.
+* @param struct empire_storage_data *store The entry whose amount changed.
+*/
+void update_storage_order(empire_data *emp, struct empire_storage_data *store) {
+	struct empire_storage_data **view = emp->store_by_amount;
+	int pos = store->by_amount_pos;
+	
+	if (emp->store_by_amount_dirty || !view) {
+		return;	// rebuilt on the next get_storage_by_quantity() anyway
+	}
+	if (pos < 0 || pos >= emp->store_by_amount_size || view[pos] != store) {
+		// not in the view (shouldn't happen): rebuild it instead
+		EMPIRE_STORAGE_CHANGED(emp);
+		return;
+	}
+	
+	// now has more than the ones before it
+	while (pos > 0 && view[pos-1]->amount < store->amount) {
+		view[pos] = view[pos-1];
+		view[pos]->by_amount_pos = pos;
+		--pos;
+	}
+	// now has less than the ones after it
+	while (pos < emp->store_by_amount_size - 1 && view[pos+1]->amount > store->amount) {
+		view[pos] = view[pos+1];
+		view[pos]->by_amount_pos = pos;
+		++pos;
+	}
+	
+	view[pos] = store;
+	store->by_amount_pos = pos;
+}
+
+
 /**
 * removes X stored components from an empire
 *
@@ -6592,8 +7416,10 @@ bool charge_stored_component(empire_data *emp, int island, int cmp_type, int cmp
 		}
 		
 		if (store->amount <= 0) {
-			LL_DELETE(EMPIRE_STORAGE(emp), store);
-			free(store);
+			delete_storage_entry(emp, store);
+		}
+		else {
+			update_storage_order(emp, store);
 		}
 		
 		// done?
@@ -6617,7 +7443,7 @@ bool charge_stored_component(empire_data *emp, int island, int cmp_type, int cmp
 * @return bool TRUE if it was able to charge enough, FALSE if not
 */
 bool charge_stored_resource(empire_data *emp, int island, obj_vnum vnum, int amount) {
-	struct empire_storage_data *store, *next_store, *temp;
+	struct empire_storage_data *store, *next_store;
 	int old;
 	
 	// can't charge a negative amount
@@ -6654,8 +7480,10 @@ bool charge_stored_resource(empire_data *emp, int island, obj_vnum vnum, int amo
 		}
 	
 		if (store->amount <= 0) {
-			REMOVE_FROM_LIST(store, EMPIRE_STORAGE(emp), next);
-			free(store);
+			delete_storage_entry(emp, store);
+		}
+		else {
+			update_storage_order(emp, store);
 		}
 	}
 	
@@ -6673,7 +7501,7 @@ bool charge_stored_resource(empire_data *emp, int island, obj_vnum vnum, int amo
 * @return bool TRUE if it deleted at least 1, FALSE if it deleted 0.
 */
 bool delete_stored_resource(empire_data *emp, obj_vnum vnum) {
-	struct empire_storage_data *sto, *next_sto, *temp;
+	struct empire_storage_data *sto, *next_sto;
 	int deleted = 0;
 	
 	for (sto = EMPIRE_STORAGE(emp); sto; sto = next_sto) {
@@ -6681,8 +7509,7 @@ bool delete_stored_resource(empire_data *emp, obj_vnum vnum) {
 		
 		if (sto->vnum == vnum) {
 			deleted += sto->amount;
-			REMOVE_FROM_LIST(sto, EMPIRE_STORAGE(emp), next);
-			free(sto);
+			delete_storage_entry(emp, sto);
 		}
 	}
 	
@@ -6791,15 +7618,11 @@ int find_lowest_storage_loc(obj_data *obj) {
 * @return struct empire_storage_data* A pointer to the storage object for the empire, if any (otherwise NULL).
 */
 struct empire_storage_data *find_stored_resource(empire_data *emp, int island, obj_vnum vnum) {
+	unsigned long long key = STORAGE_HASH_KEY(island, vnum);
 	struct empire_storage_data *store;
-
-	for (store = EMPIRE_STORAGE(emp); store; store = store->next) {
-		if (store->island == island && store->vnum == vnum) {
-			return store;
-		}
-	}
 	
-	return NULL;
+	HASH_FIND(hh, EMPIRE_STORAGE_HASH(emp), &key, sizeof(key), store);
+	return store;
 }
 
 
@@ -7331,6 +8154,7 @@ void extract_vehicle(vehicle_data *veh) {
 	void empty_vehicle(vehicle_data *veh);
 	void relocate_players(room_data *room, room_data *to_room);
 	extern char_data *unharness_mob_from_vehicle(struct vehicle_attached_mob *vam, vehicle_data *veh);
+	extern vehicle_data *point_update_next_veh;
 	
 	struct vehicle_room_list *vrl, *next_vrl;
 	room_data *main_room;
@@ -7386,11 +8210,40 @@ void extract_vehicle(vehicle_data *veh) {
 		unharness_mob_from_vehicle(VEH_ANIMALS(veh), veh);
 	}
 	
+	if (veh == point_update_next_veh) {
+		point_update_next_veh = veh->next;
+	}
+	set_vehicle_owner(veh, NULL);
 	LL_DELETE2(vehicle_list, veh, next);
 	free_vehicle(veh);
 }
 
 
+/**
+* Changes who owns a vehicle, keeping the owners' vehicle lists up to date.
+* Always use this instead of setting VEH_OWNER() on a live vehicle.
+*
+* @param vehicle_data *veh The vehicle.
+* @param empire_data *emp The new owner (may be NULL for none).
+*/
+void set_vehicle_owner(vehicle_data *veh, empire_data *emp) {
+	if (VEH_OWNER(veh) == emp) {
+		return;
+	}
+	
+	if (VEH_OWNER(veh)) {
+		LL_DELETE2(EMPIRE_VEHICLES(VEH_OWNER(veh)), veh, next_owned);
+	}
+	
+	VEH_OWNER(veh) = emp;
+	veh->next_owned = NULL;
+	
+	if (emp) {
+		LL_PREPEND2(EMPIRE_VEHICLES(emp), veh, next_owned);
+	}
+}
+
+
 /**
 * @param char_data *ch Someone trying to sit.
 * @param vehicle_data *veh The vehicle to seat them on.
@@ -7431,6 +8284,7 @@ void vehicle_from_room(vehicle_data *veh) {
 		return;
 	}
 	
+	request_world_save(GET_ROOM_VNUM(IN_ROOM(veh)));	// vehicles are saved with the room
 	LL_DELETE2(ROOM_VEHICLES(IN_ROOM(veh)), veh, next_in_room);
 	IN_ROOM(veh) = NULL;
 }
@@ -7454,6 +8308,7 @@ void vehicle_to_room(vehicle_data *veh, room_data *room) {
 	
 	LL_PREPEND2(ROOM_VEHICLES(room), veh, next_in_room);
 	IN_ROOM(veh) = room;
+	request_world_save(GET_ROOM_VNUM(room));
 	VEH_LAST_MOVE_TIME(veh) = time(0);
 }
 
@@ -93,6 +93,9 @@ void perform_idle_out(char_data *ch);
 // character location handlers
 void char_from_room(char_data *ch);
 void char_to_room(char_data *ch, room_data *room);
+extern char_data *first_char_near(struct near_char_iterator *it, room_data *center, int distance, bool pc_only);
+extern bool is_player_nearby(room_data *room, int distance);
+extern char_data *next_char_near(struct near_char_iterator *it);
 
 // character targeting handlers
 extern char_data *find_closest_char(char_data *ch, char *arg, bool pc);
@@ -134,6 +137,10 @@ extern struct empire_political_data *create_relation(empire_data *a, empire_data
 extern int find_rank_by_name(empire_data *emp, char *name);
 extern struct empire_political_data *find_relation(empire_data *from, empire_data *to);
 extern struct empire_territory_data *find_territory_entry(empire_data *emp, room_data *room);
+void free_territory_indexes(empire_data *emp);
+extern struct empire_territory_ref *get_territory_by_building(empire_data *emp, bld_vnum vnum);
+extern struct empire_territory_ref *get_territory_functions_on_island(empire_data *emp, int island_id);
+void reset_territory_indexes(empire_data *emp);
 struct empire_trade_data *find_trade_entry(empire_data *emp, int type, obj_vnum vnum);
 extern int increase_empire_coins(empire_data *emp_gaining, empire_data *coin_empire, double amount);
 #define decrease_empire_coins(emp_gaining, coin_empire, amount)  increase_empire_coins((emp_gaining), (coin_empire), -1 * (amount))
@@ -142,6 +149,8 @@ void perform_claim_room(room_data *room, empire_data *emp);
 
 // empire targeting handlers
 extern struct empire_city_data *find_city(empire_data *emp, room_data *loc);
+extern struct city_coverage_data *get_city_coverage(empire_data *emp, int x, int y);
+void reset_city_coverage(empire_data *emp);
 extern struct empire_city_data *find_city_entry(empire_data *emp, room_data *location);
 extern struct empire_city_data *find_city_by_name(empire_data *emp, char *name);
 extern struct empire_city_data *find_closest_city(empire_data *emp, room_data *loc);
@@ -257,6 +266,9 @@ void set_depletion(room_data *room, int type, int value);
 void attach_building_to_room(bld_data *bld, room_data *room, bool with_triggers);
 void attach_template_to_room(room_template *rmt, room_data *room);
 void detach_building_from_room(room_data *room);
+void remove_room_base_flags(room_data *room, bitvector_t flags);
+void set_private_owner(room_data *room, int idnum);
+void set_room_base_flags(room_data *room, bitvector_t flags);
 
 // room extra data handlers
 void add_to_room_extra_data(room_data *room, int type, int add_value);
@@ -277,6 +289,10 @@ sector_data *reverse_lookup_evolution_for_sector(sector_data *in_sect, int evo_t
 
 // storage handlers
 void add_to_empire_storage(empire_data *emp, int island, obj_vnum vnum, int amount);
+extern struct empire_storage_data *create_storage_entry(empire_data *emp, int island, obj_vnum vnum);
+void delete_storage_entry(empire_data *emp, struct empire_storage_data *store);
+extern struct empire_storage_data **get_storage_by_quantity(empire_data *emp, int *size);
+void update_storage_order(empire_data *emp, struct empire_storage_data *store);
 extern bool charge_stored_component(empire_data *emp, int island, int cmp_type, int cmp_flags, int amount, struct resource_data **build_used_list);
 extern bool charge_stored_resource(empire_data *emp, int island, obj_vnum vnum, int amount);
 extern bool delete_stored_resource(empire_data *emp, obj_vnum vnum);
@@ -304,6 +320,7 @@ void store_unique_item(char_data *ch, obj_data *obj, empire_data *emp, room_data
 
 // vehicle handlers
 void extract_vehicle(vehicle_data *veh);
+void set_vehicle_owner(vehicle_data *veh, empire_data *emp);
 void sit_on_vehicle(char_data *ch, vehicle_data *veh);
 void unseat_char_from_vehicle(char_data *ch);
 void vehicle_from_room(vehicle_data *veh);
@@ -135,19 +135,21 @@ static void build_instance_entrance(struct instance_data *inst, struct adventure
 			complete_building(loc);
 			
 			// set these so it can be cleaned up later
-			SET_BIT(ROOM_BASE_FLAGS(loc), ROOM_AFF_TEMPORARY);
+			set_room_base_flags(loc, ROOM_AFF_TEMPORARY);
 			SET_BIT(ROOM_AFF_FLAGS(loc), ROOM_AFF_TEMPORARY);			
 			break;
 		}
 	}
 	
 	// small tweaks to room
-	SET_BIT(ROOM_BASE_FLAGS(loc), ROOM_AFF_HAS_INSTANCE);
+	set_room_base_flags(loc, ROOM_AFF_HAS_INSTANCE);
 	SET_BIT(ROOM_AFF_FLAGS(loc), ROOM_AFF_HAS_INSTANCE);
+	request_world_save(GET_ROOM_VNUM(loc));
 	
 	// and the home room
-	SET_BIT(ROOM_BASE_FLAGS(HOME_ROOM(loc)), ROOM_AFF_HAS_INSTANCE);
+	set_room_base_flags(HOME_ROOM(loc), ROOM_AFF_HAS_INSTANCE);
 	SET_BIT(ROOM_AFF_FLAGS(HOME_ROOM(loc)), ROOM_AFF_HAS_INSTANCE);
+	request_world_save(GET_ROOM_VNUM(HOME_ROOM(loc)));
 	
 	// ADV_LINK_x part 2: portal or direction
 	switch (rule->type) {
@@ -440,9 +442,9 @@ static room_data *instantiate_one_room(struct instance_data *inst, room_template
 	room = create_room();
 	attach_template_to_room(rmt, room);
 	sect = sector_proto(config_get_int("default_adventure_sect"));
-	perform_change_sect(room, NULL, sect);
-	perform_change_base_sect(room, NULL, sect);
-	SET_BIT(ROOM_BASE_FLAGS(room), GET_RMT_BASE_AFFECTS(rmt) | default_affs);
+	perform_change_sect(room, NOWHERE, sect);
+	perform_change_base_sect(room, NOWHERE, sect);
+	set_room_base_flags(room, GET_RMT_BASE_AFFECTS(rmt) | default_affs);
 	SET_BIT(ROOM_AFF_FLAGS(room), GET_RMT_BASE_AFFECTS(rmt) | default_affs);
 	
 	// copy proto script
@@ -572,14 +574,14 @@ static void instantiate_rooms(adv_data *adv, struct instance_data *inst, struct
 *
 * @param adv_data *adv The adventure we are trying to link.
 * @param room_data *loc The chosen room -- OPTIONAL (pass loc OR map).
-* @param struct map_data *map The chosen map tile -- OPTIONAL (pass loc OR map).
+* @param room_vnum map The chosen map tile -- OPTIONAL (pass loc OR map).
 * @return bool TRUE if the location is ok, FALSE if not.
 */
-bool validate_linking_limits(adv_data *adv, room_data *loc, struct map_data *map) {
+bool validate_linking_limits(adv_data *adv, room_data *loc, room_vnum map) {
 	struct adventure_link_rule *rule;
 	struct instance_data *inst;
 	
-	if (!loc && !map) {
+	if (!loc && map == NOWHERE) {
 		return FALSE;
 	}
 	
@@ -599,7 +601,7 @@ bool validate_linking_limits(adv_data *adv, room_data *loc, struct map_data *map
 					}
 					
 					// check distance
-					if (inst->location && compute_map_distance(X_COORD(inst->location), Y_COORD(inst->location), (loc ? X_COORD(loc) : MAP_X_COORD(map->vnum)), (loc ? Y_COORD(loc) : MAP_Y_COORD(map->vnum))) <= rule->value) {
+					if (inst->location && compute_map_distance(X_COORD(inst->location), Y_COORD(inst->location), (loc ? X_COORD(loc) : MAP_X_COORD(map)), (loc ? Y_COORD(loc) : MAP_Y_COORD(map))) <= rule->value) {
 						// NO! Too close.
 						return FALSE;
 					}
@@ -625,10 +627,10 @@ bool validate_linking_limits(adv_data *adv, room_data *loc, struct map_data *map
 * @param adv_data *adv The adventure we are linking.
 * @param struct adventure_link_rule *rule The linking rule we're trying.
 * @param room_data *loc A location to test -- OPTIONAL (pass this or map).
-* @param struct map_data *map A location to test -- OPTIONAL (pass this or loc).
+* @param room_vnum map A location to test -- OPTIONAL (pass this or loc).
 * @return bool TRUE if the location seems ok.
 */
-bool validate_one_loc(adv_data *adv, struct adventure_link_rule *rule, room_data *loc, struct map_data *map) {
+bool validate_one_loc(adv_data *adv, struct adventure_link_rule *rule, room_data *loc, room_vnum map) {
 	extern bool is_entrance(room_data *room);
 	
 	room_data *home;
@@ -641,18 +643,18 @@ bool validate_one_loc(adv_data *adv, struct adventure_link_rule *rule, room_data
 	const bitvector_t no_no_flags = ROOM_AFF_DISMANTLING | ROOM_AFF_HAS_INSTANCE;
 	
 	// need one of these
-	if (!loc && !map) {
+	if (!loc && map == NOWHERE) {
 		return FALSE;
 	}
 	
 	// detect map
-	if (!map && GET_ROOM_VNUM(loc) < MAP_SIZE) {
-		map = &(world_map[FLAT_X_COORD(loc)][FLAT_Y_COORD(loc)]);
+	if (map == NOWHERE && GET_ROOM_VNUM(loc) < MAP_SIZE) {
+		map = GET_ROOM_VNUM(loc);
 	}
 	
 	// detect loc (still OPTIONAL at this stage)
-	if (!loc) {
-		loc = real_real_room(map->vnum);
+	if (!loc && map != NOWHERE) {
+		loc = real_real_room(map);
 	}
 	
 	// detect home room if applicable
@@ -698,7 +700,7 @@ bool validate_one_loc(adv_data *adv, struct adventure_link_rule *rule, room_data
 	}
 	
 	// newbie island checks
-	island_id = map ? map->island : GET_ISLAND_ID(loc);
+	island_id = (map != NOWHERE) ? MAP_ISLAND(map) : GET_ISLAND_ID(loc);
 	if (island_id != NO_ISLAND) {
 		isle = get_island(island_id, TRUE);
 		if (IS_SET(isle->flags, ISLE_NEWBIE)) {	// is newbie island
@@ -723,7 +725,7 @@ bool validate_one_loc(adv_data *adv, struct adventure_link_rule *rule, room_data
 		if (!IS_SET(GET_BLD_FLAGS(bdg), BLD_OPEN)) {
 			// now we need loc
 			if (!loc) {
-				loc = real_room(map->vnum);
+				loc = real_room(map);
 			}
 			if (is_entrance(loc)) {
 				return FALSE;
@@ -754,7 +756,7 @@ room_data *find_location_for_rule(adv_data *adv, struct adventure_link_rule *rul
 	sector_data *findsect = NULL;
 	bool match_buildon = FALSE;
 	bld_data *findbdg = NULL, *bdg = NULL;
-	struct map_data *map;
+	room_vnum map;
 	
 	const int max_tries = 500, max_dir_tries = 10;	// for random checks
 	
@@ -796,9 +798,9 @@ room_data *find_location_for_rule(adv_data *adv, struct adventure_link_rule *rul
 	// two ways of doing this:
 	if (findsect) {	// scan the whole map
 		num_found = 0;
-		for (map = land_map; map; map = map->next) {
+		for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
 			// looking for sect: fail
-			if (findsect && map->sector_type != findsect) {
+			if (findsect && MAP_SECT(map) != findsect) {
 				continue;
 			}
 			
@@ -810,7 +812,7 @@ room_data *find_location_for_rule(adv_data *adv, struct adventure_link_rule *rul
 			// SUCCESS: mark it ok
 			if (!number(0, num_found++) || !found) {
 				// may already have looked up room
-				found = real_room(map->vnum);
+				found = real_room(map);
 			}
 		}
 	}
@@ -822,7 +824,7 @@ room_data *find_location_for_rule(adv_data *adv, struct adventure_link_rule *rul
 			}
 			
 			// attributes/limits checks
-			if (!validate_one_loc(adv, rule, room, NULL) || !validate_linking_limits(adv, room, NULL)) {
+			if (!validate_one_loc(adv, rule, room, NOWHERE) || !validate_linking_limits(adv, room, NOWHERE)) {
 				continue;
 			}
 			
@@ -837,10 +839,10 @@ room_data *find_location_for_rule(adv_data *adv, struct adventure_link_rule *rul
 		for (iter = 0; iter < max_tries && !found; ++iter) {
 			// random location:
 			pos = number(0, MAP_SIZE-1);
-			map = &(world_map[MAP_X_COORD(pos)][MAP_Y_COORD(pos)]);
+			map = pos;
 			
 			// shortcut: skip BASIC_OCEAN
-			if (GET_SECT_VNUM(map->sector_type) == BASIC_OCEAN) {
+			if (GET_SECT_VNUM(MAP_SECT(map)) == BASIC_OCEAN) {
 				continue;
 			}
 			
@@ -1278,12 +1280,14 @@ void unlink_instance_entrance(room_data *room, struct instance_data *inst) {
 	struct trig_proto_list *tpl;
 	trig_data *proto, *trig;
 	
-	REMOVE_BIT(ROOM_BASE_FLAGS(room), ROOM_AFF_HAS_INSTANCE);
+	remove_room_base_flags(room, ROOM_AFF_HAS_INSTANCE);
 	REMOVE_BIT(ROOM_AFF_FLAGS(room), ROOM_AFF_HAS_INSTANCE);
+	request_world_save(GET_ROOM_VNUM(room));
 	
 	// and the home room
-	REMOVE_BIT(ROOM_BASE_FLAGS(HOME_ROOM(room)), ROOM_AFF_HAS_INSTANCE);
+	remove_room_base_flags(HOME_ROOM(room), ROOM_AFF_HAS_INSTANCE);
 	REMOVE_BIT(ROOM_AFF_FLAGS(HOME_ROOM(room)), ROOM_AFF_HAS_INSTANCE);
+	request_world_save(GET_ROOM_VNUM(HOME_ROOM(room)));
 	
 	// check for scripts
 	if (adv && GET_ADV_SCRIPTS(adv)) {
@@ -2041,20 +2045,23 @@ void load_instances(void) {
 
 /**
 * Writes all instances to the instance file.
+*
+* @return bool TRUE if it saved (or was put off by instance_save_wait); FALSE if the file couldn't be written.
 */
-void save_instances(void) {
+bool save_instances(void) {
 	struct instance_data *inst;
+	bool failed;
 	FILE *fl;
 	int iter;
 	
 	// this prevents dozens of saves during an instance delete
 	if (instance_save_wait) {
-		return;
+		return TRUE;
 	}
 	
 	if (!(fl = fopen(INSTANCE_FILE TEMP_SUFFIX, "w"))) {
 		log("SYSERR: Unable to write %s", INSTANCE_FILE TEMP_SUFFIX);
-		return;
+		return FALSE;
 	}
 
 	for (inst = instance_list; inst; inst = inst->next) {
@@ -2071,8 +2078,12 @@ void save_instances(void) {
 	}
 
 	fprintf(fl, "$\n");
-	fclose(fl);
-	rename(INSTANCE_FILE TEMP_SUFFIX, INSTANCE_FILE);
+	failed = (ferror(fl) != 0);
+	if (fclose(fl) != 0 || failed || rename(INSTANCE_FILE TEMP_SUFFIX, INSTANCE_FILE) != 0) {
+		log("SYSERR: Unable to write %s: %s", INSTANCE_FILE, strerror(errno));
+		return FALSE;
+	}
+	return TRUE;
 }
 
 
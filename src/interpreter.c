@@ -30,6 +30,7 @@
 *   Command Prototypes
 *   Master Command List
 *   Command Interpreter
+*   Command Lookup Trie
 *   Alias System
 *   Helper Functions
 *   Command Functions
@@ -1092,7 +1093,7 @@ cpp_extern const struct command_info cmd_info[] = {
  */
 void command_interpreter(char_data *ch, char *argument) {
 	extern bool check_social(char_data *ch, char *string, bool exact);
-	int cmd, length, iter;
+	int cmd, iter;
 	char *line;
 
 	/* just drop to next line for hitting CR */
@@ -1125,27 +1126,7 @@ void command_interpreter(char_data *ch, char *argument) {
 	}
 
 	/* otherwise, find the command */
-	for (length = strlen(arg), cmd = 0; *cmd_info[cmd].command != '\n'; cmd++) {
-		if (GET_ACCESS_LEVEL(ch) < cmd_info[cmd].minimum_level && (cmd_info[cmd].grants == NO_GRANTS || !IS_GRANTED(ch, cmd_info[cmd].grants))) {
-			continue;
-		}
-		if (IS_SET(cmd_info[cmd].flags, CMD_NO_ABBREV) ? strcmp(arg, cmd_info[cmd].command) : strncmp(cmd_info[cmd].command, arg, length)) {
-			continue;
-		}		
-		if (IS_SET(cmd_info[cmd].flags, CMD_VAMPIRE_ONLY) && !IS_VAMPIRE(ch)) {
-			continue;
-		}
-		if (IS_SET(cmd_info[cmd].flags, CMD_IMM_OR_MOB_ONLY) && GET_ACCESS_LEVEL(ch) < LVL_START_IMM && !IS_NPC(ch)) {
-			continue;
-		}
-		// NPCs can use ability commands IF they aren't charmed; players require the ability
-		if (cmd_info[cmd].ability != NO_ABIL && (IS_NPC(ch) ? AFF_FLAGGED(ch, AFF_CHARM) : !has_ability(ch, cmd_info[cmd].ability))) {
-			continue;
-		}
-		
-		// found!
-		break;
-	}
+	cmd = find_command_for_char(ch, arg);
 
 	if (!IS_SET(cmd_info[cmd].flags, CMD_STAY_HIDDEN | CMD_UNHIDE_AFTER))
 		REMOVE_BIT(AFF_FLAGS(ch), AFF_HIDE);
@@ -1230,6 +1211,197 @@ int find_command(const char *command) {
 }
 
 
+ //////////////////////////////////////////////////////////////////////////////
+//// COMMAND LOOKUP TRIE /////////////////////////////////////////////////////
+
+// prefix trie over cmd_info, built at boot by build_command_trie()
+struct cmd_trie_node *command_trie = NULL;
+
+
+/**
+* Adds an entry to a command trie. Every node along the way lists the entry
+* as an abbreviation match (if abbrev_ok), and the last node also lists it as
+* an exact match. Add entries in priority order: lookups return them in the
+* order they were added.
+*
+* @param struct cmd_trie_node **root The trie to add to (may be NULL/empty).
+* @param const char *str The full name of the entry.
+* @param int id The entry's id, e.g. its position in cmd_info.
+* @param bool abbrev_ok If FALSE, the entry only matches its exact name.
+*/
+void add_to_cmd_trie(struct cmd_trie_node **root, const char *str, int id, bool abbrev_ok) {
+	struct cmd_trie_node *node, *child;
+	
+	if (!*root) {
+		CREATE(*root, struct cmd_trie_node, 1);
+	}
+	
+	for (node = *root;; node = child) {
+		if (abbrev_ok || !*str) {
+			RECREATE(node->abbrev, int, node->num_abbrev + 1);
+			node->abbrev[node->num_abbrev++] = id;
+		}
+		if (!*str) {
+			RECREATE(node->exact, int, node->num_exact + 1);
+			node->exact[node->num_exact++] = id;
+			break;
+		}
+		
+		// find or add the next node
+		for (child = node->children; child && child->key != *str; child = child->next);
+		if (!child) {
+			CREATE(child, struct cmd_trie_node, 1);
+			child->key = *str;
+			child->next = node->children;
+			node->children = child;
+		}
+		++str;
+	}
+}
+
+
+/**
+* Finds the node for a typed-in string. Its abbrev list holds every entry the
+* string can match (in the order added), and its exact list holds entries
+* whose name is exactly the string.
+*
+* @param struct cmd_trie_node *root The trie to search.
+* @param const char *str The typed-in string (case-sensitive).
+* @return struct cmd_trie_node* The node, or NULL if nothing could match.
+*/
+struct cmd_trie_node *find_in_cmd_trie(struct cmd_trie_node *root, const char *str) {
+	struct cmd_trie_node *node = root;
+	
+	for (; node && *str; ++str) {
+		for (node = node->children; node && node->key != *str; node = node->next);
+	}
+	
+	return node;
+}
+
+
+/**
+* Frees a command trie.
+*
+* @param struct cmd_trie_node *node The root of the trie to free.
+*/
+void free_cmd_trie(struct cmd_trie_node *node) {
+	struct cmd_trie_node *child, *next_child;
+	
+	if (node) {
+		for (child = node->children; child; child = next_child) {
+			next_child = child->next;
+			free_cmd_trie(child);
+		}
+		if (node->abbrev) {
+			free(node->abbrev);
+		}
+		if (node->exact) {
+			free(node->exact);
+		}
+		free(node);
+	}
+}
+
+
+/**
+* Builds the command trie from cmd_info. Table order is kept in each node, so
+* the first usable entry in a node is the same one the old linear scan found.
+*/
+void build_command_trie(void) {
+	int cmd;
+	
+	free_cmd_trie(command_trie);
+	command_trie = NULL;
+	
+	for (cmd = 0; *cmd_info[cmd].command != '\n'; ++cmd) {
+		add_to_cmd_trie(&command_trie, cmd_info[cmd].command, cmd, !IS_SET(cmd_info[cmd].flags, CMD_NO_ABBREV));
+	}
+}
+
+
+/**
+* Checks everything about whether ch can use a command, except its name.
+*
+* @param char_data *ch The person typing the command.
+* @param int cmd A position in cmd_info.
+* @return bool TRUE if ch can use it.
+*/
+static bool can_use_command(char_data *ch, int cmd) {
+	if (GET_ACCESS_LEVEL(ch) < cmd_info[cmd].minimum_level && (cmd_info[cmd].grants == NO_GRANTS || !IS_GRANTED(ch, cmd_info[cmd].grants))) {
+		return FALSE;
+	}
+	if (IS_SET(cmd_info[cmd].flags, CMD_VAMPIRE_ONLY) && !IS_VAMPIRE(ch)) {
+		return FALSE;
+	}
+	if (IS_SET(cmd_info[cmd].flags, CMD_IMM_OR_MOB_ONLY) && GET_ACCESS_LEVEL(ch) < LVL_START_IMM && !IS_NPC(ch)) {
+		return FALSE;
+	}
+	// NPCs can use ability commands IF they aren't charmed; players require the ability
+	if (cmd_info[cmd].ability != NO_ABIL && (IS_NPC(ch) ? AFF_FLAGGED(ch, AFF_CHARM) : !has_ability(ch, cmd_info[cmd].ability))) {
+		return FALSE;
+	}
+	
+	return TRUE;
+}
+
+
+/**
+* Finds the command a person means by a typed-in (lowercase) word, following
+* cmd_info's order for abbreviations and CMD_NO_ABBREV.
+*
+* @param char_data *ch The person typing the command.
+* @param char *arg The typed-in command word, already lowercase.
+* @return int The position in cmd_info, or the position of the "\n" entry if none matched.
+*/
+int find_command_for_char(char_data *ch, char *arg) {
+	extern int num_of_cmds;
+	struct cmd_trie_node *node;
+	int iter;
+	
+	if (!command_trie) {	// not booted yet
+		return find_command_for_char_linear(ch, arg);
+	}
+	
+	if ((node = find_in_cmd_trie(command_trie, arg))) {
+		for (iter = 0; iter < node->num_abbrev; ++iter) {
+			if (can_use_command(ch, node->abbrev[iter])) {
+				return node->abbrev[iter];
+			}
+		}
+	}
+	
+	return num_of_cmds;
+}
+
+
+/**
+* The original linear scan of cmd_info, which find_command_for_char() must
+* agree with. This is used before boot and by the "util cmdtrie" check.
+*
+* @param char_data *ch The person typing the command.
+* @param char *arg The typed-in command word, already lowercase.
+* @return int The position in cmd_info, or the position of the "\n" entry if none matched.
+*/
+int find_command_for_char_linear(char_data *ch, char *arg) {
+	int cmd, length = strlen(arg);
+	
+	for (cmd = 0; *cmd_info[cmd].command != '\n'; cmd++) {
+		if (IS_SET(cmd_info[cmd].flags, CMD_NO_ABBREV) ? strcmp(arg, cmd_info[cmd].command) : strncmp(cmd_info[cmd].command, arg, length)) {
+			continue;
+		}
+		if (!can_use_command(ch, cmd)) {
+			continue;
+		}
+		
+		// found!
+		break;
+	}
+	
+	return cmd;
+}
+
+
  //////////////////////////////////////////////////////////////////////////////
 //// ALIAS SYSTEM ////////////////////////////////////////////////////////////
 
@@ -15,11 +15,31 @@
 #define LIBRARY_SCMD(name)  void name(char_data *ch, char *argument)
 
 
+// prefix trie for command/social lookups: each node is one typed character
+struct cmd_trie_node {
+	char key;	// character that leads to this node
+	
+	int *abbrev;	// ids (in the order added) that the input ending here can match
+	int num_abbrev;
+	int *exact;	// ids whose name is exactly the input ending here
+	int num_exact;
+	
+	struct cmd_trie_node *children;	// first child
+	struct cmd_trie_node *next;	// next sibling
+};
+
+
 // prototypes
+void add_to_cmd_trie(struct cmd_trie_node **root, const char *str, int id, bool abbrev_ok);
+void build_command_trie();
 void command_interpreter(char_data *ch, char *argument);
 char lower( char c );
 void nanny(descriptor_data *d, char *arg);
 int find_command(const char *command);
+int find_command_for_char(char_data *ch, char *arg);
+int find_command_for_char_linear(char_data *ch, char *arg);
+struct cmd_trie_node *find_in_cmd_trie(struct cmd_trie_node *root, const char *str);
+void free_cmd_trie(struct cmd_trie_node *node);
 void send_low_pos_msg(char_data *ch);
 
 
@@ -40,6 +60,7 @@ struct command_info {
 #define NO_GRANTS  NOBITS
 
 
+
 /* Command types for reference/sorting */
 #define CTYPE_MOVE		0	/* A movement command		*/
 #define CTYPE_IMMORTAL	1	/* An imm command			*/
@@ -458,7 +458,7 @@ void point_update_char(char_data *ch) {
 	// check spawned
 	if (REAL_NPC(ch) && !ch->desc && MOB_FLAGGED(ch, MOB_SPAWNED) && (!MOB_FLAGGED(ch, MOB_ANIMAL) || !room_has_function_and_city_ok(IN_ROOM(ch), FNC_STABLE)) && MOB_SPAWN_TIME(ch) < (time(0) - config_get_int("mob_spawn_interval") * SECS_PER_REAL_MIN)) {
 		if (!GET_LED_BY(ch) && !GET_LEADING_MOB(ch) && !GET_LEADING_VEHICLE(ch) && !MOB_FLAGGED(ch, MOB_TIED)) {
-			if (distance_to_nearest_player(IN_ROOM(ch)) > config_get_int("mob_despawn_radius")) {
+			if (!is_player_nearby(IN_ROOM(ch), config_get_int("mob_despawn_radius"))) {
 				despawn_mob(ch);
 				return;
 			}
@@ -1011,6 +1011,8 @@ static void reduce_city_overage_one(empire_data *emp) {
 	if (city->type > 0) {
 		log_to_empire(emp, ELOG_TERRITORY, "%s (%d, %d) is shrinking because of too many city points in use", city->name, X_COORD(loc), Y_COORD(loc));
 		city->type -= 1;
+		invalidate_map_icon(GET_ROOM_VNUM(loc));
+		reset_city_coverage(emp);
 	}
 	else {
 		log_to_empire(emp, ELOG_TERRITORY, "%s (%d, %d) is no longer a city because of too many city points in use", city->name, X_COORD(loc), Y_COORD(loc));
@@ -1582,6 +1584,7 @@ void real_update_obj(obj_data *obj) {
 				if (!emp || (enemy && (pol = find_relation(enemy, emp)) && IS_SET(pol->type, DIPL_WAR))) {
 					// TODO magic number -- this should be a config
 					COMPLEX_DATA(home)->burning = number(4, 12);
+					request_world_save(GET_ROOM_VNUM(home));
 					if (ROOM_PEOPLE(home)) {
 						act("A stray ember from $p ignites the room!", FALSE, ROOM_PEOPLE(home), obj, 0, TO_CHAR | TO_ROOM);
 
@@ -1646,6 +1649,7 @@ void point_update_room(room_data *room) {
 		if (COMPLEX_DATA(room) && HOME_ROOM(room) == room && BUILDING_BURNING(room)) {
 			/* Reduce by one tick */
 			--COMPLEX_DATA(room)->burning;
+			request_world_save(GET_ROOM_VNUM(room));
 		
 			emp = ROOM_OWNER(room);
 			if (emp) {
@@ -2195,76 +2199,164 @@ int move_gain(char_data *ch, bool info_only) {
  //////////////////////////////////////////////////////////////////////////////
 //// CORE PERIODICALS ////////////////////////////////////////////////////////
 
+// phases of point_update_job()
+#define PU_PHASE_CHARS  0
+#define PU_PHASE_VEHICLES  1
+#define PU_PHASE_OBJS  2
+#define PU_PHASE_ROOMS  3
+
+// cursors for point_update_job() -- these are advanced by whatever removes the item from its list
+char_data *point_update_next_char = NULL;
+obj_data *point_update_next_obj = NULL;
+vehicle_data *point_update_next_veh = NULL;
+
+
 /**
 * Point Update: runs once per tick (75 seconds). This also calls the "real"
 * update for that tick, to avoid iterating a second time over the same data.
+*
+* This is a budgeted job: it picks up where it left off each pulse until it
+* has been through every character, vehicle, object, and room. Things created
+* during the update may not be updated until the next tick. Rooms are taken
+* from a snapshot of vnums, since world_table may be sorted or unloaded while
+* the update is in progress.
+*
+* @param bool start TRUE on the first call of a new update.
+* @param unsigned long long deadline microtime() to stop by.
+* @return bool TRUE when the update is finished.
 */
-void point_update(bool run_real) {
+BUDGET_JOB(point_update_job) {
 	void clean_offers(char_data *ch);
 	void setup_daily_quest_cycles(int only_cycle);
 	void update_players_online_stats();
 	
-	vehicle_data *veh, *next_veh;
-	room_data *room, *next_room;
-	obj_data *obj, *next_obj;
-	char_data *ch, *next_ch;
+	static room_vnum *room_list = NULL;	// snapshot of the world for the room phase
+	static int num_rooms = 0, room_pos = 0;
+	static int phase = PU_PHASE_CHARS;
 	
-	long daily_cycle = data_get_long(DATA_DAILY_CYCLE);
+	room_data *room, *next_room;
+	vehicle_data *veh;
+	obj_data *obj;
+	char_data *ch;
+	int count = 0;
+	long daily_cycle;
 	
-	// check if the skill cycle must reset (daily)
-	if (time(0) > daily_cycle + SECS_PER_REAL_DAY) {
-		// put this in a while so that it doesn't repeatedly update if the mud is down for more than a day
-		// but it only adds 1 day at a time so that the cycle time doesn't move
-		while (time(0) > daily_cycle + SECS_PER_REAL_DAY) {
-			daily_cycle += SECS_PER_REAL_DAY;
+	if (start) {
+		daily_cycle = data_get_long(DATA_DAILY_CYCLE);
+		
+		// check if the skill cycle must reset (daily)
+		if (time(0) > daily_cycle + SECS_PER_REAL_DAY) {
+			// put this in a while so that it doesn't repeatedly update if the mud is down for more than a day
+			// but it only adds 1 day at a time so that the cycle time doesn't move
+			while (time(0) > daily_cycle + SECS_PER_REAL_DAY) {
+				daily_cycle += SECS_PER_REAL_DAY;
+			}
+			data_set_long(DATA_DAILY_CYCLE, daily_cycle);
+		
+			// reset players seen today too
+			data_set_int(DATA_MAX_PLAYERS_TODAY, 0);
+			update_players_online_stats();
+			setup_daily_quest_cycles(NOTHING);
 		}
-		data_set_long(DATA_DAILY_CYCLE, daily_cycle);
 		
-		// reset players seen today too
-		data_set_int(DATA_MAX_PLAYERS_TODAY, 0);
-		update_players_online_stats();
-		setup_daily_quest_cycles(NOTHING);
+		phase = PU_PHASE_CHARS;
+		point_update_next_char = character_list;
 	}
 	
 	// characters
-	for (ch = character_list; ch; ch = next_ch) {
-		next_ch = ch->next;
+	if (phase == PU_PHASE_CHARS) {
+		while ((ch = point_update_next_char)) {
+			if (BUDGET_EXPIRED(deadline, count)) {
+				return FALSE;
+			}
+			++count;
+			point_update_next_char = ch->next;
 		
-		// remove stale offers -- this needs to happen even if dead (resurrect)
-		// TODO shouldn't this logic be inside the point_update_char function?
-		if (!IS_NPC(ch)) {
-			clean_offers(ch);
-		}
+			// remove stale offers -- this needs to happen even if dead (resurrect)
+			// TODO shouldn't this logic be inside the point_update_char function?
+			if (!IS_NPC(ch)) {
+				clean_offers(ch);
+			}
 		
-		if (EXTRACTED(ch)) {
-			continue;
-		}
-		if (IS_DEAD(ch)) {
-			check_idling(ch);
-			continue;
+			if (EXTRACTED(ch)) {
+				continue;
+			}
+			if (IS_DEAD(ch)) {
+				check_idling(ch);
+				continue;
+			}
+		
+			real_update_char(ch);
+			point_update_char(ch);
 		}
 		
-		real_update_char(ch);
-		point_update_char(ch);
+		phase = PU_PHASE_VEHICLES;
+		point_update_next_veh = vehicle_list;
 	}
 	
 	// vehicles
-	LL_FOREACH_SAFE(vehicle_list, veh, next_veh) {
-		point_update_vehicle(veh);
+	if (phase == PU_PHASE_VEHICLES) {
+		while ((veh = point_update_next_veh)) {
+			if (BUDGET_EXPIRED(deadline, count)) {
+				return FALSE;
+			}
+			++count;
+			point_update_next_veh = veh->next;
+			point_update_vehicle(veh);
+		}
+		
+		phase = PU_PHASE_OBJS;
+		point_update_next_obj = object_list;
 	}
 	
 	// objs
-	for (obj = object_list; obj; obj = next_obj) {
-		next_obj = obj->next;
+	if (phase == PU_PHASE_OBJS) {
+		while ((obj = point_update_next_obj)) {
+			if (BUDGET_EXPIRED(deadline, count)) {
+				return FALSE;
+			}
+			++count;
+			point_update_next_obj = obj->next;
 		
-		real_update_obj(obj);
-		point_update_obj(obj);
+			real_update_obj(obj);
+			point_update_obj(obj);
+		}
+		
+		// snapshot the rooms to update
+		if (room_list) {
+			free(room_list);
+		}
+		num_rooms = HASH_CNT(hh, world_table);
+		CREATE(room_list, room_vnum, MAX(1, num_rooms));
+		room_pos = 0;
+		HASH_ITER(hh, world_table, room, next_room) {
+			room_list[room_pos++] = GET_ROOM_VNUM(room);
+		}
+		
+		phase = PU_PHASE_ROOMS;
+		room_pos = 0;
 	}
 	
 	// rooms
-	HASH_ITER(hh, world_table, room, next_room) {
-		point_update_room(room);
+	if (phase == PU_PHASE_ROOMS) {
+		while (room_pos < num_rooms) {
+			if (BUDGET_EXPIRED(deadline, count)) {
+				return FALSE;
+			}
+			++count;
+			
+			// rooms may have been unloaded since the snapshot
+			if ((room = real_real_room(room_list[room_pos++]))) {
+				point_update_room(room);
+			}
+		}
+		
+		free(room_list);
+		room_list = NULL;
+		num_rooms = 0;
 	}
+	
+	return TRUE;
 }
 
 
@@ -43,9 +43,24 @@ extern vehicle_data *find_vehicle_to_show(char_data *ch, room_data *room);
  //////////////////////////////////////////////////////////////////////////////
 //// DATA ////////////////////////////////////////////////////////////////////
 
-#define ANY_ROAD_TYPE(tile)  (IS_ROAD(tile) || BUILDING_VNUM(tile) == BUILDING_BRIDGE || BUILDING_VNUM(tile) == BUILDING_SWAMPWALK)
-#define CONNECTS_TO_ROAD(tile)  (tile && (ANY_ROAD_TYPE(tile) || ROOM_BLD_FLAGGED(tile, BLD_ATTACH_ROAD)))
-#define IS_BARRIER(tile)  (BUILDING_VNUM(tile) == BUILDING_WALL || BUILDING_VNUM(tile) == BUILDING_FENCE || BUILDING_VNUM(tile) == BUILDING_GATE || BUILDING_VNUM(tile) == BUILDING_GATEHOUSE)
+// these take a struct map_tile_data* (see get_map_tile)
+#define ANY_ROAD_TYPE(tile)  (TILE_SECT_FLAGGED((tile), SECTF_IS_ROAD) || TILE_BUILDING_VNUM(tile) == BUILDING_BRIDGE || TILE_BUILDING_VNUM(tile) == BUILDING_SWAMPWALK)
+#define CONNECTS_TO_ROAD(tile)  (tile && (ANY_ROAD_TYPE(tile) || TILE_BLD_FLAGGED((tile), BLD_ATTACH_ROAD)))
+#define IS_BARRIER(tile)  (TILE_BUILDING_VNUM(tile) == BUILDING_WALL || TILE_BUILDING_VNUM(tile) == BUILDING_FENCE || TILE_BUILDING_VNUM(tile) == BUILDING_GATE || TILE_BUILDING_VNUM(tile) == BUILDING_GATEHOUSE)
+
+#define MAP_ICON_LENGTH  30	// buffer size for one drawn map tile
+
+// things that are the same for every tile in one map view (see init_map_view)
+struct map_view_data {
+	int north;	// the viewer's north, from get_north_for_char()
+	room_data *map_loc;	// the viewer's map location
+	int season_y;	// last y-coord passed to pick_season_by_y() (-1 for none)
+	int season;	// and its TILESET_x
+};
+
+// counters for 'show stats': map views should not have to load rooms
+int map_views_drawn = 0;	// number of map views shown by look_at_room_by_loc()
+int map_view_rooms_loaded = 0;	// number of map rooms loaded while drawing them
 
 
 // for showing map pcs
@@ -58,6 +73,7 @@ struct mappc_data {
 
 struct mappc_data_container {
 	struct mappc_data *data;
+	struct mappc_data *last;	// end of data, for appending
 };
 
 
@@ -71,34 +87,69 @@ void replace_question_color(char *input, char *color, char *output);
 
 // locals
 ACMD(do_exits);
-static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc, room_data *to_room, bitvector_t options);
+int pick_season_by_y(int ycoord);
+static void init_map_view(char_data *ch, struct map_view_data *view);
+static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc, struct map_view_data *view, struct map_tile_data *tile, bitvector_t options);
 
 
  //////////////////////////////////////////////////////////////////////////////
 //// HELPERS /////////////////////////////////////////////////////////////////
 
 
+/**
+* Checks the map tiles around a location for light, without loading them.
+*
+* @param room_vnum vnum A map location.
+* @return bool TRUE if any adjacent tile is light; otherwise FALSE.
+*/
+static bool any_adjacent_tile_is_light(room_vnum vnum) {
+	struct map_tile_data tile;
+	int i;
+	
+	for (i = 0; i < NUM_SIMPLE_DIRS; i++) {
+		if (get_map_tile_shift(vnum, shift_dir[i][0], shift_dir[i][1], &tile) && TILE_IS_REAL_LIGHT(&tile)) {
+			return TRUE;
+		}
+	}
+	
+	return FALSE;
+}
+
+
 /**
 * @param room_data *room The room to check.
 * @return bool TRUE if any adjacent room is light; otherwise FALSE.
 */
 bool adjacent_room_is_light(room_data *room) {
-	room_data *to_room;
-	int i;
+	room_data *map;
 	
 	// adventure rooms don't bother
 	if (IS_ADVENTURE_ROOM(room)) {
 		return FALSE;
 	}
+	
+	if (!(map = get_map_location_for(room))) {
+		return FALSE;
+	}
+	
+	return any_adjacent_tile_is_light(GET_ROOM_VNUM(map));
+}
 
-	for (i = 0; i < NUM_SIMPLE_DIRS; i++) {
-		to_room = real_shift(room, shift_dir[i][0], shift_dir[i][1]);
-		if (to_room && IS_REAL_LIGHT(to_room)) {
-			return TRUE;
-		}
+
+/**
+* CAN_SEE_IN_DARK_ROOM() for a map tile, which may not have a room loaded.
+*
+* @param char_data *ch The person looking.
+* @param struct map_tile_data *tile The tile they're looking at.
+* @return bool TRUE if ch can see the tile in the dark.
+*/
+static bool can_see_in_dark_tile(char_data *ch, struct map_tile_data *tile) {
+	if (TILE_ROOM(tile)) {
+		return CAN_SEE_IN_DARK_ROOM(ch, TILE_ROOM(tile));
 	}
 	
-	return FALSE;
+	// blank tiles have no magical darkness, templates, or light sources
+	return (!TILE_IS_DARK(tile) || (!TILE_SECT_FLAGGED(tile, SECTF_ADVENTURE) && any_adjacent_tile_is_light(TILE_VNUM(tile))) || TILE_SECT_FLAGGED(tile, SECTF_MAP_BUILDING | SECTF_INSIDE) || CAN_SEE_IN_DARK(ch));
 }
 
 
@@ -309,7 +360,18 @@ char *get_room_name(room_data *room, bool color) {
 
 // determines which tileset to use for sector color
 int pick_season(room_data *room) {
-	int ycoord = Y_COORD(room);
+	return pick_season_by_y(Y_COORD(room));
+}
+
+
+/**
+* Determines which tileset to use for sector color at a given y-coordinate,
+* for callers that have a map location instead of a room.
+*
+* @param int ycoord The y-coordinate on the map.
+* @return int A TILESET_x season.
+*/
+int pick_season_by_y(int ycoord) {
 	double arctic = config_get_double("arctic_percent") / 200.0;	// split in half and convert from XX.XX to .XXXX (percent)
 	double tropics = config_get_double("tropics_percent") / 200.0;
 	bool northern = (ycoord >= MAP_HEIGHT/2);
@@ -381,7 +443,7 @@ bool can_see_player_in_other_room(char_data *ch, char_data *vict) {
 
 
 bool show_pc_in_room(char_data *ch, room_data *room, struct mappc_data_container *mappc) {
-	struct mappc_data *pc, *pc_iter, *start_this_room = NULL;
+	struct mappc_data *pc, *start_this_room = NULL;
 	char lbuf[60];
 	char_data *c;
 	empire_data *emp;
@@ -400,17 +462,14 @@ bool show_pc_in_room(char_data *ch, room_data *room, struct mappc_data_container
 			pc->character = c;
 			pc->next = NULL;
 	
-			if (mappc->data) {
-				// append to end
-				pc_iter = mappc->data;
-				while (pc_iter->next) {
-					pc_iter = pc_iter->next;
-				}
-				pc_iter->next = pc;
+			// append to end
+			if (mappc->last) {
+				mappc->last->next = pc;
 			}
 			else {
 				mappc->data = pc;
 			}
+			mappc->last = pc;
 	
 			if (!start_this_room) {
 				start_this_room = pc;
@@ -511,7 +570,10 @@ void look_at_room_by_loc(char_data *ch, room_data *room, bitvector_t options) {
 	bool y_first, invert_x, invert_y, comma;
 	struct instance_data *inst;
 	player_index_data *index;
-	room_data *to_room;
+	struct map_view_data view;
+	struct map_tile_data tile;
+	room_data *map_loc;
+	room_vnum origin;
 	empire_data *emp, *pcemp;
 	crop_data *cp;
 	char *strptr;
@@ -618,6 +680,13 @@ void look_at_room_by_loc(char_data *ch, room_data *room, bitvector_t options) {
 			magnitude = PRF_FLAGGED(ch, PRF_BRIEF) ? 3 : mapsize;
 			*buf = '\0';
 			
+			// tiles are read from the world map; only rooms that are already loaded are used
+			map_loc = get_map_location_for(room);
+			origin = map_loc ? GET_ROOM_VNUM(map_loc) : NOWHERE;
+			init_map_view(ch, &view);
+			++map_views_drawn;
+			map_view_rooms_loaded -= map_rooms_loaded;
+			
 			if (show_title) {
 				// spacing to center the title
 				s = ((4 * (magnitude * 2 + 1)) + 2 - (strlen(output)-4))/2;
@@ -722,32 +791,32 @@ void look_at_room_by_loc(char_data *ch, room_data *room, bitvector_t options) {
 					xx = (y_first ? second_iter : first_iter) * (invert_x ? -1 : 1);
 					yy = (y_first ? first_iter : second_iter) * (invert_y ? -1 : 1);
 				
-					to_room = real_shift(room, xx, yy);
-				
-					if (!to_room) {
+					if (!get_map_tile_shift(origin, xx, yy, &tile)) {
 						// nothing to show?
 						send_to_char("    ", ch);
 					}
-					else if (to_room != room && ROOM_AFF_FLAGGED(to_room, ROOM_AFF_DARK)) {
+					else if (TILE_ROOM(&tile) != room && TILE_AFF_FLAGGED(&tile, ROOM_AFF_DARK)) {
 						// magic dark
 						send_to_char("    ", ch);
 					}
-					else if (to_room != room && !CAN_SEE_IN_DARK_ROOM(ch, to_room) && compute_distance(room, to_room) > distance_can_see(ch) && !adjacent_room_is_light(to_room)) {
+					else if (TILE_ROOM(&tile) != room && !can_see_in_dark_tile(ch, &tile) && compute_map_distance(check_x, check_y, MAP_X_COORD(TILE_VNUM(&tile)), MAP_Y_COORD(TILE_VNUM(&tile))) > distance_can_see(ch) && (TILE_SECT_FLAGGED(&tile, SECTF_ADVENTURE) || !any_adjacent_tile_is_light(TILE_VNUM(&tile)))) {
 						// normal dark
 						if (!PRF_FLAGGED(ch, PRF_NOMAPCOL)) {
-							show_map_to_char(ch, mappc, to_room, options | LRR_SHOW_DARK);
+							show_map_to_char(ch, mappc, &view, &tile, options | LRR_SHOW_DARK);
 						}
 						else {
 							send_to_char("    ", ch);
 						}
 					}
 					else {
-						show_map_to_char(ch, mappc, to_room, options);
+						show_map_to_char(ch, mappc, &view, &tile, options);
 					}
 				}
 			
 				msg_to_char(ch, "&0|\r\n");
 			}
+			
+			map_view_rooms_loaded += map_rooms_loaded;
 
 			// border
 			send_to_char("+", ch);
@@ -1154,85 +1223,293 @@ void look_in_direction(char_data *ch, int dir) {
 }
 
 /**
-* Shows one tile
+* Gets the map tile in a direction from another tile, for a viewer whose
+* north may be turned (see SHIFT_CHAR_DIR).
 *
-* @param char_data *ch the viewer
-* @param struct mappc_data_container *mappc Players visible on the map are stored in this, to be shown below the map
-* @param room_data *to_room The room the character is looking at.
-* @param bitvector_t options Will recolor the tile if TRUE
+* @param int north The viewer's north, from get_north_for_char().
+* @param struct map_tile_data *from The tile to shift from.
+* @param int dir Which direction, as the viewer sees it.
+* @param struct map_tile_data *tile The view to fill in.
+* @return struct map_tile_data* The tile, or NULL if it's off the map.
+*/
+static struct map_tile_data *shift_tile_for_north(int north, struct map_tile_data *from, int dir, struct map_tile_data *tile) {
+	int real_dir = confused_dirs[north][0][dir];
+	
+	return get_map_tile_shift(TILE_VNUM(from), shift_dir[real_dir][0], shift_dir[real_dir][1], tile) ? tile : NULL;
+}
+
+
+/**
+* Like find_city(), for a map tile with no room loaded.
+*
+* @param empire_data *emp The empire to check.
+* @param struct map_tile_data *tile The map tile.
+* @return bool TRUE if the tile is inside one of emp's cities.
+*/
+static bool tile_is_in_city(empire_data *emp, struct map_tile_data *tile) {
+	struct city_coverage_data *cov;
+	int x, y;
+	
+	if (!emp) {
+		return FALSE;
+	}
+	
+	x = MAP_X_COORD(TILE_VNUM(tile));
+	y = MAP_Y_COORD(TILE_VNUM(tile));
+	
+	for (cov = get_city_coverage(emp, x, y); cov; cov = cov->next) {
+		if (compute_map_distance(x, y, cov->x, cov->y) <= cov->radius) {
+			return TRUE;
+		}
+	}
+	
+	return FALSE;
+}
+
+
+/**
+* Fills in the variable tile codes (@) in a map icon.
+*
+* @param char *buf The icon, which is changed in place (MAP_ICON_LENGTH).
+* @param struct map_tile_data *tile The tile it's for.
+* @param int north The viewer's north, from get_north_for_char().
+* @param int tileset Which TILESET_x to use.
+* @return bool TRUE if it had barrier codes, which depend on the neighbors' affects; otherwise FALSE.
+*/
+static bool replace_map_icon_codes(char *buf, struct map_tile_data *tile, int north, int tileset) {
+	struct map_tile_data adjacent[2], *r_east, *r_west;
+	sector_data *st, *base_sect = TILE_BASE_SECT(tile);
+	char buf1[MAP_ICON_LENGTH];
+	bool enchanted, barrier = FALSE;
+	struct icon_data *icon;
+	char *str;
+	
+	if (!strchr(buf, '@')) {
+		return FALSE;
+	}
+	
+	r_east = shift_tile_for_north(north, tile, EAST, &adjacent[0]);
+	r_west = shift_tile_for_north(north, tile, WEST, &adjacent[1]);
+	
+	// NOTE: If you add new @ codes here, you must update "const char *icon_codes" in utils.c
+	
+	// here (@.) roadside icon
+	if (strstr(buf, "@.")) {
+		icon = get_icon_from_set(GET_SECT_ICONS(base_sect), tileset);
+		sprintf(buf1, "%s%c", icon->color, GET_SECT_ROADSIDE_ICON(base_sect));
+		str = str_replace("@.", buf1, buf);
+		strcpy(buf, str);
+		free(str);
+	}
+	// east (@e) tile attachment
+	if (strstr(buf, "@e")) {
+		st = r_east ? TILE_BASE_SECT(r_east) : base_sect;
+		icon = get_icon_from_set(GET_SECT_ICONS(st), tileset);
+		sprintf(buf1, "%s%c", icon->color, GET_SECT_ROADSIDE_ICON(st));
+		str = str_replace("@e", buf1, buf);
+		strcpy(buf, str);
+		free(str);
+	}
+	// west (@w) tile attachment
+	if (strstr(buf, "@w")) {
+		st = r_west ? TILE_BASE_SECT(r_west) : base_sect;
+		icon = get_icon_from_set(GET_SECT_ICONS(st), tileset);
+		sprintf(buf1, "%s%c", icon->color, GET_SECT_ROADSIDE_ICON(st));
+		str = str_replace("@w", buf1, buf);
+		strcpy(buf, str);
+		free(str);
+	}
+	
+	// west (@u) barrier attachment
+	if (strstr(buf, "@u") || strstr(buf, "@U")) {
+		barrier = TRUE;
+		if (!r_west || ((IS_BARRIER(r_west) || TILE_IS_CLOSED(r_west)) && !TILE_AFF_FLAGGED(r_west, ROOM_AFF_CHAMELEON))) {
+			enchanted = (r_west && TILE_AFF_FLAGGED(r_west, ROOM_AFF_NO_FLY)) || TILE_AFF_FLAGGED(tile, ROOM_AFF_NO_FLY);
+			// west is a barrier
+			sprintf(buf1, "%sv", enchanted ? "&m" : "&0");
+			str = str_replace("@u", buf1, buf);
+			strcpy(buf, str);
+			free(str);
+			sprintf(buf1, "%sV", enchanted ? "&m" : "&0");
+			str = str_replace("@U", buf1, buf);
+			strcpy(buf, str);
+			free(str);
+		}
+		else {
+			// west is not a barrier
+			sprintf(buf1, "&?%c", GET_SECT_ROADSIDE_ICON(base_sect));
+			str = str_replace("@u", buf1, buf);
+			strcpy(buf, str);
+			free(str);
+			str = str_replace("@U", buf1, buf);
+			strcpy(buf, str);
+			free(str);
+		}
+	}
+	
+	//  east (@v) barrier attachment
+	if (strstr(buf, "@v") || strstr(buf, "@V")) {
+		barrier = TRUE;
+		if (!r_east || ((IS_BARRIER(r_east) || TILE_IS_CLOSED(r_east)) && !TILE_AFF_FLAGGED(r_east, ROOM_AFF_CHAMELEON))) {
+			enchanted = (r_east && TILE_AFF_FLAGGED(r_east, ROOM_AFF_NO_FLY)) || TILE_AFF_FLAGGED(tile, ROOM_AFF_NO_FLY);
+			// east is a barrier
+			sprintf(buf1, "%sv", enchanted ? "&m" : "&0");
+			str = str_replace("@v", buf1, buf);
+			strcpy(buf, str);
+			free(str);
+			sprintf(buf1, "%sV", enchanted ? "&m" : "&0");
+			str = str_replace("@V", buf1, buf);
+			strcpy(buf, str);
+			free(str);
+		}
+		else {
+			// east is not a barrier
+			sprintf(buf1, "&?%c", GET_SECT_ROADSIDE_ICON(base_sect));
+			str = str_replace("@v", buf1, buf);
+			strcpy(buf, str);
+			free(str);
+			str = str_replace("@V", buf1, buf);
+			strcpy(buf, str);
+			free(str);
+		}
+	}
+	
+	return barrier;
+}
+
+
+ //////////////////////////////////////////////////////////////////////////////
+//// MAP ICON CACHE //////////////////////////////////////////////////////////
+
+// The part of each map tile's icon that doesn't depend on who is looking
+// (custom icon, road, building, crop, or sector, with its @ codes filled in)
+// is cached by tile. A look only adds players, vehicles, hidden buildings,
+// and color modes. Anything that changes how a tile looks must call
+// invalidate_map_icon(); season changes are caught by the tileset check.
+
+#define MAP_ICON_CACHE_MAX  100000	// the whole cache is cleared if it reaches this many tiles
+
+struct map_icon_cache_data {
+	room_vnum vnum;	// which tile (hash key)
+	int tileset;	// TILESET_x it was drawn for
+	int north;	// the viewer's north it was drawn for (roads depend on it)
+	char icon[MAP_ICON_LENGTH];	// color and icon with @ codes filled in; &? and &# are left for the look
+	char color[MAP_ICON_LENGTH];	// base color, for &?
+	char colored[MAP_ICON_LENGTH];	// icon with &? already replaced, for normal color
+	
+	UT_hash_handle hh;	// map_icon_cache hash handle
+};
+
+struct map_icon_cache_data *map_icon_cache = NULL;	// hash table by vnum
+bool map_icon_cache_enabled = TRUE;	// turned off by 'util lookbench' for comparison
+int map_icon_cache_hits = 0;	// for 'show stats'
+int map_icon_cache_misses = 0;	// for 'show stats'
+
+
+/**
+* Empties the map icon cache, e.g. when a sector, crop, or building's icons
+* are edited.
+*/
+void clear_map_icon_cache(void) {
+	struct map_icon_cache_data *mic, *next_mic;
+	
+	HASH_ITER(hh, map_icon_cache, mic, next_mic) {
+		HASH_DEL(map_icon_cache, mic);
+		free(mic);
+	}
+}
+
+
+/**
+* @return int How many map tiles currently have a cached icon.
+*/
+int count_map_icon_cache(void) {
+	return HASH_COUNT(map_icon_cache);
+}
+
+
+/**
+* Call this when anything changes how a map tile looks. It also clears the 8
+* tiles around it, because roads and tile attachments depend on neighbors.
+* Vnums that aren't on the map are ignored, so it's safe to pass any room.
+*
+* @param room_vnum vnum The map tile that changed.
+*/
+void invalidate_map_icon(room_vnum vnum) {
+	struct map_icon_cache_data *mic;
+	int x, y, x_shift, y_shift;
+	room_vnum loc;
+	
+	if (vnum < 0 || vnum >= MAP_SIZE || !map_icon_cache) {
+		return;
+	}
+	
+	for (x_shift = -1; x_shift <= 1; ++x_shift) {
+		for (y_shift = -1; y_shift <= 1; ++y_shift) {
+			if (get_coord_shift(MAP_X_COORD(vnum), MAP_Y_COORD(vnum), x_shift, y_shift, &x, &y)) {
+				loc = MAP_TILE(x, y);
+				HASH_FIND_INT(map_icon_cache, &loc, mic);
+				if (mic) {
+					HASH_DEL(map_icon_cache, mic);
+					free(mic);
+				}
+			}
+		}
+	}
+}
+
+
+/**
+* Draws the part of a map tile's icon that doesn't depend on the viewer.
+*
+* @param struct map_tile_data *tile The tile to draw.
+* @param int tileset Which TILESET_x to use.
+* @param int north The viewer's north, from get_north_for_char().
+* @param struct map_icon_cache_data *mic Where to put the icon and color.
+* @return bool TRUE if the icon can be cached; FALSE if it depends on things the cache doesn't track.
 */
-static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc, room_data *to_room, bitvector_t options) {
+static bool build_map_icon(struct map_tile_data *tile, int tileset, int north, struct map_icon_cache_data *mic) {
 	extern const char *closed_ruins_icons[NUM_RUINS_ICONS];
 	extern const char *open_ruins_icons[NUM_RUINS_ICONS];
-	extern int get_north_for_char(char_data *ch);
-	extern int get_direction_for_char(char_data *ch, int dir);
 	extern struct city_metadata_type city_type[];
 	
-	bool need_color_terminator = FALSE;
-	char buf[30], buf1[30], lbuf[MAX_STRING_LENGTH];
+	char buf[MAP_ICON_LENGTH], lbuf[MAX_STRING_LENGTH];
 	struct empire_city_data *city;
-	int iter;
-	empire_data *emp, *chemp = GET_LOYALTY(ch);
-	int tileset = pick_season(to_room);
+	empire_data *emp;
 	struct icon_data *base_icon, *icon, *crop_icon = NULL;
-	bool junk, enchanted, hidden = FALSE;
-	crop_data *cp = ROOM_CROP(to_room);
-	sector_data *st, *base_sect = BASE_SECT(to_room);
-	char *base_color, *str;
-	room_data *map_loc = get_map_location_for(IN_ROOM(ch)), *map_to_room = get_map_location_for(to_room);
-	vehicle_data *show_veh;
+	crop_data *cp = TILE_CROP(tile);
+	sector_data *base_sect = TILE_BASE_SECT(tile);
+	room_data *to_room = TILE_ROOM(tile);	// may be NULL
+	bool barrier;
+	char *base_color;
 	
-	// options
-	bool show_dark = IS_SET(options, LRR_SHOW_DARK) ? TRUE : FALSE;
-	// bool ship_partial = IS_SET(options, LRR_SHIP_PARTIAL) ? TRUE : FALSE;
-		
-	// adjacent rooms, shifted by map change
+	// adjacent tiles, shifted by map change
 	// WARNING: You must make sure these are not NULL when you try to use them
-	room_data *r_north = SHIFT_CHAR_DIR(ch, to_room, NORTH);
-	room_data *r_east = SHIFT_CHAR_DIR(ch, to_room, EAST);
-	room_data *r_south = SHIFT_CHAR_DIR(ch, to_room, SOUTH);
-	room_data *r_west = SHIFT_CHAR_DIR(ch, to_room, WEST);
-	room_data *r_northwest = SHIFT_CHAR_DIR(ch, to_room, NORTHWEST);
-	room_data *r_northeast = SHIFT_CHAR_DIR(ch, to_room, NORTHEAST);
-	room_data *r_southwest = SHIFT_CHAR_DIR(ch, to_room, SOUTHWEST);
-	room_data *r_southeast = SHIFT_CHAR_DIR(ch, to_room, SOUTHEAST);
+	struct map_tile_data adjacent[NUM_2D_DIRS];
+	struct map_tile_data *r_north = shift_tile_for_north(north, tile, NORTH, &adjacent[NORTH]);
+	struct map_tile_data *r_east = shift_tile_for_north(north, tile, EAST, &adjacent[EAST]);
+	struct map_tile_data *r_south = shift_tile_for_north(north, tile, SOUTH, &adjacent[SOUTH]);
+	struct map_tile_data *r_west = shift_tile_for_north(north, tile, WEST, &adjacent[WEST]);
+	struct map_tile_data *r_northwest = shift_tile_for_north(north, tile, NORTHWEST, &adjacent[NORTHWEST]);
+	struct map_tile_data *r_northeast = shift_tile_for_north(north, tile, NORTHEAST, &adjacent[NORTHEAST]);
+	struct map_tile_data *r_southwest = shift_tile_for_north(north, tile, SOUTHWEST, &adjacent[SOUTHWEST]);
+	struct map_tile_data *r_southeast = shift_tile_for_north(north, tile, SOUTHEAST, &adjacent[SOUTHEAST]);
 	
-	#define distance(x, y, a, b)		((x - a) * (x - a) + (y - b) * (y - b))
-
 	// detect base icon
 	base_icon = get_icon_from_set(GET_SECT_ICONS(base_sect), tileset);
 	base_color = base_icon->color;
-	if (ROOM_SECT_FLAGGED(to_room, SECTF_CROP) && cp) {
+	if (TILE_SECT_FLAGGED(tile, SECTF_CROP) && cp) {
 		crop_icon = get_icon_from_set(GET_CROP_ICONS(cp), tileset);
 		base_color = crop_icon->color;
 	}
 
 	// start with the sector color
 	strcpy(buf, base_color);
-
-	if (to_room == IN_ROOM(ch) && !ROOM_IS_CLOSED(IN_ROOM(ch))) {
-		sprintf(buf, "&0<%soo&0>", chemp ? EMPIRE_BANNER(chemp) : "");
-	}
-	else if (!show_dark && !PRF_FLAGGED(ch, PRF_INFORMATIVE | PRF_POLITICAL) && show_pc_in_room(ch, to_room, mappc)) {
-		return;
-	}
 	
-	// check for a vehicle with an icon
-	else if ((show_veh = find_vehicle_to_show(ch, to_room))) {
-		strcat(buf, NULLSAFE(VEH_ICON(show_veh)));
-	}
-
-	/* Hidden buildings */
-	else if (CHECK_CHAMELEON(map_loc, to_room)) {
-		strcat(buf, base_icon->icon);
-		hidden = TRUE;
-	}
-
-	/* Rooms with custom icons (take precedence over all but hidden rooms */
-	else if (ROOM_CUSTOM_ICON(to_room)) {
+	if (to_room && ROOM_CUSTOM_ICON(to_room)) {
 		strcat(buf, ROOM_CUSTOM_ICON(to_room));
 	}
-	else if (ANY_ROAD_TYPE(to_room)) {
+	else if (ANY_ROAD_TYPE(tile)) {
 		// check west for the first 2 parts of the tile
 		if (CONNECTS_TO_ROAD(r_west)) {
 			// road west
@@ -1293,7 +1570,7 @@ static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc,
 			sprintf(buf + strlen(buf), "&?%c", GET_SECT_ROADSIDE_ICON(base_sect));
 		}
 	}
-	else if (BUILDING_VNUM(to_room) == BUILDING_STEPS) {
+	else if (TILE_BUILDING_VNUM(tile) == BUILDING_STEPS) {
 		// check west for the first 2 parts of the tile
 		if (CONNECTS_TO_ROAD(r_west) || (CONNECTS_TO_ROAD(r_southwest) && !CONNECTS_TO_ROAD(r_south)) || (CONNECTS_TO_ROAD(r_northwest) && !CONNECTS_TO_ROAD(r_north))) {
 			// road west
@@ -1326,10 +1603,10 @@ static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc,
 			sprintf(buf + strlen(buf), "&?%c", GET_SECT_ROADSIDE_ICON(base_sect));
 		}
 	}
-	else if (ROOM_SECT_FLAGGED(to_room, SECTF_CROP) && cp) {
+	else if (TILE_SECT_FLAGGED(tile, SECTF_CROP) && cp) {
 		strcat(buf, crop_icon->icon);
 	}
-	else if (IS_CITY_CENTER(to_room)) {
+	else if (to_room && IS_CITY_CENTER(to_room)) {
 		emp = ROOM_OWNER(to_room);
 		if ((city = find_city(emp, to_room))) {
 			strcat(buf, city_type[city->type].icon);
@@ -1338,109 +1615,167 @@ static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc,
 			strcat(buf, "[  ]");
 		}
 	}
-	else if (BUILDING_VNUM(to_room) == BUILDING_RUINS_CLOSED) {
+	else if (TILE_BUILDING_VNUM(tile) == BUILDING_RUINS_CLOSED) {
 		// TODO could add variable icons system like sectors use, or a "custom ruins icon" to Building data
 		strcat(buf, closed_ruins_icons[get_room_extra_data(to_room, ROOM_EXTRA_RUINS_ICON)]);
 	}
-	else if (BUILDING_VNUM(to_room) == BUILDING_RUINS_OPEN) {
+	else if (TILE_BUILDING_VNUM(tile) == BUILDING_RUINS_OPEN) {
 		// TODO could add variable icons system like sectors use, or a "custom ruins icon" to Building data
 		strcat(buf, open_ruins_icons[get_room_extra_data(to_room, ROOM_EXTRA_RUINS_ICON)]);
 	}
-	else if (IS_MAP_BUILDING(to_room) && GET_BUILDING(to_room)) {
+	else if (to_room && IS_MAP_BUILDING(to_room) && GET_BUILDING(to_room)) {
 		strcat(buf, GET_BLD_ICON(GET_BUILDING(to_room)));
 	}
 	else {
-		icon = get_icon_from_set(GET_SECT_ICONS(SECT(to_room)), tileset);
+		icon = get_icon_from_set(GET_SECT_ICONS(TILE_SECT(tile)), tileset);
 		strcat(buf, icon->icon);
 	}
 	
-	// buf is now the completed icon, but has both color codes (&) and variable tile codes (@)
-	if (strchr(buf, '@')) {
-		// NOTE: If you add new @ codes here, you must update "const char *icon_codes" in utils.c
-		
-		// here (@.) roadside icon
-		if (strstr(buf, "@.")) {
-			icon = get_icon_from_set(GET_SECT_ICONS(base_sect), tileset);
-			sprintf(buf1, "%s%c", icon->color, GET_SECT_ROADSIDE_ICON(base_sect));
-			str = str_replace("@.", buf1, buf);
-			strcpy(buf, str);
-			free(str);
-		}
-		// east (@e) tile attachment
-		if (strstr(buf, "@e")) {
-			st = r_east ? BASE_SECT(r_east) : BASE_SECT(to_room);
-			icon = get_icon_from_set(GET_SECT_ICONS(st), tileset);
-			sprintf(buf1, "%s%c", icon->color, GET_SECT_ROADSIDE_ICON(st));
-			str = str_replace("@e", buf1, buf);
-			strcpy(buf, str);
-			free(str);
+	
+	barrier = replace_map_icon_codes(buf, tile, north, tileset);
+	
+	snprintf(mic->icon, sizeof(mic->icon), "%s", buf);
+	snprintf(mic->color, sizeof(mic->color), "%s", base_color);
+	if (strstr(buf, "&?")) {
+		replace_question_color(buf, base_color, lbuf);
+		snprintf(mic->colored, sizeof(mic->colored), "%.*s", (int) sizeof(mic->colored) - 1, lbuf);
+	}
+	else {
+		strcpy(mic->colored, buf);
+	}
+	
+	// barriers depend on their neighbors' affects, which don't invalidate the cache
+	return (!barrier && strlen(base_color) < sizeof(mic->color));
+}
+
+
+/**
+* Gets the viewer-independent part of a map tile's icon, from the cache if it
+* can.
+*
+* @param struct map_tile_data *tile The tile.
+* @param int tileset Which TILESET_x to use.
+* @param int north The viewer's north, from get_north_for_char().
+* @param struct map_icon_cache_data *temp Storage for an icon that can't be cached.
+* @return struct map_icon_cache_data* The icon: either a cache entry or temp.
+*/
+static struct map_icon_cache_data *get_map_icon(struct map_tile_data *tile, int tileset, int north, struct map_icon_cache_data *temp) {
+	struct map_icon_cache_data *mic = NULL;
+	room_vnum vnum = TILE_VNUM(tile);
+	
+	if (map_icon_cache_enabled) {
+		HASH_FIND_INT(map_icon_cache, &vnum, mic);
+		if (mic && mic->tileset == tileset && mic->north == north) {
+			++map_icon_cache_hits;
+			return mic;
 		}
-		// west (@w) tile attachment
-		if (strstr(buf, "@w")) {
-			st = r_west ? BASE_SECT(r_west) : BASE_SECT(to_room);
-			icon = get_icon_from_set(GET_SECT_ICONS(st), tileset);
-			sprintf(buf1, "%s%c", icon->color, GET_SECT_ROADSIDE_ICON(st));
-			str = str_replace("@w", buf1, buf);
-			strcpy(buf, str);
-			free(str);
+	}
+	
+	++map_icon_cache_misses;
+	if (!build_map_icon(tile, tileset, north, temp) || !map_icon_cache_enabled) {
+		if (mic) {
+			HASH_DEL(map_icon_cache, mic);
+			free(mic);
 		}
-		
-		// west (@u) barrier attachment
-		if (strstr(buf, "@u") || strstr(buf, "@U")) {
-			if (!r_west || ((IS_BARRIER(r_west) || ROOM_IS_CLOSED(r_west)) && !ROOM_AFF_FLAGGED(r_west, ROOM_AFF_CHAMELEON))) {
-				enchanted = (r_west && ROOM_AFF_FLAGGED(r_west, ROOM_AFF_NO_FLY)) || ROOM_AFF_FLAGGED(to_room, ROOM_AFF_NO_FLY);
-				// west is a barrier
-				sprintf(buf1, "%sv", enchanted ? "&m" : "&0");
-				str = str_replace("@u", buf1, buf);
-				strcpy(buf, str);
-				free(str);
-				sprintf(buf1, "%sV", enchanted ? "&m" : "&0");
-				str = str_replace("@U", buf1, buf);
-				strcpy(buf, str);
-				free(str);
-			}
-			else {
-				// west is not a barrier
-				sprintf(buf1, "&?%c", GET_SECT_ROADSIDE_ICON(base_sect));
-				str = str_replace("@u", buf1, buf);
-				strcpy(buf, str);
-				free(str);
-				str = str_replace("@U", buf1, buf);
-				strcpy(buf, str);
-				free(str);
-			}
+		return temp;
+	}
+	
+	if (!mic) {
+		if (HASH_COUNT(map_icon_cache) >= MAP_ICON_CACHE_MAX) {
+			clear_map_icon_cache();
 		}
-		
-		//  east (@v) barrier attachment
-		if (strstr(buf, "@v") || strstr(buf, "@V")) {
-			if (!r_east || ((IS_BARRIER(r_east) || ROOM_IS_CLOSED(r_east)) && !ROOM_AFF_FLAGGED(r_east, ROOM_AFF_CHAMELEON))) {
-				enchanted = (r_east && ROOM_AFF_FLAGGED(r_east, ROOM_AFF_NO_FLY)) || ROOM_AFF_FLAGGED(to_room, ROOM_AFF_NO_FLY);
-				// east is a barrier
-				sprintf(buf1, "%sv", enchanted ? "&m" : "&0");
-				str = str_replace("@v", buf1, buf);
-				strcpy(buf, str);
-				free(str);
-				sprintf(buf1, "%sV", enchanted ? "&m" : "&0");
-				str = str_replace("@V", buf1, buf);
-				strcpy(buf, str);
-				free(str);
-			}
-			else {
-				// east is not a barrier
-				sprintf(buf1, "&?%c", GET_SECT_ROADSIDE_ICON(base_sect));
-				str = str_replace("@v", buf1, buf);
-				strcpy(buf, str);
-				free(str);
-				str = str_replace("@V", buf1, buf);
-				strcpy(buf, str);
-				free(str);
-			}
+		CREATE(mic, struct map_icon_cache_data, 1);
+		mic->vnum = vnum;
+		HASH_ADD_INT(map_icon_cache, vnum, mic);
+	}
+	
+	mic->tileset = tileset;
+	mic->north = north;
+	strcpy(mic->icon, temp->icon);
+	strcpy(mic->color, temp->color);
+	strcpy(mic->colored, temp->colored);
+	return mic;
+}
+
+
+ //////////////////////////////////////////////////////////////////////////////
+//// MAP TILE DISPLAY ////////////////////////////////////////////////////////
+
+/**
+* Draws one tile for a viewer: the cached icon plus anything that depends on
+* who is looking.
+*
+* @param char_data *ch the viewer
+* @param struct mappc_data_container *mappc Players visible on the map are stored in this, to be shown below the map (NULL to skip players)
+* @param struct map_view_data *view Data for the whole view, from init_map_view().
+* @param struct map_tile_data *tile The map tile the character is looking at (it may not have a room).
+* @param bitvector_t options Will recolor the tile if TRUE
+* @param char *buf Where to draw the tile (MAP_ICON_LENGTH).
+* @return bool TRUE if buf should be shown; FALSE if the tile was already sent (players).
+*/
+static bool draw_map_tile(char_data *ch, struct mappc_data_container *mappc, struct map_view_data *view, struct map_tile_data *tile, bitvector_t options, char *buf) {
+	bool need_color_terminator = FALSE, cached = FALSE;
+	char buf1[MAP_ICON_LENGTH], lbuf[MAX_STRING_LENGTH];
+	struct map_icon_cache_data *mic, temp;
+	int iter, tileset, north = view->north;
+	empire_data *emp, *chemp = GET_LOYALTY(ch);
+	struct icon_data *base_icon;
+	bool junk, hidden = FALSE;
+	char *base_color, *str;
+	room_data *to_room = TILE_ROOM(tile);	// may be NULL: blank tiles have no building, owner, people, or affects
+	room_data *map_loc = view->map_loc;
+	vehicle_data *show_veh;
+	
+	// options
+	bool show_dark = IS_SET(options, LRR_SHOW_DARK) ? TRUE : FALSE;
+	// bool ship_partial = IS_SET(options, LRR_SHIP_PARTIAL) ? TRUE : FALSE;
+	
+	#define distance(x, y, a, b)		((x - a) * (x - a) + (y - b) * (y - b))
+	
+	// season: tiles in a row usually share a y-coord
+	if (MAP_Y_COORD(TILE_VNUM(tile)) != view->season_y) {
+		view->season_y = MAP_Y_COORD(TILE_VNUM(tile));
+		view->season = pick_season_by_y(view->season_y);
+	}
+	tileset = view->season;
+	
+	// the part that doesn't depend on the viewer
+	mic = get_map_icon(tile, tileset, north, &temp);
+	base_color = mic->color;
+	
+	if (to_room && to_room == IN_ROOM(ch) && !ROOM_IS_CLOSED(IN_ROOM(ch))) {
+		sprintf(buf, "&0<%soo&0>", chemp ? EMPIRE_BANNER(chemp) : "");
+	}
+	else if (mappc && to_room && !show_dark && !PRF_FLAGGED(ch, PRF_INFORMATIVE | PRF_POLITICAL) && show_pc_in_room(ch, to_room, mappc)) {
+		return FALSE;
+	}
+	
+	// check for a vehicle with an icon
+	else if (to_room && (show_veh = find_vehicle_to_show(ch, to_room))) {
+		sprintf(buf, "%s%s", base_color, NULLSAFE(VEH_ICON(show_veh)));
+		replace_map_icon_codes(buf, tile, north, tileset);
+	}
+
+	/* Hidden buildings */
+	else if (to_room && CHECK_CHAMELEON(map_loc, to_room)) {
+		base_icon = get_icon_from_set(GET_SECT_ICONS(TILE_BASE_SECT(tile)), tileset);
+		if (!TILE_SECT_FLAGGED(tile, SECTF_CROP) || !TILE_CROP(tile)) {
+			base_color = base_icon->color;
 		}
+		sprintf(buf, "%s%s", base_color, base_icon->icon);
+		replace_map_icon_codes(buf, tile, north, tileset);
+		hidden = TRUE;
+	}
+	
+	// everything else comes from the icon cache
+	else {
+		strcpy(buf, mic->icon);
+		cached = TRUE;
 	}
 
 	// buf now contains the tile with preliminary color codes including &?
 
-	if (BUILDING_BURNING(to_room)) {
+	if (to_room && BUILDING_BURNING(to_room)) {
 		strcpy(buf1, strip_color(buf));
 		sprintf(buf, "\t0\t[B300]%s", buf1);
 		need_color_terminator = TRUE;
@@ -1449,9 +1784,9 @@ static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc,
 		strcpy(buf1, strip_color(buf));
 
 		if (PRF_FLAGGED(ch, PRF_POLITICAL) && !show_dark) {
-			emp = ROOM_OWNER(to_room);
+			emp = to_room ? ROOM_OWNER(to_room) : NULL;
 			
-			if (chemp && (chemp == emp || find_city(chemp, to_room)) && is_in_city_for_empire(to_room, chemp, FALSE, &junk)) {
+			if (to_room ? (chemp && (chemp == emp || find_city(chemp, to_room)) && is_in_city_for_empire(to_room, chemp, FALSE, &junk)) : tile_is_in_city(chemp, tile)) {
 				strcpy(buf2, get_banner_complement_color(chemp));
 				need_color_terminator = TRUE;
 			}
@@ -1467,7 +1802,11 @@ static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc,
 			}
 		}
 		else if (PRF_FLAGGED(ch, PRF_INFORMATIVE) && !show_dark) {
-			if (IS_IMMORTAL(ch) && ROOM_AFF_FLAGGED(to_room, ROOM_AFF_CHAMELEON) && IS_COMPLETE(to_room) && distance(FLAT_X_COORD(map_loc), FLAT_Y_COORD(map_loc), FLAT_X_COORD(map_to_room), FLAT_Y_COORD(map_to_room)) > 2) {
+			if (!to_room) {
+				// blank tile: nothing to report
+				strcpy(buf2, "&0");
+			}
+			else if (IS_IMMORTAL(ch) && ROOM_AFF_FLAGGED(to_room, ROOM_AFF_CHAMELEON) && IS_COMPLETE(to_room) && distance(FLAT_X_COORD(map_loc), FLAT_Y_COORD(map_loc), MAP_X_COORD(TILE_VNUM(tile)), MAP_Y_COORD(TILE_VNUM(tile))) > 2) {
 				strcpy(buf2, "&y");
 			}
 			else if (IS_DISMANTLING(to_room)) {
@@ -1509,12 +1848,15 @@ static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc,
 	}
 	else {
 		// normal color
-		if (strstr(buf, "&?")) {
+		if (cached) {
+			strcpy(buf, mic->colored);
+		}
+		else if (strstr(buf, "&?")) {
 			replace_question_color(buf, base_color, lbuf);
 			strcpy(buf, lbuf);
 		}
 		if (strstr(buf, "&#")) {
-			str = str_replace("&#", ROOM_AFF_FLAGGED(to_room, ROOM_AFF_NO_FLY) ? "&m" : "&0", buf);
+			str = str_replace("&#", TILE_AFF_FLAGGED(tile, ROOM_AFF_NO_FLY) ? "&m" : "&0", buf);
 			strcpy(buf, str);
 			free(str);
 		}
@@ -1561,7 +1903,74 @@ static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc,
 		strcat(buf, "&0");
 	}
 	
-	send_to_char(buf, ch);
+	return TRUE;
+}
+
+
+/**
+* Sets up the data that's shared by every tile in ch's map view.
+*
+* @param char_data *ch The viewer.
+* @param struct map_view_data *view The data to fill in.
+*/
+static void init_map_view(char_data *ch, struct map_view_data *view) {
+	extern int get_north_for_char(char_data *ch);
+	
+	view->north = get_north_for_char(ch);
+	view->map_loc = get_map_location_for(IN_ROOM(ch));
+	view->season_y = -1;
+	view->season = TILESET_ANY;
+}
+
+
+/**
+* Shows one tile
+*
+* @param char_data *ch the viewer
+* @param struct mappc_data_container *mappc Players visible on the map are stored in this, to be shown below the map
+* @param struct map_view_data *view Data for the whole view, from init_map_view().
+* @param struct map_tile_data *tile The map tile the character is looking at (it may not have a room).
+* @param bitvector_t options Will recolor the tile if TRUE
+*/
+static void show_map_to_char(char_data *ch, struct mappc_data_container *mappc, struct map_view_data *view, struct map_tile_data *tile, bitvector_t options) {
+	char buf[MAP_ICON_LENGTH];
+	
+	if (draw_map_tile(ch, mappc, view, tile, options, buf)) {
+		send_to_char(buf, ch);
+	}
+}
+
+
+/**
+* Draws every tile in ch's map view without sending anything, for timing the
+* map renderer ('util lookbench'). Players on the map are skipped.
+*
+* @param char_data *ch The viewer.
+* @return int The number of tiles drawn.
+*/
+int draw_map_view_for_benchmark(char_data *ch) {
+	char buf[MAP_ICON_LENGTH];
+	struct map_view_data view;
+	struct map_tile_data tile;
+	room_data *map_loc;
+	int x_shift, y_shift, radius, count = 0;
+	
+	if (!(map_loc = get_map_location_for(IN_ROOM(ch))) || GET_ROOM_VNUM(map_loc) >= MAP_SIZE) {
+		return 0;
+	}
+	
+	init_map_view(ch, &view);
+	radius = get_map_radius(ch);
+	for (y_shift = radius; y_shift >= -radius; --y_shift) {
+		for (x_shift = -radius; x_shift <= radius; ++x_shift) {
+			if (get_map_tile_shift(GET_ROOM_VNUM(map_loc), x_shift, y_shift, &tile)) {
+				draw_map_tile(ch, NULL, &view, &tile, NOBITS, buf);
+				++count;
+			}
+		}
+	}
+	
+	return count;
 }
 
 
@@ -1794,6 +2203,7 @@ void perform_mortal_where(char_data *ch, char *arg) {
 	
 	int check_x, check_y, closest, dir, dist, max_distance;
 	struct instance_data *ch_inst, *i_inst;
+	struct near_char_iterator near;
 	descriptor_data *d;
 	char_data *i, *found = NULL;
 	
@@ -1808,8 +2218,8 @@ void perform_mortal_where(char_data *ch, char *arg) {
 
 	if (!*arg) {
 		send_to_char("Players near you\r\n--------------------\r\n", ch);
-		for (d = descriptor_list; d; d = d->next) {
-			if (STATE(d) != CON_PLAYING || !(i = d->character) || IS_NPC(i) || ch == i || !IN_ROOM(i))
+		for (i = first_char_near(&near, IN_ROOM(ch), max_distance, TRUE); i; i = next_char_near(&near)) {
+			if (!(d = i->desc) || STATE(d) != CON_PLAYING || ch == i)
 				continue;
 			if (!CAN_SEE(ch, i) || !CAN_RECOGNIZE(ch, i) || !WIZHIDE_OK(ch, i))
 				continue;
@@ -1861,7 +2271,7 @@ void perform_mortal_where(char_data *ch, char *arg) {
 	else {			/* print only FIRST char, not all. */
 		found = NULL;
 		closest = MAP_SIZE;
-		for (i = character_list; i; i = i->next) {
+		for (i = first_char_near(&near, IN_ROOM(ch), max_distance, FALSE); i; i = next_char_near(&near)) {
 			if (i == ch || !IN_ROOM(i) || !CAN_RECOGNIZE(ch, i) || !CAN_SEE(ch, i))
 				continue;
 			if (!multi_isname(arg, GET_PC_NAME(i)))
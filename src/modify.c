@@ -127,6 +127,7 @@ void start_string_editor(descriptor_data *d, char *prompt, char **writeto, size_
 	d->mail_to = 0;
 	d->notes_id = 0;
 	d->save_empire = NOTHING;
+	d->save_room = NOWHERE;
 	d->file_storage = NULL;
 	d->allow_null = allow_null;
 	
@@ -239,6 +240,11 @@ void string_add(descriptor_data *d, char *str) {
 	}
 
 	if (action) {
+		// room text (e.g. custom descriptions) only reaches disk with its world block
+		if (d->save_room != NOWHERE && action == STRINGADD_SAVE) {
+			request_world_save(d->save_room);
+		}
+		
 		if (STATE(d) == CON_PLAYING && PLR_FLAGGED(d->character, PLR_MAILING)) {
 			if (action == STRINGADD_SAVE && *d->str) {
 				if ((index = find_player_index_by_idnum(d->mail_to)) && (recip = find_or_load_player(index->name, &is_file))) {
@@ -339,6 +345,7 @@ void string_add(descriptor_data *d, char *str) {
 		d->notes_id = 0;
 		d->max_str = 0;
 		d->save_empire = NOTHING;
+		d->save_room = NOWHERE;
 		if (d->file_storage) {
 			free(d->file_storage);
 		}
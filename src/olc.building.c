@@ -616,6 +616,10 @@ void save_olc_building(descriptor_data *desc) {
 	proto->hh = hh;	// restore hash handle
 	proto->quest_lookups = ql;	// restore lookups
 	
+	// icons and flags may have changed
+	clear_map_icon_cache();
+	reset_territory_indexes(NULL);	// functions may have changed
+	
 	// and save to file
 	save_library_file_for_vnum(DB_BOOT_BLD, vnum);
 }
@@ -194,7 +194,7 @@ void olc_delete_crop(char_data *ch, crop_vnum vnum) {
 	
 	obj_data *obj, *next_obj;
 	descriptor_data *desc;
-	struct map_data *map;
+	room_vnum map;
 	room_data *room;
 	crop_data *crop;
 	sector_data *base = NULL;
@@ -222,12 +222,12 @@ void olc_delete_crop(char_data *ch, crop_vnum vnum) {
 	
 	// update world
 	count = 0;
-	LL_FOREACH(land_map, map) {
-		room = real_real_room(map->vnum);
+	for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
+		room = real_real_room(map);
 		
-		if (map->crop_type == crop || (room && ROOM_CROP(room) == crop)) {
+		if (MAP_CROP(map) == crop || (room && ROOM_CROP(room) == crop)) {
 			if (!room) {
-				room = real_room(map->vnum);
+				room = real_room(map);
 			}
 			set_crop_type(room, NULL);	// remove it explicitly
 			change_terrain(room, GET_SECT_VNUM(base));
@@ -314,6 +314,7 @@ void save_olc_crop(descriptor_data *desc) {
 	struct interaction_item *interact;
 	struct spawn_info *spawn;
 	UT_hash_handle hh;
+	ush_int map_idx;
 
 	// have a place to save it?
 	if (!(proto = crop_proto(vnum))) {
@@ -353,9 +354,14 @@ void save_olc_crop(descriptor_data *desc) {
 
 	// save data back over the proto-type
 	hh = proto->hh;	// save old hash handle
+	map_idx = proto->map_idx;	// and world_map index
 	*proto = *cp;	// copy over all data
 	proto->vnum = vnum;	// ensure correct vnum
 	proto->hh = hh;	// restore old hash handle
+	proto->map_idx = map_idx;	// restore world_map index
+	
+	// icons may have changed
+	clear_map_icon_cache();
 		
 	// and save to file
 	save_library_file_for_vnum(DB_BOOT_CROP, vnum);
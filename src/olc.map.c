@@ -159,6 +159,7 @@ OLC_MODULE(mapedit_terrain) {
 		// delete city center?
 		if (IS_CITY_CENTER(IN_ROOM(ch)) && emp && (city = find_city_entry(emp, IN_ROOM(ch)))) {
 			REMOVE_FROM_LIST(city, EMPIRE_CITY_LIST(emp), next);
+			reset_city_coverage(emp);
 			if (city->name) {
 				free(city->name);
 			}
@@ -248,12 +249,12 @@ OLC_MODULE(mapedit_unclaimable) {
 			if (to) {
 				if (set) {
 					SET_BIT(ROOM_AFF_FLAGS(to), ROOM_AFF_UNCLAIMABLE);
-					SET_BIT(ROOM_BASE_FLAGS(to), ROOM_AFF_UNCLAIMABLE);
+					set_room_base_flags(to, ROOM_AFF_UNCLAIMABLE);
 					abandon_room(to);
 				}
 				else {
 					REMOVE_BIT(ROOM_AFF_FLAGS(to), ROOM_AFF_UNCLAIMABLE);
-					REMOVE_BIT(ROOM_BASE_FLAGS(to), ROOM_AFF_UNCLAIMABLE);
+					remove_room_base_flags(to, ROOM_AFF_UNCLAIMABLE);
 				}
 			}
 		}
@@ -295,6 +296,7 @@ OLC_MODULE(mapedit_room_name) {
 		if (ROOM_CUSTOM_NAME(IN_ROOM(ch))) {
 			free(ROOM_CUSTOM_NAME(IN_ROOM(ch)));
 			ROOM_CUSTOM_NAME(IN_ROOM(ch)) = NULL;
+			request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 		}
 		msg_to_char(ch, "This room/tile no longer has a specialized name.\r\n");
 	}
@@ -303,6 +305,7 @@ OLC_MODULE(mapedit_room_name) {
 			free(ROOM_CUSTOM_NAME(IN_ROOM(ch)));
 		}
 		ROOM_CUSTOM_NAME(IN_ROOM(ch)) = str_dup(argument);
+		request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 		msg_to_char(ch, "This room/tile is now called \"%s\".\r\n", argument);
 	}
 }
@@ -319,6 +322,8 @@ OLC_MODULE(mapedit_icon) {
 		if (ROOM_CUSTOM_ICON(IN_ROOM(ch))) {
 			free(ROOM_CUSTOM_ICON(IN_ROOM(ch)));
 			ROOM_CUSTOM_ICON(IN_ROOM(ch)) = NULL;
+			invalidate_map_icon(GET_ROOM_VNUM(IN_ROOM(ch)));
+			request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 			}
 		msg_to_char(ch, "This area no longer has a specialized icon.\r\n");
 		}
@@ -333,6 +338,8 @@ OLC_MODULE(mapedit_icon) {
 			free(ROOM_CUSTOM_ICON(IN_ROOM(ch)));
 		}
 		ROOM_CUSTOM_ICON(IN_ROOM(ch)) = str_dup(argument);
+		invalidate_map_icon(GET_ROOM_VNUM(IN_ROOM(ch)));
+		request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 		msg_to_char(ch, "This area now has the icon \"%s&0\".\r\n", argument);
 	}
 }
@@ -377,6 +384,7 @@ OLC_MODULE(mapedit_room_description) {
 		if (ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch))) {
 			free(ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch)));
 			ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch)) = NULL;
+			request_world_save(GET_ROOM_VNUM(IN_ROOM(ch)));
 			}
 		msg_to_char(ch, "This area no longer has a specialized description.\r\n");
 	}
@@ -386,6 +394,7 @@ OLC_MODULE(mapedit_room_description) {
 		}
 		else {
 			start_string_editor(ch->desc, "room description", &(ROOM_CUSTOM_DESCRIPTION(IN_ROOM(ch))), MAX_ROOM_DESCRIPTION, TRUE);
+			ch->desc->save_room = GET_ROOM_VNUM(IN_ROOM(ch));
 		}
 	}
 	else
@@ -499,7 +508,7 @@ OLC_MODULE(mapedit_naturalize) {
 	bool island = FALSE, world = FALSE;
 	int count, island_id = NO_ISLAND;
 	struct island_info *isle;
-	struct map_data *map;
+	room_vnum map;
 	room_data *room;
 	
 	bool do_unclaim = config_get_bool("naturalize_unclaimable");
@@ -527,10 +536,10 @@ OLC_MODULE(mapedit_naturalize) {
 		count = 0;
 		
 		// check all land tiles
-		LL_FOREACH(land_map, map) {
-			room = real_real_room(map->vnum);	// may or may not exist
+		for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
+			room = real_real_room(map);	// may or may not exist
 			
-			if (island && map->island != island_id) {
+			if (island && MAP_ISLAND(map) != island_id) {
 				continue;
 			}
 			if (room && ROOM_OWNER(room)) {
@@ -542,13 +551,13 @@ OLC_MODULE(mapedit_naturalize) {
 			if (room && ROOM_AFF_FLAGGED(room, ROOM_AFF_UNCLAIMABLE) && !do_unclaim) {
 				continue;
 			}
-			if (map->sector_type == map->natural_sector) {
+			if (MAP_SECT(map) == MAP_NATURAL_SECT(map)) {
 				continue;	// already same
 			}
 			
 			// looks good: naturalize it
 			if (room) {
-				change_terrain(room, GET_SECT_VNUM(map->natural_sector));
+				change_terrain(room, GET_SECT_VNUM(MAP_NATURAL_SECT(map)));
 				if (ROOM_PEOPLE(room)) {
 					act("The area is naturalized!", FALSE, ROOM_PEOPLE(room), NULL, NULL, TO_CHAR | TO_ROOM);
 				}
@@ -557,15 +566,15 @@ OLC_MODULE(mapedit_naturalize) {
 				}
 			}
 			else {
-				perform_change_sect(NULL, map, map->natural_sector);
-				perform_change_base_sect(NULL, map, map->natural_sector);
+				perform_change_sect(NULL, map, MAP_NATURAL_SECT(map));
+				perform_change_base_sect(NULL, map, MAP_NATURAL_SECT(map));
 				
-				if (SECT_FLAGGED(map->natural_sector, SECTF_HAS_CROP_DATA)) {
-					room = real_room(map->vnum);	// need it loaded after all
+				if (SECT_FLAGGED(MAP_NATURAL_SECT(map), SECTF_HAS_CROP_DATA)) {
+					room = real_room(map);	// need it loaded after all
 					set_crop_type(room, get_potential_crop_for_location(room));
 				}
 				else {
-					map->crop_type = NULL;
+					SET_MAP_CROP(map, NULL);
 				}
 			}
 			++count;
@@ -585,8 +594,8 @@ OLC_MODULE(mapedit_naturalize) {
 		msg_to_char(ch, "You have naturalized the sectors for %d tile%s%s.\r\n", count, PLURAL(count), island ? " on this island" : "");
 	}
 	else {	// normal processing for 1 room
-		map = &(world_map[FLAT_X_COORD(IN_ROOM(ch))][FLAT_Y_COORD(IN_ROOM(ch))]);
-		change_terrain(IN_ROOM(ch), GET_SECT_VNUM(map->natural_sector));
+		map = GET_ROOM_VNUM(IN_ROOM(ch));
+		change_terrain(IN_ROOM(ch), GET_SECT_VNUM(MAP_NATURAL_SECT(map)));
 		if (ROOM_OWNER(IN_ROOM(ch))) {
 			deactivate_workforce_room(ROOM_OWNER(IN_ROOM(ch)), IN_ROOM(ch));
 		}
@@ -623,7 +632,7 @@ OLC_MODULE(mapedit_populate) {
 OLC_MODULE(mapedit_remember) {
 	int count, island_id = NO_ISLAND;
 	struct island_info *isle;
-	struct map_data *map;
+	room_vnum map;
 	bool island = FALSE;
 	
 	// parse argument
@@ -649,19 +658,19 @@ OLC_MODULE(mapedit_remember) {
 		count = 0;
 		
 		// check all land tiles
-		LL_FOREACH(land_map, map) {
-			if (map->island != island_id) {
+		for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
+			if (MAP_ISLAND(map) != island_id) {
 				continue;
 			}
-			if (SECT_FLAGGED(map->sector_type, SECTF_MAP_BUILDING | SECTF_INSIDE | SECTF_ADVENTURE)) {
+			if (SECT_FLAGGED(MAP_SECT(map), SECTF_MAP_BUILDING | SECTF_INSIDE | SECTF_ADVENTURE)) {
 				continue;
 			}
-			if (map->natural_sector == map->sector_type) {
+			if (MAP_NATURAL_SECT(map) == MAP_SECT(map)) {
 				continue;	// already same
 			}
 			
 			// looks good
-			map->natural_sector = map->sector_type;
+			SET_MAP_NATURAL_SECT(map, MAP_SECT(map));
 			++count;
 		}
 		
@@ -673,8 +682,8 @@ OLC_MODULE(mapedit_remember) {
 		msg_to_char(ch, "You have set the map to remember sectors for %d tile%s on this island.\r\n", count, PLURAL(count));
 	}
 	else {	// normal processing for 1 room
-		map = &(world_map[FLAT_X_COORD(IN_ROOM(ch))][FLAT_Y_COORD(IN_ROOM(ch))]);
-		map->natural_sector = map->sector_type;
+		map = GET_ROOM_VNUM(IN_ROOM(ch));
+		SET_MAP_NATURAL_SECT(map, MAP_SECT(map));
 		
 		syslog(SYS_OLC, GET_INVIS_LEV(ch), TRUE, "OLC: %s has set 'remember' for %s", GET_NAME(ch), room_log_identifier(IN_ROOM(ch)));
 		msg_to_char(ch, "You have set the map to remember the sector for this tile.\r\n");
@@ -569,6 +569,8 @@ void save_olc_room_template(descriptor_data *desc) {
 	proto->hh = hh;	// restore old hash handle
 	proto->quest_lookups = ql;	// restore lookups
 	
+	reset_territory_indexes(NULL);	// functions may have changed
+	
 	// and save to file
 	save_library_file_for_vnum(DB_BOOT_RMT, vnum);
 }
@@ -142,7 +142,7 @@ void olc_delete_sector(char_data *ch, sector_vnum vnum) {
 	social_data *soc, *next_soc;
 	descriptor_data *desc;
 	adv_data *adv, *next_adv;
-	struct map_data *map;
+	room_vnum map;
 	room_data *room;
 	int count, x, y;
 	bool found;
@@ -178,18 +178,18 @@ void olc_delete_sector(char_data *ch, sector_vnum vnum) {
 	count = 0;
 	for (x = 0; x < MAP_WIDTH; ++x) {
 		for (y = 0; y < MAP_HEIGHT; ++y) {
-			map = &(world_map[x][y]);
+			map = MAP_TILE(x, y);
 			room = NULL;
 			
-			if (map->sector_type == sect) {
+			if (MAP_SECT(map) == sect) {
 				perform_change_sect(NULL, map, replace_sect);
 				++count;
 			}
-			if (map->base_sector == sect) {
+			if (MAP_BASE_SECT(map) == sect) {
 				perform_change_base_sect(NULL, map, replace_sect);
 			}
-			if (map->natural_sector == sect) {
-				map->natural_sector = replace_sect;
+			if (MAP_NATURAL_SECT(map) == sect) {
+				SET_MAP_NATURAL_SECT(map, replace_sect);
 			}
 		}
 	}
@@ -198,7 +198,7 @@ void olc_delete_sector(char_data *ch, sector_vnum vnum) {
 	LL_FOREACH2(interior_room_list, room, next_interior) {
 		if (SECT(room) == sect) {
 			// can't use change_terrain() here
-			perform_change_sect(room, NULL, replace_sect);
+			perform_change_sect(room, NOWHERE, replace_sect);
 			++count;
 		}
 		if (BASE_SECT(room) == sect) {
@@ -399,6 +399,7 @@ void save_olc_sector(descriptor_data *desc) {
 	struct interaction_item *interact;
 	struct spawn_info *spawn;
 	UT_hash_handle hh;
+	ush_int map_idx;
 	
 	// have a place to save it?
 	if (!(proto = sector_proto(vnum))) {
@@ -447,9 +448,14 @@ void save_olc_sector(descriptor_data *desc) {
 	
 	// save data back over the proto-type
 	hh = proto->hh;	// save old hash handle
+	map_idx = proto->map_idx;	// and world_map index
 	*proto = *st;	// copy over all data
 	proto->vnum = vnum;	// ensure correct vnum
 	proto->hh = hh;	// restore old hash handle
+	proto->map_idx = map_idx;	// restore world_map index
+	
+	// icons and flags may have changed
+	clear_map_icon_cache();
 	
 	// and save to file
 	save_library_file_for_vnum(DB_BOOT_SECTOR, vnum);
@@ -713,11 +713,11 @@ void olc_search_trigger(char_data *ch, trig_vnum vnum) {
 */
 void save_olc_trigger(descriptor_data *desc, char *script_text) {
 	extern struct cmdlist_element *compile_command_list(char *input);
+	void free_command_list(struct cmdlist_element *list);
 	void free_varlist(struct trig_var_data *vd);
 	
 	trig_data *proto, *live_trig, *next_trig, *find, *trig = GET_OLC_TRIGGER(desc);
 	trig_vnum vnum = GET_OLC_VNUM(desc);
-	struct cmdlist_element *cmd, *next_cmd;
 	struct script_data *sc;
 	bool free_text = FALSE;
 	UT_hash_handle hh;
@@ -729,12 +729,7 @@ void save_olc_trigger(descriptor_data *desc, char *script_text) {
 	}
 	
 	// free existing commands
-	for (cmd = proto->cmdlist; cmd; cmd = next_cmd) { 
-		next_cmd = cmd->next;
-		if (cmd->cmd)
-			free(cmd->cmd);
-		free(cmd);
-	}
+	free_command_list(proto->cmdlist);
 
 	// free old data on the proto
 	if (proto->arglist) {
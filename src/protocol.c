@@ -21,6 +21,8 @@
  code reduction.
  *****************************************************************************/
 
+#define __PROTOCOL_C__
+
 #include <alloca.h>
 
 #include "conf.h"
@@ -40,10 +42,14 @@
 #include "telnet.h"
 #endif
 
+#ifdef USING_MCCP
+#include <zlib.h>
+#endif
+
 
 static void Write(descriptor_t *apDescriptor, const char *apData) {
 	if (apDescriptor != NULL && apDescriptor->has_prompt) {
-		if (apDescriptor->pProtocol->WriteOOB > 0 || *(apDescriptor->output) == '\0') {
+		if (apDescriptor->pProtocol->WriteOOB > 0 || apDescriptor->output == NULL) {
 			apDescriptor->pProtocol->WriteOOB = 2;
 		}
 	}
@@ -61,24 +67,268 @@ static void InfoMessage(descriptor_t *apDescriptor, const char *apData) {
 	apDescriptor->pProtocol->WriteOOB = 0;
 }
 
+#ifdef USING_MCCP
+/* Sends as much of the waiting compressed output as the socket will take.
+ * Anything left over stays in pZipPending for next time.  Returns -1 if the
+ * socket had a fatal error.
+ */
+static int SendCompressed(descriptor_t *apDescriptor) {
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+	ssize_t Written;
+	int Sent = 0;
+
+	while (Sent < pProtocol->ZipPendingLength) {
+		Written = perform_socket_write(apDescriptor->descriptor, pProtocol->pZipPending + Sent, pProtocol->ZipPendingLength - Sent);
+		if (Written < 0) {
+			perror("SYSERR: Write to socket");
+			return -1;
+		}
+		else if (Written == 0) {
+			break;	/* Socket buffer full -- try again later */
+		}
+		Sent += Written;
+	}
+
+	if (Sent > 0) {
+		pProtocol->ZipPendingLength -= Sent;
+		memmove(pProtocol->pZipPending, pProtocol->pZipPending + Sent, pProtocol->ZipPendingLength);
+	}
+	return 0;
+}
+
+/* Runs text through the MCCP stream and adds the result to pZipPending.
+ * aFlush is Z_SYNC_FLUSH so the client can show everything sent so far, or
+ * Z_FINISH to end the stream.  Returns -1 if zlib failed or pZipPending
+ * couldn't grow; the stream is unusable after that, so the caller should
+ * treat it as a fatal write error.
+ */
+static int Compress(descriptor_t *apDescriptor, const char *apData, int aLength, int aFlush) {
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+	z_stream *pZip = pProtocol->pOutZip;
+	char Chunk[MAX_OUTPUT_BUFFER];
+	char *pNewPending;
+	int Have, NewSize;
+
+	pZip->next_in = (Bytef*)apData;
+	pZip->avail_in = aLength;
+
+	do {
+		pZip->next_out = (Bytef*)Chunk;
+		pZip->avail_out = sizeof(Chunk);
+		if (deflate(pZip, aFlush) == Z_STREAM_ERROR) {
+			ReportBug("Compress: deflate() failed.\n");
+			return -1;
+		}
+
+		Have = sizeof(Chunk) - pZip->avail_out;
+		if (pProtocol->ZipPendingLength + Have > pProtocol->ZipPendingSize) {
+			NewSize = pProtocol->ZipPendingLength + Have + MAX_OUTPUT_BUFFER;
+			if ((pNewPending = realloc(pProtocol->pZipPending, NewSize)) == NULL) {
+				/* The old buffer is still valid, and is freed with the descriptor */
+				ReportBug("Compress: Unable to grow the MCCP output buffer.\n");
+				return -1;
+			}
+			pProtocol->pZipPending = pNewPending;
+			pProtocol->ZipPendingSize = NewSize;
+		}
+		memcpy(pProtocol->pZipPending + pProtocol->ZipPendingLength, Chunk, Have);
+		pProtocol->ZipPendingLength += Have;
+		pProtocol->ZipCompressedBytes += Have;
+	} while (pZip->avail_out == 0);
+
+	pProtocol->ZipRawBytes += aLength;
+	return 0;
+}
+
+static void DecompressEnd(descriptor_t *apDescriptor) {
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+
+	if (pProtocol->pInZip != NULL) {
+		inflateEnd(pProtocol->pInZip);
+		free(pProtocol->pInZip);
+		pProtocol->pInZip = NULL;
+	}
+}
+
+/* Makes sure the Decompress() result buffer can hold aNeeded bytes plus the
+ * parser's NUL padding.  Returns false if it couldn't grow.
+ */
+static bool_t GrowDecompressResult(char **apResult, int *apResultSize, int aNeeded) {
+	char *pNewResult;
+	int NewSize;
+
+	if (aNeeded + 4 <= *apResultSize)
+		return true;
+
+	NewSize = aNeeded + 4 + MAX_PROTOCOL_BUFFER;
+	if ((pNewResult = realloc(*apResult, NewSize)) == NULL)
+		return false;
+
+	*apResult = pNewResult;
+	*apResultSize = NewSize;
+	return true;
+}
+
+/* Inflates MCCP3 input from the client, returning the plain text and setting
+ * *apSize to its length.  All of the input is inflated, however much text it
+ * makes, so the stream never loses its place; text the parser has no room for
+ * is dropped there, just like oversized plain input.  If the client ends its
+ * stream partway through, the bytes after the end are passed through as they
+ * are.
+ */
+static char *Decompress(descriptor_t *apDescriptor, const char *apData, int *apSize) {
+	static char *pResult = NULL;
+	static int ResultSize = 0;
+	static char Empty[4];
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+	z_stream *pZip = pProtocol->pInZip;
+	int Status, Length = 0, Rest;
+
+	pZip->next_in = (Bytef*)apData;
+	pZip->avail_in = *apSize;
+
+	do {
+		if (!GrowDecompressResult(&pResult, &ResultSize, Length + MAX_PROTOCOL_BUFFER)) {
+			ReportBug("Decompress: Unable to grow the MCCP3 input buffer.\n");
+			DecompressEnd(apDescriptor);
+			*apSize = 0;
+			return Empty;
+		}
+
+		pZip->next_out = (Bytef*)(pResult + Length);
+		pZip->avail_out = ResultSize - Length - 4;
+		Status = inflate(pZip, Z_SYNC_FLUSH);
+		Length = ResultSize - 4 - pZip->avail_out;
+	} while (Status == Z_OK && pZip->avail_out == 0);
+
+	if (Status == Z_STREAM_END) {
+		/* The client stopped compressing: the rest is plain input */
+		Rest = pZip->avail_in;
+		if (GrowDecompressResult(&pResult, &ResultSize, Length + Rest)) {
+			memcpy(pResult + Length, pZip->next_in, Rest);
+			Length += Rest;
+		}
+		else {
+			ReportBug("Decompress: Unable to grow the MCCP3 input buffer.\n");
+		}
+		DecompressEnd(apDescriptor);
+	}
+	else if (Status != Z_OK && Status != Z_BUF_ERROR) {
+		ReportBug("Decompress: Bad MCCP3 data from the client.\n");
+		DecompressEnd(apDescriptor);
+		Length = 0;
+	}
+
+	/* The parser looks a few bytes ahead, so pad it with NULs */
+	memset(pResult + Length, '\0', 4);
+	*apSize = Length;
+	return pResult;
+}
+
+static void DecompressStart(descriptor_t *apDescriptor) {
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+	z_stream *pZip;
+
+	if (pProtocol->pInZip == NULL) {
+		pZip = calloc(1, sizeof(z_stream));
+		if (inflateInit(pZip) != Z_OK) {
+			ReportBug("DecompressStart: Unable to start MCCP3.\n");
+			free(pZip);
+			return;
+		}
+		pProtocol->pInZip = pZip;
+	}
+}
+
+/* The inflate stream can't survive a copyover, so this asks the client to
+ * end it (IAC WONT MCCP3) and reads until it does, or until a short timeout.
+ * Any input read here is discarded, as it would be by the reboot anyway.
+ */
+static void DecompressFinish(descriptor_t *apDescriptor) {
+	const char StopSequence[] = { (char)IAC, (char)WONT, (char)TELOPT_MCCP3, '\0' };
+	char Buffer[MAX_PROTOCOL_BUFFER];
+	struct timeval Timeout;
+	fd_set ReadSet;
+	ssize_t Size;
+	int Length, Tries;
+
+	write_to_descriptor(apDescriptor->descriptor, StopSequence);
+
+	for (Tries = 0; Tries < 5 && apDescriptor->pProtocol->pInZip != NULL; ++Tries) {
+		FD_ZERO(&ReadSet);
+		FD_SET(apDescriptor->descriptor, &ReadSet);
+		Timeout.tv_sec = 0;
+		Timeout.tv_usec = 50000;
+		if (select(apDescriptor->descriptor + 1, &ReadSet, NULL, NULL, &Timeout) <= 0) {
+			continue;
+		}
+		if ((Size = read(apDescriptor->descriptor, Buffer, sizeof(Buffer))) <= 0) {
+			break;
+		}
+		Length = Size;
+		Decompress(apDescriptor, Buffer, &Length);
+	}
+
+	if (apDescriptor->pProtocol->pInZip != NULL) {
+		ReportBug("DecompressFinish: Client did not end MCCP3 before the copyover.\n");
+		DecompressEnd(apDescriptor);
+	}
+}
+#endif /* USING_MCCP */
+
 static void CompressStart(descriptor_t *apDescriptor) {
-	/* If your mud uses MCCP (Mud Client Compression Protocol), you need to 
-	* call whatever function normally starts compression from here - the 
-	* ReportBug() call should then be deleted.
-	* 
-	* Otherwise you can just ignore this function.
+#ifdef USING_MCCP
+	const char StartSequence[] = { (char)IAC, (char)SB, (char)TELOPT_MCCP, (char)IAC, (char)SE, '\0' };
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+	z_stream *pZip;
+
+	if (pProtocol->pOutZip != NULL) {
+		return;	/* Already compressing */
+	}
+
+	pZip = calloc(1, sizeof(z_stream));
+	if (deflateInit(pZip, Z_DEFAULT_COMPRESSION) != Z_OK) {
+		ReportBug("CompressStart: Unable to start MCCP compression.\n");
+		free(pZip);
+		pProtocol->bMCCP = false;
+		return;
+	}
+
+	/* This goes out ahead of any queued output: everything after it is
+	* compressed, including whatever is still waiting in the output buffer.
 	*/
-	ReportBug("CompressStart() in protocol.c is being called, but it doesn't do anything!\n");
+	if (write_to_descriptor(apDescriptor->descriptor, StartSequence) < 0) {
+		deflateEnd(pZip);
+		free(pZip);
+		return;
+	}
+	pProtocol->pOutZip = pZip;
+#else
+	ReportBug("CompressStart() in protocol.c is being called, but MCCP is not compiled in!\n");
+#endif /* USING_MCCP */
 }
 
 static void CompressEnd(descriptor_t *apDescriptor) {
-	/* If your mud uses MCCP (Mud Client Compression Protocol), you need to 
-	* call whatever function normally starts compression from here - the 
-	* ReportBug() call should then be deleted.
-	* 
-	* Otherwise you can just ignore this function.
-	*/
-	ReportBug("CompressEnd() in protocol.c is being called, but it doesn't do anything!\n");
+#ifdef USING_MCCP
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+
+	if (pProtocol->pOutZip != NULL) {
+		/* Finish the stream so the client goes back to plain text */
+		if (Compress(apDescriptor, "", 0, Z_FINISH) == 0) {
+			SendCompressed(apDescriptor);
+		}
+		if (pProtocol->ZipPendingLength > 0) {
+			ReportBug("CompressEnd: Socket was full; the end of the MCCP stream was lost.\n");
+		}
+
+		deflateEnd(pProtocol->pOutZip);
+		free(pProtocol->pOutZip);
+		pProtocol->pOutZip = NULL;
+		pProtocol->ZipPendingLength = 0;
+	}
+#else
+	ReportBug("CompressEnd() in protocol.c is being called, but MCCP is not compiled in!\n");
+#endif /* USING_MCCP */
 }
 
 /******************************************************************************
@@ -475,6 +725,14 @@ protocol_t *ProtocolCreate(void) {
 	pProtocol->bMSP = false;
 	pProtocol->bMXP = false;
 	pProtocol->bMCCP = false;
+	pProtocol->bMCCP3 = false;
+	pProtocol->pOutZip = NULL;
+	pProtocol->pInZip = NULL;
+	pProtocol->pZipPending = NULL;
+	pProtocol->ZipPendingSize = 0;
+	pProtocol->ZipPendingLength = 0;
+	pProtocol->ZipRawBytes = 0;
+	pProtocol->ZipCompressedBytes = 0;
 	pProtocol->b256Support = eUNKNOWN;
 	pProtocol->ScreenWidth = 0;
 	pProtocol->ScreenHeight = 0;
@@ -513,6 +771,18 @@ void ProtocolDestroy(protocol_t *apProtocol) {
 		free(apProtocol->pVariables[i]);
 	}
 
+#ifdef USING_MCCP
+	if (apProtocol->pOutZip != NULL) {
+		deflateEnd(apProtocol->pOutZip);
+		free(apProtocol->pOutZip);
+	}
+	if (apProtocol->pInZip != NULL) {
+		inflateEnd(apProtocol->pInZip);
+		free(apProtocol->pInZip);
+	}
+#endif /* USING_MCCP */
+	free(apProtocol->pZipPending);
+
 	free(apProtocol->pVariables);
 	free(apProtocol->pLastTTYPE);
 	free(apProtocol->pMXPVersion);
@@ -528,6 +798,12 @@ void ProtocolInput(descriptor_t *apDescriptor, char *apData, int aSize, char *ap
 
 	protocol_t *pProtocol = apDescriptor ? apDescriptor->pProtocol : NULL;
 
+#ifdef USING_MCCP
+	/* MCCP3: the client is compressing its input */
+	if (pProtocol->pInZip != NULL)
+		apData = Decompress(apDescriptor, apData, &aSize);
+#endif /* USING_MCCP */
+
 	for (Index = 0; Index < aSize; ++Index) {
 		/* If we'd overflow the buffer, we just ignore the input */
 		if (CmdIndex >= MAX_PROTOCOL_BUFFER || IacIndex >= MAX_PROTOCOL_BUFFER) {
@@ -551,6 +827,18 @@ void ProtocolInput(descriptor_t *apDescriptor, char *apData, int aSize, char *ap
 				IacBuf[IacIndex] = '\0';
 				if (IacIndex >= 2)
 					PerformSubnegotiation(apDescriptor, IacBuf[0], &IacBuf[1], IacIndex-1);
+#ifdef USING_MCCP
+				else if (IacIndex == 1 && IacBuf[0] == (char)TELOPT_MCCP3 && pProtocol->bMCCP3 && pProtocol->pInZip == NULL) {
+					/* IAC SB MCCP3 IAC SE: everything after this is compressed */
+					DecompressStart(apDescriptor);
+					if (pProtocol->pInZip != NULL) {
+						int Rest = aSize - Index - 1;
+						apData = Decompress(apDescriptor, apData + Index + 1, &Rest);
+						aSize = Rest;
+						Index = -1;	/* Carry on from the start of the new data */
+					}
+				}
+#endif /* USING_MCCP */
 				IacIndex = 0;
 			}
 			else
@@ -1194,6 +1482,81 @@ void ProtocolNoEcho(descriptor_t *apDescriptor, bool_t abOn) {
 }
 
 
+/******************************************************************************
+ MCCP functions.
+ *****************************************************************************/
+
+int ProtocolWrite(descriptor_t *apDescriptor, const char *apData) {
+#ifdef USING_MCCP
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+	int Length = strlen(apData);
+
+	if (pProtocol->pOutZip != NULL) {
+		/* Earlier output has to finish before any more can go in the stream */
+		if (pProtocol->ZipPendingLength > 0) {
+			if (SendCompressed(apDescriptor) < 0)
+				return -1;
+			if (pProtocol->ZipPendingLength > 0)
+				return 0;
+		}
+
+		if (Length == 0)
+			return 0;
+
+		if (Compress(apDescriptor, apData, Length, Z_SYNC_FLUSH) < 0 || SendCompressed(apDescriptor) < 0)
+			return -1;
+
+		/* Whatever the socket didn't take waits in pZipPending */
+		return Length;
+	}
+#endif /* USING_MCCP */
+
+	return write_to_descriptor(apDescriptor->descriptor, apData);
+}
+
+int ProtocolWritev(descriptor_t *apDescriptor, const struct iovec *apVector, int aCount) {
+	int Result = 0;
+
+#ifdef USING_MCCP
+	protocol_t *pProtocol = apDescriptor->pProtocol;
+	int i;
+
+	if (pProtocol->pOutZip != NULL) {
+		/* Earlier output has to finish before any more can go in the stream */
+		if (pProtocol->ZipPendingLength > 0) {
+			if (SendCompressed(apDescriptor) < 0)
+				return -1;
+			if (pProtocol->ZipPendingLength > 0)
+				return 0;
+		}
+
+		/* Only the last piece needs a flush for the client to see it all */
+		for (i = 0; i < aCount; ++i) {
+			if (Compress(apDescriptor, apVector[i].iov_base, apVector[i].iov_len, (i == aCount - 1) ? Z_SYNC_FLUSH : Z_NO_FLUSH) < 0)
+				return -1;
+			Result += apVector[i].iov_len;
+		}
+
+		return (SendCompressed(apDescriptor) < 0) ? -1 : Result;
+	}
+#endif /* USING_MCCP */
+
+	if ((Result = perform_socket_writev(apDescriptor->descriptor, apVector, aCount)) < 0)
+		perror("SYSERR: Write to socket");
+
+	return Result;
+}
+
+bool_t ProtocolCompressStats(descriptor_t *apDescriptor, unsigned long long *apRaw, unsigned long long *apCompressed) {
+	protocol_t *pProtocol = apDescriptor ? apDescriptor->pProtocol : NULL;
+
+	*apRaw = pProtocol ? pProtocol->ZipRawBytes : 0;
+	*apCompressed = pProtocol ? pProtocol->ZipCompressedBytes : 0;
+
+	return (*apRaw > 0) ? true : false;
+}
+
+
 /******************************************************************************
  Copyover save/load functions.
  *****************************************************************************/
@@ -1226,6 +1589,13 @@ const char *CopyoverGet(descriptor_t *apDescriptor) {
 			*pBuffer++ = 'c';
 			CompressEnd(apDescriptor);
 		}
+		if (pProtocol->bMCCP3) {
+			*pBuffer++ = 'z';
+			#ifdef USING_MCCP
+				if (pProtocol->pInZip != NULL)
+					DecompressFinish(apDescriptor);
+			#endif /* USING_MCCP */
+		}
 		if (pProtocol->pVariables[eMSDP_XTERM_256_COLORS]->ValueInt)
 			*pBuffer++ = 'C';
 		if (pProtocol->bCHARSET)
@@ -1273,6 +1643,10 @@ void CopyoverSet(descriptor_t *apDescriptor, const char *apData) {
 					pProtocol->bMCCP = true;
 					CompressStart(apDescriptor);
 					break;
+				case 'z':
+					/* Offer MCCP3 again; the client stopped it for the copyover */
+					ConfirmNegotiation(apDescriptor, eNEGOTIATED_MCCP3, true, true);
+					break;
 				case 'C':
 					pProtocol->pVariables[eMSDP_XTERM_256_COLORS]->ValueInt = 1;
 					break;
@@ -1736,6 +2110,7 @@ static void Negotiate(descriptor_t *apDescriptor) {
 		ConfirmNegotiation(apDescriptor, eNEGOTIATED_MSP, true, true);
 		ConfirmNegotiation(apDescriptor, eNEGOTIATED_MXP, true, true);
 		ConfirmNegotiation(apDescriptor, eNEGOTIATED_MCCP, true, true);
+		ConfirmNegotiation(apDescriptor, eNEGOTIATED_MCCP3, true, true);
 	}
 }
 
@@ -1904,6 +2279,23 @@ static void PerformHandshake(descriptor_t *apDescriptor, char aCmd, char aProtoc
 			break;
 		}
 
+		case (char)TELOPT_MCCP3: {
+			/* The client starts compressing once it sends IAC SB MCCP3 IAC SE */
+			if (aCmd == (char)DO) {
+				ConfirmNegotiation(apDescriptor, eNEGOTIATED_MCCP3, true, true);
+				pProtocol->bMCCP3 = true;
+			}
+			else if (aCmd == (char)DONT) {
+				ConfirmNegotiation(apDescriptor, eNEGOTIATED_MCCP3, false, pProtocol->bMCCP3);
+				pProtocol->bMCCP3 = false;
+			}
+			else if (aCmd == (char)WILL) {
+				/* Invalid negotiation, send a rejection */
+				SendNegotiationSequence(apDescriptor, (char)DONT, (char)aProtocol);
+			}
+			break;
+		}
+
 		case (char)TELOPT_MSP: {
 			if (aCmd == (char)DO) {
 				ConfirmNegotiation(apDescriptor, eNEGOTIATED_MSP, true, true);
@@ -2244,6 +2636,11 @@ static bool_t ConfirmNegotiation(descriptor_t *apDescriptor, negotiated_t aProto
 							SendNegotiationSequence(apDescriptor, (char) (abWillDo ? WILL : WONT), TELOPT_MCCP);
 						#endif /* USING_MCCP */
 						break;
+					case eNEGOTIATED_MCCP3:
+						#ifdef USING_MCCP
+							SendNegotiationSequence(apDescriptor, (char) (abWillDo ? WILL : WONT), TELOPT_MCCP3);
+						#endif /* USING_MCCP */
+						break;
 					default: {
 						bResult = false;
 						break;
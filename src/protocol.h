@@ -23,6 +23,7 @@
 #define PROTOCOL_H
 
 typedef struct descriptor_data descriptor_t;
+struct iovec;
 
 
 /******************************************************************************
@@ -37,10 +38,12 @@ typedef struct descriptor_data descriptor_t;
 
 
 /******************************************************************************
- If your mud supports MCCP (compression), uncomment the next line.
+ MCCP (compression) is supported whenever configure finds zlib.
  *****************************************************************************/
 
-// #define USING_MCCP
+#ifdef EMPIRE_ZLIB
+	#define USING_MCCP
+#endif
 
 
 /******************************************************************************
@@ -69,6 +72,7 @@ typedef struct descriptor_data descriptor_t;
 #define TELOPT_MSDP  69
 #define TELOPT_MSSP  70
 #define TELOPT_MCCP  86	// This is MCCP version 2
+#define TELOPT_MCCP3  87	// MCCP version 3 (compresses the client's input)
 #define TELOPT_MSP  90
 #define TELOPT_MXP  91
 #define TELOPT_ATCP  200
@@ -109,6 +113,7 @@ typedef enum {
 	eNEGOTIATED_MXP, 
 	eNEGOTIATED_MXP2, 
 	eNEGOTIATED_MCCP, 
+	eNEGOTIATED_MCCP3, 
 	
 	eNEGOTIATED_MAX	// This must always be last
 } negotiated_t;
@@ -278,6 +283,14 @@ typedef struct {
 	bool_t bMSP;	// The client supports MSP
 	bool_t bMXP;	// The client supports MXP
 	bool_t bMCCP;	// The client supports MCCP
+	bool_t bMCCP3;	// The client supports MCCP v3 (compressed input)
+	struct z_stream_s *pOutZip;	// MCCP output stream, while compressing
+	struct z_stream_s *pInZip;	// MCCP3 input stream, while decompressing
+	char *pZipPending;	// Compressed output the socket hasn't taken yet
+	int ZipPendingSize;	// Allocated size of pZipPending
+	int ZipPendingLength;	// Bytes waiting in pZipPending
+	unsigned long long ZipRawBytes;	// Output fed into the MCCP stream
+	unsigned long long ZipCompressedBytes;	// Compressed bytes that came out
 	support_t b256Support;	// The client supports XTerm 256 colors
 	int ScreenWidth;	// The client's screen width
 	int ScreenHeight;	// The client's screen height
@@ -399,6 +412,41 @@ void ProtocolInput(descriptor_t *apDescriptor, char *apData, int aSize, char *ap
  */
 const char *ProtocolOutput(descriptor_t *apDescriptor, const char *apData, int *apLength);
 
+/******************************************************************************
+ MCCP functions.
+ ******************************************************************************/
+
+/* Function: ProtocolWrite
+ *
+ * Sends text to the client, through the MCCP stream if compression is on,
+ * and otherwise straight to write_to_descriptor().  Use this instead of
+ * write_to_descriptor() for any descriptor that might be compressing.
+ *
+ * Returns -1 on a fatal error, 0 if the socket is still busy with earlier
+ * compressed output (nothing was taken; try again later), or the number of
+ * bytes of text that were sent or queued.  Passing an empty string just
+ * flushes any compressed output that's still waiting.
+ */
+int ProtocolWrite(descriptor_t *apDescriptor, const char *apData);
+
+/* Function: ProtocolWritev
+ *
+ * Like ProtocolWrite(), but sends several pieces of text (which need not be
+ * NUL-terminated) at once.  Without compression this is a single writev(),
+ * which may stop partway through; the return value is the number of bytes
+ * taken, 0 if the socket is full, or -1 on a fatal error.  With compression,
+ * either all of the text is taken or none of it is.
+ */
+int ProtocolWritev(descriptor_t *apDescriptor, const struct iovec *apVector, int aCount);
+
+/* Function: ProtocolCompressStats
+ *
+ * Reports how much output has gone into this descriptor's MCCP stream and
+ * how many compressed bytes came out.  Returns false if the client has never
+ * had compression turned on.
+ */
+bool_t ProtocolCompressStats(descriptor_t *apDescriptor, unsigned long long *apRaw, unsigned long long *apCompressed);
+
 /******************************************************************************
  Copyover save/load functions.
  ******************************************************************************/
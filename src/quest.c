@@ -195,18 +195,18 @@ void copy_quest_progress(struct req_data *to_list, struct req_data *from_list) {
 * @return int The number of completed buildings with that vnum, owned by emp.
 */
 int count_owned_buildings(empire_data *emp, bld_vnum vnum) {
-	struct empire_territory_data *ter;
+	struct empire_territory_ref *ref;
 	int count = 0;	// ah ah ah
 	
 	if (!emp || vnum == NOTHING) {
 		return count;
 	}
 	
-	LL_FOREACH(EMPIRE_TERRITORY_LIST(emp), ter) {
-		if (!IS_COMPLETE(ter->room) || !GET_BUILDING(ter->room)) {
+	for (ref = get_territory_by_building(emp, vnum); ref; ref = ref->next) {
+		if (!IS_COMPLETE(ref->ter->room) || !GET_BUILDING(ref->ter->room)) {
 			continue;
 		}
-		if (GET_BLD_VNUM(GET_BUILDING(ter->room)) != vnum) {
+		if (GET_BLD_VNUM(GET_BUILDING(ref->ter->room)) != vnum) {
 			continue;
 		}
 		
@@ -90,3 +90,26 @@ unsigned long empire_random(void) {
 
 	return (seed);
 }
+
+
+/*
+ * Same generator as empire_random(), but it advances a seed the caller owns
+ * instead of the global one. This is safe to use off the main thread, and a
+ * given starting seed always gives the same sequence. The seed must be in
+ * the range 1 to m-1.
+ */
+unsigned long empire_random_r(unsigned long *state) {
+	register int lo, hi, test;
+
+	hi = *state/q;
+	lo = *state%q;
+
+	test = a*lo - r*hi;
+
+	if (test > 0)
+		*state = test;
+	else
+		*state = test+ m;
+
+	return (*state);
+}
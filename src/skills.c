@@ -419,37 +419,26 @@ void add_ability(char_data *ch, ability_data *abil, bool reset_levels) {
 * @param bool add Adds the abilities if TRUE, or removes them if FALSE
 */
 void adjust_abilities_to_empire(char_data *ch, empire_data *emp, bool add) {
-	int mod = (add ? 1 : -1);
+	adjust_techs_to_empire(get_player_techs(ch), emp, add);
+}
+
+
+/**
+* Modifies empire technology using a set of techs from get_player_techs().
+* This allows the techs to be applied for players who aren't loaded, using
+* the copy in their player index entry.
+*
+* @param bitvector_t techs The player's TECH_ bits, from get_player_techs().
+* @param empire_data *emp The empire
+* @param bool add Adds the techs if TRUE, or removes them if FALSE
+*/
+void adjust_techs_to_empire(bitvector_t techs, empire_data *emp, bool add) {
+	int iter, mod = (add ? 1 : -1);
 	
-	if (has_ability(ch, ABIL_EXARCH_CRAFTS)) {
-		EMPIRE_TECH(emp, TECH_EXARCH_CRAFTS) += mod;
-	}
-	if (has_ability(ch, ABIL_WORKFORCE)) {
-		EMPIRE_TECH(emp, TECH_WORKFORCE) += mod;
-	}
-	if (has_ability(ch, ABIL_SKILLED_LABOR)) {
-		EMPIRE_TECH(emp, TECH_SKILLED_LABOR) += mod;
-	}
-	if (has_ability(ch, ABIL_TRADE_ROUTES)) {
-		EMPIRE_TECH(emp, TECH_TRADE_ROUTES) += mod;
-	}
-	if (has_ability(ch, ABIL_LOCKS)) {
-		EMPIRE_TECH(emp, TECH_LOCKS) += mod;
-	}
-	if (has_ability(ch, ABIL_PROMINENCE)) {
-		EMPIRE_TECH(emp, TECH_PROMINENCE) += mod;
-	}
-	if (has_ability(ch, ABIL_COMMERCE)) {
-		EMPIRE_TECH(emp, TECH_COMMERCE) += mod;
-	}
-	if (has_ability(ch, ABIL_CITY_LIGHTS)) {
-		EMPIRE_TECH(emp, TECH_CITY_LIGHTS) += mod;
-	}
-	if (has_ability(ch, ABIL_PORTAL_MAGIC)) {
-		EMPIRE_TECH(emp, TECH_PORTALS) += mod;
-	}
-	if (has_ability(ch, ABIL_PORTAL_MASTER)) {
-		EMPIRE_TECH(emp, TECH_MASTER_PORTALS) += mod;
+	for (iter = 0; iter < NUM_TECHS; ++iter) {
+		if (IS_SET(techs, BIT(iter))) {
+			EMPIRE_TECH(emp, iter) += mod;
+		}
 	}
 }
 
@@ -1024,6 +1013,51 @@ int get_ability_points_spent(char_data *ch, any_vnum skill) {
 }
 
 
+/**
+* Determines which empire techs a player contributes via their abilities. This
+* is stored in the player index so offline members don't need to be loaded.
+*
+* @param char_data *ch The player.
+* @return bitvector_t The TECH_ bits the player provides.
+*/
+bitvector_t get_player_techs(char_data *ch) {
+	bitvector_t techs = NOBITS;
+	
+	if (has_ability(ch, ABIL_EXARCH_CRAFTS)) {
+		techs |= BIT(TECH_EXARCH_CRAFTS);
+	}
+	if (has_ability(ch, ABIL_WORKFORCE)) {
+		techs |= BIT(TECH_WORKFORCE);
+	}
+	if (has_ability(ch, ABIL_SKILLED_LABOR)) {
+		techs |= BIT(TECH_SKILLED_LABOR);
+	}
+	if (has_ability(ch, ABIL_TRADE_ROUTES)) {
+		techs |= BIT(TECH_TRADE_ROUTES);
+	}
+	if (has_ability(ch, ABIL_LOCKS)) {
+		techs |= BIT(TECH_LOCKS);
+	}
+	if (has_ability(ch, ABIL_PROMINENCE)) {
+		techs |= BIT(TECH_PROMINENCE);
+	}
+	if (has_ability(ch, ABIL_COMMERCE)) {
+		techs |= BIT(TECH_COMMERCE);
+	}
+	if (has_ability(ch, ABIL_CITY_LIGHTS)) {
+		techs |= BIT(TECH_CITY_LIGHTS);
+	}
+	if (has_ability(ch, ABIL_PORTAL_MAGIC)) {
+		techs |= BIT(TECH_PORTALS);
+	}
+	if (has_ability(ch, ABIL_PORTAL_MASTER)) {
+		techs |= BIT(TECH_MASTER_PORTALS);
+	}
+	
+	return techs;
+}
+
+
 /**
 * @param char_data *ch The character whose skills to use, and who to send to.
 * @param skill_data *skill Which skill to show.
@@ -46,6 +46,7 @@
 // protos
 void add_ability(char_data *ch, ability_data *abil, bool reset_levels);
 void adjust_abilities_to_empire(char_data *ch, empire_data *emp, bool add);
+void adjust_techs_to_empire(bitvector_t techs, empire_data *emp, bool add);
 extern bool can_gain_exp_from(char_data *ch, char_data *vict);
 extern bool can_use_ability(char_data *ch, any_vnum ability, int cost_pool, int cost_amount, int cooldown_type);
 void charge_ability_cost(char_data *ch, int cost_pool, int cost_amount, int cooldown_type, int cooldown_time, int wait_type);
@@ -57,6 +58,7 @@ extern struct player_ability_data *get_ability_data(char_data *ch, any_vnum abil
 extern int get_ability_level(char_data *ch, any_vnum ability);
 extern int get_ability_points_available_for_char(char_data *ch, any_vnum skill);
 extern int get_approximate_level(char_data *ch);
+extern bitvector_t get_player_techs(char_data *ch);
 extern struct player_skill_data *get_skill_data(char_data *ch, any_vnum vnum, bool add_if_missing);
 void mark_level_gained_from_ability(char_data *ch, ability_data *abil);
 void remove_ability(char_data *ch, ability_data *abil, bool reset_levels);
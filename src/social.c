@@ -46,6 +46,7 @@ extern const char *social_flags[];
 extern const char *social_message_types[NUM_SOCM_MESSAGES][2];
 
 // external funcs
+void clear_social_trie();
 void get_requirement_display(struct req_data *list, char *save_buffer);
 
 
@@ -277,6 +278,7 @@ void add_social_to_table(social_data *soc) {
 		if (!find) {
 			HASH_ADD(sorted_hh, sorted_socials, vnum, sizeof(int), soc);
 			HASH_SRT(sorted_hh, sorted_socials, sort_socials_by_data);
+			clear_social_trie();
 		}
 	}
 }
@@ -290,6 +292,7 @@ void add_social_to_table(social_data *soc) {
 void remove_social_from_table(social_data *soc) {
 	HASH_DEL(social_table, soc);
 	HASH_DELETE(sorted_hh, sorted_socials, soc);
+	clear_social_trie();
 }
 
 
@@ -614,6 +617,7 @@ void save_olc_social(descriptor_data *desc) {
 
 	// ... and re-sort
 	HASH_SRT(sorted_hh, sorted_socials, sort_socials_by_data);
+	clear_social_trie();
 }
 
 
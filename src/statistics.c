@@ -75,10 +75,14 @@ void update_world_count();
 * @param char_data *ch The person to show stats to.
 */
 void display_statistics_to_char(char_data *ch) {
+	extern const char *get_io_backend_name(void);
+	extern struct io_timing_data io_timing;
 	extern time_t boot_time;
 
 	char populous_str[MAX_STRING_LENGTH], wealthiest_str[MAX_STRING_LENGTH], famous_str[MAX_STRING_LENGTH], greatest_str[MAX_STRING_LENGTH];
 	int populous_empire = NOTHING, wealthiest_empire = NOTHING, famous_empire = NOTHING, greatest_empire = NOTHING;
+	unsigned long long raw, zipped, total_raw, total_zipped;
+	descriptor_data *desc;
 	vehicle_data *veh;
 	char_data *vict;
 	obj_data *obj;
@@ -194,6 +198,33 @@ void display_statistics_to_char(char_data *ch) {
 	// vehicles
 	LL_COUNT(vehicle_list, veh, count);
 	msg_to_char(ch, "Unique Vehicles:    %3d     Total Vehicles:     %d\r\n", HASH_COUNT(vehicle_table), count);
+	
+	// socket i/o (immortals only)
+	if (IS_IMMORTAL(ch) && io_timing.pulses > 0) {
+		msg_to_char(ch, "Socket I/O (%s): %.2f ms last pulse, %.2f ms avg, %.2f ms max, %.1f ready/pulse\r\n", get_io_backend_name(), io_timing.last_usec / 1000.0, (double) io_timing.total_usec / io_timing.pulses / 1000.0, io_timing.max_usec / 1000.0, (double) io_timing.total_ready / io_timing.pulses);
+	}
+	
+	// output compression (immortals only)
+	if (IS_IMMORTAL(ch)) {
+		count = 0;
+		total_raw = total_zipped = 0;
+		for (desc = descriptor_list; desc; desc = desc->next) {
+			if (ProtocolCompressStats(desc, &raw, &zipped)) {
+				++count;
+				total_raw += raw;
+				total_zipped += zipped;
+			}
+		}
+		
+		if (count > 0) {
+			msg_to_char(ch, "Compression (MCCP): %d connection%s, %.1f KB sent as %.1f KB (%.1f:1, %.1f KB saved)\r\n", count, PLURAL(count), total_raw / 1024.0, total_zipped / 1024.0, total_zipped > 0 ? (double) total_raw / total_zipped : 0.0, (total_raw - MIN(total_raw, total_zipped)) / 1024.0);
+			for (desc = descriptor_list; desc; desc = desc->next) {
+				if (ProtocolCompressStats(desc, &raw, &zipped)) {
+					msg_to_char(ch, "  %-20.20s %.1f KB sent as %.1f KB (%.1f:1, %.1f KB saved)\r\n", (desc->character ? GET_NAME(desc->character) : desc->host), raw / 1024.0, zipped / 1024.0, zipped > 0 ? (double) raw / zipped : 0.0, (raw - MIN(raw, zipped)) / 1024.0);
+				}
+			}
+		}
+	}
 }
 
 
@@ -399,7 +430,7 @@ void update_players_online_stats(void) {
 void update_world_count(void) {
 	struct stats_data_struct *sect_inf = NULL, *crop_inf = NULL, *bld_inf = NULL, *data, *next_data;
 	any_vnum vnum, last_bld_vnum = NOTHING, last_crop_vnum = NOTHING, last_sect_vnum = NOTHING;
-	struct map_data *map;
+	room_vnum map;
 	room_data *room;
 	
 	// free and recreate counts
@@ -417,9 +448,9 @@ void update_world_count(void) {
 	}
 	
 	// scan world
-	for (map = land_map; map; map = map->next) {
+	for (map = land_map; map != NOWHERE; map = MAP_NEXT_LAND(map)) {
 		// sector
-		vnum = GET_SECT_VNUM(map->sector_type);
+		vnum = GET_SECT_VNUM(MAP_SECT(map));
 		if (vnum != last_sect_vnum || !sect_inf) {
 			HASH_FIND_INT(global_sector_count, &vnum, sect_inf);
 			if (!sect_inf) {
@@ -432,8 +463,8 @@ void update_world_count(void) {
 		++sect_inf->count;
 		
 		// crop
-		if (map->crop_type) {
-			vnum = GET_CROP_VNUM(map->crop_type);
+		if (MAP_CROP(map)) {
+			vnum = GET_CROP_VNUM(MAP_CROP(map));
 			
 			if (vnum != last_crop_vnum || !crop_inf) {
 				HASH_FIND_INT(global_crop_count, &vnum, crop_inf);
@@ -449,7 +480,7 @@ void update_world_count(void) {
 		}
 		
 		// any further data?
-		if (!(room = real_real_room(map->vnum))) {
+		if (!(room = real_real_room(map))) {
 			continue;
 		}
 		
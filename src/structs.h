@@ -119,7 +119,7 @@
 	!COMPLEX_DATA(room) && \
 	GET_ROOM_VNUM(room) < MAP_SIZE && \
 	GET_EXITS_HERE(room) == 0 && \
-	SECT(room) == world_map[FLAT_X_COORD(room)][FLAT_Y_COORD(room)].sector_type && \
+	SECT(room) == MAP_SECT(GET_ROOM_VNUM(room)) && \
 	!ROOM_SECT_FLAGGED(room, TILE_KEEP_FLAGS) && \
 	!ROOM_OWNER(room) && !ROOM_CONTENTS(room) && !ROOM_PEOPLE(room) && \
 	!ROOM_VEHICLES(room) && \
@@ -1057,9 +1057,11 @@ typedef struct vehicle_data vehicle_data;
 #define MAX_SOCK_BUF  (24 * 1024)	// Size of kernel's sock buf
 #define MAX_PROMPT_LENGTH  275	// Max length of rendered prompt
 #define GARBAGE_SPACE  32	// Space for **OVERFLOW** etc
-#define SMALL_BUFSIZE  8192	// Static output buffer size
-// Max amount of output that can be buffered
-#define LARGE_BUFSIZE  (MAX_SOCK_BUF - GARBAGE_SPACE - MAX_PROMPT_LENGTH)
+#define OUTBUF_CHUNK_SIZE  4096	// Size of each pooled output chunk
+#define MAX_OUTBUF_POOL  256	// Max spare chunks kept in the pool for reuse
+#define MAX_OUTPUT_IOV  64	// Max chunks handed to one writev()
+#define MAX_OUTPUT_PIECE  2048	// Text given to ProtocolOutput() at a time; color codes expand it
+#define DEFAULT_OUTPUT_LIMIT  512	// KB of queued output per connection, if the max_output_buffer config is not set
 
 
 // shutdown types
@@ -2901,6 +2903,15 @@ struct player_index_data {
 	int rank;	// empire rank
 	char *last_host;	// last known host
 	
+	// these are only accurate when the player was fully loaded (incl. delayed data)
+	int greatness;	// greatness, with gear and affects
+	bitvector_t techs;	// TECH_: empire techs granted by the player's abilities
+	bool summary_complete;	// TRUE if greatness/techs are up-to-date
+	
+	// for checking the player index file against the actual player file
+	time_t file_time;	// last-modified time of the player file
+	long file_size;	// size of the player file
+	
 	UT_hash_handle idnum_hh;	// player_table_by_idnum
 	UT_hash_handle name_hh;	// player_table_by_name
 };
@@ -2922,6 +2933,16 @@ struct txt_q {
 };
 
 
+// for descriptor_data: one piece of the output queue, from the chunk pool
+struct outbuf_chunk {
+	char text[OUTBUF_CHUNK_SIZE];
+	int start;	// first byte not yet sent
+	int length;	// bytes of text in the chunk
+	
+	struct outbuf_chunk *next;
+};
+
+
 // for descriptor_data, reducing the number of color codes sent to a client
 struct color_reducer {
 	char last_fg[COLREDUC_SIZE];	// last sent foreground
@@ -2940,6 +2961,7 @@ struct descriptor_data {
 	socket_t descriptor;	// file descriptor for socket
 
 	char *host;	// hostname
+	bool resolving_host;	// TRUE while waiting on a background hostname lookup (host is the IP until then)
 	byte bad_pws;	// number of bad pw attemps this login
 	byte idle_tics;	// tics idle at password prompt
 	int connected;	// STATE()
@@ -2965,19 +2987,20 @@ struct descriptor_data {
 	int mail_to;	// name for mail system
 	int notes_id;	// idnum of player for notes-editing
 	any_vnum save_empire;	// for the text editor to know which empire to save
+	room_vnum save_room;	// for the text editor to know which room to save
 	bool allow_null;	// string editor can be empty/null
 	
 	int has_prompt;	// is the user at a prompt?
 	char inbuf[MAX_RAW_INPUT_LENGTH];	// buffer for raw input
 	char last_input[MAX_INPUT_LENGTH];	// the last input
-	char small_outbuf[SMALL_BUFSIZE];	// standard output buffer
-	char *output;	// ptr to the current output buffer
+	struct outbuf_chunk *output;	// queue of output waiting to be sent
+	struct outbuf_chunk *output_tail;	// last chunk in the output queue
+	int output_size;	// bytes waiting in the output queue
+	int output_peak;	// largest the output queue has been
+	bool output_overflow;	// hit the output limit; drops new output until the queue drains
 	char **history;	// History of commands, for ! mostly.
 	int history_pos;	// Circular array position.
-	int bufptr;	// ptr to end of current output
-	int bufspace;	// space left in the output buffer
 	bool data_left_to_write;	// indicates there is more data to write, to prevent an extra crlf
-	struct txt_block *large_outbuf;	// ptr to large buffer, if we need it
 	struct txt_q input;	// q of unprocessed input
 
 	char_data *character;	// linked to char
@@ -3318,10 +3341,29 @@ struct char_special_data {
 	int mana_regen;	// mana regen add
 	
 	int carry_items;	// Number of items carried
+	int command_trig_objs;	// carried/worn items with command triggers (live only)
 	int	timer;	// Timer for update
 };
 
 
+// one area of the character location grid (handler.c)
+struct char_grid_cell {
+	char_data *players;	// doubly-linked by next_in_grid/prev_in_grid
+	char_data *npcs;	// same
+};
+
+
+// for going through the characters near a location: see first_char_near()
+struct near_char_iterator {
+	int cell_x, cell_y;	// first grid cell of the search box
+	int width, height;	// size of the search box, in cells (it can wrap around the map)
+	int pos;	// which cell of the box it's on; width * height means the unplaced list
+	bool pc_only;	// skips NPCs
+	bool npcs;	// TRUE while it's on the current cell's NPCs
+	char_data *next;	// the character it will return next
+};
+
+
 // main character data for PC/NPC in-game
 struct char_data {
 	mob_vnum vnum;	// mob's vnum
@@ -3353,6 +3395,8 @@ struct char_data {
 
 	char_data *next_in_room;	// For room->people - list
 	char_data *next;	// For either monster or ppl-list
+	struct char_grid_cell *grid_cell;	// location grid cell this character is listed in (see handler.c)
+	char_data *prev_in_grid, *next_in_grid;	// doubly-linked list for grid_cell
 	char_data *next_fighting;	// For fighting list
 	
 	struct follow_type *followers;	// List of chars followers
@@ -3473,6 +3517,7 @@ struct crop_data {
 	struct spawn_info *spawns;	// mob spawn data
 	struct interaction_item *interactions;	// interaction items
 	
+	ush_int map_idx;	// position in map_crop_table (0 = not on the map yet)
 	UT_hash_handle hh;	// crop_table hash
 };
 
@@ -3661,14 +3706,21 @@ struct empire_storage_data {
 	obj_vnum vnum;	// what's stored
 	int amount;	// how much
 	int island;	// which island it's stored on
-
-	struct empire_storage_data *next;
+	int by_amount_pos;	// index in the empire's store_by_amount view
+	
+	unsigned long long hash_key;	// STORAGE_HASH_KEY(island, vnum)
+	UT_hash_handle hh;	// EMPIRE_STORAGE_HASH(emp) hash handle
+	struct empire_storage_data *next;	// EMPIRE_STORAGE(emp) linked list
 };
 
+// einv is hashed by island and vnum together
+#define STORAGE_HASH_KEY(island, vnum)  (((unsigned long long) (unsigned int) (island) << 32) | (unsigned int) (vnum))
+
 
 // list of rooms and buildings owned
 struct empire_territory_data {
 	room_data *room;	// pointer to territory location
+	room_vnum vnum;	// room's vnum, for territory_by_vnum
 	int population_timer;	// time to re-populate
 	
 	struct empire_npc_data *npcs;	// list of empire mobs that live here
@@ -3676,6 +3728,42 @@ struct empire_territory_data {
 	bool marked;	// for checking that rooms still exist
 	
 	struct empire_territory_data *next;	// linked list
+	UT_hash_handle hh;	// empire's territory_by_vnum hash
+};
+
+
+// one index key's share of an empire's territory list (see build_territory_indexes)
+struct empire_territory_index {
+	int key;	// building vnum or island id, depending on the index
+	struct empire_territory_ref *refs;	// matching territory, in territory-list order
+	struct empire_territory_ref *last_ref;	// end of refs, for appending
+	UT_hash_handle hh;	// hashed by key
+};
+
+
+// a territory entry listed in an empire_territory_index
+struct empire_territory_ref {
+	struct empire_territory_data *ter;
+	bitvector_t functions;	// FNC_x the room had when the index was built
+	struct empire_territory_ref *next;
+};
+
+
+// a city listed in a map grid cell it may cover (see build_city_coverage)
+struct city_coverage_data {
+	struct empire_city_data *city;
+	int x, y;	// city center
+	int radius;	// normal city radius (some tiles count at 3x)
+	struct city_coverage_data *next;	// in city-list order
+};
+
+
+// the cities that may cover one map grid cell
+struct city_coverage_cell {
+	int cell;	// map grid cell (y * width + x)
+	struct city_coverage_data *cities;	// LL
+	struct city_coverage_data *last_city;	// end of cities, for appending
+	UT_hash_handle hh;	// hashed by cell
 };
 
 
@@ -3744,15 +3832,26 @@ struct empire_data {
 	// linked lists
 	struct empire_political_data *diplomacy;
 	struct shipping_data *shipping_list;
-	struct empire_storage_data *store;
+	struct empire_storage_data *store;	// LL: store->next (also in store_hash)
 	struct empire_unique_storage *unique_store;	// LL: eus->next
 	struct empire_trade_data *trade;
 	struct empire_log_data *logs;
 	
 	// unsaved data
 	struct empire_territory_data *territory_list;	// linked list of buildings/rooms
+	struct empire_territory_data *territory_by_vnum;	// same entries as territory_list, hashed by room vnum
+	struct empire_territory_index *buildings_by_vnum;	// lazy index of territory_list by building vnum
+	struct empire_territory_index *functions_by_island;	// lazy index of territory with functions, by island id
+	bool territory_index_built;	// buildings_by_vnum/functions_by_island are up to date
 	struct empire_city_data *city_list;	// linked list of cities
+	struct city_coverage_cell *city_coverage;	// lazy index of which cities may cover each map grid cell
+	bool city_coverage_built;	// city_coverage is up to date
 	struct empire_workforce_tracker *ewt_tracker;	// workforce tracker
+	vehicle_data *vehicles;	// vehicles it owns (LL: next_owned)
+	struct empire_storage_data *store_hash;	// same entries as 'store', hashed by island+vnum
+	struct empire_storage_data **store_by_amount;	// lazy "most quantity first" view of 'store'
+	int store_by_amount_size;	// entries in store_by_amount
+	bool store_by_amount_dirty;	// view must be rebuilt before use
 	
 	// unsaved data
 	int city_terr;	// total territory IN cities
@@ -3873,6 +3972,62 @@ struct reboot_control_data {
 };
 
 
+// tracks time spent polling/reading/writing sockets in game_loop()
+struct io_timing_data {
+	unsigned long long last_usec;	// socket I/O time in the most recent pulse
+	unsigned long long max_usec;	// worst pulse since boot
+	unsigned long long total_usec;	// sum over all pulses (for the average)
+	unsigned long long total_ready;	// sum of ready descriptors over all pulses
+	unsigned long pulses;	// number of pulses measured
+};
+
+
+// for the heartbeat profiler (comm.c)
+#define HEARTBEAT_HISTOGRAM_SIZE  128	// log-scale buckets, for p99
+
+struct heartbeat_timing_data {
+	unsigned long calls;	// times the job ran
+	unsigned long long total_usec;	// sum of all runs
+	unsigned long long max_usec;	// slowest run
+	unsigned long overruns;	// runs that took a full pulse or more
+	unsigned long histogram[HEARTBEAT_HISTOGRAM_SIZE];	// runs by duration
+};
+
+
+struct heartbeat_job_data {
+	char *name;	// job name for 'show heartbeat'
+	struct heartbeat_timing_data since_boot;	// shown in-game
+	struct heartbeat_timing_data since_dump;	// written to HEARTBEAT_PROFILE_FILE
+};
+
+
+// for the budgeted job scheduler (comm.c): heavy periodic jobs that resume across pulses
+#define BUDGET_JOB(name)  bool (name)(bool start, unsigned long long deadline)
+#define BUDGET_JOB_CHECK  25	// budgeted jobs check the clock every this many items
+#define BUDGET_JOB_USEC  (OPT_USEC / 2)	// budgeted jobs may run until this far into a pulse
+#define BUDGET_JOB_MIN_USEC  5000	// ...but always get at least this much time per pulse
+
+// TRUE if a budgeted job has done at least 1 item and is past its deadline
+#define BUDGET_EXPIRED(deadline, count)  ((count) > 0 && ((count) % BUDGET_JOB_CHECK) == 0 && microtime() >= (deadline))
+
+struct budget_job_data {
+	char *name;	// shown in 'show heartbeat'
+	BUDGET_JOB(*func);	// works until the deadline; returns TRUE when finished
+	
+	bool queued;	// waiting or in progress
+	bool started;	// has had its first call this run
+	int profile_job;	// heartbeat_jobs entry for timing
+	unsigned long queued_pulse;	// pulse this run was queued on
+	unsigned long long run_usec;	// time spent so far on this run
+	
+	unsigned long runs;	// completed runs since startup
+	unsigned long last_pulses;	// pulses the last completed run spanned
+	unsigned long long last_usec;	// time spent on the last completed run
+	
+	struct budget_job_data *next;	// queue (LL)
+};
+
+
  //////////////////////////////////////////////////////////////////////////////
 //// OBJECT STRUCTS //////////////////////////////////////////////////////////
 
@@ -4083,6 +4238,7 @@ struct sector_data {
 	struct evolution_data *evolution;	// change over time
 	struct interaction_item *interactions;	// interaction items
 	
+	ush_int map_idx;	// position in map_sect_table (0 = not on the map yet)
 	UT_hash_handle hh;	// sector_table hash
 };
 
@@ -4098,16 +4254,28 @@ struct evolution_data {
 };
 
 
+// one tile in a map evolution pass (see run_map_evolutions)
+struct map_evolution_data {
+	room_vnum tile;	// map location
+	sector_data *original;	// its sector when it was evaluated
+	sector_vnum becomes;	// what it will evolve into, or NOTHING
+};
+
+
 // for iteration of map locations by sector
 struct sector_index_type {
 	sector_vnum vnum;	// which sect
 	
-	struct map_data *sect_rooms;	// LL of rooms
-	int sect_count;	// how many rooms in the list
+	room_vnum *sect_rooms;	// array of map tiles with this sect (see world_map.sect_pos)
+	int num_sect_rooms;	// how many map tiles are in sect_rooms
+	int max_sect_rooms;	// allocated size of sect_rooms
+	int sect_count;	// how many rooms (map and interior) have this sect
 	
-	struct map_data *base_rooms;	// LL of rooms
 	int base_count;	// number of rooms with it as the base sect
 	
+	int *near_count;	// MAP_SIZE entries: tiles of this sect within near_distance of each tile (see map_tile_near_sector)
+	int near_distance;	// radius near_count was built for
+	
 	UT_hash_handle hh;	// sector_index hash handle
 };
 
@@ -4185,6 +4353,7 @@ struct vehicle_data {
 	// lists
 	struct vehicle_data *next;	// vehicle_list (global) linked list
 	struct vehicle_data *next_in_room;	// ROOM_VEHICLES(room) linked list
+	struct vehicle_data *next_owned;	// EMPIRE_VEHICLES(owner) linked list
 	UT_hash_handle hh;	// vehicle_table hash handle
 };
 
@@ -4255,6 +4424,8 @@ struct room_data {
 	
 	struct complex_room_data *complex; // for rooms that are buildings, inside, adventures, etc
 	byte light;  // number of light sources
+	int command_trig_objs;	// items here with command triggers (live only)
+	int command_trig_mobs;	// people here with command triggers (live only)
 	int exits_here;	// number of rooms that have complex->exits to this one
 	
 	struct depletion_data *depletion;	// resource depletion
@@ -4389,20 +4560,63 @@ struct track_data {
 };
 
 
-// data for the world map (world_map, land_map)
-struct map_data {
-	room_vnum vnum;	// corresponding room vnum (coordinates can be derived from here)
-	int island;	// the island id
-	
-	// three basic sector types
-	sector_data *sector_type;	// current sector
-	sector_data *base_sector;	// underlying current sector (e.g. plains under building)
-	sector_data *natural_sector;	// sector at time of map generation
+// data for the world map (world_map, land_map): packed parallel arrays indexed
+// by map tile vnum (the coordinates are derived from the vnum); read and write
+// these through the MAP_x() accessors in utils.h
+struct world_map_data {
+	// three basic sector types, as map_sect_table indexes
+	ush_int sector_type[MAP_SIZE];	// current sector
+	ush_int base_sector[MAP_SIZE];	// underlying current sector (e.g. plains under building)
+	ush_int natural_sector[MAP_SIZE];	// sector at time of map generation
 	
-	crop_data *crop_type;	// possible crop type
+	ush_int crop_type[MAP_SIZE];	// possible crop type, as a map_crop_table index (0 = none)
+	int island[MAP_SIZE];	// the island id
 	
 	// lists
-	struct map_data *next_in_sect;	// LL of all map locations of a given sect
-	struct map_data *next_in_base_sect;	// LL for base sect
-	struct map_data *next;	// linked list of non-ocean tiles, for iterating
+	int sect_pos[MAP_SIZE];	// position in its sector index's sect_rooms array
+	room_vnum next[MAP_SIZE];	// linked list of non-ocean tiles, for iterating (NOWHERE terminates)
+};
+
+
+// save tracking for one world block file (world_blocks, by GET_WORLD_BLOCK)
+struct world_block_data {
+	int rooms;	// rooms in the world_table that belong to this block
+	bool dirty;	// something in it changed since it was last written
+};
+
+
+// binary base map file (WORLD_MAP_BINARY_FILE): one header, then num_tiles
+// fixed-width tile records in the host's byte order
+#define WORLD_MAP_FILE_MAGIC  "EmpMap\n"	// 8 bytes with the terminator
+#define WORLD_MAP_FILE_VERSION  1	// bump this if world_map_file_tile changes
+#define WORLD_MAP_FILE_BYTE_ORDER  0x01020304	// reads back differently on other-endian hosts
+
+struct world_map_file_header {
+	char magic[8];	// WORLD_MAP_FILE_MAGIC
+	unsigned int version;	// WORLD_MAP_FILE_VERSION
+	unsigned int byte_order;	// WORLD_MAP_FILE_BYTE_ORDER
+	unsigned int tile_size;	// sizeof(struct world_map_file_tile)
+	int width, height;	// map size it was saved from (informational)
+	int num_tiles;	// number of tile records after the header
+	unsigned int checksum;	// world_map_file_checksum() of the tile records
+};
+
+// same fields as a line of the text base map
+struct world_map_file_tile {
+	int x, y;	// coordinates
+	int island;	// island id
+	int sector_type, base_sector, natural_sector;	// sector vnums (or -1)
+	int crop_type;	// crop vnum (or -1)
+};
+
+
+// a read-only look at one map tile that doesn't load a room (see get_map_tile)
+struct map_tile_data {
+	room_vnum vnum;	// map location
+	room_data *room;	// the live room, if one is loaded; if not, the tile has no building, owner, or affects
+	
+	// copied from the room, if there is one, or the world_map
+	sector_data *sect;
+	sector_data *base_sect;
+	crop_data *crop;
 };
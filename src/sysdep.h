@@ -193,6 +193,10 @@ extern void abort (), exit ();
 #define assert(arg)
 #endif
 
+#ifdef EMPIRE_THREADS
+#include <pthread.h>
+#endif
+
 
 /* Header files only used in comm.c and some of the utils */
 
@@ -250,21 +254,49 @@ struct in_addr {
 # endif
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+# include <sys/epoll.h>
+#endif
+
+#endif /* __COMM_C__ && EMPIRE_UTIL */
+
+
+/* Header files that are only used in comm.c and protocol.c */
+#if defined(__COMM_C__) || defined(__PROTOCOL_C__)
+
 #ifdef HAVE_SYS_UIO_H
 # include <sys/uio.h>
 #endif
 
-#endif /* __COMM_C__ && EMPIRE_UTIL */
+#endif /* __COMM_C__ && __PROTOCOL_C__ */
+
+
+/* Header files that are only used in act.other.c and db.player.c */
+#if defined(__ACT_OTHER_C__) || defined(__DB_PLAYER_C__)
 
+#ifdef HAVE_SYS_STAT_H
+# include <sys/stat.h>
+#endif
 
-/* Header files that are only used in act.other.c */
-#ifdef __ACT_OTHER_C__
+#endif /* __ACT_OTHER_C__ && __DB_PLAYER_C__ */
+
+
+/* Header files that are only used in db.world.c and the map utils */
+#if defined(__DB_WORLD_C__) || defined(EMPIRE_UTIL)
+
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
 
 #ifdef HAVE_SYS_STAT_H
 # include <sys/stat.h>
 #endif
 
-#endif /* __ACT_OTHER_C__ */
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
+
+#endif /* __DB_WORLD_C__ && EMPIRE_UTIL */
 
 
 /* Basic system dependencies *******************************************/
@@ -21,7 +21,8 @@
 *  2a. you may have to "chmod u+x map" to run it
 *  2b. you may need to raise the stack size limit: ulimit -s <limit>
 *  2c. this will generate new .wld files and a new index -- you must to delete
-*      your lib/world/base_map file or it will combine with your new .wld files
+*      your lib/world/base_map and base_map.bin files or they will combine
+*      with your new .wld files
 *  3. make sure the stats output looks good
 *  4. you can use the map.txt data file with your map.php image generator to
 *     see if the world looks good to you
@@ -0,0 +1,193 @@
+/* ************************************************************************
+*  file:  mapconv.c                                       EmpireMUD 2.0b5 *
+*  Usage: converts the base map between the text and binary formats       *
+*                                                                         *
+*  The mud reads lib/world/base_map.bin if it's usable, and falls back to *
+*  the older text lib/world/base_map, then saves the binary one. Use this *
+*  to convert a world by hand, or to get a readable copy of a binary map: *
+*                                                                         *
+*  > ./mapconv tobinary <text file> <binary file>                         *
+*  > ./mapconv totext <binary file> <text file>                           *
+*                                                                         *
+*  NOTE: Run this while the mud is down; it overwrites the output file    *
+*                                                                         *
+*  EmpireMUD code base by Paul Clarke, (C) 2000-2015                      *
+*  All rights reserved.  See license.doc for complete information.        *
+*                                                                         *
+*  EmpireMUD based upon CircleMUD 3.0, bpl 17, by Jeremy Elson.           *
+*  CircleMUD (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+*  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+************************************************************************ */
+
+#include "conf.h"
+#include "sysdep.h"
+
+#include "structs.h"
+#include "utils.h"
+
+
+/**
+* Same as world_map_file_checksum() in db.world.c (32-bit FNV-1a).
+*
+* @param const struct world_map_file_tile *tiles The tile records.
+* @param int num_tiles How many records there are.
+* @return unsigned int The checksum.
+*/
+unsigned int map_checksum(const struct world_map_file_tile *tiles, int num_tiles) {
+	const unsigned char *ptr = (const unsigned char*) tiles;
+	size_t iter, size = num_tiles * sizeof(struct world_map_file_tile);
+	unsigned int hash = 2166136261U;
+	
+	for (iter = 0; iter < size; ++iter) {
+		hash ^= ptr[iter];
+		hash *= 16777619U;
+	}
+	
+	return hash;
+}
+
+
+/**
+* Converts a text base map to the binary format.
+*
+* @param char *from The text file to read.
+* @param char *to The binary file to write.
+* @return int 0 on success, 1 on error.
+*/
+int to_binary(char *from, char *to) {
+	struct world_map_file_header header;
+	struct world_map_file_tile *tiles = NULL, *tile;
+	int num_tiles = 0, max_tiles = 0, line_num = 0;
+	char line[256];
+	FILE *in, *out;
+	
+	if (!(in = fopen(from, "r"))) {
+		fprintf(stderr, "Unable to open %s: %s\n", from, strerror(errno));
+		return 1;
+	}
+	
+	while (fgets(line, sizeof(line), in)) {
+		++line_num;
+		if (*line == '$') {
+			break;
+		}
+		
+		if (num_tiles >= max_tiles) {
+			max_tiles = MAX(1024, max_tiles * 2);
+			if (!(tiles = realloc(tiles, max_tiles * sizeof(struct world_map_file_tile)))) {
+				fprintf(stderr, "Out of memory at line %d\n", line_num);
+				fclose(in);
+				return 1;
+			}
+		}
+		
+		// x y island sect base natural crop
+		tile = &tiles[num_tiles];
+		if (sscanf(line, "%d %d %d %d %d %d %d", &tile->x, &tile->y, &tile->island, &tile->sector_type, &tile->base_sector, &tile->natural_sector, &tile->crop_type) != 7) {
+			fprintf(stderr, "Skipping bad line %d: %s", line_num, line);
+			continue;
+		}
+		++num_tiles;
+	}
+	fclose(in);
+	
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, WORLD_MAP_FILE_MAGIC, sizeof(header.magic));
+	header.version = WORLD_MAP_FILE_VERSION;
+	header.byte_order = WORLD_MAP_FILE_BYTE_ORDER;
+	header.tile_size = sizeof(struct world_map_file_tile);
+	header.width = MAP_WIDTH;
+	header.height = MAP_HEIGHT;
+	header.num_tiles = num_tiles;
+	header.checksum = map_checksum(tiles, num_tiles);
+	
+	if (!(out = fopen(to, "wb"))) {
+		fprintf(stderr, "Unable to open %s for writing: %s\n", to, strerror(errno));
+		free(tiles);
+		return 1;
+	}
+	if (fwrite(&header, sizeof(header), 1, out) != 1 || (num_tiles > 0 && fwrite(tiles, sizeof(struct world_map_file_tile), num_tiles, out) != num_tiles)) {
+		fprintf(stderr, "Unable to write %s: %s\n", to, strerror(errno));
+		fclose(out);
+		free(tiles);
+		return 1;
+	}
+	fclose(out);
+	free(tiles);
+	
+	printf("Wrote %d tiles to %s\n", num_tiles, to);
+	return 0;
+}
+
+
+/**
+* Converts a binary base map to the text format.
+*
+* @param char *from The binary file to read.
+* @param char *to The text file to write.
+* @return int 0 on success, 1 on error.
+*/
+int to_text(char *from, char *to) {
+	struct world_map_file_header header;
+	struct world_map_file_tile *tiles, *tile;
+	FILE *in, *out;
+	int iter;
+	
+	if (!(in = fopen(from, "rb"))) {
+		fprintf(stderr, "Unable to open %s: %s\n", from, strerror(errno));
+		return 1;
+	}
+	if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, WORLD_MAP_FILE_MAGIC, sizeof(header.magic))) {
+		fprintf(stderr, "%s is not a binary base map\n", from);
+		fclose(in);
+		return 1;
+	}
+	if (header.byte_order != WORLD_MAP_FILE_BYTE_ORDER || header.version != WORLD_MAP_FILE_VERSION || header.tile_size != sizeof(struct world_map_file_tile) || header.num_tiles < 0) {
+		fprintf(stderr, "%s has an unknown version or byte order\n", from);
+		fclose(in);
+		return 1;
+	}
+	
+	if (!(tiles = calloc(MAX(1, header.num_tiles), sizeof(struct world_map_file_tile)))) {
+		fprintf(stderr, "Out of memory\n");
+		fclose(in);
+		return 1;
+	}
+	if ((header.num_tiles > 0 && fread(tiles, sizeof(struct world_map_file_tile), header.num_tiles, in) != header.num_tiles) || map_checksum(tiles, header.num_tiles) != header.checksum) {
+		fprintf(stderr, "%s is truncated or has a bad checksum\n", from);
+		fclose(in);
+		free(tiles);
+		return 1;
+	}
+	fclose(in);
+	
+	if (!(out = fopen(to, "w"))) {
+		fprintf(stderr, "Unable to open %s for writing: %s\n", to, strerror(errno));
+		free(tiles);
+		return 1;
+	}
+	for (iter = 0; iter < header.num_tiles; ++iter) {
+		// x y island sect base natural crop
+		tile = &tiles[iter];
+		fprintf(out, "%d %d %d %d %d %d %d\n", tile->x, tile->y, tile->island, tile->sector_type, tile->base_sector, tile->natural_sector, tile->crop_type);
+	}
+	fclose(out);
+	free(tiles);
+	
+	printf("Wrote %d tiles to %s\n", header.num_tiles, to);
+	return 0;
+}
+
+
+int main(int argc, char **argv) {
+	if (argc == 4 && !strcmp(argv[1], "tobinary")) {
+		return to_binary(argv[2], argv[3]);
+	}
+	else if (argc == 4 && !strcmp(argv[1], "totext")) {
+		return to_text(argv[2], argv[3]);
+	}
+	
+	fprintf(stderr, "Usage: %s tobinary <text file> <binary file>\n", argv[0]);
+	fprintf(stderr, "       %s totext <binary file> <text file>\n", argv[0]);
+	return 1;
+}
@@ -4265,30 +4265,6 @@ int count_flagged_sect_between(bitvector_t sectf_bits, room_data *start, room_da
 }
 
 
-/**
-* Computes the distance to the nearest connected player.
-*
-* @param room_data *room Origin spot
-* @return int Distance to the nearest player (> MAP_SIZE if no players)
-*/
-int distance_to_nearest_player(room_data *room) {
-	descriptor_data *d_iter;
-	char_data *vict;
-	int dist, best = MAP_SIZE * 2;
-	
-	for (d_iter = descriptor_list; d_iter; d_iter = d_iter->next) {
-		if ((vict = d_iter->character) && IN_ROOM(vict)) {
-			dist = compute_distance(room, IN_ROOM(vict));
-			if (dist < best) {
-				best = dist;
-			}
-		}
-	}
-	
-	return best;
-}
-
-
 /**
 * This finds the ultimate map point for a given room, resolving any number of
 * layers of boats and home rooms.
@@ -4476,19 +4452,38 @@ bool find_sect_within_distance_from_char(char_data *ch, sector_vnum sect, int di
 */
 bool find_sect_within_distance_from_room(room_data *room, sector_vnum sect, int distance) {
 	room_data *real = get_map_location_for(room);
+	
+	if (!real || GET_ROOM_VNUM(real) >= MAP_SIZE) {	// no map location
+		return FALSE;
+	}
+	
+	return find_sect_within_distance_from_tile(GET_ROOM_VNUM(real), sect, distance);
+}
+
+
+/**
+* This determines if a map tile is close enough to a given sect. It checks the
+* world_map directly, so it doesn't load any rooms.
+*
+* @param room_vnum tile The map tile to check from.
+* @param sector_vnum sect Sector vnum
+* @param int distance how far away to check
+* @return bool TRUE if the sect is found
+*/
+bool find_sect_within_distance_from_tile(room_vnum tile, sector_vnum sect, int distance) {
 	sector_data *find = sector_proto(sect);
+	int x, y, start_x, start_y, new_x, new_y;
 	bool found = FALSE;
-	room_data *shift;
-	int x, y;
 	
-	if (!real) {	// no map location
+	if (!find || tile < 0 || tile >= MAP_SIZE) {
 		return FALSE;
 	}
 	
+	start_x = MAP_X_COORD(tile);
+	start_y = MAP_Y_COORD(tile);
 	for (x = -1 * distance; x <= distance && !found; ++x) {
 		for (y = -1 * distance; y <= distance && !found; ++y) {
-			shift = real_shift(real, x, y);
-			if (shift && SECT(shift) == find && compute_distance(real, shift) <= distance) {
+			if (get_coord_shift(start_x, start_y, x, y, &new_x, &new_y) && MAP_SECT(MAP_TILE(new_x, new_y)) == find && compute_map_distance(start_x, start_y, new_x, new_y) <= distance) {
 				found = TRUE;
 			}
 		}
@@ -4655,7 +4650,7 @@ int GET_ISLAND_ID(room_data *room) {
 	room_data *map = get_map_location_for(room);
 	
 	if (map && GET_ROOM_VNUM(map) < MAP_SIZE) {
-		return world_map[FLAT_X_COORD(map)][FLAT_Y_COORD(map)].island;
+		return MAP_ISLAND(GET_ROOM_VNUM(map));
 	}
 	else {
 		return NO_ISLAND;
@@ -4673,7 +4668,7 @@ void SET_ISLAND_ID(room_data *room, int island) {
 	extern bool world_map_needs_save;
 	
 	if (GET_ROOM_VNUM(room) < MAP_SIZE) {
-		world_map[FLAT_X_COORD(room)][FLAT_Y_COORD(room)].island = island;
+		MAP_ISLAND(GET_ROOM_VNUM(room)) = island;
 		world_map_needs_save = TRUE;
 	}
 }
@@ -4713,6 +4708,63 @@ void lock_icon(room_data *room, struct icon_data *use_icon) {
 		icon = get_icon_from_set(GET_SECT_ICONS(SECT(room)), season);
 	}
 	ROOM_CUSTOM_ICON(room) = str_dup(icon->icon);
+	invalidate_map_icon(GET_ROOM_VNUM(room));
+}
+
+
+/**
+* Gets a read-only view of one map tile, without loading a room for it. If the
+* tile has a live room, that room is included and its data is used. If not,
+* the tile is 'blank': it has no building, owner, affects, or contents (see
+* CAN_UNLOAD_MAP_ROOM), so only its sectors and crop matter. Use the TILE_x()
+* macros on the result, and only use TILE_ROOM() if it's not NULL.
+*
+* @param room_vnum vnum The map location.
+* @param struct map_tile_data *tile The view to fill in.
+* @return bool TRUE if vnum is on the map, FALSE if not (tile is not filled in).
+*/
+bool get_map_tile(room_vnum vnum, struct map_tile_data *tile) {
+	if (vnum < 0 || vnum >= MAP_SIZE) {
+		return FALSE;
+	}
+	
+	tile->vnum = vnum;
+	if ((tile->room = real_real_room(vnum))) {
+		tile->sect = SECT(tile->room);
+		tile->base_sect = BASE_SECT(tile->room);
+		tile->crop = ROOM_CROP(tile->room);
+	}
+	else {
+		tile->sect = MAP_SECT(vnum);
+		tile->base_sect = MAP_BASE_SECT(vnum);
+		tile->crop = MAP_CROP(vnum);
+	}
+	
+	return TRUE;
+}
+
+
+/**
+* Like real_shift(), but gets a read-only map tile view instead of loading
+* the room (see get_map_tile).
+*
+* @param room_vnum origin The map location to start from.
+* @param int x_shift How far to move east/west
+* @param int y_shift How far to move north/south
+* @param struct map_tile_data *tile The view to fill in.
+* @return bool TRUE if the tile was found, FALSE if the shift goes off the map (tile is not filled in).
+*/
+bool get_map_tile_shift(room_vnum origin, int x_shift, int y_shift, struct map_tile_data *tile) {
+	int x_coord, y_coord;
+	
+	if (origin < 0 || origin >= MAP_SIZE) {
+		return FALSE;
+	}
+	if (!get_coord_shift(MAP_X_COORD(origin), MAP_Y_COORD(origin), x_shift, y_shift, &x_coord, &y_coord)) {
+		return FALSE;
+	}
+	
+	return get_map_tile(MAP_TILE(x_coord, y_coord), tile);
 }
 
 
@@ -311,6 +311,7 @@ extern int GET_MAX_BLOOD(char_data *ch);	// this one is different than the other
 #define FIGHTING(ch)  ((ch)->char_specials.fighting.victim)
 #define FIGHT_MODE(ch)  ((ch)->char_specials.fighting.mode)
 #define FIGHT_WAIT(ch)  ((ch)->char_specials.fighting.wait)
+#define GET_COMMAND_TRIG_OBJS(ch)  ((ch)->char_specials.command_trig_objs)
 #define GET_DRIVING(ch)  ((ch)->char_specials.driving)
 #define GET_EMPIRE_NPC_DATA(ch)  ((ch)->char_specials.empire_npc)
 #define GET_FED_ON_BY(ch)  ((ch)->char_specials.fed_on_by)
@@ -477,9 +478,11 @@ extern int GET_MAX_BLOOD(char_data *ch);	// this one is different than the other
 #define EMPIRE_DESCRIPTION(emp)  ((emp)->description)
 #define EMPIRE_DIPLOMACY(emp)  ((emp)->diplomacy)
 #define EMPIRE_STORAGE(emp)  ((emp)->store)
+#define EMPIRE_STORAGE_HASH(emp)  ((emp)->store_hash)
 #define EMPIRE_TRADE(emp)  ((emp)->trade)
 #define EMPIRE_LOGS(emp)  ((emp)->logs)
 #define EMPIRE_TERRITORY_LIST(emp)  ((emp)->territory_list)
+#define EMPIRE_TERRITORY_BY_VNUM(emp)  ((emp)->territory_by_vnum)
 #define EMPIRE_CITY_LIST(emp)  ((emp)->city_list)
 #define EMPIRE_CITY_TERRITORY(emp)  ((emp)->city_terr)
 #define EMPIRE_OUTSIDE_TERRITORY(emp)  ((emp)->outside_terr)
@@ -500,12 +503,14 @@ extern int GET_MAX_BLOOD(char_data *ch);	// this one is different than the other
 #define EMPIRE_SHIPPING_LIST(emp)  ((emp)->shipping_list)
 #define EMPIRE_SORT_VALUE(emp)  ((emp)->sort_value)
 #define EMPIRE_UNIQUE_STORAGE(emp)  ((emp)->unique_store)
+#define EMPIRE_VEHICLES(emp)  ((emp)->vehicles)
 #define EMPIRE_WORKFORCE_TRACKER(emp)  ((emp)->ewt_tracker)
 #define EMPIRE_ISLANDS(emp)  ((emp)->islands)
 #define EMPIRE_TOP_SHIPPING_ID(emp)  ((emp)->top_shipping_id)
 
 // helpers
 #define EMPIRE_HAS_TECH(emp, num)  (EMPIRE_TECH((emp), (num)) > 0)
+#define EMPIRE_STORAGE_CHANGED(emp)  ((emp)->store_by_amount_dirty = TRUE)	// call when einv entries are added/removed (see update_storage_order for amounts)
 #define EMPIRE_IS_TIMED_OUT(emp)  (EMPIRE_LAST_LOGON(emp) + (config_get_int("whole_empire_timeout") * SECS_PER_REAL_DAY) < time(0))
 #define GET_TOTAL_WEALTH(emp)  (EMPIRE_WEALTH(emp) + (EMPIRE_COINS(emp) * COIN_VALUE))
 #define EXPLICIT_BANNER_TERMINATOR(emp)  (EMPIRE_BANNER_HAS_UNDERLINE(emp) ? "\t0" : "")
@@ -579,6 +584,35 @@ extern int GET_MAX_BLOOD(char_data *ch);	// this one is different than the other
 extern int X_COORD(room_data *room);	// formerly #define X_COORD(room)  FLAT_X_COORD(get_map_location_for(room))
 extern int Y_COORD(room_data *room);	// formerly #define Y_COORD(room)  FLAT_Y_COORD(get_map_location_for(room))
 
+// world_map accessors: 'tile' is a map vnum (see struct world_map_data)
+#define MAP_TILE(x, y)  ((y) * MAP_WIDTH + (x))
+#define MAP_SECT(tile)  (map_sect_table[world_map.sector_type[(tile)]])
+#define MAP_BASE_SECT(tile)  (map_sect_table[world_map.base_sector[(tile)]])
+#define MAP_NATURAL_SECT(tile)  (map_sect_table[world_map.natural_sector[(tile)]])
+#define MAP_CROP(tile)  (map_crop_table[world_map.crop_type[(tile)]])
+#define MAP_ISLAND(tile)  (world_map.island[(tile)])
+#define MAP_NEXT_LAND(tile)  (world_map.next[(tile)])
+
+// only perform_change_sect/perform_change_base_sect may change sector_type/base_sector
+#define SET_MAP_NATURAL_SECT(tile, st)  (world_map.natural_sector[(tile)] = map_sect_index(st))
+#define SET_MAP_CROP(tile, cp)  (world_map.crop_type[(tile)] = map_crop_index(cp))
+
+// map tile views: read-only, and they never load a room (see get_map_tile)
+#define TILE_VNUM(tile)  ((tile)->vnum)
+#define TILE_ROOM(tile)  ((tile)->room)
+#define TILE_SECT(tile)  ((tile)->sect)
+#define TILE_BASE_SECT(tile)  ((tile)->base_sect)
+#define TILE_CROP(tile)  ((tile)->crop)
+#define TILE_AFF_FLAGGED(tile, flag)  (TILE_ROOM(tile) && ROOM_AFF_FLAGGED(TILE_ROOM(tile), (flag)))
+#define TILE_BLD_FLAGGED(tile, flag)  (TILE_ROOM(tile) && ROOM_BLD_FLAGGED(TILE_ROOM(tile), (flag)))
+#define TILE_BUILDING_VNUM(tile)  (TILE_ROOM(tile) ? BUILDING_VNUM(TILE_ROOM(tile)) : NOTHING)
+#define TILE_SECT_FLAGGED(tile, flg)  SECT_FLAGGED(TILE_SECT(tile), (flg))
+
+// these give the same result as the room versions would for a tile with no room loaded
+#define TILE_IS_CLOSED(tile)  (TILE_ROOM(tile) ? ROOM_IS_CLOSED(TILE_ROOM(tile)) : TILE_SECT_FLAGGED((tile), SECTF_INSIDE | SECTF_ADVENTURE | SECTF_MAP_BUILDING))
+#define TILE_IS_DARK(tile)  (TILE_ROOM(tile) ? IS_DARK(TILE_ROOM(tile)) : (!TILE_SECT_FLAGGED((tile), SECTF_MAP_BUILDING | SECTF_INSIDE) && weather_info.sunlight == SUN_DARK))
+#define TILE_IS_REAL_LIGHT(tile)  (TILE_ROOM(tile) ? IS_REAL_LIGHT(TILE_ROOM(tile)) : (!TILE_IS_DARK(tile) || TILE_SECT_FLAGGED((tile), SECTF_INSIDE)))
+
 // wrap x/y "around the edge"
 #define WRAP_X_COORD(x)  (WRAP_X ? (((x) < 0) ? ((x) + MAP_WIDTH) : (((x) >= MAP_WIDTH) ? ((x) - MAP_WIDTH) : (x))) : MAX(0, MIN(MAP_WIDTH-1, (x))))
 #define WRAP_Y_COORD(y)  (WRAP_Y ? (((y) < 0) ? ((y) + MAP_HEIGHT) : (((y) >= MAP_HEIGHT) ? ((y) - MAP_HEIGHT) : (y))) : MAX(0, MIN(MAP_HEIGHT-1, (y))))
@@ -1028,6 +1062,8 @@ extern int Y_COORD(room_data *room);	// formerly #define Y_COORD(room)  FLAT_Y_C
 #define ROOM_AFF_FLAGS(room)  ((room)->affects)
 #define ROOM_AFFECTS(room)  ((room)->af)
 #define ROOM_BASE_FLAGS(room)  ((room)->base_affects)
+#define ROOM_COMMAND_TRIG_MOBS(room)  ((room)->command_trig_mobs)
+#define ROOM_COMMAND_TRIG_OBJS(room)  ((room)->command_trig_objs)
 #define ROOM_CONTENTS(room)  ((room)->contents)
 #define ROOM_CROP(room)  ((room)->crop_type)
 #define ROOM_DEPLETION(room)  ((room)->depletion)
@@ -1424,13 +1460,15 @@ extern bool find_flagged_sect_within_distance_from_char(char_data *ch, bitvector
 extern bool find_flagged_sect_within_distance_from_room(room_data *room, bitvector_t with_flags, bitvector_t without_flags, int distance);
 extern bool find_sect_within_distance_from_char(char_data *ch, sector_vnum sect, int distance);
 extern bool find_sect_within_distance_from_room(room_data *room, sector_vnum sect, int distance);
+extern bool find_sect_within_distance_from_tile(room_vnum tile, sector_vnum sect, int distance);
 extern int compute_map_distance(int x1, int y1, int x2, int y2);
 #define compute_distance(from, to)  compute_map_distance(X_COORD(from), Y_COORD(from), X_COORD(to), Y_COORD(to))
 extern int count_adjacent_sectors(room_data *room, sector_vnum sect, bool count_original_sect);
-extern int distance_to_nearest_player(room_data *room);
 extern bool get_coord_shift(int start_x, int start_y, int x_shift, int y_shift, int *new_x, int *new_y);
 extern int get_direction_to(room_data *from, room_data *to);
 extern room_data *get_map_location_for(room_data *room);
+extern bool get_map_tile(room_vnum vnum, struct map_tile_data *tile);
+extern bool get_map_tile_shift(room_vnum origin, int x_shift, int y_shift, struct map_tile_data *tile);
 extern room_data *real_shift(room_data *origin, int x_shift, int y_shift);
 extern room_data *straight_line(room_data *origin, room_data *destination, int iter);
 extern sector_data *find_first_matching_sector(bitvector_t with_flags, bitvector_t without_flags);
@@ -1463,6 +1501,8 @@ void gain_condition(char_data *ch, int condition, int value);
 
 // utils from mapview.c
 extern bool adjacent_room_is_light(room_data *room);
+void clear_map_icon_cache(void);
+void invalidate_map_icon(room_vnum vnum);
 void look_at_room_by_loc(char_data *ch, room_data *room, bitvector_t options);
 #define look_at_room(ch)  look_at_room_by_loc((ch), IN_ROOM(ch), NOBITS)
 
@@ -171,7 +171,7 @@ room_data *get_vehicle_interior(vehicle_data *veh) {
 	attach_building_to_room(bld, room, TRUE);
 	COMPLEX_DATA(room)->home_room = NULL;
 	SET_BIT(ROOM_AFF_FLAGS(room), ROOM_AFF_IN_VEHICLE);
-	SET_BIT(ROOM_BASE_FLAGS(room), ROOM_AFF_IN_VEHICLE);
+	set_room_base_flags(room, ROOM_AFF_IN_VEHICLE);
 	
 	// attach
 	COMPLEX_DATA(room)->vehicle = veh;
@@ -821,6 +821,7 @@ vehicle_data *read_vehicle(any_vnum vnum, bool with_triggers) {
 	
 	// new vehicle setup
 	VEH_OWNER(veh) = NULL;
+	veh->next_owned = NULL;
 	VEH_SCALE_LEVEL(veh) = 0;	// unscaled
 	VEH_HEALTH(veh) = VEH_MAX_HEALTH(veh);
 	VEH_CONTAINS(veh) = NULL;
@@ -1244,7 +1245,7 @@ vehicle_data *unstore_vehicle_from_file(FILE *fl, any_vnum vnum) {
 			case 'O': {
 				if (OBJ_FILE_TAG(line, "Owner:", length)) {
 					if (sscanf(line + length + 1, "%d", &i_in[0])) {
-						VEH_OWNER(veh) = real_empire(i_in[0]);
+						set_vehicle_owner(veh, real_empire(i_in[0]));
 					}
 				}
 				break;
@@ -1716,7 +1717,7 @@ void convert_one_obj_to_vehicle(obj_data *obj) {
 	}
 	
 	// convert traits
-	VEH_OWNER(veh) = real_empire(obj->last_empire_id);
+	set_vehicle_owner(veh, real_empire(obj->last_empire_id));
 	VEH_SCALE_LEVEL(veh) = GET_OBJ_CURRENT_SCALE_LEVEL(obj);
 	
 	// type-based traits
@@ -1727,14 +1728,14 @@ void convert_one_obj_to_vehicle(obj_data *obj) {
 				
 				// detect owner from room
 				if (ROOM_OWNER(main_room)) {
-					VEH_OWNER(veh) = ROOM_OWNER(main_room);
+					set_vehicle_owner(veh, ROOM_OWNER(main_room));
 				}
 				
 				// apply vehicle aff
 				LL_FOREACH2(interior_room_list, room_iter, next_interior) {
 					if (room_iter == main_room || HOME_ROOM(room_iter) == main_room) {
 						SET_BIT(ROOM_AFF_FLAGS(room_iter), ROOM_AFF_IN_VEHICLE);
-						SET_BIT(ROOM_BASE_FLAGS(room_iter), ROOM_AFF_IN_VEHICLE);
+						set_room_base_flags(room_iter, ROOM_AFF_IN_VEHICLE);
 					}
 				}
 			}
@@ -1748,7 +1749,7 @@ void convert_one_obj_to_vehicle(obj_data *obj) {
 	
 	// did we successfully get an owner? try the room it's in
 	if (!VEH_OWNER(veh)) {
-		VEH_OWNER(veh) = ROOM_OWNER(room);
+		set_vehicle_owner(veh, ROOM_OWNER(room));
 	}
 	
 	// remove the object
@@ -1803,7 +1804,7 @@ void b3_8_ship_update(void) {
 	HASH_ITER(hh, world_table, room, next_room) {
 		if (IS_SET(ROOM_AFF_FLAGS(room) | ROOM_BASE_FLAGS(room), ROOM_AFF_SHIP_PRESENT)) {
 			REMOVE_BIT(ROOM_AFF_FLAGS(room), ROOM_AFF_SHIP_PRESENT);
-			REMOVE_BIT(ROOM_BASE_FLAGS(room), ROOM_AFF_SHIP_PRESENT);
+			remove_room_base_flags(room, ROOM_AFF_SHIP_PRESENT);
 			++changed;
 		}
 	}
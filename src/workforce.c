@@ -34,6 +34,9 @@
 *   Vehicle Chore Functions
 */
 
+// the hourly chore cycle is spread over this many pulses (leaving some slack before the next hour)
+#define CHORE_CYCLE_PULSES  (SECS_PER_MUD_HOUR * PASSES_PER_SEC * 3 / 4)
+
 // for territory iteration
 struct empire_territory_data *global_next_territory_entry = NULL;
 
@@ -60,7 +63,6 @@ void vehicle_chore_repair(empire_data *emp, vehicle_data *veh);
 
 // other locals
 int empire_chore_limit(empire_data *emp, int island_id, int chore);
-int sort_einv(struct empire_storage_data *a, struct empire_storage_data *b);
 
 // external functions
 void empire_skillup(empire_data *emp, any_vnum ability, double amount);	// skills.c
@@ -572,45 +574,132 @@ bool can_gain_chore_resource_from_interaction(empire_data *emp, room_data *room,
 
 
 /**
-* This runs once per mud hour to update all empire chores.
+* Finishes an empire's chore cycle: runs its vehicle chores and frees the
+* workforce tracker.
+*
+* @param empire_data *emp The empire whose territory chores are all done.
 */
-void chore_update(void) {
+static void finish_empire_chores(empire_data *emp) {
 	void ewt_free_tracker(struct empire_workforce_tracker **tracker);
 	
-	struct empire_territory_data *ter;
 	vehicle_data *veh, *next_veh;
-	empire_data *emp, *next_emp;
 	
+	LL_FOREACH_SAFE2(EMPIRE_VEHICLES(emp), veh, next_veh, next_owned) {
+		process_one_vehicle_chore(emp, veh);
+	}
+	
+	EMPIRE_NEEDS_SAVE(emp) = TRUE;
+	
+	// no longer need this -- free up the tracker
+	ewt_free_tracker(&EMPIRE_WORKFORCE_TRACKER(emp));
+}
+
+
+/**
+* @param empire_data *emp An empire.
+* @return bool TRUE if that empire's workforce runs this hour.
+*/
+static bool empire_has_active_workforce(empire_data *emp) {
 	int time_to_empire_emptiness = config_get_int("time_to_empire_emptiness") * SECS_PER_REAL_WEEK;
+	
+	// skip idle empires
+	if (EMPIRE_LAST_LOGON(emp) + time_to_empire_emptiness < time(0)) {
+		return FALSE;
+	}
+	return EMPIRE_HAS_TECH(emp, TECH_WORKFORCE);
+}
 
-	HASH_ITER(hh, empire_table, emp, next_emp) {
-		// skip idle empires
-		if (EMPIRE_LAST_LOGON(emp) + time_to_empire_emptiness < time(0)) {
+
+/**
+* This runs once per mud hour to update all empire chores. It is a budgeted
+* job that is paced to spread the work over CHORE_CYCLE_PULSES: each call
+* works through territory (one entry at a time, resuming from
+* global_next_territory_entry) until it has done its share of the cycle or
+* hits the deadline. Each territory entry is processed once per cycle.
+*
+* Empires come from a snapshot of vnums, in case one is deleted during the
+* cycle. Territory claimed during the cycle may wait until the next one.
+*
+* @param bool start TRUE on the first call of a new cycle.
+* @param unsigned long long deadline microtime() to stop by.
+* @return bool TRUE when every empire has been updated.
+*/
+BUDGET_JOB(chore_update_job) {
+	extern unsigned long pulse;
+	
+	static empire_vnum *emp_list = NULL;
+	static int num_emps = 0, emp_pos = 0;
+	static bool in_empire = FALSE;	// TRUE if emp_list[emp_pos] is partly done
+	static unsigned long start_pulse = 0;
+	static unsigned long long cycle_total = 0, cycle_done = 0;
+	
+	struct empire_territory_data *ter;
+	empire_data *emp, *next_emp;
+	unsigned long long quota;
+	int count = 0;
+	
+	if (start) {
+		if (emp_list) {
+			free(emp_list);
+		}
+		CREATE(emp_list, empire_vnum, MAX(1, HASH_CNT(hh, empire_table)));
+		num_emps = 0;
+		cycle_total = cycle_done = 0;
+		
+		HASH_ITER(hh, empire_table, emp, next_emp) {
+			if (empire_has_active_workforce(emp)) {
+				emp_list[num_emps++] = EMPIRE_VNUM(emp);
+				LL_FOREACH(EMPIRE_TERRITORY_LIST(emp), ter) {
+					++cycle_total;
+				}
+			}
+		}
+		
+		emp_pos = 0;
+		in_empire = FALSE;
+		start_pulse = pulse;
+	}
+	
+	// how much of the cycle should be done by now
+	quota = cycle_total * (pulse - start_pulse + 1) / CHORE_CYCLE_PULSES;
+	
+	while (emp_pos < num_emps) {
+		if (!(emp = real_empire(emp_list[emp_pos]))) {
+			// deleted during the cycle
+			in_empire = FALSE;
+			++emp_pos;
 			continue;
 		}
-
-		if (EMPIRE_HAS_TECH(emp, TECH_WORKFORCE)) {
-			// sort einv now to ensure it's in a useful order (most quantity first)
-			LL_SORT(EMPIRE_STORAGE(emp), sort_einv);
-			
-			global_next_territory_entry = NULL;
-			for (ter = EMPIRE_TERRITORY_LIST(emp); ter; ter = global_next_territory_entry) {
-				global_next_territory_entry = ter->next;
-				process_one_chore(emp, ter->room);
+		
+		if (!in_empire) {
+			if (!empire_has_active_workforce(emp)) {
+				++emp_pos;
+				continue;
 			}
-			
-			LL_FOREACH_SAFE(vehicle_list, veh, next_veh) {
-				if (VEH_OWNER(veh) == emp) {
-					process_one_vehicle_chore(emp, veh);
-				}
+			in_empire = TRUE;
+			global_next_territory_entry = EMPIRE_TERRITORY_LIST(emp);
+		}
+		
+		// global_next_territory_entry is kept safe by the code that deletes territory
+		while ((ter = global_next_territory_entry)) {
+			if (cycle_done >= quota || BUDGET_EXPIRED(deadline, count)) {
+				return FALSE;	// continue next pulse
 			}
-			
-			EMPIRE_NEEDS_SAVE(emp) = TRUE;
-			
-			// no longer need this -- free up the tracker
-			ewt_free_tracker(&EMPIRE_WORKFORCE_TRACKER(emp));
+			global_next_territory_entry = ter->next;
+			process_one_chore(emp, ter->room);
+			++cycle_done;
+			++count;
 		}
+		
+		finish_empire_chores(emp);
+		in_empire = FALSE;
+		++emp_pos;
 	}
+	
+	free(emp_list);
+	emp_list = NULL;
+	num_emps = 0;
+	return TRUE;
 }
 
 
@@ -839,18 +928,6 @@ char_data *place_chore_worker(empire_data *emp, int chore, room_data *room) {
 }
 
 
-/**
-* Simple sorter puts higher quantities at the top (helps workforce optimize)
-*
-* @param struct empire_storage_data *a One element
-* @param struct empire_storage_data *b Another element
-* @return int Sort instruction of <0, 0, or >0
-*/
-int sort_einv(struct empire_storage_data *a, struct empire_storage_data *b) {
-	return b->amount - a->amount;
-}
-
-
  /////////////////////////////////////////////////////////////////////////////
 //// GENERIC CRAFT WORKFORCE ////////////////////////////////////////////////
 
@@ -1419,13 +1496,15 @@ INTERACTION_FUNC(one_einv_interaction_chore) {
 */
 void do_chore_einv_interaction(empire_data *emp, room_data *room, int chore, int interact_type) {
 	char_data *worker = find_chore_worker_in_room(room, chore_data[chore].mob);
-	struct empire_storage_data *store, *found_store = NULL;
+	struct empire_storage_data *store, *found_store = NULL, **by_qty;
 	obj_data *proto, *found_proto = NULL;
 	int islid = GET_ISLAND_ID(room);
-	int most_found = -1;
+	int iter, size;
 	
-	// look for something to process
-	LL_FOREACH(EMPIRE_STORAGE(emp), store) {
+	// look for something to process: the first match is the one with the most
+	by_qty = get_storage_by_quantity(emp, &size);
+	for (iter = 0; iter < size && !found_store; ++iter) {
+		store = by_qty[iter];
 		if (store->island != islid || store->amount < 1) {
 			continue;
 		}
@@ -1440,11 +1519,8 @@ void do_chore_einv_interaction(empire_data *emp, room_data *room, int chore, int
 		}
 		
 		// found!
-		if (store->amount > most_found) {
-			found_proto = proto;
-			found_store = store;
-			most_found = store->amount;
-		}
+		found_proto = proto;
+		found_store = store;
 	}
 	
 	if (found_proto && worker) {
@@ -1456,8 +1532,10 @@ void do_chore_einv_interaction(empire_data *emp, room_data *room, int chore, int
 			found_store->amount -= 1;
 			
 			if (found_store->amount <= 0) {
-				LL_DELETE(EMPIRE_STORAGE(emp), found_store);
-				free(found_store);
+				delete_storage_entry(emp, found_store);
+			}
+			else {
+				update_storage_order(emp, found_store);
 			}
 		}
 		else {
@@ -1535,7 +1613,7 @@ void do_chore_farming(empire_data *emp, room_data *room) {
 				if (!ROOM_CROP_FLAGGED(room, CROPF_IS_ORCHARD) || get_depletion(room, DPLTN_PICK) >= config_get_int("short_depletion")) {
 					if (empire_chore_limit(emp, GET_ISLAND_ID(room), CHORE_REPLANTING) && (old_sect = reverse_lookup_evolution_for_sector(SECT(room), EVO_CROP_GROWS))) {
 						// sly-convert back to what it was grown from ... not using change_terrain
-						perform_change_sect(room, NULL, old_sect);
+						perform_change_sect(room, NOWHERE, old_sect);
 				
 						// we are keeping the original sect the same as it was
 						// TODO un-magic-number this
@@ -1724,9 +1802,9 @@ void do_chore_mining(empire_data *emp, room_data *room) {
 
 
 void do_chore_minting(empire_data *emp, room_data *room) {
-	struct empire_storage_data *highest, *store, *temp;
+	struct empire_storage_data *highest, *store, **by_qty;
 	char_data *worker = find_chore_worker_in_room(room, chore_data[CHORE_MINTING].mob);
-	int high_amt, limit, islid = GET_ISLAND_ID(room);
+	int iter, size, limit, islid = GET_ISLAND_ID(room);
 	bool can_do = TRUE;
 	obj_data *orn;
 	obj_vnum vnum;
@@ -1738,20 +1816,18 @@ void do_chore_minting(empire_data *emp, room_data *room) {
 	
 	// detect available treasure
 	if (can_do) {
-		// first, find the best item to mint
+		// first, find the best item to mint (the one we have the most of)
 		highest = NULL;
-		high_amt = 0;
-		for (store = EMPIRE_STORAGE(emp); store; store = store->next) {
+		by_qty = get_storage_by_quantity(emp, &size);
+		for (iter = 0; iter < size && !highest; ++iter) {
+			store = by_qty[iter];
 			if (store->island != islid) {
 				continue;
 			}
 			
 			orn = obj_proto(store->vnum);
 			if (orn && store->amount >= 1 && IS_WEALTH_ITEM(orn) && GET_WEALTH_VALUE(orn) > 0 && GET_WEALTH_AUTOMINT(orn)) {
-				if (highest == NULL || store->amount > high_amt) {
-					highest = store;
-					high_amt = store->amount;
-				}
+				highest = store;
 			}
 		}
 	}
@@ -1768,8 +1844,10 @@ void do_chore_minting(empire_data *emp, room_data *room) {
 			highest->amount = MAX(0, highest->amount - 1);
 			
 			if (highest->amount == 0) {
-				REMOVE_FROM_LIST(highest, EMPIRE_STORAGE(emp), next);
-				free(highest);
+				delete_storage_entry(emp, highest);
+			}
+			else {
+				update_storage_order(emp, highest);
 			}
 			
 			orn = obj_proto(vnum);	// existence of this was pre-validated